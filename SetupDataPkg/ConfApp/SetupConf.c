@@ -25,6 +25,7 @@
 #include <Library/PerformanceLib.h>
 #include <Library/ConfigVariableListLib.h>
 #include <Library/ConfigSystemModeLib.h>
+#include <Library/ConfigBase64Lib.h>
 #include <Library/ResetUtilityLib.h>
 
 #include "ConfApp.h"
@@ -114,6 +115,23 @@ InspectDumpOutput (
 
 #endif // UNIT_TEST_ENV
 
+VOID
+InspectApplyResults (
+  IN CONST XmlNode  *ResultSettingsNode
+  );
+
+#ifndef UNIT_TEST_ENV
+VOID
+InspectApplyResults (
+  IN CONST XmlNode  *ResultSettingsNode
+  )
+{
+  // The results are only inspected in unit test environment
+  return;
+}
+
+#endif // UNIT_TEST_ENV
+
 /**
   Helper internal function to reset all local variable in this file.
 **/
@@ -199,7 +217,7 @@ WriteSVDSetting (
     return EFI_INVALID_PARAMETER;
   }
 
-  Status = RetrieveActiveConfigVarList (Value, ValueSize, &ConfigVarListPtr, &ConfigVarListCount);
+  Status = RetrieveActiveConfigVarListArena (Value, ValueSize, &ConfigVarListPtr, &ConfigVarListCount);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to extract all configuration elements - %r\n", Status));
     goto Done;
@@ -210,8 +228,8 @@ WriteSVDSetting (
     // in manufacturing mode. Don't retrieve the status, if we fail to delete, try to write it anyway. If we fail
     // there, just log it and move on
     gRT->SetVariable (
-           ConfigVarListPtr->Name,
-           &ConfigVarListPtr->Guid,
+           ConfigVarListPtr[ListIndex].Name,
+           &ConfigVarListPtr[ListIndex].Guid,
            0,
            0,
            NULL
@@ -219,26 +237,21 @@ WriteSVDSetting (
 
     // write variable directly to var storage
     Status = gRT->SetVariable (
-                    ConfigVarListPtr->Name,
-                    &ConfigVarListPtr->Guid,
-                    ConfigVarListPtr->Attributes,
-                    ConfigVarListPtr->DataSize,
-                    ConfigVarListPtr->Data
+                    ConfigVarListPtr[ListIndex].Name,
+                    &ConfigVarListPtr[ListIndex].Guid,
+                    ConfigVarListPtr[ListIndex].Attributes,
+                    ConfigVarListPtr[ListIndex].DataSize,
+                    ConfigVarListPtr[ListIndex].Data
                     );
 
     if (EFI_ERROR (Status)) {
       // failed to set variable, continue to try with other variables
-      DEBUG ((DEBUG_ERROR, "Failed to set SVD Setting %s, continuing to try next variables\n", ConfigVarListPtr->Name));
+      DEBUG ((DEBUG_ERROR, "Failed to set SVD Setting %s, continuing to try next variables\n", ConfigVarListPtr[ListIndex].Name));
     }
-
-    FreePool (ConfigVarListPtr->Name);
-    FreePool (ConfigVarListPtr->Data);
   }
 
 Done:
-  if (ConfigVarListPtr != NULL) {
-    FreePool (ConfigVarListPtr);
-  }
+  FreeConfigVarList (ConfigVarListPtr);
 
   return Status;
 }
@@ -258,29 +271,32 @@ ApplySettings (
   IN  UINTN  Count
   )
 {
-  XmlNode  *InputRootNode     = NULL;                     // The root xml node for the Input list.
-  XmlNode  *InputPacketNode   = NULL;                     // The SettingsPacket node in the Input list
-  XmlNode  *InputSettingsNode = NULL;                     // The Settings node for the Input list.
-  XmlNode  *InputTempNode     = NULL;                     // Temp node ptr to use when moving thru the Input list
+  XmlNode                    *InputRootNode   = NULL;  // The root xml node for the Input list.
+  XmlNode                    *InputPacketNode = NULL;  // The SettingsPacket node in the Input list
+  XmlNode                    *InputTempNode   = NULL;  // Temp node ptr to use when moving thru the Input list
+  SVD_SETTINGS_PACKET_INDEX  *InputIndex      = NULL;  // Index of the elements and settings of the Input list
 
   XmlNode  *ResultRootNode     = NULL;                    // The root xml node in the result list
   XmlNode  *ResultPacketNode   = NULL;                    // The ResultsPacket node in the result list
   XmlNode  *ResultSettingsNode = NULL;                    // The Settings Node in the result list
 
-  LIST_ENTRY  *Link = NULL;
+  UINTN       SettingIndex;
   EFI_STATUS  Status;
   EFI_TIME    ApplyTime;
   UINTN       Version       = 0;
   UINTN       Lsv           = 0;
   BOOLEAN     ResetRequired = FALSE;
+  CHAR8       StatusString[sizeof ("0x0000000000000000")];
 
   UINTN       b64Size;
   UINTN       ValueSize;
+  UINTN       ByteArraySize;
   UINT8       *ByteArray;
   CONST VOID  *SetValue;
 
-  ByteArray = NULL;
-  SetValue  = NULL;
+  ByteArray     = NULL;
+  ByteArraySize = 0;
+  SetValue      = NULL;
 
   //
   // Create Node List from input
@@ -330,10 +346,18 @@ ApplySettings (
     goto EXIT;
   }
 
+  // Index the input packet once, rather than searching the node lists for every element and setting
+  Status = BuildSettingsPacketIndex (InputPacketNode, &InputIndex);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to index Input SettingsPacket.  Bad XML Data. %r\n", Status));
+    Status = EFI_NO_MAPPING;
+    goto EXIT;
+  }
+
   //
   // Get input version
   //
-  InputTempNode = FindFirstChildNodeByName (InputPacketNode, SETTINGS_VERSION_ELEMENT_NAME);
+  InputTempNode = GetIndexedPacketElement (InputIndex, SETTINGS_VERSION_ELEMENT_NAME);
   if (InputTempNode == NULL) {
     DEBUG ((DEBUG_ERROR, "Failed to Get Version Node\n"));
     Status = EFI_NO_MAPPING;
@@ -352,7 +376,7 @@ ApplySettings (
   //
   // Get Incoming LSV
   //
-  InputTempNode = FindFirstChildNodeByName (InputPacketNode, SETTINGS_LSV_ELEMENT_NAME);
+  InputTempNode = GetIndexedPacketElement (InputIndex, SETTINGS_LSV_ELEMENT_NAME);
   if (InputTempNode == NULL) {
     DEBUG ((DEBUG_ERROR, "Failed to Get LSV Node\n"));
     Status = EFI_NO_MAPPING;
@@ -374,15 +398,6 @@ ApplySettings (
     goto EXIT;
   }
 
-  // Get the Xml Node for the SettingsList
-  InputSettingsNode = GetSettingsListNodeFromPacketNode (InputPacketNode);
-
-  if (InputSettingsNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to Get Input Settings List Node\n"));
-    Status = EFI_NO_MAPPING;
-    goto EXIT;
-  }
-
   ResultSettingsNode = GetSettingsListNodeFromPacketNode (ResultPacketNode);
 
   if (ResultSettingsNode == NULL) {
@@ -392,36 +407,34 @@ ApplySettings (
   }
 
   // All verified.   Now lets walk thru the Settings and try to apply each one.
-  BASE_LIST_FOR_EACH (Link, &(InputSettingsNode->ChildrenListHead)) {
-    XmlNode      *NodeThis = NULL;
-    CONST CHAR8  *Id       = NULL;
-    CONST CHAR8  *Value    = NULL;
+  for (SettingIndex = 0; SettingIndex < InputIndex->SettingCount; SettingIndex++) {
+    SVD_SETTING_INDEX_ENTRY  *Setting = &InputIndex->Settings[SettingIndex];
+    CONST CHAR8              *Id      = Setting->Id;
+    CONST CHAR8              *Value   = Setting->Value;
 
-    NodeThis = (XmlNode *)Link;   // Link is first member so just cast it.  this is the <Setting> node
-    Status   = GetInputSettings (NodeThis, &Id, &Value);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "Failed to GetInputSettings.  Bad XML Data. %r\n", Status));
-      Status = EFI_NO_MAPPING;
-      goto EXIT;
-    }
-
-    // Now we have an Id and Value
+    // Now we have an Id and Value, decode it in a single pass into a buffer reused by all settings
     b64Size   = AsciiStrnLenS (Value, PcdGet32 (PcdMaxVariableSize));
-    ValueSize = 0;
-    Status    = Base64Decode (Value, b64Size, NULL, &ValueSize);
-    if (Status != EFI_BUFFER_TOO_SMALL) {
-      DEBUG ((DEBUG_ERROR, "Cannot query binary blob size. Code = %r\n", Status));
-      Status = EFI_INVALID_PARAMETER;
-      goto EXIT;
-    }
+    ValueSize = CONFIG_BASE64_DECODED_MAX_SIZE (b64Size);
+    if (ValueSize > ByteArraySize) {
+      if (ByteArray != NULL) {
+        FreePool (ByteArray);
+      }
 
-    ByteArray = (UINT8 *)AllocatePool (ValueSize);
+      ByteArraySize = 0;
+      ByteArray     = (UINT8 *)AllocatePool (ValueSize);
+      if (ByteArray == NULL) {
+        DEBUG ((DEBUG_ERROR, "Cannot allocate binary blob of size 0x%x.\n", ValueSize));
+        Status = EFI_OUT_OF_RESOURCES;
+        goto EXIT;
+      }
 
-    Status = Base64Decode (Value, b64Size, ByteArray, &ValueSize);
-    if (EFI_ERROR (Status)) {
-      FreePool (ByteArray);
+      ByteArraySize = ValueSize;
+    }
+
+    Status = ConfigBase64Decode (Value, b64Size, ByteArray, &ValueSize);
+    if (EFI_ERROR (Status) || (ValueSize == 0)) {
       DEBUG ((DEBUG_ERROR, "Cannot decode binary data. Code=%r\n", Status));
-      Status = EFI_NO_MAPPING;
+      Status = EFI_INVALID_PARAMETER;
       goto EXIT;
     }
 
@@ -434,9 +447,18 @@ ApplySettings (
 
     DEBUG ((DEBUG_INFO, "%a - Set %a = %a. Result = %r\n", __func__, Id, Value, Status));
 
+    // Record the result of this setting
+    AsciiSPrint (StatusString, sizeof (StatusString), "0x%lx", (UINT64)Status);
+    Status = SetIndexedOutputSettingsStatus (ResultSettingsNode, Setting, StatusString, NULL);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a - Failed to set result of %a. %r\n", __func__, Id, Status));
+    }
+
     // all done.
   } // end for loop
 
+  InspectApplyResults (ResultSettingsNode);
+
   // PRINT OUT XML HERE
   DEBUG ((DEBUG_INFO, "PRINTING OUT XML - Start\n"));
   DebugPrintXmlTree (ResultRootNode, 0);
@@ -445,6 +467,8 @@ ApplySettings (
   Status = EFI_SUCCESS;
 
 EXIT:
+  FreeSettingsPacketIndex (InputIndex);
+
   if (InputRootNode) {
     FreeXmlTree (&InputRootNode);
   }
@@ -644,14 +668,15 @@ CreateXmlStringFromCurrentSettings (
   XmlNode                *CurrentSettingsListNode = NULL;
   CHAR8                  LsvString[20];
   EFI_TIME               Time;
-  UINT32                 Lsv            = 1;
-  UINTN                  DataSize       = 0;
-  UINTN                  VarListSize    = 0;
-  UINTN                  Offset         = 0;
-  CHAR8                  *EncodedBuffer = NULL;
-  UINTN                  EncodedSize    = 0;
-  VOID                   *Data          = NULL;
-  CHAR8                  *AsciiName     = NULL;
+  UINT32                 Lsv               = 1;
+  UINTN                  DataSize          = 0;
+  UINTN                  VarListSize       = 0;
+  UINTN                  Offset            = 0;
+  CHAR8                  *EncodedBuffer    = NULL;
+  UINTN                  EncodedBufferSize = 0;
+  UINTN                  EncodedSize       = 0;
+  VOID                   *Data             = NULL;
+  CHAR8                  *AsciiName        = NULL;
   UINTN                  AsciiSize;
   UINTN                  i;
   UINTN                  NumPolicies;
@@ -781,23 +806,25 @@ CreateXmlStringFromCurrentSettings (
 
           AsciiSPrint (AsciiName, AsciiSize, "%s", ConfigVarList.Name);
 
-          // First encode the binary blob
-          EncodedSize = 0;
-          Status      = Base64Encode ((UINT8 *)Data + Offset, VarListSize, NULL, &EncodedSize);
-          if (Status != EFI_BUFFER_TOO_SMALL) {
-            DEBUG ((DEBUG_ERROR, "Cannot query binary blob size. Code = %r\n", Status));
-            Status = EFI_INVALID_PARAMETER;
-            goto EXIT;
-          }
-
-          EncodedBuffer = (CHAR8 *)AllocatePool (EncodedSize);
-          if (EncodedBuffer == NULL) {
-            DEBUG ((DEBUG_ERROR, "Cannot allocate encoded buffer of size 0x%x.\n", EncodedSize));
-            Status = EFI_OUT_OF_RESOURCES;
-            goto EXIT;
+          // First encode the binary blob in a single pass, into a buffer reused by all entries
+          EncodedSize = CONFIG_BASE64_ENCODED_SIZE (VarListSize);
+          if (EncodedSize > EncodedBufferSize) {
+            if (EncodedBuffer != NULL) {
+              FreePool (EncodedBuffer);
+            }
+
+            EncodedBufferSize = 0;
+            EncodedBuffer     = (CHAR8 *)AllocatePool (EncodedSize);
+            if (EncodedBuffer == NULL) {
+              DEBUG ((DEBUG_ERROR, "Cannot allocate encoded buffer of size 0x%x.\n", EncodedSize));
+              Status = EFI_OUT_OF_RESOURCES;
+              goto EXIT;
+            }
+
+            EncodedBufferSize = EncodedSize;
           }
 
-          Status = Base64Encode ((UINT8 *)Data + Offset, VarListSize, EncodedBuffer, &EncodedSize);
+          Status = ConfigBase64Encode ((UINT8 *)Data + Offset, VarListSize, EncodedBuffer, &EncodedSize);
           if (EFI_ERROR (Status)) {
             DEBUG ((DEBUG_ERROR, "Failed to encode binary data into Base 64 format. Code = %r\n", Status));
             Status = EFI_INVALID_PARAMETER;
@@ -0,0 +1,584 @@
+/** @file
+  Host based micro-benchmarks of the Setup Configuration page of ConfApp module.
+
+  Applying settings is also run against the mocked variable store, which reports its simulated flash cost.
+
+  Results are printed on stdout as one JSON object per line, see SetupDataPkgBenchmark.h.
+
+  Copyright (C) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Protocol/Policy.h>
+#include <XmlTypes.h>
+
+#include <Library/BaseLib.h>
+#include <Library/PrintLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootManagerLib.h>
+#include <Library/ConfigVariableListLib.h>
+#include <Library/MockVariableStoreLib.h>
+
+#include <SetupDataPkgBenchmark.h>
+#include "ConfApp.h"
+
+#define SETUP_CONF_SUITE_NAME  "ConfApp.SetupConf"
+
+extern POLICY_PROTOCOL       *mPolicyProtocol;
+extern EFI_RUNTIME_SERVICES  MockRuntime;
+
+EFI_STATUS
+ApplySettings (
+  IN  CHAR8  *Buffer,
+  IN  UINTN  Count
+  );
+
+EFI_STATUS
+EFIAPI
+CreateXmlStringFromCurrentSettings (
+  OUT CHAR8  **XmlString,
+  OUT UINTN  *StringSize
+  );
+
+//
+// Variable list served by the mocked configuration policy.
+//
+STATIC VOID   *mPolicyVarList     = NULL;
+STATIC UINTN  mPolicyVarListSize = 0;
+
+//
+// SVD of the synthetic knobs, the setting is repeated for each knob with its name and encoded entry.
+//
+STATIC CONST CHAR8  mBenchmarkSvdHeader[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+  "<SettingsPacket xmlns=\"urn:UefiSettings-Schema\">"
+  "<CreatedBy>SetupDataPkg Benchmark</CreatedBy><CreatedOn>2022-04-29 00:00</CreatedOn>"
+  "<Version>1</Version><LowestSupportedVersion>1</LowestSupportedVersion>"
+  "<Settings>";
+STATIC CONST CHAR8  mBenchmarkSvdSetting[] =
+  "<Setting><Id>%s</Id><Value>%a</Value></Setting>";
+STATIC CONST CHAR8  mBenchmarkSvdFooter[] =
+  "</Settings></SettingsPacket>";
+
+EFI_STATUS
+InspectDumpOutput (
+  IN VOID   *Buffer,
+  IN UINTN  BufferSize
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Stubbed version of the hook receiving the results of ApplySettings.
+
+  @param[in]  ResultSettingsNode  The <Settings> node of the ResultsPacket.
+**/
+VOID
+InspectApplyResults (
+  IN CONST XmlNode  *ResultSettingsNode
+  )
+{
+  return;
+}
+
+/**
+  Stubbed version of SvdRequestXmlFromUSB, not reached by the benchmarks.
+
+**/
+EFI_STATUS
+EFIAPI
+SvdRequestXmlFromUSB (
+  IN  CHAR16  *FileName,
+  OUT CHAR8   **JsonString,
+  OUT UINTN   *JsonStringSize
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  State machine for system information page, not reached by the benchmarks.
+
+**/
+EFI_STATUS
+EFIAPI
+SysInfoMgr (
+  VOID
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  State machine for boot option page, not reached by the benchmarks.
+
+**/
+EFI_STATUS
+EFIAPI
+BootOptionMgr (
+  VOID
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  State machine for secure boot page, not reached by the benchmarks.
+
+**/
+EFI_STATUS
+EFIAPI
+SecureBootMgr (
+  VOID
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Stubbed version of EfiBootManagerConnectAll.
+
+**/
+VOID
+EFIAPI
+EfiBootManagerConnectAll (
+  VOID
+  )
+{
+  return;
+}
+
+/**
+  Stubbed version of Print, output would disturb the benchmark results.
+
+  @param Format   A null-terminated Unicode format string.
+  @param ...      The variable argument list whose contents are accessed based
+                  on the format string specified by Format.
+
+  @return Always 0.
+**/
+UINTN
+EFIAPI
+Print (
+  IN CONST CHAR16  *Format,
+  ...
+  )
+{
+  return 0;
+}
+
+/**
+  Mock implementation of CpuDeadLoop to prevent actual deadlocks.
+
+**/
+VOID
+EFIAPI
+MockCpuDeadLoop (
+  VOID
+  )
+{
+  return;
+}
+
+///
+/// Mock version of the UEFI Boot Services Table, no boot service is used by the benchmarks
+///
+EFI_BOOT_SERVICES  MockBoot = {
+  {
+    EFI_BOOT_SERVICES_SIGNATURE,
+    EFI_BOOT_SERVICES_REVISION,
+    sizeof (EFI_BOOT_SERVICES),
+    0,
+    0
+  },
+};
+
+/**
+  Mocked version of GetTime.
+
+  @param[out]  Time             A pointer to storage to receive a snapshot of the current time.
+  @param[out]  Capabilities     An optional pointer to a buffer to receive the real time clock
+                                device's capabilities.
+
+  @retval EFI_SUCCESS           The operation completed successfully.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkGetTime (
+  OUT  EFI_TIME               *Time,
+  OUT  EFI_TIME_CAPABILITIES  *Capabilities OPTIONAL
+  )
+{
+  ZeroMem (Time, sizeof (EFI_TIME));
+  Time->Year  = 2022;
+  Time->Month = 4;
+  Time->Day   = 29;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Mocked version of SetVariable, which accepts every write without storing it so only
+  the cost of ConfApp itself is measured.
+
+  @param[in]  VariableName       A Null-terminated string that is the name of the vendor's variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+  @param[in]  Attributes         Attributes bitmask to set for the variable.
+  @param[in]  DataSize           The size in bytes of the Data buffer.
+  @param[in]  Data               The contents for the variable.
+
+  @retval EFI_SUCCESS            The firmware has successfully stored the variable and its data as
+                                 defined by the Attributes.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Mocked version of GetPolicy, returning mPolicyVarList for any policy.
+
+  @param[in]  PolicyGuid        The GUID of the policy being retrieved.
+  @param[out] Attributes        The attributes of the stored policy.
+  @param[out] Policy            The buffer where the policy data is copied.
+  @param[in,out] PolicySize     The size of the stored policy data buffer.
+
+  @retval   EFI_SUCCESS           The policy was retrieved.
+  @retval   EFI_BUFFER_TOO_SMALL  The provided buffer size was too small.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkGetPolicy (
+  IN CONST EFI_GUID  *PolicyGuid,
+  OUT UINT64         *Attributes OPTIONAL,
+  OUT VOID           *Policy,
+  IN OUT UINT16      *PolicySize
+  )
+{
+  if (*PolicySize < mPolicyVarListSize) {
+    *PolicySize = (UINT16)mPolicyVarListSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *PolicySize = (UINT16)mPolicyVarListSize;
+  CopyMem (Policy, mPolicyVarList, mPolicyVarListSize);
+
+  return EFI_SUCCESS;
+}
+
+POLICY_PROTOCOL  mBenchmarkPolicy = {
+  .GetPolicy = BenchmarkGetPolicy
+};
+
+/**
+  Create a SVD applying every knob of a synthetic variable list, one setting per knob.
+
+  @param[in]  VarList      The synthetic variable list, every entry of the same size.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+  @param[out] Svd          Allocated SVD, the caller frees it with FreePool.
+  @param[out] SvdLength    Length of Svd, excluding the NULL terminator.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+  @retval EFI_SUCCESS           The SVD was created.
+  @retval Others                A knob could not be encoded.
+**/
+STATIC
+EFI_STATUS
+BenchmarkCreateSvd (
+  IN  UINT8  *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount,
+  OUT CHAR8  **Svd,
+  OUT UINTN  *SvdLength
+  )
+{
+  EFI_STATUS  Status;
+  CHAR16      Name[BENCHMARK_KNOB_NAME_LEN];
+  CHAR8       *Encoded;
+  UINTN       EncodedSize;
+  UINTN       EntrySize;
+  UINTN       BufferSize;
+  UINTN       Offset;
+  UINTN       Index;
+  CHAR8       *Buffer;
+
+  Encoded = NULL;
+  Buffer  = NULL;
+
+  EntrySize   = VarListSize / KnobCount;
+  EncodedSize = 0;
+  Status      = Base64Encode (VarList, EntrySize, NULL, &EncodedSize);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    goto Exit;
+  }
+
+  Encoded    = AllocatePool (EncodedSize);
+  BufferSize = sizeof (mBenchmarkSvdHeader) + sizeof (mBenchmarkSvdFooter) +
+               KnobCount * (sizeof (mBenchmarkSvdSetting) + BENCHMARK_KNOB_NAME_LEN + EncodedSize);
+  Buffer     = AllocatePool (BufferSize);
+  if ((Encoded == NULL) || (Buffer == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Offset = AsciiSPrint (Buffer, BufferSize, mBenchmarkSvdHeader);
+  for (Index = 0; Index < KnobCount; Index++) {
+    Status = Base64Encode (VarList + Index * EntrySize, EntrySize, Encoded, &EncodedSize);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    BenchmarkGetKnobName (Index, Name);
+    Offset += AsciiSPrint (Buffer + Offset, BufferSize - Offset, mBenchmarkSvdSetting, Name, Encoded);
+  }
+
+  Offset += AsciiSPrint (Buffer + Offset, BufferSize - Offset, mBenchmarkSvdFooter);
+
+  *Svd       = Buffer;
+  *SvdLength = Offset;
+  Buffer     = NULL;
+
+Exit:
+  if (Encoded != NULL) {
+    FreePool (Encoded);
+  }
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+
+  return Status;
+}
+
+/**
+  Benchmark applying a SVD that sets every knob of a synthetic variable list.
+
+  @param[in]  VarList      The synthetic variable list.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+**/
+STATIC
+VOID
+BenchmarkApplySettings (
+  IN  VOID   *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *Svd;
+  UINTN       SvdLength;
+  UINTN       Iterations;
+  UINTN       Index;
+  UINT64      Start;
+
+  Svd    = NULL;
+  Status = BenchmarkCreateSvd (VarList, VarListSize, KnobCount, &Svd, &SvdLength);
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (SETUP_CONF_SUITE_NAME, "ApplySettings", KnobCount, Status);
+    return;
+  }
+
+  Iterations = BenchmarkGetIterations (KnobCount);
+  Start      = BenchmarkGetTimeNs ();
+  for (Index = 0; Index < Iterations; Index++) {
+    Status = ApplySettings (Svd, SvdLength);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (SETUP_CONF_SUITE_NAME, "ApplySettings", KnobCount, Status);
+  } else {
+    BenchmarkReport (SETUP_CONF_SUITE_NAME, "ApplySettings", KnobCount, Iterations, BenchmarkGetTimeNs () - Start);
+  }
+
+  FreePool (Svd);
+}
+
+/**
+  Benchmark the simulated flash cost of applying again a SVD that sets every knob of a synthetic variable list, to a
+  variable store already holding the same settings.
+
+  @param[in]  VarList      The synthetic variable list.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+**/
+STATIC
+VOID
+BenchmarkReapplySettingsVariableStore (
+  IN  VOID   *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount
+  )
+{
+  EFI_STATUS                 Status;
+  MOCK_VARIABLE_STORE_STATS  Stats;
+  CHAR8                      *Svd;
+  UINTN                      SvdLength;
+
+  Svd    = NULL;
+  Status = BenchmarkCreateSvd (VarList, VarListSize, KnobCount, &Svd, &SvdLength);
+  if (!EFI_ERROR (Status)) {
+    Status = BenchmarkInitializeVariableStore (KnobCount);
+  }
+
+  MockRuntime.SetVariable = MockVariableStoreSetVariable;
+  if (!EFI_ERROR (Status)) {
+    Status = ApplySettings (Svd, SvdLength);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    MockVariableStoreResetStats ();
+    Status = ApplySettings (Svd, SvdLength);
+    MockVariableStoreGetStats (&Stats);
+  }
+
+  MockRuntime.SetVariable = BenchmarkSetVariable;
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (SETUP_CONF_SUITE_NAME, "ReapplySettingsVariableStore", KnobCount, Status);
+  } else {
+    BenchmarkReportVariableStore (SETUP_CONF_SUITE_NAME, "ReapplySettingsVariableStore", KnobCount, &Stats);
+  }
+
+  MockVariableStoreFree ();
+  if (Svd != NULL) {
+    FreePool (Svd);
+  }
+}
+
+/**
+  Benchmark dumping the current settings of a configuration policy holding a synthetic variable list.
+
+  @param[in]  VarList      The synthetic variable list.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+**/
+STATIC
+VOID
+BenchmarkCreateXmlStringFromCurrentSettings (
+  IN  VOID   *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *XmlString;
+  UINTN       XmlStringSize;
+  UINTN       Iterations;
+  UINTN       Index;
+  UINT64      Start;
+  UINT64      Elapsed;
+
+  // Policy sizes are UINT16, larger configurations cannot be published through the policy service
+  if (VarListSize > MAX_UINT16) {
+    BenchmarkReportError (SETUP_CONF_SUITE_NAME, "CreateXmlStringFromCurrentSettings", KnobCount, EFI_BAD_BUFFER_SIZE);
+    return;
+  }
+
+  mPolicyProtocol    = &mBenchmarkPolicy;
+  mPolicyVarList     = VarList;
+  mPolicyVarListSize = VarListSize;
+
+  Status     = EFI_SUCCESS;
+  Iterations = BenchmarkGetIterations (KnobCount);
+  Elapsed    = 0;
+  for (Index = 0; Index < Iterations; Index++) {
+    XmlString     = NULL;
+    XmlStringSize = 0;
+
+    Start   = BenchmarkGetTimeNs ();
+    Status  = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+    Elapsed = Elapsed + BenchmarkGetTimeNs () - Start;
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    FreePool (XmlString);
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (SETUP_CONF_SUITE_NAME, "CreateXmlStringFromCurrentSettings", KnobCount, Status);
+  } else {
+    BenchmarkReport (SETUP_CONF_SUITE_NAME, "CreateXmlStringFromCurrentSettings", KnobCount, Iterations, Elapsed);
+  }
+
+  mPolicyProtocol    = NULL;
+  mPolicyVarList     = NULL;
+  mPolicyVarListSize = 0;
+}
+
+/**
+  Run all ConfApp benchmarks against synthetic variable lists of growing size.
+
+  @param[in]  MaxKnobCount  Largest knob count to benchmark.
+
+  @retval EFI_SUCCESS  All benchmarks ran, failures of individual benchmarks are reported in the output.
+  @retval Others       A synthetic variable list could not be created.
+**/
+STATIC
+EFI_STATUS
+BenchmarkEntry (
+  IN  UINTN  MaxKnobCount
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *VarList;
+  UINTN       VarListSize;
+  UINTN       KnobCount;
+
+  MockRuntime.GetTime     = BenchmarkGetTime;
+  MockRuntime.SetVariable = BenchmarkSetVariable;
+
+  Status = EFI_SUCCESS;
+  for (KnobCount = BENCHMARK_MIN_KNOB_COUNT;
+       KnobCount <= MaxKnobCount;
+       KnobCount = BenchmarkNextKnobCount (KnobCount))
+  {
+    VarList = NULL;
+    Status  = BenchmarkCreateVarList (KnobCount, &VarList, &VarListSize);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to create a variable list of %u knobs - %r\n", __func__, KnobCount, Status));
+      break;
+    }
+
+    BenchmarkApplySettings (VarList, VarListSize, KnobCount);
+    BenchmarkReapplySettingsVariableStore (VarList, VarListSize, KnobCount);
+    BenchmarkCreateXmlStringFromCurrentSettings (VarList, VarListSize, KnobCount);
+
+    FreePool (VarList);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based benchmark execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return EFI_ERROR (BenchmarkEntry (BenchmarkGetMaxKnobCount (argc, argv))) ? 1 : 0;
+}
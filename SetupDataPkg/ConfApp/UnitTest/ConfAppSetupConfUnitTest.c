@@ -27,6 +27,9 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootManagerLib.h>
 #include <Library/ConfigVariableListLib.h>
+#include <XmlTypes.h>
+#include <Library/XmlTreeQueryLib.h>
+#include <Library/SvdXmlSettingSchemaSupportLib.h>
 
 #include <Library/UnitTestLib.h>
 
@@ -36,6 +39,11 @@
 #define UNIT_TEST_APP_NAME     "Conf Application Setup Configuration Unit Tests"
 #define UNIT_TEST_APP_VERSION  "1.0"
 
+// Number of settings in the SVD of the scaling test
+#define SCALE_SETTING_COUNT  10000
+
+#define SCALE_SVD_ID_PREFIX  "INTEGER_KNOB_"
+
 extern EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL  MockSimpleInput;
 extern SetupConfState_t                   mSetupConfState;
 extern POLICY_PROTOCOL                    *mPolicyProtocol;
@@ -51,6 +59,71 @@ typedef struct {
   UINTN                    VarListCnt;
 } CONTEXT_DATA;
 
+EFI_STATUS
+ApplySettings (
+  IN  CHAR8  *Buffer,
+  IN  UINTN  Count
+  );
+
+//
+// Settings of the scaling test that got a successful result, by index. Results are only collected while it is set.
+//
+STATIC BOOLEAN  *mScaleResultSeen    = NULL;
+STATIC UINTN    mScaleResultSuccess = 0;
+
+// SVD of the scaling test, the setting is repeated SCALE_SETTING_COUNT times with its index in the Id
+STATIC CONST CHAR8  mScaleSvdHeader[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+  "<SettingsPacket xmlns=\"urn:UefiSettings-Schema\">"
+  "<CreatedBy>Dfci Testcase Libraries</CreatedBy><CreatedOn>2022-12-07 14:21</CreatedOn>"
+  "<Version>1</Version><LowestSupportedVersion>1</LowestSupportedVersion>"
+  "<Settings>";
+STATIC CONST CHAR8  mScaleSvdSetting[] =
+  "<Setting><Id>" SCALE_SVD_ID_PREFIX "%05u</Id>"
+  "<Value>GgAAAAQAAABJAE4AVABFAEcARQBSAF8ASwBOAE8AQgAAAP4+1J+xc0HtkHY1ZmHUakIGAAAAZAAAAA/g+N8=</Value>"
+  "</Setting>";
+STATIC CONST CHAR8  mScaleSvdFooter[] =
+  "</Settings></SettingsPacket>";
+
+/**
+  Mocked version of the hook receiving the results of ApplySettings, which counts the distinct settings of the
+  scaling test with a successful result.
+
+  @param[in]  ResultSettingsNode  The <Settings> node of the ResultsPacket.
+**/
+VOID
+InspectApplyResults (
+  IN CONST XmlNode  *ResultSettingsNode
+  )
+{
+  CONST LIST_ENTRY  *Link;
+  XmlNode           *IdNode;
+  XmlNode           *ResultNode;
+  UINTN             Index;
+
+  if (mScaleResultSeen == NULL) {
+    return;
+  }
+
+  BASE_LIST_FOR_EACH (Link, &(ResultSettingsNode->ChildrenListHead)) {
+    IdNode     = FindFirstChildNodeByName ((XmlNode *)Link, RESULTS_SETTING_ID_ELEMENT_NAME);
+    ResultNode = FindFirstChildNodeByName ((XmlNode *)Link, RESULTS_SETTING_STATUS_ELEMENT_NAME);
+    if ((IdNode == NULL) || (ResultNode == NULL) || (AsciiStrCmp (ResultNode->Value, "0x0") != 0)) {
+      continue;
+    }
+
+    if (AsciiStrnCmp (IdNode->Value, SCALE_SVD_ID_PREFIX, sizeof (SCALE_SVD_ID_PREFIX) - 1) != 0) {
+      continue;
+    }
+
+    Index = AsciiStrDecimalToUintn (IdNode->Value + sizeof (SCALE_SVD_ID_PREFIX) - 1);
+    if ((Index < SCALE_SETTING_COUNT) && !mScaleResultSeen[Index]) {
+      mScaleResultSeen[Index] = TRUE;
+      mScaleResultSuccess++;
+    }
+  }
+}
+
 EFI_STATUS
 InspectDumpOutput (
   IN VOID   *Buffer,
@@ -1078,6 +1151,71 @@ ConfAppSetupConfNonMfg (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for applying a SVD with a large number of settings, where every setting is
+  applied and gets a successful result status.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfApplySettingsScale (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *Xml;
+  UINTN       XmlSize;
+  UINTN       Offset;
+  UINT32      Index;
+
+  // The Id placeholder grows by one character when printed
+  XmlSize = sizeof (mScaleSvdHeader) + SCALE_SETTING_COUNT * sizeof (mScaleSvdSetting) + sizeof (mScaleSvdFooter);
+  Xml     = AllocatePool (XmlSize);
+  UT_ASSERT_NOT_NULL (Xml);
+
+  Offset = AsciiSPrint (Xml, XmlSize, mScaleSvdHeader);
+  for (Index = 0; Index < SCALE_SETTING_COUNT; Index++) {
+    Offset += AsciiSPrint (Xml + Offset, XmlSize - Offset, mScaleSvdSetting, Index);
+  }
+
+  Offset += AsciiSPrint (Xml + Offset, XmlSize - Offset, mScaleSvdFooter);
+
+  // Each setting deletes and then sets INTEGER_KNOB
+  will_return_always (MockSetVariable, EFI_SUCCESS);
+  expect_memory_count (MockSetVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"), 2 * SCALE_SETTING_COUNT);
+  expect_memory_count (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID), 2 * SCALE_SETTING_COUNT);
+  expect_any_count (MockSetVariable, DataSize, 2 * SCALE_SETTING_COUNT);
+  expect_any_count (MockSetVariable, Data, 2 * SCALE_SETTING_COUNT);
+
+  mScaleResultSeen    = AllocateZeroPool (SCALE_SETTING_COUNT * sizeof (BOOLEAN));
+  mScaleResultSuccess = 0;
+  UT_ASSERT_NOT_NULL (mScaleResultSeen);
+
+  Status = ApplySettings (Xml, Offset);
+
+  FreePool (mScaleResultSeen);
+  mScaleResultSeen = NULL;
+  FreePool (Xml);
+
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  // Every Id of the input has a successful result in the output packet
+  UT_ASSERT_EQUAL (mScaleResultSuccess, SCALE_SETTING_COUNT);
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   ConfApp and run the ConfApp unit test.
@@ -1134,6 +1272,7 @@ UnitTestingEntry (
   AddTestCase (MiscTests, "Setup Configuration page should dump 2 configurations from serial", "ConfDumpMini", ConfAppSetupConfDumpSerialMini, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should dump all configurations from serial", "ConfDump", ConfAppSetupConfDumpSerial, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should ignore updating configurations when in non-mfg mode", "ConfNonMfg", ConfAppSetupConfNonMfg, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration should apply a SVD with 10k settings", "ApplySettingsScale", ConfAppSetupConfApplySettingsScale, NULL, NULL, NULL);
 
   //
   // Execute the tests.
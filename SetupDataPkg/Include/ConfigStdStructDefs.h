@@ -32,6 +32,15 @@ typedef struct {
   KNOB_VALIDATION_FN    *Validator;
 } KNOB_DATA;
 
+/*
+ * Access statistics of a single knob, only collected by modules built with CONFIG_KNOB_STATISTICS
+ */
+typedef struct {
+  UINT32    ReadCount;              // Successful reads of the knob
+  UINT32    CacheHitCount;          // Reads served from an already populated cached policy
+  UINT32    ValidationFailureCount; // Reads rejected because the cached policy could not be validated
+} KNOB_STATISTICS;
+
 typedef struct {
   UINTN    Knob;
   VOID     *Value;
@@ -0,0 +1,74 @@
+/** @file ConfigBase64Lib.h
+  Library interface to Base64 encode and decode SVD setting values in a single pass.
+
+  The results are identical to Base64Encode and Base64Decode of BaseLib, statuses and returned sizes included, so
+  either can be used interchangeably. Unlike the BaseLib routines, callers are expected to size the destination with
+  CONFIG_BASE64_ENCODED_SIZE or CONFIG_BASE64_DECODED_MAX_SIZE up front instead of querying the size with a first call,
+  and whole quanta are converted at once instead of one character at a time.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_BASE64_LIB_H_
+#define CONFIG_BASE64_LIB_H_
+
+//
+// Size in bytes of the Base64 encoding of BinarySize bytes, including the NULL terminator.
+//
+#define CONFIG_BASE64_ENCODED_SIZE(BinarySize)  ((((BinarySize) + 2) / 3) * 4 + 1)
+
+//
+// Largest number of bytes EncodedLength Base64 characters can decode to, whitespace and padding included.
+//
+#define CONFIG_BASE64_DECODED_MAX_SIZE(EncodedLength)  (((EncodedLength) / 4) * 3)
+
+/**
+  Convert binary data to a Base64 encoded ascii string based on RFC4648, identical to Base64Encode of BaseLib.
+
+  @param[in]      Source           Input UINT8 data.
+  @param[in]      SourceLength     Number of UINT8 bytes of data.
+  @param[out]     Destination      Pointer to the buffer receiving the NULL terminated encoded string.
+  @param[in, out] DestinationSize  Size in bytes of Destination. Set to CONFIG_BASE64_ENCODED_SIZE (SourceLength) on
+                                   success or if Destination is too small.
+
+  @retval EFI_SUCCESS            Source was encoded.
+  @retval EFI_BUFFER_TOO_SMALL   Destination is NULL or smaller than CONFIG_BASE64_ENCODED_SIZE (SourceLength).
+  @retval EFI_INVALID_PARAMETER  Source or DestinationSize is NULL, or a buffer wraps around the address space.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Encode (
+  IN  CONST UINT8  *Source,
+  IN        UINTN  SourceLength,
+  OUT       CHAR8  *Destination   OPTIONAL,
+  IN OUT    UINTN  *DestinationSize
+  );
+
+/**
+  Decode a Base64 encoded ascii string to binary data based on RFC4648, identical to Base64Decode of BaseLib.
+
+  Whitespace is ignored at all positions, padding is required and the unused bits of the last quantum must be zero.
+
+  @param[in]      Source           Base64 encoded characters, need not be NULL terminated.
+  @param[in]      SourceSize       Number of CHAR8 elements in Source.
+  @param[out]     Destination      Pointer to the buffer receiving the decoded bytes.
+  @param[in, out] DestinationSize  On input, size in bytes of Destination. On output, number of bytes Source decodes
+                                   to, or decoded so far if Source is invalid.
+
+  @retval EFI_SUCCESS            Source was decoded.
+  @retval EFI_BUFFER_TOO_SMALL   Destination is too small, the bytes fitting in it were decoded.
+  @retval EFI_INVALID_PARAMETER  Source is not valid Base64, DestinationSize is NULL, a buffer is NULL with a non zero
+                                 size, a buffer wraps around the address space or Source and Destination overlap.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Decode (
+  IN     CONST CHAR8  *Source          OPTIONAL,
+  IN     UINTN        SourceSize,
+  OUT    UINT8        *Destination     OPTIONAL,
+  IN OUT UINTN        *DestinationSize
+  );
+
+#endif // CONFIG_BASE64_LIB_H_
@@ -0,0 +1,100 @@
+/** @file ConfigKnobPerfLib.h
+  Library interface to account how many config knobs were resolved in each boot phase, where their values
+  came from and how long it took.
+
+  The Null instance of this library turns all accounting into no-ops, so it compiles to nothing when disabled.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_KNOB_PERF_LIB_H_
+#define CONFIG_KNOB_PERF_LIB_H_
+
+/*
+ * Where the value of a resolved config knob came from
+ */
+typedef enum {
+  ConfigKnobSourceCache = 0,  // Read from the already populated cached config policy
+  ConfigKnobSourcePolicy,     // Read after populating the cached config policy from the policy service
+  ConfigKnobSourceVariable,   // Override found in variable storage
+  ConfigKnobSourceDefault,    // No override found, the profile default applies
+  ConfigKnobSourceMax
+} CONFIG_KNOB_SOURCE;
+
+/*
+ * Boot phase the knob resolutions were accounted in
+ */
+typedef enum {
+  ConfigKnobPhasePei = 0,     // All PEIMs, accounted in the config knob perf HOB
+  ConfigKnobPhaseDxe,         // The calling DXE or MM module
+  ConfigKnobPhaseMax
+} CONFIG_KNOB_PHASE;
+
+/*
+ * Accounting of knob resolutions, indexed by CONFIG_KNOB_SOURCE
+ */
+typedef struct {
+  UINT64    Count[ConfigKnobSourceMax];
+  UINT64    TimeNs[ConfigKnobSourceMax];
+} CONFIG_KNOB_PERF_STATS;
+
+/*
+ * Data of the GUIDed HOB identified by gConfigKnobPerfHobGuid, produced by the PEI instance and consumed by the
+ * DXE instance
+ */
+typedef CONFIG_KNOB_PERF_STATS CONFIG_KNOB_PERF_HOB;
+
+/**
+  Start accounting the resolution of a config knob.
+
+  @return Opaque start of the resolution, to be passed to ConfigKnobPerfEnd.
+**/
+UINT64
+EFIAPI
+ConfigKnobPerfBegin (
+  VOID
+  );
+
+/**
+  Account the resolution of a config knob in the current boot phase.
+
+  @param[in]  Source  Where the value of the knob came from.
+  @param[in]  Begin   Value returned by ConfigKnobPerfBegin when the resolution started.
+**/
+VOID
+EFIAPI
+ConfigKnobPerfEnd (
+  IN CONFIG_KNOB_SOURCE  Source,
+  IN UINT64              Begin
+  );
+
+/**
+  Retrieve the accounting of a boot phase.
+
+  @param[in]  Phase   The boot phase of interest.
+  @param[out] Stats   The accounting of Phase.
+
+  @retval EFI_INVALID_PARAMETER   Stats is NULL or Phase is not a valid phase.
+  @retval EFI_NOT_FOUND           Phase was not accounted, i.e. no knob was resolved in it.
+  @retval EFI_UNSUPPORTED         Accounting is disabled.
+  @retval EFI_SUCCESS             Stats contains the accounting of Phase.
+**/
+EFI_STATUS
+EFIAPI
+ConfigKnobPerfGetStats (
+  IN  CONFIG_KNOB_PHASE       Phase,
+  OUT CONFIG_KNOB_PERF_STATS  *Stats
+  );
+
+/**
+  Print the accounting of all boot phases visible to the caller to the debug output.
+**/
+VOID
+EFIAPI
+ConfigKnobPerfDump (
+  VOID
+  );
+
+#endif // CONFIG_KNOB_PERF_LIB_H_
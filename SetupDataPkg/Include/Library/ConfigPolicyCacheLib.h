@@ -0,0 +1,68 @@
+/** @file ConfigPolicyCacheLib.h
+  Library interface to share a single cached config policy between all modules of a boot phase.
+
+  Modules built with CONFIG_SHARED_POLICY_CACHE defined resolve the autogenerated getters to the cache returned by
+  this library instead of a STATIC copy of their own. The first getter call of the phase populates the shared cache
+  from the policy service and marks it valid, all later calls of any module read the validated cache directly.
+
+  The PEI instance publishes the cache in a GUIDed HOB, so that it is writable before permanent memory, the DXE instance
+  through a protocol and the MM instance in the MM configuration table.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_POLICY_CACHE_LIB_H_
+#define CONFIG_POLICY_CACHE_LIB_H_
+
+#define CONFIG_POLICY_CACHE_REVISION  1
+
+//
+// Alignment in bytes of the shared cache. The getters of the aligned variable list layout read the cached policy with
+// naturally aligned UINT64 accesses, so every instance places the cache on this boundary, whatever the size of the
+// structure preceding it on the target architecture.
+//
+#define CONFIG_POLICY_CACHE_ALIGNMENT  sizeof (UINT64)
+
+/*
+ * Shared cached config policy, installed as gConfigPolicyCacheProtocolGuid in DXE and as the gConfigPolicyCacheGuid
+ * configuration table in MM
+ */
+typedef struct {
+  UINT32    Revision;
+  UINT32    Size;    // Size in bytes of Cache
+  UINT8     *Cache;  // Cached policy header followed by the cached policy, aligned on CONFIG_POLICY_CACHE_ALIGNMENT
+} CONFIG_POLICY_CACHE;
+
+/*
+ * Shared cached config policy in PEI, the data of the gConfigPolicyCacheGuid HOB followed by the cache itself at the
+ * next CONFIG_POLICY_CACHE_ALIGNMENT boundary. Both are writable in temporary RAM and moved with the HOB list, so the
+ * HOB is looked up rather than kept.
+ */
+typedef struct {
+  UINT32    Revision;
+  UINT32    Size;    // Size in bytes of the cache following this structure
+} CONFIG_POLICY_CACHE_HOB;
+
+extern EFI_GUID  gConfigPolicyCacheGuid;
+extern EFI_GUID  gConfigPolicyCacheProtocolGuid;
+
+/**
+  Return the cached config policy shared by all modules of the current boot phase, publishing it if it does not
+  exist yet.
+
+  A newly published cache is zeroed, so the cached policy header is not valid until the first getter populated it.
+
+  @param[in]  Size    Size in bytes of the cache, including the cached policy header.
+
+  @return The shared cache of Size bytes, aligned on CONFIG_POLICY_CACHE_ALIGNMENT bytes, NULL if it could not be
+          published or was published with another size.
+**/
+UINT8 *
+EFIAPI
+ConfigPolicyCacheGetShared (
+  IN UINTN  Size
+  );
+
+#endif // CONFIG_POLICY_CACHE_LIB_H_
@@ -46,6 +46,105 @@ typedef struct {
 } CONFIG_VAR_LIST_HDR;
 #pragma pack(pop)
 
+//
+// Signature at the start of a v2 variable list. Its value is far larger than any legal
+// v1 NameSize, so it can never be confused with the first header of a v1 list.
+//
+#define CONFIG_VAR_LIST_V2_SIGNATURE  SIGNATURE_32 ('C', 'V', 'L', '2')
+#define CONFIG_VAR_LIST_V2_VERSION    2
+
+//
+// Version of a v2 variable list padded so the data of every entry is aligned on
+// CONFIG_VAR_LIST_V2_DATA_ALIGNMENT bytes from the start of the list, and can be read in place:
+// the string table is padded with zeros so the first entry is aligned, the CRC32 of each entry
+// is aligned on 4 bytes after its data and each entry is padded with zeros to the alignment.
+// Neither padding is covered by the CRC32 of the entry.
+//
+#define CONFIG_VAR_LIST_V2_ALIGNED_VERSION  3
+#define CONFIG_VAR_LIST_V2_DATA_ALIGNMENT   8
+
+/*
+ * Header for tool generated v2 variable list. Unlike v1, a v2 list has one header for the
+ * whole list, followed by tables of the unique namespace guids and names that entries refer to.
+ */
+#pragma pack(push, 1)
+typedef struct {
+  /* CONFIG_VAR_LIST_V2_SIGNATURE */
+  UINT32    Signature;
+
+  /* CONFIG_VAR_LIST_V2_VERSION or CONFIG_VAR_LIST_V2_ALIGNED_VERSION */
+  UINT16    Version;
+
+  /* Size of this header in bytes */
+  UINT16    HeaderSize;
+
+  /* Number of entries in the guid table */
+  UINT32    GuidCount;
+
+  /* Size of the string table in bytes */
+  UINT32    StringTableSize;
+
+  /* Checksum of the guid and string tables */
+  UINT32    Crc32;
+
+  /*
+   * Rest of Variable List:
+   *
+   * EFI_GUID GuidTable[GuidCount] // unique namespace Guids
+   * CHAR16 StringTable[StringTableSize/2] // unique Null terminated UTF-16LE encoded names
+   * CONFIG_VAR_LIST_V2_ENTRY_HDR Entries[] // until the end of the list
+   */
+} CONFIG_VAR_LIST_V2_HDR;
+
+/*
+ * Header for each entry of a v2 variable list
+ */
+typedef struct {
+  /* Offset in bytes of the name in the string table */
+  UINT32    NameOffset;
+
+  /* Index of the namespace guid in the guid table */
+  UINT16    GuidIndex;
+
+  /* Must be 0 */
+  UINT16    Reserved;
+
+  /* UEFI attributes */
+  UINT32    Attributes;
+
+  /* Size of Data in bytes */
+  UINT32    DataSize;
+
+  /*
+   * Rest of Variable List entry:
+   *
+   * CHAR8 Data[DataSize] // actual variable value
+   * UINT32 CRC32 // checksum of all bytes from NameOffset up to CRC32
+   */
+} CONFIG_VAR_LIST_V2_ENTRY_HDR;
+#pragma pack(pop)
+
+/*
+ * Precomputed key of an ascii variable name, to look it up repeatedly without converting it to unicode.
+ * Initialized by InitConfigVarListNameKey.
+ */
+typedef struct {
+  /* Null terminated ascii name, must stay valid as long as the key is used */
+  CONST CHAR8    *Name;
+
+  /* Number of characters in Name, excluding the null terminator */
+  UINTN          Length;
+
+  /* Size in bytes of the UTF-16LE name in a variable list, including the null terminator */
+  UINTN          NameSize;
+
+  /*
+   * Last four characters of Name widened to UTF-16LE, 0 for shorter names. Names of a variable list
+   * sharing a prefix with Name are rejected by a single comparison of their tail.
+   */
+  UINT64         Tail;
+} CONFIG_VAR_LIST_NAME_KEY;
+
 /**
   Return the size of the variable list given a NameSize (including null terminator) and DataSize
 
@@ -90,6 +189,46 @@ RetrieveActiveConfigVarList (
   OUT UINTN                  *ConfigVarListCount
   );
 
+/**
+  Find all active configuration variables for this platform, copying them to a single allocation.
+
+  The entries, their names and their data all live in one pool allocation, released with FreeConfigVarList. The
+  list does not refer to VariableListBuffer, which can be freed as soon as this function returns.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, in either v1 or v2 format.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free it with
+                                      FreeConfigVarList, the Name and Data fields of the entries must not be freed.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           VariableListBuffer holds no variable.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListArena (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  );
+
+/**
+  Free a list of configuration variables returned by RetrieveActiveConfigVarListArena.
+
+  @param[in]  ConfigVarList   List of configuration variables, may be NULL.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarList (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList
+  );
+
 /**
   Find specified active configuration variable for this platform.
 
@@ -140,6 +279,51 @@ QuerySingleActiveConfigAsciiVarList (
   OUT CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr
   );
 
+/**
+  Precompute the key of an ascii variable name for QuerySingleActiveConfigVarListByKey.
+
+  @param[in]  VarName   NULL terminated ascii variable name, must outlive Key.
+  @param[out] Key       Key of VarName.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+InitConfigVarListNameKey (
+  IN  CONST CHAR8               *VarName,
+  OUT CONFIG_VAR_LIST_NAME_KEY  *Key
+  );
+
+/**
+  Find specified active configuration variable for this platform, by a precomputed name key.
+
+  The ascii name is compared in place against the UTF-16LE names of the variable list, only the matching
+  entry is validated and copied out.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  Key                     Key of the variable name of interest, from InitConfigVarListNameKey.
+  @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer. User is
+                                      responsible to free the Data and Name fields.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QuerySingleActiveConfigVarListByKey (
+  IN  VOID                            *VariableListBuffer,
+  IN  UINTN                           VariableListBufferSize,
+  IN  CONST CONFIG_VAR_LIST_NAME_KEY  *Key,
+  OUT CONFIG_VAR_LIST_ENTRY           *ConfigVarListPtr
+  );
+
 /**
   Helper function to convert variable list to variable entry.
 
@@ -154,6 +338,8 @@ QuerySingleActiveConfigAsciiVarList (
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list.
   @retval EFI_COMPROMISED_DATA    The input variable list buffer has a corrupted CRC.
+  @retval EFI_UNSUPPORTED         The input buffer is the start of a v2 variable list, whose entries can only
+                                  be converted together with its tables, i.e. by RetrieveActiveConfigVarList.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
@@ -26,4 +26,10 @@ extern PROFILE    gProfileData[];
 extern UINTN  gNumProfiles;
 extern CHAR8  *gProfileFlavorNames[];
 extern UINT8  gProfileFlavorIds[];
+// complete config policy of each profile (indexed as gProfileData) and of the
+// generic profile, each gProfileCacheImageSize bytes. Only generated when
+// KnobService.py is invoked with -ci, see CONF_PROFILE_CACHE_IMAGES
+extern CONST UINT8  *gProfileCacheImages[];
+extern CONST UINT8  *gGenericProfileCacheImage;
+extern UINTN        gProfileCacheImageSize;
 #endif // PLATFORM_CONFIG_DATA_LIB_H_
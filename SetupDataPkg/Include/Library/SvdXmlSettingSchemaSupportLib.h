@@ -54,6 +54,35 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define CURRENT_SETTING_ID_ELEMENT_NAME     "Id"
 #define CURRENT_SETTING_VALUE_ELEMENT_NAME  "Value"
 
+/**
+Index of a single <Setting> element of a SettingsPacket.
+
+Id and Value point into the XML tree and are only valid until the tree is freed.
+**/
+typedef struct {
+  CONST CHAR8    *Id;
+  CONST CHAR8    *Value;
+  XmlNode        *SettingNode;
+  XmlNode        *ResultNode;     // <SettingResult> node, once a status was set for this setting
+} SVD_SETTING_INDEX_ENTRY;
+
+/**
+Index over a parsed SettingsPacket, built once with BuildSettingsPacketIndex so that looking up
+packet elements and settings does not rescan the child lists of the XML tree for every setting.
+
+Must be freed using FreeSettingsPacketIndex, before the XML tree it indexes is freed.
+**/
+typedef struct {
+  XmlNode                    *PacketNode;
+  UINTN                      ElementCount;
+  XmlNode                    **Elements;        // Children of the packet node, in document order
+  XmlNode                    *SettingsListNode;
+  UINTN                      SettingCount;
+  SVD_SETTING_INDEX_ENTRY    *Settings;         // <Setting> elements, in document order
+  UINTN                      BucketCount;       // Power of 2
+  UINTN                      *Buckets;          // Hash of Id to 1 based index into Settings, 0 if empty
+} SVD_SETTINGS_PACKET_INDEX;
+
 /**
 Creates a new XmlNode list following the ResultPacket
 format.
@@ -105,6 +134,93 @@ SetOutputSettingsStatus (
   IN CONST CHAR8    *Flags  OPTIONAL
   );
 
+/**
+Build an index over the elements and settings of a SettingsPacket with a single walk of the tree.
+
+Every <Setting> element must have an <Id> and a <Value>. If the same Id appears more than once,
+lookups by Id return the first one, while Settings still holds all of them in document order.
+
+@param[in]  PacketNode:  The SettingsPacket node, as returned by GetSettingsPacketNode
+@param[out] Index:       Newly allocated index, to be freed with FreeSettingsPacketIndex
+
+@retval EFI_SUCCESS             The index was built.
+@retval EFI_INVALID_PARAMETER   A parameter is NULL or PacketNode is not a SettingsPacket.
+@retval EFI_NOT_FOUND           The packet has no <Settings> list, or a <Setting> misses its Id or Value.
+@retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+**/
+EFI_STATUS
+EFIAPI
+BuildSettingsPacketIndex (
+  IN  CONST XmlNode              *PacketNode,
+  OUT SVD_SETTINGS_PACKET_INDEX  **Index
+  );
+
+/**
+Function to get a direct child element of the indexed packet by name, e.g. the Version element.
+
+@param[in] Index:        Index built by BuildSettingsPacketIndex
+@param[in] ElementName:  Name of the element
+
+@retval The first element with that name, NULL if there is none or a parameter is NULL.
+**/
+XmlNode *
+EFIAPI
+GetIndexedPacketElement (
+  IN CONST SVD_SETTINGS_PACKET_INDEX  *Index,
+  IN CONST CHAR8                      *ElementName
+  );
+
+/**
+Function to find an indexed setting by Id in constant time.
+
+@param[in] Index:  Index built by BuildSettingsPacketIndex
+@param[in] Id:     Id of the setting
+
+@retval The index entry of the setting, NULL if there is none or a parameter is NULL.
+**/
+SVD_SETTING_INDEX_ENTRY *
+EFIAPI
+FindIndexedSetting (
+  IN CONST SVD_SETTINGS_PACKET_INDEX  *Index,
+  IN CONST CHAR8                      *Id
+  );
+
+/**
+Function to Create the XML nodes for the output status of an indexed setting.
+
+Same as SetOutputSettingsStatus, but the created <SettingResult> node is remembered in the
+index entry, so each setting gets exactly one result.
+
+@param[in] ParentSettingsListNode:  The <Settings> element node that all <ResultSettings> are under
+@param[in] Setting:   Index entry of the setting, from the Settings of the index or FindIndexedSetting
+@param[in] Result:    String of the status code value for the operation
+@param[in,opt] Flags: optional String of the return flags
+
+@retval EFI_SUCCESS             Created and added to the xml successfully
+@retval EFI_INVALID_PARAMETER   A parameter is NULL or ParentSettingsListNode is not a results settings list
+@retval EFI_ALREADY_STARTED     A status was already set for this setting
+@retval Error if it could not be created or added to the xml
+**/
+EFI_STATUS
+EFIAPI
+SetIndexedOutputSettingsStatus (
+  IN CONST XmlNode            *ParentSettingsListNode,
+  IN SVD_SETTING_INDEX_ENTRY  *Setting,
+  IN CONST CHAR8              *Result,
+  IN CONST CHAR8              *Flags  OPTIONAL
+  );
+
+/**
+Free an index built by BuildSettingsPacketIndex. The indexed XML tree is not freed.
+
+@param[in] Index:  Index to free, may be NULL
+**/
+VOID
+EFIAPI
+FreeSettingsPacketIndex (
+  IN SVD_SETTINGS_PACKET_INDEX  *Index
+  );
+
 /**
 Create a new Current Settings Packet Node List
 **/
@@ -0,0 +1,29 @@
+/** @file ConfigKnobStatistics.h
+  Debug protocol publishing the per knob access statistics collected by the autogenerated getters of a module.
+
+  A module built with CONFIG_KNOB_STATISTICS defined gets a gConfigKnobStatistics instance of this protocol from
+  the autogenerated getter header. DXE modules may install it on a new handle so that the statistics of all
+  modules can be located and dumped later in boot.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_KNOB_STATISTICS_PROTOCOL_H_
+#define CONFIG_KNOB_STATISTICS_PROTOCOL_H_
+
+#include <ConfigStdStructDefs.h>
+
+#define CONFIG_KNOB_STATISTICS_PROTOCOL_REVISION  1
+
+typedef struct {
+  UINT32                   Revision;
+  UINTN                    KnobCount;
+  CONST CHAR8 *CONST       *KnobNames;  // Indexed by knob, KnobCount entries
+  CONST KNOB_STATISTICS    *Statistics; // Indexed by knob, KnobCount entries
+} CONFIG_KNOB_STATISTICS_PROTOCOL;
+
+extern EFI_GUID  gConfigKnobStatisticsProtocolGuid;
+
+#endif // CONFIG_KNOB_STATISTICS_PROTOCOL_H_
@@ -0,0 +1,338 @@
+/** @file
+  Library instance to Base64 encode and decode SVD setting values in a single pass.
+
+  The encoder converts three bytes to four characters per iteration. The decoder converts four characters to three
+  bytes per iteration through a lookup table flagging every character outside of the alphabet, and only falls back to
+  the character by character state machine of BaseLib around whitespace, padding, invalid characters or when the
+  destination is full, so the results are identical to BaseLib in all cases.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigBase64Lib.h>
+
+//
+// Values of the decoding table besides the 6-bit groups of the alphabet, all have BASE64_NOT_ALPHABET set.
+//
+#define BASE64_NOT_ALPHABET  0x80
+#define BASE64_INVALID       0xFF
+#define BASE64_WHITESPACE    0xFE
+#define BASE64_PADDING       0xFD
+
+STATIC CONST CHAR8  mBase64EncodingTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+//
+// 6-bit group of every ascii character, RFC4648 "Table 1: The Base 64 Alphabet", whitespace as ignored by BaseLib.
+//
+STATIC CONST UINT8  mBase64DecodingTable[256] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF,
+  0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+  0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+/**
+  Convert binary data to a Base64 encoded ascii string based on RFC4648, identical to Base64Encode of BaseLib.
+
+  @param[in]      Source           Input UINT8 data.
+  @param[in]      SourceLength     Number of UINT8 bytes of data.
+  @param[out]     Destination      Pointer to the buffer receiving the NULL terminated encoded string.
+  @param[in, out] DestinationSize  Size in bytes of Destination. Set to CONFIG_BASE64_ENCODED_SIZE (SourceLength) on
+                                   success or if Destination is too small.
+
+  @retval EFI_SUCCESS            Source was encoded.
+  @retval EFI_BUFFER_TOO_SMALL   Destination is NULL or smaller than CONFIG_BASE64_ENCODED_SIZE (SourceLength).
+  @retval EFI_INVALID_PARAMETER  Source or DestinationSize is NULL, or a buffer wraps around the address space.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Encode (
+  IN  CONST UINT8  *Source,
+  IN        UINTN  SourceLength,
+  OUT       CHAR8  *Destination   OPTIONAL,
+  IN OUT    UINTN  *DestinationSize
+  )
+{
+  UINTN   RequiredSize;
+  UINTN   Left;
+  UINT32  Quantum;
+
+  if ((Source == NULL) || (DestinationSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Allow for RFC 4648 test vector 1
+  //
+  if (SourceLength == 0) {
+    if (*DestinationSize < 1) {
+      *DestinationSize = 1;
+      return EFI_BUFFER_TOO_SMALL;
+    }
+
+    *DestinationSize = 1;
+    *Destination     = '\0';
+    return EFI_SUCCESS;
+  }
+
+  if ((SourceLength >= (MAX_ADDRESS - (UINTN)Source)) || (*DestinationSize >= (MAX_ADDRESS - (UINTN)Destination))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  RequiredSize = CONFIG_BASE64_ENCODED_SIZE (SourceLength);
+  if ((Destination == NULL) || (*DestinationSize < RequiredSize)) {
+    *DestinationSize = RequiredSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  //
+  // Encode 24 bits (three bytes) into 4 ascii characters
+  //
+  for (Left = SourceLength; Left >= 3; Left -= 3) {
+    Quantum        = ((UINT32)Source[0] << 16) | ((UINT32)Source[1] << 8) | Source[2];
+    Destination[0] = mBase64EncodingTable[Quantum >> 18];
+    Destination[1] = mBase64EncodingTable[(Quantum >> 12) & 0x3F];
+    Destination[2] = mBase64EncodingTable[(Quantum >> 6) & 0x3F];
+    Destination[3] = mBase64EncodingTable[Quantum & 0x3F];
+    Source        += 3;
+    Destination   += 4;
+  }
+
+  //
+  // Handle the remainder, and add padding '=' characters as necessary.
+  //
+  if (Left > 0) {
+    Quantum        = (UINT32)Source[0] << 16;
+    Destination[3] = '=';
+    if (Left == 2) {
+      Quantum       |= (UINT32)Source[1] << 8;
+      Destination[2] = mBase64EncodingTable[(Quantum >> 6) & 0x3F];
+    } else {
+      Destination[2] = '=';
+    }
+
+    Destination[0] = mBase64EncodingTable[Quantum >> 18];
+    Destination[1] = mBase64EncodingTable[(Quantum >> 12) & 0x3F];
+    Destination   += 4;
+  }
+
+  *Destination     = '\0';
+  *DestinationSize = RequiredSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Decode a Base64 encoded ascii string to binary data based on RFC4648, identical to Base64Decode of BaseLib.
+
+  Whitespace is ignored at all positions, padding is required and the unused bits of the last quantum must be zero.
+
+  @param[in]      Source           Base64 encoded characters, need not be NULL terminated.
+  @param[in]      SourceSize       Number of CHAR8 elements in Source.
+  @param[out]     Destination      Pointer to the buffer receiving the decoded bytes.
+  @param[in, out] DestinationSize  On input, size in bytes of Destination. On output, number of bytes Source decodes
+                                   to, or decoded so far if Source is invalid.
+
+  @retval EFI_SUCCESS            Source was decoded.
+  @retval EFI_BUFFER_TOO_SMALL   Destination is too small, the bytes fitting in it were decoded.
+  @retval EFI_INVALID_PARAMETER  Source is not valid Base64, DestinationSize is NULL, a buffer is NULL with a non zero
+                                 size, a buffer wraps around the address space or Source and Destination overlap.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Decode (
+  IN     CONST CHAR8  *Source          OPTIONAL,
+  IN     UINTN        SourceSize,
+  OUT    UINT8        *Destination     OPTIONAL,
+  IN OUT UINTN        *DestinationSize
+  )
+{
+  BOOLEAN  PaddingMode;
+  UINTN    SixBitGroupsConsumed;
+  UINT32   Accumulator;
+  UINTN    OriginalDestinationSize;
+  UINTN    DecodedSize;
+  UINTN    SourceIndex;
+  UINT8    Base64Value;
+  UINT8    DestinationOctet;
+  UINT32   Quantum;
+  UINT8    Flags;
+
+  if (DestinationSize == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Check Source and Destination array validity, and that they do not overlap.
+  //
+  if (Source == NULL) {
+    if (SourceSize > 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+  } else if (SourceSize > MAX_ADDRESS - (UINTN)Source) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Destination == NULL) {
+    if (*DestinationSize > 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+  } else if (*DestinationSize > MAX_ADDRESS - (UINTN)Destination) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Source != NULL) && (Destination != NULL) &&
+      ((UINTN)Source + SourceSize > (UINTN)Destination) &&
+      ((UINTN)Destination + *DestinationSize > (UINTN)Source))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PaddingMode             = FALSE;
+  SixBitGroupsConsumed    = 0;
+  Accumulator             = 0;
+  OriginalDestinationSize = *DestinationSize;
+  DecodedSize             = 0;
+
+  SourceIndex = 0;
+  while (SourceIndex < SourceSize) {
+    //
+    // Decode whole quanta of four alphabet characters at once while at a quantum boundary and Destination has room.
+    //
+    if (!PaddingMode && (SixBitGroupsConsumed == 0)) {
+      while ((SourceSize - SourceIndex >= 4) && (DecodedSize + 3 <= OriginalDestinationSize)) {
+        Flags = mBase64DecodingTable[(UINT8)Source[SourceIndex]] |
+                mBase64DecodingTable[(UINT8)Source[SourceIndex + 1]] |
+                mBase64DecodingTable[(UINT8)Source[SourceIndex + 2]] |
+                mBase64DecodingTable[(UINT8)Source[SourceIndex + 3]];
+        if ((Flags & BASE64_NOT_ALPHABET) != 0) {
+          break;
+        }
+
+        Quantum = ((UINT32)mBase64DecodingTable[(UINT8)Source[SourceIndex]] << 18) |
+                  ((UINT32)mBase64DecodingTable[(UINT8)Source[SourceIndex + 1]] << 12) |
+                  ((UINT32)mBase64DecodingTable[(UINT8)Source[SourceIndex + 2]] << 6) |
+                  mBase64DecodingTable[(UINT8)Source[SourceIndex + 3]];
+
+        Destination[DecodedSize]     = (UINT8)(Quantum >> 16);
+        Destination[DecodedSize + 1] = (UINT8)(Quantum >> 8);
+        Destination[DecodedSize + 2] = (UINT8)Quantum;
+        DecodedSize                 += 3;
+        SourceIndex                 += 4;
+      }
+
+      if (SourceIndex >= SourceSize) {
+        break;
+      }
+    }
+
+    //
+    // Otherwise decode a single character, exactly as BaseLib does.
+    //
+    Base64Value = mBase64DecodingTable[(UINT8)Source[SourceIndex++]];
+    if (Base64Value == BASE64_WHITESPACE) {
+      continue;
+    }
+
+    //
+    // In padding mode, only accept the second padding character completing case (2) of RFC4648 Chapter 4.
+    //
+    if (PaddingMode) {
+      if ((Base64Value == BASE64_PADDING) && (SixBitGroupsConsumed == 3)) {
+        SixBitGroupsConsumed = 0;
+        continue;
+      }
+
+      *DestinationSize = DecodedSize;
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (Base64Value == BASE64_PADDING) {
+      //
+      // Padding is only allowed at the last two positions of a quantum, and the pending bits must be zero.
+      //
+      PaddingMode = TRUE;
+      if (SixBitGroupsConsumed == 2) {
+        SixBitGroupsConsumed = 3;
+      } else if (SixBitGroupsConsumed == 3) {
+        SixBitGroupsConsumed = 0;
+      } else {
+        *DestinationSize = DecodedSize;
+        return EFI_INVALID_PARAMETER;
+      }
+
+      if (Accumulator != 0) {
+        *DestinationSize = DecodedSize;
+        return EFI_INVALID_PARAMETER;
+      }
+
+      continue;
+    }
+
+    if ((Base64Value & BASE64_NOT_ALPHABET) != 0) {
+      *DestinationSize = DecodedSize;
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Accumulator = (Accumulator << 6) | Base64Value;
+    SixBitGroupsConsumed++;
+    switch (SixBitGroupsConsumed) {
+      case 1:
+        continue;
+      case 2:
+        DestinationOctet = (UINT8)(Accumulator >> 4);
+        Accumulator     &= 0xF;
+        break;
+      case 3:
+        DestinationOctet = (UINT8)(Accumulator >> 2);
+        Accumulator     &= 0x3;
+        break;
+      default:
+        ASSERT (SixBitGroupsConsumed == 4);
+        DestinationOctet     = (UINT8)Accumulator;
+        Accumulator          = 0;
+        SixBitGroupsConsumed = 0;
+        break;
+    }
+
+    //
+    // Store the decoded octet if there's room left, count it unconditionally.
+    //
+    if (DecodedSize < OriginalDestinationSize) {
+      Destination[DecodedSize] = DestinationOctet;
+    }
+
+    DecodedSize++;
+  }
+
+  *DestinationSize = DecodedSize;
+
+  //
+  // If Source terminates mid-quantum, then Source is invalid.
+  //
+  if (SixBitGroupsConsumed != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (DecodedSize <= OriginalDestinationSize) {
+    return EFI_SUCCESS;
+  }
+
+  return EFI_BUFFER_TOO_SMALL;
+}
@@ -0,0 +1,531 @@
+/** @file
+  Unit tests of the ConfigBase64Lib instance.
+
+  Every result of ConfigBase64Lib is compared with Base64Encode and Base64Decode of BaseLib, which it must match bit
+  for bit: status, returned size and content of the destination buffer.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigBase64Lib.h>
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "Config Base64 Lib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// Largest binary size compared exhaustively, covering every remainder and fast path boundary.
+//
+#define MAX_COMPARED_SIZE  200
+
+//
+// Byte filling the unused part of the destination buffers, so stray writes are detected.
+//
+#define FILL_BYTE  0xA5
+
+typedef struct {
+  CONST CHAR8    *Decoded;
+  CONST CHAR8    *Encoded;
+} BASE64_TEST_VECTOR;
+
+//
+// RFC4648 Chapter 10. "Test Vectors"
+//
+STATIC CONST BASE64_TEST_VECTOR  mRfc4648Vectors[] = {
+  { "",       ""         },
+  { "f",      "Zg=="     },
+  { "fo",     "Zm8="     },
+  { "foo",    "Zm9v"     },
+  { "foob",   "Zm9vYg==" },
+  { "fooba",  "Zm9vYmE=" },
+  { "foobar", "Zm9vYmFy" }
+};
+
+//
+// Invalid or unusual encodings, each one decoded with every destination size.
+//
+STATIC CONST CHAR8  *mDecodeVectors[] = {
+  "Zm9vYmFy",
+  " Zm9v\tYmFy\r\n",
+  "Zm9vYmFyZm9vYmFy\nZm9vYmFyZm9vYmFy",
+  "Zm9vYg==",
+  "Zm9vYmE=",
+  "Zm9vYg= =",
+  "Zm9vYg=\n=",
+  "Zm9vYg=",
+  "Zm9vYmE",
+  "Zm9vY",
+  "Zm9vYh==",
+  "Zm9vYmF=",
+  "Zm9vYg==Zm9v",
+  "Zm9vYmE=Zg==",
+  "Zm9v=Zg=",
+  "Zm9v===",
+  "Z===",
+  "====",
+  "Zm9v-mFy",
+  "Zm9v_mFy",
+  "Zm9vYmFy\x80",
+  "YWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXo=",
+  "YWJj ZGVm Z2hp amts bW5v cHFy c3R1 dnd4 eXo=",
+  "YWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXo=\v\f"
+};
+
+//
+// Valid encoding with an embedded NULL character, which is not whitespace.
+//
+STATIC CONST CHAR8  mEmbeddedNullVector[] = "Zm\0vYmFy";
+
+/**
+  Fill Buffer with pseudo random bytes, the same ones on every run.
+
+  @param[out] Buffer  The buffer to fill.
+  @param[in]  Size    Size in bytes of Buffer.
+  @param[in]  Seed    Seed of the sequence.
+**/
+STATIC
+VOID
+FillPseudoRandom (
+  OUT UINT8   *Buffer,
+  IN  UINTN   Size,
+  IN  UINT32  Seed
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Seed          = Seed * 1103515245 + 12345;
+    Buffer[Index] = (UINT8)(Seed >> 16);
+  }
+}
+
+/**
+  Decode Source with both ConfigBase64Decode and Base64Decode into destinations of DestinationSize bytes and check
+  the results are identical.
+
+  @param[in]  Source           Base64 encoded characters.
+  @param[in]  SourceSize       Number of characters in Source.
+  @param[in]  DestinationSize  Size in bytes of the destinations, 0 for NULL destinations.
+
+  @retval UNIT_TEST_PASSED             The results are identical.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The results differ.
+**/
+STATIC
+UNIT_TEST_STATUS
+CompareDecode (
+  IN  CONST CHAR8  *Source,
+  IN  UINTN        SourceSize,
+  IN  UINTN        DestinationSize
+  )
+{
+  UINT8       Expected[MAX_COMPARED_SIZE];
+  UINT8       Actual[MAX_COMPARED_SIZE];
+  UINTN       ExpectedSize;
+  UINTN       ActualSize;
+  EFI_STATUS  ExpectedStatus;
+  EFI_STATUS  ActualStatus;
+
+  UT_ASSERT_TRUE (DestinationSize <= MAX_COMPARED_SIZE);
+
+  SetMem (Expected, sizeof (Expected), FILL_BYTE);
+  SetMem (Actual, sizeof (Actual), FILL_BYTE);
+  ExpectedSize   = DestinationSize;
+  ActualSize     = DestinationSize;
+  ExpectedStatus = Base64Decode (Source, SourceSize, (DestinationSize == 0) ? NULL : Expected, &ExpectedSize);
+  ActualStatus   = ConfigBase64Decode (Source, SourceSize, (DestinationSize == 0) ? NULL : Actual, &ActualSize);
+
+  UT_ASSERT_STATUS_EQUAL (ActualStatus, ExpectedStatus);
+  UT_ASSERT_EQUAL (ActualSize, ExpectedSize);
+  UT_ASSERT_MEM_EQUAL (Actual, Expected, sizeof (Expected));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigBase64Encode and ConfigBase64Decode with the RFC4648 test vectors.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64Rfc4648Test (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR8       Encoded[16];
+  UINT8       Decoded[16];
+  UINTN       Size;
+  UINTN       DecodedLength;
+  UINTN       EncodedLength;
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  for (Index = 0; Index < ARRAY_SIZE (mRfc4648Vectors); Index++) {
+    DecodedLength = AsciiStrLen (mRfc4648Vectors[Index].Decoded);
+    EncodedLength = AsciiStrLen (mRfc4648Vectors[Index].Encoded);
+    UT_ASSERT_EQUAL (CONFIG_BASE64_ENCODED_SIZE (DecodedLength), EncodedLength + 1);
+    UT_ASSERT_EQUAL (CONFIG_BASE64_DECODED_MAX_SIZE (EncodedLength), ((DecodedLength + 2) / 3) * 3);
+
+    Size   = sizeof (Encoded);
+    Status = ConfigBase64Encode ((CONST UINT8 *)mRfc4648Vectors[Index].Decoded, DecodedLength, Encoded, &Size);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Size, EncodedLength + 1);
+    UT_ASSERT_MEM_EQUAL (Encoded, mRfc4648Vectors[Index].Encoded, EncodedLength + 1);
+
+    Size   = sizeof (Decoded);
+    Status = ConfigBase64Decode (mRfc4648Vectors[Index].Encoded, EncodedLength, Decoded, &Size);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Size, DecodedLength);
+    UT_ASSERT_MEM_EQUAL (Decoded, mRfc4648Vectors[Index].Decoded, DecodedLength);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test comparing ConfigBase64Encode with Base64Encode for every binary size up to MAX_COMPARED_SIZE bytes and
+  every destination size.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64EncodeMatchesBaseLibTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8       Binary[MAX_COMPARED_SIZE];
+  CHAR8       Expected[CONFIG_BASE64_ENCODED_SIZE (MAX_COMPARED_SIZE)];
+  CHAR8       Actual[CONFIG_BASE64_ENCODED_SIZE (MAX_COMPARED_SIZE)];
+  UINTN       ExpectedSize;
+  UINTN       ActualSize;
+  UINTN       BinarySize;
+  UINTN       DestinationSize;
+  EFI_STATUS  ExpectedStatus;
+  EFI_STATUS  ActualStatus;
+
+  FillPseudoRandom (Binary, sizeof (Binary), 0x42);
+
+  for (BinarySize = 0; BinarySize <= MAX_COMPARED_SIZE; BinarySize++) {
+    //
+    // Too small destinations, then the exact size and a larger one.
+    //
+    for (DestinationSize = 0; DestinationSize <= CONFIG_BASE64_ENCODED_SIZE (BinarySize) + 1; DestinationSize++) {
+      if (DestinationSize > sizeof (Actual)) {
+        break;
+      }
+
+      SetMem (Expected, sizeof (Expected), FILL_BYTE);
+      SetMem (Actual, sizeof (Actual), FILL_BYTE);
+      ExpectedSize   = DestinationSize;
+      ActualSize     = DestinationSize;
+      ExpectedStatus = Base64Encode (Binary, BinarySize, Expected, &ExpectedSize);
+      ActualStatus   = ConfigBase64Encode (Binary, BinarySize, Actual, &ActualSize);
+
+      UT_ASSERT_STATUS_EQUAL (ActualStatus, ExpectedStatus);
+      UT_ASSERT_EQUAL (ActualSize, ExpectedSize);
+      UT_ASSERT_MEM_EQUAL (Actual, Expected, sizeof (Expected));
+    }
+
+    //
+    // Size query with a NULL destination.
+    //
+    ExpectedSize   = 0;
+    ActualSize     = 0;
+    ExpectedStatus = Base64Encode (Binary, BinarySize, NULL, &ExpectedSize);
+    ActualStatus   = ConfigBase64Encode (Binary, BinarySize, NULL, &ActualSize);
+    UT_ASSERT_STATUS_EQUAL (ActualStatus, ExpectedStatus);
+    UT_ASSERT_EQUAL (ActualSize, ExpectedSize);
+    UT_ASSERT_EQUAL (ActualSize, CONFIG_BASE64_ENCODED_SIZE (BinarySize));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test comparing ConfigBase64Decode with Base64Decode for the encodings of every binary size up to
+  MAX_COMPARED_SIZE bytes, with every destination size.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64DecodeMatchesBaseLibTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8             Binary[MAX_COMPARED_SIZE];
+  CHAR8             Encoded[CONFIG_BASE64_ENCODED_SIZE (MAX_COMPARED_SIZE)];
+  UINTN             EncodedSize;
+  UINTN             BinarySize;
+  UINTN             DestinationSize;
+  EFI_STATUS        Status;
+  UNIT_TEST_STATUS  TestStatus;
+
+  FillPseudoRandom (Binary, sizeof (Binary), 0x1234);
+
+  for (BinarySize = 0; BinarySize <= MAX_COMPARED_SIZE; BinarySize++) {
+    EncodedSize = sizeof (Encoded);
+    Status      = Base64Encode (Binary, BinarySize, Encoded, &EncodedSize);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+
+    for (DestinationSize = 0; DestinationSize <= MIN (BinarySize + 1, MAX_COMPARED_SIZE); DestinationSize++) {
+      TestStatus = CompareDecode (Encoded, EncodedSize - 1, DestinationSize);
+      if (TestStatus != UNIT_TEST_PASSED) {
+        return TestStatus;
+      }
+    }
+
+    //
+    // A corrupted character at every position of the first and last quanta.
+    //
+    if (EncodedSize > 1) {
+      Encoded[0] = '*';
+      TestStatus = CompareDecode (Encoded, EncodedSize - 1, BinarySize);
+      if (TestStatus != UNIT_TEST_PASSED) {
+        return TestStatus;
+      }
+
+      Encoded[EncodedSize - 2] = '-';
+      TestStatus               = CompareDecode (Encoded, EncodedSize - 1, BinarySize);
+      if (TestStatus != UNIT_TEST_PASSED) {
+        return TestStatus;
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test comparing ConfigBase64Decode with Base64Decode on whitespace, padding and invalid characters, with every
+  destination size.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64DecodeUnusualInputTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN             Index;
+  UINTN             SourceSize;
+  UINTN             DestinationSize;
+  UNIT_TEST_STATUS  TestStatus;
+
+  for (Index = 0; Index < ARRAY_SIZE (mDecodeVectors); Index++) {
+    SourceSize = AsciiStrLen (mDecodeVectors[Index]);
+    for (DestinationSize = 0; DestinationSize <= CONFIG_BASE64_DECODED_MAX_SIZE (SourceSize); DestinationSize++) {
+      TestStatus = CompareDecode (mDecodeVectors[Index], SourceSize, DestinationSize);
+      if (TestStatus != UNIT_TEST_PASSED) {
+        return TestStatus;
+      }
+    }
+  }
+
+  SourceSize = sizeof (mEmbeddedNullVector) - 1;
+  for (DestinationSize = 0; DestinationSize <= CONFIG_BASE64_DECODED_MAX_SIZE (SourceSize); DestinationSize++) {
+    TestStatus = CompareDecode (mEmbeddedNullVector, SourceSize, DestinationSize);
+    if (TestStatus != UNIT_TEST_PASSED) {
+      return TestStatus;
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for invalid parameters of ConfigBase64Encode and ConfigBase64Decode.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64InvalidParamTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8       Buffer[16];
+  UINTN       Size;
+  EFI_STATUS  Status;
+
+  ZeroMem (Buffer, sizeof (Buffer));
+
+  Size   = sizeof (Buffer);
+  Status = ConfigBase64Encode (NULL, 1, (CHAR8 *)Buffer, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigBase64Encode (Buffer, 1, (CHAR8 *)Buffer, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigBase64Decode ("Zm9v", 4, Buffer, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Size   = sizeof (Buffer);
+  Status = ConfigBase64Decode (NULL, 4, Buffer, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Size   = sizeof (Buffer);
+  Status = ConfigBase64Decode ("Zm9v", 4, NULL, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  //
+  // Overlapping source and destination.
+  //
+  CopyMem (Buffer, "Zm9vYmFy", 8);
+  Size   = sizeof (Buffer);
+  Status = ConfigBase64Decode ((CHAR8 *)Buffer, 8, Buffer + 4, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  //
+  // Empty source with no destination.
+  //
+  Size   = 0;
+  Status = ConfigBase64Decode (NULL, 0, NULL, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Size, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  ConfigBase64Lib and run the ConfigBase64Lib unit test.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ConfigBase64Lib;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the ConfigBase64Lib Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&ConfigBase64Lib, Framework, "ConfigBase64Lib Conversion Tests", "ConfigBase64Lib.Convert", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for ConfigBase64Lib\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (ConfigBase64Lib, "RFC4648 test vectors should convert", "ConfigBase64Rfc4648Test", ConfigBase64Rfc4648Test, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "Encoding should match BaseLib", "ConfigBase64EncodeMatchesBaseLibTest", ConfigBase64EncodeMatchesBaseLibTest, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "Decoding should match BaseLib", "ConfigBase64DecodeMatchesBaseLibTest", ConfigBase64DecodeMatchesBaseLibTest, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "Decoding unusual input should match BaseLib", "ConfigBase64DecodeUnusualInputTest", ConfigBase64DecodeUnusualInputTest, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "Null Param test should fail", "ConfigBase64InvalidParamTest", ConfigBase64InvalidParamTest, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,65 @@
+/** @file
+  Library instance accounting config knob resolutions of a DXE or MM module, with visibility of the PEI accounting
+  through the config knob perf HOB.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+#include <Library/HobLib.h>
+
+#include "../ConfigKnobPerfLibCommon.h"
+
+STATIC CONFIG_KNOB_PERF_STATS  mDxeStats;
+STATIC BOOLEAN                 mDxeStatsValid = FALSE;
+
+/**
+  Return the accounting of the current boot phase, creating it if needed. This function is abstracted to work with
+  PEI, DXE, and Standalone MM.
+
+  This function is only expected to be called by ConfigKnobPerfEnd.
+
+  @return The writable accounting of the current boot phase, NULL if it could not be created.
+**/
+CONFIG_KNOB_PERF_STATS *
+GetCurrentPhaseStats (
+  VOID
+  )
+{
+  // mDxeStats is zero initialized, it only needs to be marked as accounted
+  mDxeStatsValid = TRUE;
+  return &mDxeStats;
+}
+
+/**
+  Return the accounting of a boot phase. This function is abstracted to work with PEI, DXE, and Standalone MM.
+
+  This function is only expected to be called by ConfigKnobPerfGetStats.
+
+  @param[in]  Phase   The boot phase of interest.
+
+  @return The accounting of Phase, NULL if the phase was not accounted or is not visible to the caller.
+**/
+CONST CONFIG_KNOB_PERF_STATS *
+GetPhaseStats (
+  IN CONFIG_KNOB_PHASE  Phase
+  )
+{
+  EFI_HOB_GUID_TYPE  *GuidHob;
+
+  switch (Phase) {
+    case ConfigKnobPhasePei:
+      GuidHob = GetFirstGuidHob (&gConfigKnobPerfHobGuid);
+      if ((GuidHob == NULL) || (GET_GUID_HOB_DATA_SIZE (GuidHob) < sizeof (CONFIG_KNOB_PERF_HOB))) {
+        return NULL;
+      }
+
+      return (CONST CONFIG_KNOB_PERF_STATS *)GET_GUID_HOB_DATA (GuidHob);
+    case ConfigKnobPhaseDxe:
+      return mDxeStatsValid ? &mDxeStats : NULL;
+    default:
+      return NULL;
+  }
+}
@@ -0,0 +1,150 @@
+/** @file
+  Common functionality of the instances accounting config knob resolutions.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ConfigKnobPerfLib.h>
+
+#include "ConfigKnobPerfLibCommon.h"
+
+STATIC CONST CHAR8  *mSourceNames[ConfigKnobSourceMax] = {
+  "Cache",
+  "Policy",
+  "Variable",
+  "Default"
+};
+
+STATIC CONST CHAR8  *mPhaseNames[ConfigKnobPhaseMax] = {
+  "PEI",
+  "DXE"
+};
+
+/**
+  Start accounting the resolution of a config knob.
+
+  @return Opaque start of the resolution, to be passed to ConfigKnobPerfEnd.
+**/
+UINT64
+EFIAPI
+ConfigKnobPerfBegin (
+  VOID
+  )
+{
+  return GetPerformanceCounter ();
+}
+
+/**
+  Account the resolution of a config knob in the current boot phase.
+
+  @param[in]  Source  Where the value of the knob came from.
+  @param[in]  Begin   Value returned by ConfigKnobPerfBegin when the resolution started.
+**/
+VOID
+EFIAPI
+ConfigKnobPerfEnd (
+  IN CONFIG_KNOB_SOURCE  Source,
+  IN UINT64              Begin
+  )
+{
+  CONFIG_KNOB_PERF_STATS  *Stats;
+  UINT64                  End;
+  UINT64                  CounterStart;
+  UINT64                  CounterEnd;
+  UINT64                  Ticks;
+
+  End = GetPerformanceCounter ();
+
+  if (Source >= ConfigKnobSourceMax) {
+    ASSERT (Source < ConfigKnobSourceMax);
+    return;
+  }
+
+  Stats = GetCurrentPhaseStats ();
+  if (Stats == NULL) {
+    return;
+  }
+
+  // Performance counters may count down
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterEnd >= CounterStart) {
+    Ticks = End - Begin;
+  } else {
+    Ticks = Begin - End;
+  }
+
+  Stats->Count[Source]++;
+  Stats->TimeNs[Source] += GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Retrieve the accounting of a boot phase.
+
+  @param[in]  Phase   The boot phase of interest.
+  @param[out] Stats   The accounting of Phase.
+
+  @retval EFI_INVALID_PARAMETER   Stats is NULL or Phase is not a valid phase.
+  @retval EFI_NOT_FOUND           Phase was not accounted, i.e. no knob was resolved in it.
+  @retval EFI_UNSUPPORTED         Accounting is disabled.
+  @retval EFI_SUCCESS             Stats contains the accounting of Phase.
+**/
+EFI_STATUS
+EFIAPI
+ConfigKnobPerfGetStats (
+  IN  CONFIG_KNOB_PHASE       Phase,
+  OUT CONFIG_KNOB_PERF_STATS  *Stats
+  )
+{
+  CONST CONFIG_KNOB_PERF_STATS  *PhaseStats;
+
+  if ((Stats == NULL) || (Phase >= ConfigKnobPhaseMax)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PhaseStats = GetPhaseStats (Phase);
+  if (PhaseStats == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  CopyMem (Stats, PhaseStats, sizeof (CONFIG_KNOB_PERF_STATS));
+  return EFI_SUCCESS;
+}
+
+/**
+  Print the accounting of all boot phases visible to the caller to the debug output.
+**/
+VOID
+EFIAPI
+ConfigKnobPerfDump (
+  VOID
+  )
+{
+  CONST CONFIG_KNOB_PERF_STATS  *Stats;
+  UINTN                         Phase;
+  UINTN                         Source;
+
+  for (Phase = 0; Phase < ConfigKnobPhaseMax; Phase++) {
+    Stats = GetPhaseStats ((CONFIG_KNOB_PHASE)Phase);
+    if (Stats == NULL) {
+      continue;
+    }
+
+    for (Source = 0; Source < ConfigKnobSourceMax; Source++) {
+      DEBUG ((
+        DEBUG_INFO,
+        "%a %a knobs from %a: %ld in %ld ns\n",
+        __func__,
+        mPhaseNames[Phase],
+        mSourceNames[Source],
+        Stats->Count[Source],
+        Stats->TimeNs[Source]
+        ));
+    }
+  }
+}
@@ -0,0 +1,41 @@
+/** @file
+  Common functionality of the instances accounting config knob resolutions.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_KNOB_PERF_LIB_COMMON_H_
+#define CONFIG_KNOB_PERF_LIB_COMMON_H_
+
+#include <Library/ConfigKnobPerfLib.h>
+
+/**
+  Return the accounting of the current boot phase, creating it if needed. This function is abstracted to work with
+  PEI, DXE, and Standalone MM.
+
+  This function is only expected to be called by ConfigKnobPerfEnd.
+
+  @return The writable accounting of the current boot phase, NULL if it could not be created.
+**/
+CONFIG_KNOB_PERF_STATS *
+GetCurrentPhaseStats (
+  VOID
+  );
+
+/**
+  Return the accounting of a boot phase. This function is abstracted to work with PEI, DXE, and Standalone MM.
+
+  This function is only expected to be called by ConfigKnobPerfGetStats.
+
+  @param[in]  Phase   The boot phase of interest.
+
+  @return The accounting of Phase, NULL if the phase was not accounted or is not visible to the caller.
+**/
+CONST CONFIG_KNOB_PERF_STATS *
+GetPhaseStats (
+  IN CONFIG_KNOB_PHASE  Phase
+  );
+
+#endif // CONFIG_KNOB_PERF_LIB_COMMON_H_
@@ -0,0 +1,68 @@
+/** @file
+  Null library instance of ConfigKnobPerfLib, config knob resolutions are not accounted.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/ConfigKnobPerfLib.h>
+
+/**
+  Start accounting the resolution of a config knob.
+
+  @return Always 0.
+**/
+UINT64
+EFIAPI
+ConfigKnobPerfBegin (
+  VOID
+  )
+{
+  return 0;
+}
+
+/**
+  Account the resolution of a config knob in the current boot phase.
+
+  @param[in]  Source  Where the value of the knob came from.
+  @param[in]  Begin   Value returned by ConfigKnobPerfBegin when the resolution started.
+**/
+VOID
+EFIAPI
+ConfigKnobPerfEnd (
+  IN CONFIG_KNOB_SOURCE  Source,
+  IN UINT64              Begin
+  )
+{
+}
+
+/**
+  Retrieve the accounting of a boot phase.
+
+  @param[in]  Phase   The boot phase of interest.
+  @param[out] Stats   The accounting of Phase.
+
+  @retval EFI_UNSUPPORTED         Accounting is disabled.
+**/
+EFI_STATUS
+EFIAPI
+ConfigKnobPerfGetStats (
+  IN  CONFIG_KNOB_PHASE       Phase,
+  OUT CONFIG_KNOB_PERF_STATS  *Stats
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Print the accounting of all boot phases visible to the caller to the debug output.
+**/
+VOID
+EFIAPI
+ConfigKnobPerfDump (
+  VOID
+  )
+{
+}
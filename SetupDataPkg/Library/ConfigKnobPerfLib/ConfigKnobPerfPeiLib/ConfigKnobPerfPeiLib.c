@@ -0,0 +1,73 @@
+/** @file
+  Library instance accounting config knob resolutions of all PEIMs in the config knob perf HOB.
+
+  PEIMs may run before permanent memory, without writable globals, so the accounting lives in a HOB which is also
+  handed to DXE for dumping.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/HobLib.h>
+#include <Library/BaseMemoryLib.h>
+
+#include "../ConfigKnobPerfLibCommon.h"
+
+/**
+  Return the accounting of the current boot phase, creating it if needed. This function is abstracted to work with
+  PEI, DXE, and Standalone MM.
+
+  This function is only expected to be called by ConfigKnobPerfEnd.
+
+  @return The writable accounting of the current boot phase, NULL if it could not be created.
+**/
+CONFIG_KNOB_PERF_STATS *
+GetCurrentPhaseStats (
+  VOID
+  )
+{
+  EFI_HOB_GUID_TYPE  *GuidHob;
+  VOID               *Stats;
+
+  GuidHob = GetFirstGuidHob (&gConfigKnobPerfHobGuid);
+  if (GuidHob != NULL) {
+    return (CONFIG_KNOB_PERF_STATS *)GET_GUID_HOB_DATA (GuidHob);
+  }
+
+  Stats = BuildGuidHob (&gConfigKnobPerfHobGuid, sizeof (CONFIG_KNOB_PERF_HOB));
+  if (Stats != NULL) {
+    ZeroMem (Stats, sizeof (CONFIG_KNOB_PERF_HOB));
+  }
+
+  return (CONFIG_KNOB_PERF_STATS *)Stats;
+}
+
+/**
+  Return the accounting of a boot phase. This function is abstracted to work with PEI, DXE, and Standalone MM.
+
+  This function is only expected to be called by ConfigKnobPerfGetStats.
+
+  @param[in]  Phase   The boot phase of interest.
+
+  @return The accounting of Phase, NULL if the phase was not accounted or is not visible to the caller.
+**/
+CONST CONFIG_KNOB_PERF_STATS *
+GetPhaseStats (
+  IN CONFIG_KNOB_PHASE  Phase
+  )
+{
+  EFI_HOB_GUID_TYPE  *GuidHob;
+
+  if (Phase != ConfigKnobPhasePei) {
+    return NULL;
+  }
+
+  GuidHob = GetFirstGuidHob (&gConfigKnobPerfHobGuid);
+  if (GuidHob == NULL) {
+    return NULL;
+  }
+
+  return (CONST CONFIG_KNOB_PERF_STATS *)GET_GUID_HOB_DATA (GuidHob);
+}
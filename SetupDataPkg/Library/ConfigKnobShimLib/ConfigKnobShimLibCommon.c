@@ -11,6 +11,7 @@
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/ConfigKnobShimLib.h>
+#include <Library/ConfigKnobPerfLib.h>
 #include "ConfigKnobShimLibCommon.h"
 
 /**
@@ -49,6 +50,9 @@ GetConfigKnobOverride (
 {
   EFI_STATUS  Status;
   UINTN       VariableSize = 0;
+  UINT64      PerfBegin;
+
+  PerfBegin = ConfigKnobPerfBegin ();
 
   if ((ConfigKnobGuid == NULL) || (ConfigKnobName == NULL) || (ConfigKnobData == NULL) ||
       (ConfigKnobDataSize == 0))
@@ -89,5 +93,8 @@ Exit:
       ));
   }
 
+  // Without an override, the caller falls back to the profile default
+  ConfigKnobPerfEnd (EFI_ERROR (Status) ? ConfigKnobSourceDefault : ConfigKnobSourceVariable, PerfBegin);
+
   return Status;
 }
@@ -0,0 +1,99 @@
+/** @file
+  Library instance sharing the cached config policy between all MM modules through the MM configuration table.
+
+  The first module asking for the cache allocates and installs it, all others look it up once and keep the pointer.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/MmServicesTableLib.h>
+#include <Library/ConfigPolicyCacheLib.h>
+
+STATIC CONFIG_POLICY_CACHE  *mSharedCache = NULL;
+
+/**
+  Find the shared cache in the MM configuration table.
+
+  @return The shared cache, NULL if it was not installed yet.
+**/
+STATIC
+CONFIG_POLICY_CACHE *
+FindSharedCache (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < gMmst->NumberOfTableEntries; Index++) {
+    if (CompareGuid (&gMmst->MmConfigurationTable[Index].VendorGuid, &gConfigPolicyCacheGuid)) {
+      return (CONFIG_POLICY_CACHE *)gMmst->MmConfigurationTable[Index].VendorTable;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Return the cached config policy shared by all modules of the current boot phase, publishing it if it does not
+  exist yet.
+
+  A newly published cache is zeroed, so the cached policy header is not valid until the first getter populated it.
+
+  @param[in]  Size    Size in bytes of the cache, including the cached policy header.
+
+  @return The shared cache of Size bytes, NULL if it could not be published or was published with another size.
+**/
+UINT8 *
+EFIAPI
+ConfigPolicyCacheGetShared (
+  IN UINTN  Size
+  )
+{
+  EFI_STATUS           Status;
+  CONFIG_POLICY_CACHE  *SharedCache;
+  UINTN                AllocationSize;
+
+  if (mSharedCache == NULL) {
+    SharedCache = FindSharedCache ();
+    if (SharedCache == NULL) {
+      AllocationSize = sizeof (CONFIG_POLICY_CACHE) + CONFIG_POLICY_CACHE_ALIGNMENT - 1 + Size;
+      SharedCache    = AllocateZeroPool (AllocationSize);
+      if (SharedCache == NULL) {
+        DEBUG ((DEBUG_ERROR, "%a: Failed to allocate the shared cache of %u bytes\n", __func__, (UINT32)Size));
+        return NULL;
+      }
+
+      SharedCache->Revision = CONFIG_POLICY_CACHE_REVISION;
+      SharedCache->Size     = (UINT32)Size;
+      SharedCache->Cache    = ALIGN_POINTER (SharedCache + 1, CONFIG_POLICY_CACHE_ALIGNMENT);
+
+      Status = gMmst->MmInstallConfigurationTable (
+                        gMmst,
+                        &gConfigPolicyCacheGuid,
+                        SharedCache,
+                        AllocationSize
+                        );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a: Failed to install the shared cache - %r\n", __func__, Status));
+        FreePool (SharedCache);
+        return NULL;
+      }
+    }
+
+    mSharedCache = SharedCache;
+  }
+
+  if ((mSharedCache->Revision < CONFIG_POLICY_CACHE_REVISION) || (mSharedCache->Size != Size)) {
+    DEBUG ((DEBUG_ERROR, "%a: Shared cache has %u bytes, %u expected\n", __func__, mSharedCache->Size, (UINT32)Size));
+    ASSERT (FALSE);
+    return NULL;
+  }
+
+  return mSharedCache->Cache;
+}
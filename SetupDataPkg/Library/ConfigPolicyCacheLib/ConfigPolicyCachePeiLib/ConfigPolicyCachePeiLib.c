@@ -0,0 +1,65 @@
+/** @file
+  Library instance sharing the cached config policy between all PEIMs through a GUIDed HOB.
+
+  The cache lives in the data of the gConfigPolicyCacheGuid HOB, which is writable in temporary RAM. PEIMs may execute
+  in place before permanent memory, without writable globals, and the PEI core moves the HOB list to permanent memory,
+  so no pointer to the cache is kept and the HOB is looked up on every call. The cache is placed at the first
+  CONFIG_POLICY_CACHE_ALIGNMENT boundary after the HOB data header. HOBs are 8 byte aligned, so the padding before the
+  cache is the same before and after migration.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/ConfigPolicyCacheLib.h>
+
+/**
+  Return the cached config policy shared by all modules of the current boot phase, publishing it if it does not
+  exist yet.
+
+  A newly published cache is zeroed, so the cached policy header is not valid until the first getter populated it.
+
+  @param[in]  Size    Size in bytes of the cache, including the cached policy header.
+
+  @return The shared cache of Size bytes, NULL if it could not be published or was published with another size.
+**/
+UINT8 *
+EFIAPI
+ConfigPolicyCacheGetShared (
+  IN UINTN  Size
+  )
+{
+  EFI_HOB_GUID_TYPE        *GuidHob;
+  CONFIG_POLICY_CACHE_HOB  *CacheHob;
+  UINTN                    HobSize;
+
+  GuidHob = GetFirstGuidHob (&gConfigPolicyCacheGuid);
+  if (GuidHob != NULL) {
+    CacheHob = (CONFIG_POLICY_CACHE_HOB *)GET_GUID_HOB_DATA (GuidHob);
+    if ((CacheHob->Revision < CONFIG_POLICY_CACHE_REVISION) || (CacheHob->Size != Size)) {
+      DEBUG ((DEBUG_ERROR, "%a: Shared cache has %u bytes, %u expected\n", __func__, CacheHob->Size, (UINT32)Size));
+      ASSERT (FALSE);
+      return NULL;
+    }
+
+    return ALIGN_POINTER (CacheHob + 1, CONFIG_POLICY_CACHE_ALIGNMENT);
+  }
+
+  HobSize  = sizeof (CONFIG_POLICY_CACHE_HOB) + CONFIG_POLICY_CACHE_ALIGNMENT - 1 + Size;
+  CacheHob = BuildGuidHob (&gConfigPolicyCacheGuid, HobSize);
+  if (CacheHob == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to build the shared cache HOB of %u bytes\n", __func__, (UINT32)Size));
+    return NULL;
+  }
+
+  ZeroMem (CacheHob, HobSize);
+  CacheHob->Revision = CONFIG_POLICY_CACHE_REVISION;
+  CacheHob->Size     = (UINT32)Size;
+
+  return ALIGN_POINTER (CacheHob + 1, CONFIG_POLICY_CACHE_ALIGNMENT);
+}
@@ -57,29 +57,100 @@ GetVarListSize (
   return EFI_SUCCESS;
 }
 
+/*
+  Fields of a variable list entry, pointing into the variable list buffer
+*/
+typedef struct {
+  CONST VOID        *Name;      // Not necessarily aligned
+  UINT32            NameSize;
+  CONST EFI_GUID    *Guid;      // Not necessarily aligned
+  UINT32            Attributes;
+  CONST VOID        *Data;
+  UINT32            DataSize;
+} CONFIG_VAR_LIST_ENTRY_VIEW;
+
+//
+// Alignment of the data and names copied to the single allocation of RetrieveActiveConfigVarListArena,
+// matching the alignment of pool allocations
+//
+#define CONFIG_VAR_LIST_ARENA_ALIGNMENT  sizeof (UINT64)
+
 /**
-  Helper function to convert variable list to variable entry.
+  Copy the name and data of a variable list entry out of the variable list buffer.
+
+  @param[in]      View            Fields of the entry, pointing into the variable list buffer.
+  @param[in,out]  Arena           If not NULL, buffer to copy the data and name to, advanced past them on return.
+                                  Otherwise they are copied to new pool allocations.
+  @param[out]     VariableEntry   Pointer to converted variable entry.
+
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+CopyVariableEntryView (
+  IN     CONST CONFIG_VAR_LIST_ENTRY_VIEW  *View,
+  IN OUT UINT8                             **Arena  OPTIONAL,
+  OUT    CONFIG_VAR_LIST_ENTRY             *VariableEntry
+  )
+{
+  CHAR16  *VarName;
+  VOID    *Data;
+
+  if (Arena != NULL) {
+    Data    = *Arena;
+    VarName = (CHAR16 *)(*Arena + ALIGN_VALUE ((UINTN)View->DataSize, CONFIG_VAR_LIST_ARENA_ALIGNMENT));
+    *Arena  = (UINT8 *)VarName + ALIGN_VALUE ((UINTN)View->NameSize, CONFIG_VAR_LIST_ARENA_ALIGNMENT);
+  } else {
+    VarName = AllocatePool (View->NameSize);
+    if (VarName == NULL) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for VarName size: %u\n", __func__, View->NameSize));
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Data = AllocatePool (View->DataSize);
+    if (Data == NULL) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for Data size: %u\n", __func__, View->DataSize));
+      FreePool (VarName);
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  CopyMem (VarName, View->Name, View->NameSize);
+  CopyMem (Data, View->Data, View->DataSize);
+
+  VariableEntry->Name = VarName;
+  CopyMem (&VariableEntry->Guid, View->Guid, sizeof (EFI_GUID));
+  VariableEntry->Attributes = View->Attributes;
+  VariableEntry->Data       = Data;
+  VariableEntry->DataSize   = View->DataSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Validate a v1 variable list entry and locate its fields, without copying them.
 
   @param[in]      VariableListBuffer    Pointer to buffer containing target variable list.
   @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
-                                        it indicates the buffer consumed after converting to
-                                        VariableEntry.
-  @param[out]     VariableEntry         Pointer to converted variable entry. Upon successful return,
-                                        callers are responsible for freeing the Name and Data fields.
+                                        it indicates the buffer consumed by this entry.
+  @param[out]     View                  Fields of the entry, pointing into VariableListBuffer.
+  @param[in]      ValidateCrc           FALSE to skip validating the CRC of an entry validated before.
 
-  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
-  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list.
   @retval EFI_COMPROMISED_DATA    The input variable list buffer has a corrupted CRC.
+  @retval EFI_UNSUPPORTED         The input buffer is the start of a v2 variable list.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-ConvertVariableListToVariableEntry (
-  IN      CONST VOID         *VariableListBuffer,
-  IN  OUT UINTN              *Size,
-  OUT CONFIG_VAR_LIST_ENTRY  *VariableEntry
+ParseVariableListEntry (
+  IN      CONST VOID              *VariableListBuffer,
+  IN  OUT UINTN                   *Size,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *View,
+  IN      BOOLEAN                 ValidateCrc
   )
 {
   CONST EFI_GUID             *Guid;
@@ -88,19 +159,10 @@ ConvertVariableListToVariableEntry (
   CONST CONFIG_VAR_LIST_HDR  *VarList = NULL;
   UINTN                      BinSize  = 0;
   EFI_STATUS                 Status   = EFI_SUCCESS;
-  CHAR16                     *VarName = NULL;
-  CHAR8                      *Data    = NULL;
   UINT32                     Attributes;
   UINT32                     CRC32;
   UINT32                     CalcCRC32;
   UINT32                     NeededSize = 0;
-  CONFIG_VAR_LIST_ENTRY      *Entry;
-
-  // Sanity check for input parameters
-  if ((VariableListBuffer == NULL) || (Size == NULL) || (VariableEntry == NULL)) {
-    Status = EFI_INVALID_PARAMETER;
-    goto Exit;
-  }
 
   if (*Size < sizeof (*VarList)) {
     Status = EFI_BUFFER_TOO_SMALL;
@@ -110,7 +172,15 @@ ConvertVariableListToVariableEntry (
   // index into variable list
   BinSize = *Size;
   VarList = (CONST CONFIG_VAR_LIST_HDR *)((CHAR8 *)VariableListBuffer);
-  Status  = GetVarListSize (VarList->NameSize, VarList->DataSize, &NeededSize);
+
+  if (VarList->NameSize == CONFIG_VAR_LIST_V2_SIGNATURE) {
+    // v2 entries refer to the name and guid tables following the list header, so they cannot be converted alone
+    DEBUG ((DEBUG_ERROR, "%a Buffer is a v2 variable list, use RetrieveActiveConfigVarList to convert it\n", __func__));
+    Status = EFI_UNSUPPORTED;
+    goto Exit;
+  }
+
+  Status = GetVarListSize (VarList->NameSize, VarList->DataSize, &NeededSize);
 
   if (EFI_ERROR (Status)) {
     // we overflowed
@@ -154,46 +224,69 @@ ConvertVariableListToVariableEntry (
   CopyMem (&CRC32, (DataInBin + VarList->DataSize), sizeof (UINT32));
 
   // validate CRC32
-  CalcCRC32 = CalculateCrc32 ((VOID *)VarList, NeededSize - sizeof (CRC32));
-  if (CRC32 != CalcCRC32) {
-    DEBUG ((DEBUG_ERROR, "%a CRC is off in the variable list: actual: %x, expect %x\n", __func__, CRC32, CalcCRC32));
-    Status = EFI_COMPROMISED_DATA;
-    goto Exit;
+  if (ValidateCrc) {
+    CalcCRC32 = CalculateCrc32 ((VOID *)VarList, NeededSize - sizeof (CRC32));
+    if (CRC32 != CalcCRC32) {
+      DEBUG ((DEBUG_ERROR, "%a CRC is off in the variable list: actual: %x, expect %x\n", __func__, CRC32, CalcCRC32));
+      Status = EFI_COMPROMISED_DATA;
+      goto Exit;
+    }
   }
 
-  VarName = AllocatePool (VarList->NameSize);
-  if (VarName == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for VarName size: %u\n", __func__, VarList->NameSize));
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Exit;
-  }
+  View->Name       = NameInBin;
+  View->NameSize   = VarList->NameSize;
+  View->Guid       = Guid;
+  View->Attributes = Attributes;
+  View->Data       = DataInBin;
+  View->DataSize   = VarList->DataSize;
 
-  CopyMem (VarName, NameInBin, VarList->NameSize);
+  Status = EFI_SUCCESS;
 
-  Data = AllocatePool (VarList->DataSize);
-  if (Data == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for Data size: %u\n", __func__, VarList->DataSize));
-    Status = EFI_OUT_OF_RESOURCES;
-    // Free VarName here, as other memory gets freed in exit routine
-    FreePool (VarName);
-    goto Exit;
-  }
+Exit:
+  return Status;
+}
 
-  CopyMem (Data, DataInBin, VarList->DataSize);
+/**
+  Helper function to convert variable list to variable entry.
 
-  // Add correct values to this entry in the blob
-  Entry = VariableEntry;
+  @param[in]      VariableListBuffer    Pointer to buffer containing target variable list.
+  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
+                                        it indicates the buffer consumed after converting to
+                                        VariableEntry.
+  @param[out]     VariableEntry         Pointer to converted variable entry. Upon successful return,
+                                        callers are responsible for freeing the Name and Data fields.
 
-  Entry->Name       = VarName;
-  Entry->Guid       = *Guid;
-  Entry->Attributes = Attributes;
-  Entry->Data       = Data;
-  Entry->DataSize   = VarList->DataSize;
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The input variable list buffer has a corrupted CRC.
+  @retval EFI_UNSUPPORTED         The input buffer is the start of a v2 variable list, whose entries can only
+                                  be converted together with its tables, i.e. by RetrieveActiveConfigVarList.
+  @retval EFI_SUCCESS             The operation succeeds.
 
-  Status = EFI_SUCCESS;
+**/
+EFI_STATUS
+EFIAPI
+ConvertVariableListToVariableEntry (
+  IN      CONST VOID         *VariableListBuffer,
+  IN  OUT UINTN              *Size,
+  OUT CONFIG_VAR_LIST_ENTRY  *VariableEntry
+  )
+{
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  EFI_STATUS                  Status;
 
-Exit:
-  return Status;
+  // Sanity check for input parameters
+  if ((VariableListBuffer == NULL) || (Size == NULL) || (VariableEntry == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = ParseVariableListEntry (VariableListBuffer, Size, &View, TRUE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return CopyVariableEntryView (&View, NULL, VariableEntry);
 }
 
 /**
@@ -296,10 +389,285 @@ Exit:
   return Status;
 }
 
+/*
+  Tables of a v2 variable list that its entries refer to
+*/
+typedef struct {
+  CONST EFI_GUID    *GuidTable;
+  UINT32            GuidCount;
+  CONST UINT8       *StringTable;
+  UINT32            StringTableSize;
+  BOOLEAN           Aligned;
+} CONFIG_VAR_LIST_V2_TABLES;
+
+/**
+  Validate the header of a v2 variable list and locate its guid and string tables.
+
+  @param[in]  VariableListBuffer      Pointer to raw v2 variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] Tables                  Guid and string tables of this variable list.
+  @param[out] EntryOffset             Offset in bytes of the first entry in VariableListBuffer.
+
+  @retval EFI_UNSUPPORTED         The buffer is not a v2 variable list this library understands.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain the full header and tables.
+  @retval EFI_COMPROMISED_DATA    The header or tables are corrupted.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+ParseVarListV2Header (
+  IN  CONST VOID                 *VariableListBuffer,
+  IN  UINTN                      VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_V2_TABLES  *Tables,
+  OUT UINTN                      *EntryOffset
+  )
+{
+  CONST CONFIG_VAR_LIST_V2_HDR  *Header;
+  UINT32                        GuidTableSize;
+  UINT32                        NeededSize;
+  UINT32                        CalcCRC32;
+  RETURN_STATUS                 Status;
+
+  if (VariableListBufferSize < sizeof (*Header)) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  Header = (CONST CONFIG_VAR_LIST_V2_HDR *)VariableListBuffer;
+  if ((Header->Signature != CONFIG_VAR_LIST_V2_SIGNATURE) ||
+      ((Header->Version != CONFIG_VAR_LIST_V2_VERSION) && (Header->Version != CONFIG_VAR_LIST_V2_ALIGNED_VERSION)) ||
+      (Header->HeaderSize != sizeof (*Header)))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Unsupported variable list version: %u header size: %u\n", __func__, Header->Version, Header->HeaderSize));
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = SafeUint32Mult (Header->GuidCount, sizeof (EFI_GUID), &GuidTableSize);
+  if (!RETURN_ERROR (Status)) {
+    Status = SafeUint32Add (GuidTableSize, Header->StringTableSize, &NeededSize);
+  }
+
+  if (!RETURN_ERROR (Status)) {
+    Status = SafeUint32Add (NeededSize, sizeof (*Header), &NeededSize);
+  }
+
+  if (RETURN_ERROR (Status) || ((Header->StringTableSize % sizeof (CHAR16)) != 0) ||
+      ((Header->Version == CONFIG_VAR_LIST_V2_ALIGNED_VERSION) && ((NeededSize % CONFIG_VAR_LIST_V2_DATA_ALIGNMENT) != 0)))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Invalid table sizes, GuidCount: 0x%x StringTableSize: 0x%x\n", __func__, Header->GuidCount, Header->StringTableSize));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  if ((UINTN)NeededSize > VariableListBufferSize) {
+    DEBUG ((DEBUG_ERROR, "%a VarList buffer does not have needed size (actual: %x, expected: %x)\n", __func__, VariableListBufferSize, NeededSize));
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CalcCRC32 = CalculateCrc32 ((VOID *)(Header + 1), NeededSize - sizeof (*Header));
+  if (Header->Crc32 != CalcCRC32) {
+    DEBUG ((DEBUG_ERROR, "%a CRC is off in the variable list tables: actual: %x, expect %x\n", __func__, Header->Crc32, CalcCRC32));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  Tables->GuidTable       = (CONST EFI_GUID *)(Header + 1);
+  Tables->GuidCount       = Header->GuidCount;
+  Tables->StringTable     = (CONST UINT8 *)(Header + 1) + GuidTableSize;
+  Tables->StringTableSize = Header->StringTableSize;
+  Tables->Aligned         = (BOOLEAN)(Header->Version == CONFIG_VAR_LIST_V2_ALIGNED_VERSION);
+  *EntryOffset            = (UINTN)NeededSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Compute the layout of an entry of a v2 variable list from the size of its data.
+
+  @param[in]  Tables      Guid and string tables of the v2 variable list holding the entry.
+  @param[in]  DataSize    Size in bytes of the data of the entry.
+  @param[out] CrcOffset   Offset in bytes of the CRC32 from the start of the entry.
+  @param[out] EntrySize   Size in bytes of the entry, including its padding.
+
+  @retval EFI_BUFFER_TOO_SMALL    The entry size overflowed.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+GetVarListV2EntrySize (
+  IN  CONST CONFIG_VAR_LIST_V2_TABLES  *Tables,
+  IN  UINT32                           DataSize,
+  OUT UINT32                           *CrcOffset,
+  OUT UINT32                           *EntrySize
+  )
+{
+  RETURN_STATUS  Status;
+
+  Status = SafeUint32Add (sizeof (CONFIG_VAR_LIST_V2_ENTRY_HDR), DataSize, CrcOffset);
+  if (!RETURN_ERROR (Status) && Tables->Aligned) {
+    Status = SafeUint32Add (*CrcOffset, ALIGN_VALUE_ADDEND (*CrcOffset, sizeof (UINT32)), CrcOffset);
+  }
+
+  if (!RETURN_ERROR (Status)) {
+    Status = SafeUint32Add (*CrcOffset, sizeof (UINT32), EntrySize);
+  }
+
+  if (!RETURN_ERROR (Status) && Tables->Aligned) {
+    Status = SafeUint32Add (*EntrySize, ALIGN_VALUE_ADDEND (*EntrySize, CONFIG_VAR_LIST_V2_DATA_ALIGNMENT), EntrySize);
+  }
+
+  return (EFI_STATUS)Status;
+}
+
+/**
+  Validate an entry of a v2 variable list and locate its fields, without copying them.
+
+  @param[in]      Tables                Guid and string tables of the v2 variable list holding this entry.
+  @param[in]      VariableListBuffer    Pointer to buffer containing target variable list entry.
+  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
+                                        it indicates the buffer consumed by this entry.
+  @param[out]     View                  Fields of the entry, pointing into VariableListBuffer and Tables.
+  @param[in]      ValidateCrc           FALSE to skip validating the CRC of an entry validated before.
+
+  @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list entry.
+  @retval EFI_COMPROMISED_DATA    The entry has a corrupted CRC or refers to data outside of the tables.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+ParseVariableListV2Entry (
+  IN      CONST CONFIG_VAR_LIST_V2_TABLES  *Tables,
+  IN      CONST VOID                       *VariableListBuffer,
+  IN  OUT UINTN                            *Size,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW           *View,
+  IN      BOOLEAN                          ValidateCrc
+  )
+{
+  CONST CONFIG_VAR_LIST_V2_ENTRY_HDR  *VarList;
+  CONST UINT8                         *NameInBin;
+  CONST CHAR8                         *DataInBin;
+  CHAR16                              NameChar;
+  UINT32                              MaxNameSize;
+  UINT32                              NameSize;
+  UINT32                              CrcOffset;
+  UINT32                              NeededSize;
+  UINT32                              CRC32;
+  UINT32                              CalcCRC32;
+  EFI_STATUS                          Status;
+
+  if (*Size < sizeof (*VarList)) {
+    Status = EFI_BUFFER_TOO_SMALL;
+    goto Exit;
+  }
+
+  VarList = (CONST CONFIG_VAR_LIST_V2_ENTRY_HDR *)VariableListBuffer;
+  Status  = GetVarListV2EntrySize (Tables, VarList->DataSize, &CrcOffset, &NeededSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a VarList size overflowed, too large of config! DataSize: 0x%x\n", __func__, VarList->DataSize));
+    goto Exit;
+  }
+
+  if ((UINTN)NeededSize > *Size) {
+    DEBUG ((DEBUG_ERROR, "%a VarList buffer does not have needed size (actual: %x, expected: %x)\n", __func__, *Size, NeededSize));
+    *Size  = (UINTN)NeededSize;
+    Status = EFI_BUFFER_TOO_SMALL;
+    goto Exit;
+  }
+
+  // Use this as stub to indicate how much buffer used.
+  *Size = (UINTN)NeededSize;
+
+  DataInBin = (CONST CHAR8 *)(VarList + 1);
+  CopyMem (&CRC32, (CONST UINT8 *)VarList + CrcOffset, sizeof (UINT32));
+
+  // validate CRC32, the padding of aligned entries is not covered
+  if (ValidateCrc) {
+    CalcCRC32 = CalculateCrc32 ((VOID *)VarList, sizeof (*VarList) + VarList->DataSize);
+    if (CRC32 != CalcCRC32) {
+      DEBUG ((DEBUG_ERROR, "%a CRC is off in the variable list: actual: %x, expect %x\n", __func__, CRC32, CalcCRC32));
+      Status = EFI_COMPROMISED_DATA;
+      goto Exit;
+    }
+  }
+
+  if ((VarList->GuidIndex >= Tables->GuidCount) ||
+      (VarList->NameOffset >= Tables->StringTableSize) ||
+      ((VarList->NameOffset % sizeof (CHAR16)) != 0))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Entry refers outside of the tables, GuidIndex: %u NameOffset: 0x%x\n", __func__, VarList->GuidIndex, VarList->NameOffset));
+    Status = EFI_COMPROMISED_DATA;
+    goto Exit;
+  }
+
+  // The string table is not necessarily aligned, so look for the null terminator a character at a time
+  NameInBin   = Tables->StringTable + VarList->NameOffset;
+  MaxNameSize = MIN (Tables->StringTableSize - VarList->NameOffset, CONF_VAR_NAME_LEN);
+  NameSize    = 0;
+  do {
+    if (NameSize + sizeof (CHAR16) > MaxNameSize) {
+      DEBUG ((DEBUG_ERROR, "%a Name at offset 0x%x is not null terminated\n", __func__, VarList->NameOffset));
+      Status = EFI_COMPROMISED_DATA;
+      goto Exit;
+    }
+
+    CopyMem (&NameChar, NameInBin + NameSize, sizeof (CHAR16));
+    NameSize += sizeof (CHAR16);
+  } while (NameChar != L'\0');
+
+  View->Name       = NameInBin;
+  View->NameSize   = NameSize;
+  View->Guid       = &Tables->GuidTable[VarList->GuidIndex];
+  View->Attributes = VarList->Attributes;
+  View->Data       = DataInBin;
+  View->DataSize   = VarList->DataSize;
+
+  Status = EFI_SUCCESS;
+
+Exit:
+  return Status;
+}
+
+/**
+  Helper function to convert an entry of a v2 variable list to variable entry.
+
+  @param[in]      Tables                Guid and string tables of the v2 variable list holding this entry.
+  @param[in]      VariableListBuffer    Pointer to buffer containing target variable list entry.
+  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
+                                        it indicates the buffer consumed after converting to
+                                        VariableEntry.
+  @param[out]     VariableEntry         Pointer to converted variable entry. Upon successful return,
+                                        callers are responsible for freeing the Name and Data fields.
+
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list entry.
+  @retval EFI_COMPROMISED_DATA    The entry has a corrupted CRC or refers to data outside of the tables.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+ConvertVariableListV2ToVariableEntry (
+  IN      CONST CONFIG_VAR_LIST_V2_TABLES  *Tables,
+  IN      CONST VOID                       *VariableListBuffer,
+  IN  OUT UINTN                            *Size,
+  OUT CONFIG_VAR_LIST_ENTRY                *VariableEntry
+  )
+{
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  EFI_STATUS                  Status;
+
+  Status = ParseVariableListV2Entry (Tables, VariableListBuffer, Size, &View, TRUE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return CopyVariableEntryView (&View, NULL, VariableEntry);
+}
+
 /**
   Parse Active Config Variable List and return full list or specific entry if VarName parameter != NULL
 
-  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, in either v1 or v2 format.
   @param[in]  VariableListBufferSize  Size of VariableListBuffer.
   @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
                                       returned buffer and the Data, Name fields for each entry.
@@ -327,6 +695,9 @@ ParseActiveConfigVarList (
   EFI_STATUS                 Status         = EFI_SUCCESS;
   UINTN                      ListIndex      = 0;
   UINTN                      AllocatedCount = 1;
+  BOOLEAN                    IsV2           = FALSE;
+  UINTN                      NameLength;
+  CONFIG_VAR_LIST_V2_TABLES  V2Tables;
 
   if ((ConfigVarListPtr == NULL) || (ConfigVarListCount == NULL)) {
     DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __func__));
@@ -354,7 +725,7 @@ ParseActiveConfigVarList (
   if (ConfigVarName == NULL) {
     // We don't know how many entries there are, for now allocate 1 entry and extend the size when needed.
     *ConfigVarListPtr = NULL;
-    *ConfigVarListPtr = AllocatePool (AllocatedCount * sizeof (CONFIG_VAR_LIST_ENTRY));
+    *ConfigVarListPtr = AllocateZeroPool (AllocatedCount * sizeof (CONFIG_VAR_LIST_ENTRY));
   }
 
   if (*ConfigVarListPtr == NULL) {
@@ -363,12 +734,27 @@ ParseActiveConfigVarList (
     goto Exit;
   }
 
+  if ((VariableListBufferSize >= sizeof (UINT32)) && (*(CONST UINT32 *)VariableListBuffer == CONFIG_VAR_LIST_V2_SIGNATURE)) {
+    // v2 variable list, entries start after the guid and string tables
+    Status = ParseVarListV2Header (VariableListBuffer, VariableListBufferSize, &V2Tables, &ListIndex);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Configuration VarList v2 header invalid %r\n", __func__, Status));
+      goto Exit;
+    }
+
+    IsV2 = TRUE;
+  }
+
   while (ListIndex < VariableListBufferSize) {
     // index into variable list
     VarList = (CONST CONFIG_VAR_LIST_HDR *)((CHAR8 *)VariableListBuffer + ListIndex);
 
     LeftSize = VariableListBufferSize - ListIndex;
-    Status   = ConvertVariableListToVariableEntry (VarList, &LeftSize, &(*ConfigVarListPtr)[*ConfigVarListCount]);
+    if (IsV2) {
+      Status = ConvertVariableListV2ToVariableEntry (&V2Tables, VarList, &LeftSize, &(*ConfigVarListPtr)[*ConfigVarListCount]);
+    } else {
+      Status = ConvertVariableListToVariableEntry (VarList, &LeftSize, &(*ConfigVarListPtr)[*ConfigVarListCount]);
+    }
 
     if (EFI_ERROR (Status)) {
       // Unable to convert this specific variable list
@@ -379,8 +765,11 @@ ParseActiveConfigVarList (
 
     ListIndex += LeftSize;
 
+    // v2 names were validated to be null terminated while converting
+    NameLength = IsV2 ? StrLen ((*ConfigVarListPtr)->Name) + 1 : VarList->NameSize / 2;
+
     // Check to see if this variable list has the target ConfigVarName
-    if ((ConfigVarName != NULL) && (0 != StrnCmp (ConfigVarName, (*ConfigVarListPtr)->Name, VarList->NameSize / 2))) {
+    if ((ConfigVarName != NULL) && (0 != StrnCmp (ConfigVarName, (*ConfigVarListPtr)->Name, NameLength))) {
       // Not the entry we are looking for
       // While we are here, set the Name entry to NULL so we can tell if we found the entry later
       FreePool ((*ConfigVarListPtr)->Name);
@@ -471,6 +860,212 @@ RetrieveActiveConfigVarList (
   return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, ConfigVarListPtr, ConfigVarListCount, NULL);
 }
 
+/**
+  Walk all entries of a variable list, either to measure the single allocation holding them or to copy them to it.
+
+  The CRC of the entries is only validated while measuring them, which must be done first.
+
+  @param[in]      VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]      VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]      EntryOffset             Offset in bytes of the first entry in VariableListBuffer.
+  @param[in]      V2Tables                Guid and string tables of a v2 variable list, NULL for a v1 list.
+  @param[out]     ConfigVarList           If not NULL, array to convert the entries to, followed by room for their
+                                          data and names. Otherwise the entries are only validated and measured.
+  @param[out]     ConfigVarListCount      Number of variable list entries.
+  @param[out]     AllocationSize          Size in bytes of the allocation holding the converted entries.
+
+  @retval EFI_BUFFER_TOO_SMALL    An entry does not fit in the variable list buffer.
+  @retval EFI_COMPROMISED_DATA    An entry is corrupted, or the converted entries do not fit in memory.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+CopyActiveConfigVarList (
+  IN  CONST VOID                       *VariableListBuffer,
+  IN  UINTN                            VariableListBufferSize,
+  IN  UINTN                            EntryOffset,
+  IN  CONST CONFIG_VAR_LIST_V2_TABLES  *V2Tables  OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY            *ConfigVarList  OPTIONAL,
+  OUT UINTN                            *ConfigVarListCount,
+  OUT UINTN                            *AllocationSize
+  )
+{
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  CONST UINT8                 *Entry;
+  UINT8                       *Arena;
+  UINTN                       ListIndex;
+  UINTN                       LeftSize;
+  UINTN                       Count;
+  UINTN                       Size;
+  EFI_STATUS                  Status;
+
+  Count = 0;
+  Size  = 0;
+  Arena = NULL;
+  if (ConfigVarList != NULL) {
+    Arena = (UINT8 *)(ConfigVarList + *ConfigVarListCount);
+  }
+
+  for (ListIndex = EntryOffset; ListIndex < VariableListBufferSize; ListIndex += LeftSize) {
+    Entry    = (CONST UINT8 *)VariableListBuffer + ListIndex;
+    LeftSize = VariableListBufferSize - ListIndex;
+    if (V2Tables != NULL) {
+      Status = ParseVariableListV2Entry (V2Tables, Entry, &LeftSize, &View, ConfigVarList == NULL);
+    } else {
+      Status = ParseVariableListEntry (Entry, &LeftSize, &View, ConfigVarList == NULL);
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Configuration VarList at offset 0x%x invalid %r\n", __func__, ListIndex, Status));
+      return Status;
+    }
+
+    if (ConfigVarList != NULL) {
+      // Cannot fail when copying to the arena
+      CopyVariableEntryView (&View, &Arena, &ConfigVarList[Count]);
+    } else {
+      Status = (EFI_STATUS)SafeUintnAdd (Size, sizeof (CONFIG_VAR_LIST_ENTRY), &Size);
+      if (!EFI_ERROR (Status)) {
+        Status = (EFI_STATUS)SafeUintnAdd (Size, ALIGN_VALUE ((UINTN)View.DataSize, CONFIG_VAR_LIST_ARENA_ALIGNMENT), &Size);
+      }
+
+      if (!EFI_ERROR (Status)) {
+        Status = (EFI_STATUS)SafeUintnAdd (Size, ALIGN_VALUE ((UINTN)View.NameSize, CONFIG_VAR_LIST_ARENA_ALIGNMENT), &Size);
+      }
+
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a Configuration VarList too large to be copied\n", __func__));
+        return EFI_COMPROMISED_DATA;
+      }
+    }
+
+    Count++;
+  }
+
+  *ConfigVarListCount = Count;
+  if (ConfigVarList == NULL) {
+    *AllocationSize = Size;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find all active configuration variables for this platform, copying them to a single allocation.
+
+  The entries, their names and their data all live in one pool allocation, released with FreeConfigVarList. The
+  list does not refer to VariableListBuffer, which can be freed as soon as this function returns.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, in either v1 or v2 format.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free it with
+                                      FreeConfigVarList, the Name and Data fields of the entries must not be freed.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           VariableListBuffer holds no variable.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListArena (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  )
+{
+  CONFIG_VAR_LIST_V2_TABLES        V2Tables;
+  CONST CONFIG_VAR_LIST_V2_TABLES  *Tables     = NULL;
+  UINTN                            EntryOffset = 0;
+  UINTN                            Count;
+  UINTN                            AllocationSize;
+  EFI_STATUS                       Status;
+
+  if ((ConfigVarListPtr == NULL) || (ConfigVarListCount == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __func__));
+    if (ConfigVarListCount != NULL) {
+      *ConfigVarListCount = 0;
+    }
+
+    if (ConfigVarListPtr != NULL) {
+      *ConfigVarListPtr = NULL;
+    }
+
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *ConfigVarListPtr   = NULL;
+  *ConfigVarListCount = 0;
+
+  if ((VariableListBuffer == NULL) || (VariableListBufferSize == 0)) {
+    DEBUG ((DEBUG_ERROR, "%a Incoming variable list buffer (base: %p, size: 0x%x) invalid\n", __func__, VariableListBuffer, VariableListBufferSize));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((VariableListBufferSize >= sizeof (UINT32)) && (*(CONST UINT32 *)VariableListBuffer == CONFIG_VAR_LIST_V2_SIGNATURE)) {
+    Status = ParseVarListV2Header (VariableListBuffer, VariableListBufferSize, &V2Tables, &EntryOffset);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Configuration VarList v2 header invalid %r\n", __func__, Status));
+      return Status;
+    }
+
+    Tables = &V2Tables;
+  }
+
+  // Validate and measure all entries first, so they can be copied to a single allocation of the right size
+  Status = CopyActiveConfigVarList (VariableListBuffer, VariableListBufferSize, EntryOffset, Tables, NULL, &Count, &AllocationSize);
+  if (EFI_ERROR (Status)) {
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  if (Count == 0) {
+    DEBUG ((DEBUG_ERROR, "%a No variable in var list\n", __func__));
+    return EFI_NOT_FOUND;
+  }
+
+  *ConfigVarListPtr = AllocatePool (AllocationSize);
+  if (*ConfigVarListPtr == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for %u variables, size: %u\n", __func__, Count, AllocationSize));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = CopyActiveConfigVarList (VariableListBuffer, VariableListBufferSize, EntryOffset, Tables, *ConfigVarListPtr, &Count, &AllocationSize);
+  if (EFI_ERROR (Status)) {
+    // The entries were already validated by the first walk
+    ASSERT (FALSE);
+    FreePool (*ConfigVarListPtr);
+    *ConfigVarListPtr = NULL;
+    return Status;
+  }
+
+  *ConfigVarListCount = Count;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free a list of configuration variables returned by RetrieveActiveConfigVarListArena.
+
+  @param[in]  ConfigVarList   List of configuration variables, may be NULL.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarList (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList
+  )
+{
+  if (ConfigVarList != NULL) {
+    FreePool (ConfigVarList);
+  }
+}
+
 /**
   Find specified active configuration variable for this platform.
 
@@ -506,6 +1101,180 @@ QuerySingleActiveConfigUnicodeVarList (
   return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, &ConfigVarListPtr, &ConfigVarListCount, VarName);
 }
 
+/**
+  Widen four ascii characters to UTF-16LE, as read from a variable list by ReadUnaligned64.
+
+  @param[in]  Ascii   Four ascii characters.
+
+  @return The four characters encoded as UTF-16LE.
+**/
+STATIC
+UINT64
+WidenAscii4 (
+  IN CONST CHAR8  *Ascii
+  )
+{
+  return (UINT64)(UINT8)Ascii[0] |
+         LShiftU64 ((UINT8)Ascii[1], 16) |
+         LShiftU64 ((UINT8)Ascii[2], 32) |
+         LShiftU64 ((UINT8)Ascii[3], 48);
+}
+
+/**
+  Compare the ascii name of a key in place against a UTF-16LE name of a variable list.
+
+  @param[in]  Key         Key of the variable name of interest.
+  @param[in]  NameInBin   Name in the variable list, not necessarily aligned. At least Key->NameSize bytes
+                          must be readable.
+
+  @retval TRUE    NameInBin is the null terminated name of Key.
+  @retval FALSE   NameInBin is another name.
+**/
+STATIC
+BOOLEAN
+VarListNameMatchesKey (
+  IN CONST CONFIG_VAR_LIST_NAME_KEY  *Key,
+  IN CONST UINT8                     *NameInBin
+  )
+{
+  UINTN  Index;
+
+  if ((NameInBin[Key->NameSize - 2] != 0) || (NameInBin[Key->NameSize - 1] != 0)) {
+    return FALSE;
+  }
+
+  // Knob names mostly share their prefix, so look at the end first
+  if ((Key->Length >= 4) &&
+      (ReadUnaligned64 ((CONST UINT64 *)(NameInBin + Key->NameSize - sizeof (CHAR16) - sizeof (UINT64))) != Key->Tail))
+  {
+    return FALSE;
+  }
+
+  // Compare four characters at a time, then the remainder
+  for (Index = 0; Index + 4 <= Key->Length; Index += 4) {
+    if (ReadUnaligned64 ((CONST UINT64 *)(NameInBin + Index * sizeof (CHAR16))) != WidenAscii4 (Key->Name + Index)) {
+      return FALSE;
+    }
+  }
+
+  for ( ; Index < Key->Length; Index++) {
+    if ((NameInBin[Index * sizeof (CHAR16)] != (UINT8)Key->Name[Index]) || (NameInBin[Index * sizeof (CHAR16) + 1] != 0)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Find the entry of a variable list matching a name key.
+
+  Only the sizes of the other entries are validated while walking over them, the matching entry is fully
+  validated and converted.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, in either v1 or v2 format.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  Key                     Key of the variable name of interest.
+  @param[out] VariableEntry           Pointer to the converted matching entry. Upon successful return,
+                                      callers are responsible for freeing the Name and Data fields.
+
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+FindActiveConfigVarListEntry (
+  IN  CONST VOID                      *VariableListBuffer,
+  IN  UINTN                           VariableListBufferSize,
+  IN  CONST CONFIG_VAR_LIST_NAME_KEY  *Key,
+  OUT CONFIG_VAR_LIST_ENTRY           *VariableEntry
+  )
+{
+  CONST CONFIG_VAR_LIST_HDR           *VarList;
+  CONST CONFIG_VAR_LIST_V2_ENTRY_HDR  *VarListV2;
+  CONFIG_VAR_LIST_V2_TABLES           V2Tables;
+  UINTN                               ListIndex = 0;
+  UINTN                               LeftSize;
+  UINT32                              CrcOffset;
+  UINT32                              NeededSize;
+  BOOLEAN                             IsV2  = FALSE;
+  BOOLEAN                             Found = FALSE;
+  EFI_STATUS                          Status;
+
+  if ((VariableListBufferSize >= sizeof (UINT32)) && (*(CONST UINT32 *)VariableListBuffer == CONFIG_VAR_LIST_V2_SIGNATURE)) {
+    Status = ParseVarListV2Header (VariableListBuffer, VariableListBufferSize, &V2Tables, &ListIndex);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Configuration VarList v2 header invalid %r\n", __func__, Status));
+      return Status;
+    }
+
+    IsV2 = TRUE;
+  }
+
+  Status = EFI_SUCCESS;
+  while (ListIndex < VariableListBufferSize) {
+    LeftSize = VariableListBufferSize - ListIndex;
+    if (IsV2) {
+      VarListV2 = (CONST CONFIG_VAR_LIST_V2_ENTRY_HDR *)((CONST UINT8 *)VariableListBuffer + ListIndex);
+      if (LeftSize < sizeof (*VarListV2)) {
+        Status = EFI_COMPROMISED_DATA;
+        break;
+      }
+
+      Status = GetVarListV2EntrySize (&V2Tables, VarListV2->DataSize, &CrcOffset, &NeededSize);
+      if (EFI_ERROR (Status) || ((UINTN)NeededSize > LeftSize)) {
+        Status = EFI_COMPROMISED_DATA;
+        break;
+      }
+
+      if ((VarListV2->NameOffset < V2Tables.StringTableSize) &&
+          (Key->NameSize <= V2Tables.StringTableSize - VarListV2->NameOffset) &&
+          VarListNameMatchesKey (Key, V2Tables.StringTable + VarListV2->NameOffset))
+      {
+        Status = ConvertVariableListV2ToVariableEntry (&V2Tables, VarListV2, &LeftSize, VariableEntry);
+        Found  = TRUE;
+        break;
+      }
+    } else {
+      VarList = (CONST CONFIG_VAR_LIST_HDR *)((CONST UINT8 *)VariableListBuffer + ListIndex);
+      if (LeftSize < sizeof (*VarList)) {
+        Status = EFI_COMPROMISED_DATA;
+        break;
+      }
+
+      Status = GetVarListSize (VarList->NameSize, VarList->DataSize, &NeededSize);
+      if (EFI_ERROR (Status) || ((UINTN)NeededSize > LeftSize)) {
+        Status = EFI_COMPROMISED_DATA;
+        break;
+      }
+
+      if ((VarList->NameSize == Key->NameSize) && VarListNameMatchesKey (Key, (CONST UINT8 *)(VarList + 1))) {
+        Status = ConvertVariableListToVariableEntry (VarList, &LeftSize, VariableEntry);
+        Found  = TRUE;
+        break;
+      }
+    }
+
+    ListIndex += NeededSize;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Configuration VarList at offset 0x%x invalid %r\n", __func__, ListIndex, Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  if (!Found) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to find varname in var list: %a\n", __func__, Key->Name));
+    return EFI_NOT_FOUND;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Find specified active configuration variable for this platform.
 
@@ -531,24 +1300,85 @@ QuerySingleActiveConfigAsciiVarList (
   OUT CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr
   )
 {
-  UINTN   ConfigVarListCount = 0;
-  CHAR16  *UniVarName        = NULL;
-  UINTN   UniVarNameLen      = 0;
+  CONFIG_VAR_LIST_NAME_KEY  Key;
 
   if ((VarName == NULL) || (ConfigVarListPtr == NULL)) {
     DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __func__));
     return EFI_INVALID_PARAMETER;
   }
 
-  UniVarNameLen = AsciiStrSize (VarName) * 2;
+  InitConfigVarListNameKey (VarName, &Key);
 
-  UniVarName = AllocatePool (UniVarNameLen);
-  if (UniVarName == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a Failed to alloc memory for UniVarName size: %u\n", __func__, UniVarNameLen));
-    return EFI_OUT_OF_RESOURCES;
+  return QuerySingleActiveConfigVarListByKey (VariableListBuffer, VariableListBufferSize, &Key, ConfigVarListPtr);
+}
+
+/**
+  Precompute the key of an ascii variable name for QuerySingleActiveConfigVarListByKey.
+
+  @param[in]  VarName   NULL terminated ascii variable name, must outlive Key.
+  @param[out] Key       Key of VarName.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+InitConfigVarListNameKey (
+  IN  CONST CHAR8               *VarName,
+  OUT CONFIG_VAR_LIST_NAME_KEY  *Key
+  )
+{
+  if ((VarName == NULL) || (Key == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __func__));
+    return EFI_INVALID_PARAMETER;
   }
 
-  AsciiStrToUnicodeStrS (VarName, UniVarName, UniVarNameLen);
+  Key->Name     = VarName;
+  Key->Length   = AsciiStrLen (VarName);
+  Key->NameSize = (Key->Length + 1) * sizeof (CHAR16);
+  Key->Tail     = (Key->Length >= 4) ? WidenAscii4 (VarName + Key->Length - 4) : 0;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find specified active configuration variable for this platform, by a precomputed name key.
+
+  The ascii name is compared in place against the UTF-16LE names of the variable list, only the matching
+  entry is validated and copied out.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  Key                     Key of the variable name of interest, from InitConfigVarListNameKey.
+  @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer. User is
+                                      responsible to free the Data and Name fields.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QuerySingleActiveConfigVarListByKey (
+  IN  VOID                            *VariableListBuffer,
+  IN  UINTN                           VariableListBufferSize,
+  IN  CONST CONFIG_VAR_LIST_NAME_KEY  *Key,
+  OUT CONFIG_VAR_LIST_ENTRY           *ConfigVarListPtr
+  )
+{
+  if ((Key == NULL) || (Key->Name == NULL) || (ConfigVarListPtr == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((VariableListBuffer == NULL) || (VariableListBufferSize == 0)) {
+    DEBUG ((DEBUG_ERROR, "%a Incoming variable list buffer (base: %p, size: 0x%x) invalid\n", __func__, VariableListBuffer, VariableListBufferSize));
+    return EFI_INVALID_PARAMETER;
+  }
 
-  return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, &ConfigVarListPtr, &ConfigVarListCount, UniVarName);
+  return FindActiveConfigVarListEntry (VariableListBuffer, VariableListBufferSize, Key, ConfigVarListPtr);
 }
@@ -0,0 +1,270 @@
+/** @file
+  Host shared library exposing ConfigVariableListLib to the Python config tools.
+
+  The tools load it with ctypes (Tools/NativeVariableList.py), so that they parse variable lists with the same code as
+  the firmware. The exported functions use the native calling convention of the host and only plain types, any change
+  to them must bump CONFIG_VAR_LIST_HOST_LIB_REVISION and be mirrored in the binding.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/ConfigVariableListLib.h>
+
+//
+// Revision of the exported interface, checked by the binding before using the library
+//
+#define CONFIG_VAR_LIST_HOST_LIB_REVISION  1
+
+#if defined (_MSC_VER)
+#define CONFIG_VAR_LIST_HOST_EXPORT  __declspec(dllexport)
+#else
+#define CONFIG_VAR_LIST_HOST_EXPORT  __attribute__((visibility ("default")))
+#endif
+
+/**
+  Return the revision of the exported interface.
+
+  @return CONFIG_VAR_LIST_HOST_LIB_REVISION.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+UINT32
+ConfigVarListHostRevision (
+  VOID
+  )
+{
+  return CONFIG_VAR_LIST_HOST_LIB_REVISION;
+}
+
+/**
+  Parse all the entries of a v1 or v2 variable list.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Entries of the list, to free with ConfigVarListHostFree.
+  @param[out] ConfigVarListCount      Number of entries.
+
+  @retval EFI_SUCCESS   The list was parsed, it is empty if ConfigVarListCount is 0.
+  @retval Others        The list is invalid, see RetrieveActiveConfigVarListArena.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+EFI_STATUS
+ConfigVarListHostParse (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  )
+{
+  EFI_STATUS  Status;
+
+  if ((ConfigVarListPtr == NULL) || (ConfigVarListCount == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *ConfigVarListPtr   = NULL;
+  *ConfigVarListCount = 0;
+  if (VariableListBufferSize == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = RetrieveActiveConfigVarListArena (
+             VariableListBuffer,
+             VariableListBufferSize,
+             ConfigVarListPtr,
+             ConfigVarListCount
+             );
+  if (Status == EFI_NOT_FOUND) {
+    // A v2 list with tables but without entries
+    Status = EFI_SUCCESS;
+  }
+
+  return Status;
+}
+
+/**
+  Free the entries returned by ConfigVarListHostParse.
+
+  @param[in]  ConfigVarList   Entries to free, may be NULL.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+VOID
+ConfigVarListHostFree (
+  IN CONFIG_VAR_LIST_ENTRY  *ConfigVarList
+  )
+{
+  FreeConfigVarList (ConfigVarList);
+}
+
+/**
+  Return the size of the name of each entry returned by ConfigVarListHostParse, so the binding does not have to look
+  for their null terminators.
+
+  @param[in]  ConfigVarList       Entries returned by ConfigVarListHostParse.
+  @param[in]  ConfigVarListCount  Number of entries.
+  @param[out] NameSizes           Size in bytes of the name of each entry, including its null terminator.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+VOID
+ConfigVarListHostGetNameSizes (
+  IN  CONST CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                        ConfigVarListCount,
+  OUT UINT32                       *NameSizes
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ConfigVarListCount; Index++) {
+    NameSizes[Index] = (UINT32)StrSize (ConfigVarList[Index].Name);
+  }
+}
+
+/**
+  Find a single entry of a v1 or v2 variable list by name.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VarListName             NULL terminated ascii name of the entry.
+  @param[out] ConfigVarListPtr        The entry, to free with ConfigVarListHostFreeEntry.
+
+  @retval EFI_SUCCESS     The entry was found.
+  @retval EFI_NOT_FOUND   No entry has this name.
+  @retval Others          The list is invalid, see QuerySingleActiveConfigAsciiVarList.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+EFI_STATUS
+ConfigVarListHostQuery (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  IN  CONST CHAR8            *VarListName,
+  OUT CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr
+  )
+{
+  return QuerySingleActiveConfigAsciiVarList (
+           VariableListBuffer,
+           VariableListBufferSize,
+           VarListName,
+           ConfigVarListPtr
+           );
+}
+
+/**
+  Free the name and data of an entry returned by ConfigVarListHostQuery.
+
+  @param[in]  ConfigVarList   Entry whose fields to free, may be NULL.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+VOID
+ConfigVarListHostFreeEntry (
+  IN CONFIG_VAR_LIST_ENTRY  *ConfigVarList
+  )
+{
+  if (ConfigVarList == NULL) {
+    return;
+  }
+
+  if (ConfigVarList->Name != NULL) {
+    FreePool (ConfigVarList->Name);
+    ConfigVarList->Name = NULL;
+  }
+
+  if (ConfigVarList->Data != NULL) {
+    FreePool (ConfigVarList->Data);
+    ConfigVarList->Data = NULL;
+  }
+}
+
+/**
+  Serialize entries to a v1 variable list.
+
+  @param[in]      ConfigVarList       Entries to serialize.
+  @param[in]      ConfigVarListCount  Number of entries.
+  @param[out]     VariableListBuffer  Buffer receiving the variable list, may be NULL if Size is 0.
+  @param[in,out]  Size                On input, the size of VariableListBuffer. On output, the size of the list.
+
+  @retval EFI_SUCCESS             The list was serialized.
+  @retval EFI_BUFFER_TOO_SMALL    VariableListBuffer is too small, Size is updated to the size needed.
+  @retval Others                  An entry is invalid, see ConvertVariableEntryToVariableList.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+EFI_STATUS
+ConfigVarListHostSerialize (
+  IN  CONST CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                        ConfigVarListCount,
+  OUT VOID                         *VariableListBuffer,
+  IN OUT UINTN                     *Size
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       Offset;
+  UINTN       EntrySize;
+  UINT32      NeededSize;
+
+  if ((Size == NULL) || ((ConfigVarList == NULL) && (ConfigVarListCount != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Size the whole list first, so nothing is written to a buffer too small
+  Offset = 0;
+  for (Index = 0; Index < ConfigVarListCount; Index++) {
+    if (  (ConfigVarList[Index].Name == NULL)
+       || (StrnLenS (ConfigVarList[Index].Name, CONF_VAR_NAME_LEN / sizeof (CHAR16)) >= CONF_VAR_NAME_LEN / sizeof (CHAR16)))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Status = GetVarListSize ((UINT32)StrSize (ConfigVarList[Index].Name), ConfigVarList[Index].DataSize, &NeededSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Offset += NeededSize;
+  }
+
+  if (*Size < Offset) {
+    *Size = Offset;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  Offset = 0;
+  for (Index = 0; Index < ConfigVarListCount; Index++) {
+    EntrySize = *Size - Offset;
+    Status    = ConvertVariableEntryToVariableList (
+                  &ConfigVarList[Index],
+                  (UINT8 *)VariableListBuffer + Offset,
+                  &EntrySize
+                  );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Offset += EntrySize;
+  }
+
+  *Size = Offset;
+  return EFI_SUCCESS;
+}
+
+/**
+  Compute the CRC32 of a buffer, as the variable list entries are checksummed.
+
+  @param[in]  Data    Buffer to checksum.
+  @param[in]  Size    Size of Data.
+
+  @return The CRC32 of Data.
+**/
+CONFIG_VAR_LIST_HOST_EXPORT
+UINT32
+ConfigVarListHostCrc32 (
+  IN CONST VOID  *Data,
+  IN UINTN       Size
+  )
+{
+  return CalculateCrc32 ((VOID *)Data, Size);
+}
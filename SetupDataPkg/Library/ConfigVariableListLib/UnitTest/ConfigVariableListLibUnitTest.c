@@ -1130,6 +1130,598 @@ GetVarListSizeOverflow (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for RetrieveActiveConfigVarList with a v2 variable list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListV2Test (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
+  UINTN                  ConfigVarListCount = 0;
+  EFI_STATUS             Status;
+  UINT32                 i = 0;
+
+  Status = RetrieveActiveConfigVarList (mKnown_Good_Generic_Profile_V2, sizeof (mKnown_Good_Generic_Profile_V2), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, KNOWN_GOOD_TAG_COUNT);
+
+  for ( ; i < ConfigVarListCount; i++) {
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrSize (mKnown_Good_VarList_Names[i]));
+    if (i < 2) {
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Yaml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Yaml_Guid));
+      UT_ASSERT_EQUAL (3, ConfigVarListPtr[i].Attributes);
+    } else {
+      // Xml part of blob
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Xml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Xml_Guid));
+      UT_ASSERT_EQUAL (7, ConfigVarListPtr[i].Attributes);
+    }
+
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+
+    FreePool (ConfigVarListPtr[i].Name);
+    FreePool (ConfigVarListPtr[i].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for QuerySingleActiveConfigAsciiVarList with a v2 variable list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QuerySingleActiveConfigAsciiVarListV2Test (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  ConfigVarList;
+  EFI_STATUS             Status;
+  CHAR8                  AsciiName[KNOWN_GOOD_TAG_NAME_LEN];
+  UINT32                 i = 0;
+
+  for ( ; i < KNOWN_GOOD_TAG_COUNT; i++) {
+    UnicodeStrToAsciiStrS (mKnown_Good_VarList_Names[i], AsciiName, sizeof (AsciiName));
+    ZeroMem (&ConfigVarList, sizeof (ConfigVarList));
+
+    Status = QuerySingleActiveConfigAsciiVarList (mKnown_Good_Generic_Profile_V2, sizeof (mKnown_Good_Generic_Profile_V2), AsciiName, &ConfigVarList);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarList.Name, StrSize (mKnown_Good_VarList_Names[i]));
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarList.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarList.Data, ConfigVarList.DataSize);
+
+    FreePool (ConfigVarList.Name);
+    FreePool (ConfigVarList.Data);
+  }
+
+  ZeroMem (&ConfigVarList, sizeof (ConfigVarList));
+  Status = QuerySingleActiveConfigAsciiVarList (mKnown_Good_Generic_Profile_V2, sizeof (mKnown_Good_Generic_Profile_V2), "INTEGER_KNO", &ConfigVarList);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for QuerySingleActiveConfigVarListByKey with v1, v2 and aligned v2 variable lists, reusing each key.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QuerySingleActiveConfigVarListByKeyTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY     ConfigVarList;
+  CONFIG_VAR_LIST_NAME_KEY  Key;
+  EFI_STATUS                Status;
+  CHAR8                     AsciiName[KNOWN_GOOD_TAG_NAME_LEN];
+  VOID                      *VarLists[]     = { mKnown_Good_Generic_Profile, mKnown_Good_Generic_Profile_V2, mKnown_Good_Generic_Profile_V2_Aligned };
+  UINTN                     VarListSizes[]  = { sizeof (mKnown_Good_Generic_Profile), sizeof (mKnown_Good_Generic_Profile_V2), sizeof (mKnown_Good_Generic_Profile_V2_Aligned) };
+  UINT32                    i               = 0;
+  UINT32                    j;
+
+  for ( ; i < KNOWN_GOOD_TAG_COUNT; i++) {
+    UnicodeStrToAsciiStrS (mKnown_Good_VarList_Names[i], AsciiName, sizeof (AsciiName));
+    Status = InitConfigVarListNameKey (AsciiName, &Key);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Key.NameSize, StrSize (mKnown_Good_VarList_Names[i]));
+
+    for (j = 0; j < ARRAY_SIZE (VarLists); j++) {
+      ZeroMem (&ConfigVarList, sizeof (ConfigVarList));
+
+      Status = QuerySingleActiveConfigVarListByKey (VarLists[j], VarListSizes[j], &Key, &ConfigVarList);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarList.Name, StrSize (mKnown_Good_VarList_Names[i]));
+      UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarList.DataSize);
+      UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarList.Data, ConfigVarList.DataSize);
+
+      FreePool (ConfigVarList.Name);
+      FreePool (ConfigVarList.Data);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for QuerySingleActiveConfigVarListByKey with names sharing a prefix or suffix with known knobs.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QuerySingleActiveConfigVarListByKeyNotFoundTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY     ConfigVarList;
+  CONFIG_VAR_LIST_NAME_KEY  Key;
+  EFI_STATUS                Status;
+  CONST CHAR8               *BadNames[] = { "COMPLEX_KNOB1", "COMPLEX_KNOB1c", "Device.ConfigData.TagID_00000281", "NTEGER_KNOB", "" };
+  UINT32                    i           = 0;
+
+  for ( ; i < ARRAY_SIZE (BadNames); i++) {
+    Status = InitConfigVarListNameKey (BadNames[i], &Key);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+
+    Status = QuerySingleActiveConfigVarListByKey (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Key, &ConfigVarList);
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+    Status = QuerySingleActiveConfigVarListByKey (mKnown_Good_Generic_Profile_V2, sizeof (mKnown_Good_Generic_Profile_V2), &Key, &ConfigVarList);
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for InitConfigVarListNameKey and QuerySingleActiveConfigVarListByKey with invalid parameters.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QuerySingleActiveConfigVarListByKeyInvalidParamTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY     ConfigVarList;
+  CONFIG_VAR_LIST_NAME_KEY  Key;
+  EFI_STATUS                Status;
+
+  Status = InitConfigVarListNameKey (NULL, &Key);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = InitConfigVarListNameKey ("INTEGER_KNOB", NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = InitConfigVarListNameKey ("INTEGER_KNOB", &Key);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = QuerySingleActiveConfigVarListByKey (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), NULL, &ConfigVarList);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = QuerySingleActiveConfigVarListByKey (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Key, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = QuerySingleActiveConfigVarListByKey (mKnown_Good_Generic_Profile, 0, &Key, &ConfigVarList);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = QuerySingleActiveConfigVarListByKey (NULL, sizeof (mKnown_Good_Generic_Profile), &Key, &ConfigVarList);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarList with corrupted v2 variable lists.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListV2BadDataTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
+  UINTN                  ConfigVarListCount = 0;
+  EFI_STATUS             Status;
+  UINT8                  *Buffer;
+
+  Buffer = AllocateCopyPool (sizeof (mKnown_Good_Generic_Profile_V2), mKnown_Good_Generic_Profile_V2);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  // Corrupt the guid table
+  Buffer[sizeof (CONFIG_VAR_LIST_V2_HDR)] ^= 0xFF;
+  Status = RetrieveActiveConfigVarList (Buffer, sizeof (mKnown_Good_Generic_Profile_V2), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 0);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+  Buffer[sizeof (CONFIG_VAR_LIST_V2_HDR)] ^= 0xFF;
+
+  // Truncate the tables
+  Status = RetrieveActiveConfigVarList (Buffer, sizeof (CONFIG_VAR_LIST_V2_HDR) + 1, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+
+  // Corrupt the last entry, same as v1 entries this is expected to assert
+  Buffer[sizeof (mKnown_Good_Generic_Profile_V2) - 1] ^= 0xFF;
+  UT_EXPECT_ASSERT_FAILURE (RetrieveActiveConfigVarList (Buffer, sizeof (mKnown_Good_Generic_Profile_V2), &ConfigVarListPtr, &ConfigVarListCount), NULL);
+  Buffer[sizeof (mKnown_Good_Generic_Profile_V2) - 1] ^= 0xFF;
+
+  // Unknown version
+  ((CONFIG_VAR_LIST_V2_HDR *)Buffer)->Version = CONFIG_VAR_LIST_V2_ALIGNED_VERSION + 1;
+  ConfigVarListPtr                            = NULL;
+  Status                                      = RetrieveActiveConfigVarList (Buffer, sizeof (mKnown_Good_Generic_Profile_V2), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarList with an aligned v2 variable list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListV2AlignedTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY         *ConfigVarListPtr  = NULL;
+  UINTN                         ConfigVarListCount = 0;
+  EFI_STATUS                    Status;
+  UINT8                         *Buffer;
+  CONFIG_VAR_LIST_V2_HDR        *Header;
+  CONFIG_VAR_LIST_V2_ENTRY_HDR  *Entry;
+  UINTN                         Offset;
+  UINT32                        i = 0;
+
+  // Place the list as firmware would, aligned in memory
+  Buffer = AllocateCopyPool (sizeof (mKnown_Good_Generic_Profile_V2_Aligned), mKnown_Good_Generic_Profile_V2_Aligned);
+  UT_ASSERT_NOT_NULL (Buffer);
+  UT_ASSERT_EQUAL ((UINTN)Buffer % CONFIG_VAR_LIST_V2_DATA_ALIGNMENT, 0);
+
+  Status = RetrieveActiveConfigVarList (Buffer, sizeof (mKnown_Good_Generic_Profile_V2_Aligned), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, KNOWN_GOOD_TAG_COUNT);
+
+  for ( ; i < ConfigVarListCount; i++) {
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrSize (mKnown_Good_VarList_Names[i]));
+    if (i < 2) {
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Yaml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Yaml_Guid));
+      UT_ASSERT_EQUAL (3, ConfigVarListPtr[i].Attributes);
+    } else {
+      // Xml part of blob
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Xml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Xml_Guid));
+      UT_ASSERT_EQUAL (7, ConfigVarListPtr[i].Attributes);
+    }
+
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+
+    FreePool (ConfigVarListPtr[i].Name);
+    FreePool (ConfigVarListPtr[i].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+
+  // The data of every entry can be read in place
+  Header = (CONFIG_VAR_LIST_V2_HDR *)Buffer;
+  Offset = sizeof (*Header) + Header->GuidCount * sizeof (EFI_GUID) + Header->StringTableSize;
+  for (i = 0; i < KNOWN_GOOD_TAG_COUNT; i++) {
+    Entry = (CONFIG_VAR_LIST_V2_ENTRY_HDR *)(Buffer + Offset);
+    UT_ASSERT_EQUAL ((UINTN)(Entry + 1) % CONFIG_VAR_LIST_V2_DATA_ALIGNMENT, 0);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], Entry->DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], Entry + 1, Entry->DataSize);
+
+    Offset += ALIGN_VALUE (ALIGN_VALUE (sizeof (*Entry) + Entry->DataSize, sizeof (UINT32)) + sizeof (UINT32), CONFIG_VAR_LIST_V2_DATA_ALIGNMENT);
+  }
+
+  UT_ASSERT_EQUAL (Offset, sizeof (mKnown_Good_Generic_Profile_V2_Aligned));
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarList with corrupted aligned v2 variable lists.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListV2AlignedBadDataTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
+  UINTN                  ConfigVarListCount = 0;
+  EFI_STATUS             Status;
+  UINT8                  *Buffer;
+  UINTN                  PaddingOffset;
+
+  Buffer = AllocateCopyPool (sizeof (mKnown_Good_Generic_Profile_V2_Aligned), mKnown_Good_Generic_Profile_V2_Aligned);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  // The padding after the CRC of the second to last entry is not covered by any CRC
+  PaddingOffset = sizeof (mKnown_Good_Generic_Profile_V2_Aligned) - 7 * sizeof (UINT32);
+  UT_ASSERT_EQUAL (Buffer[PaddingOffset], 0);
+  Buffer[PaddingOffset] ^= 0xFF;
+  Status = RetrieveActiveConfigVarList (Buffer, sizeof (mKnown_Good_Generic_Profile_V2_Aligned), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, KNOWN_GOOD_TAG_COUNT);
+  for ( ; ConfigVarListCount > 0; ConfigVarListCount--) {
+    FreePool (ConfigVarListPtr[ConfigVarListCount - 1].Name);
+    FreePool (ConfigVarListPtr[ConfigVarListCount - 1].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+  Buffer[PaddingOffset] ^= 0xFF;
+
+  // The list ends right after the CRC of the second to last entry, without its padding
+  UT_EXPECT_ASSERT_FAILURE (RetrieveActiveConfigVarList (Buffer, PaddingOffset, &ConfigVarListPtr, &ConfigVarListCount), NULL);
+
+  // A packed v2 list flagged as aligned
+  FreePool (Buffer);
+  Buffer = AllocateCopyPool (sizeof (mKnown_Good_Generic_Profile_V2), mKnown_Good_Generic_Profile_V2);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  ((CONFIG_VAR_LIST_V2_HDR *)Buffer)->Version = CONFIG_VAR_LIST_V2_ALIGNED_VERSION;
+  ConfigVarListPtr                            = NULL;
+  ConfigVarListCount                          = 0;
+  Status                                      = RetrieveActiveConfigVarList (Buffer, sizeof (mKnown_Good_Generic_Profile_V2), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 0);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConvertVariableListToVariableEntry with a v2 variable list, whose entries cannot
+  be converted without the tables.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConvertVariableListToVariableEntryV2 (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  ConfigVarList;
+  EFI_STATUS             Status;
+  UINTN                  Size;
+
+  Size   = sizeof (mKnown_Good_Generic_Profile_V2);
+  Status = ConvertVariableListToVariableEntry (mKnown_Good_Generic_Profile_V2, &Size, &ConfigVarList);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarListArena with v1, v2 and aligned v2 variable lists, freed before the list
+  is used.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListArenaTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr;
+  UINTN                  ConfigVarListCount;
+  EFI_STATUS             Status;
+  VOID                   *VarList;
+  VOID                   *VarLists[]     = { mKnown_Good_Generic_Profile, mKnown_Good_Generic_Profile_V2, mKnown_Good_Generic_Profile_V2_Aligned };
+  UINTN                  VarListSizes[]  = { sizeof (mKnown_Good_Generic_Profile), sizeof (mKnown_Good_Generic_Profile_V2), sizeof (mKnown_Good_Generic_Profile_V2_Aligned) };
+  UINT32                 i;
+  UINT32                 j               = 0;
+
+  for ( ; j < ARRAY_SIZE (VarLists); j++) {
+    VarList = AllocateCopyPool (VarListSizes[j], VarLists[j]);
+    UT_ASSERT_NOT_NULL (VarList);
+
+    ConfigVarListPtr   = NULL;
+    ConfigVarListCount = 0;
+    Status             = RetrieveActiveConfigVarListArena (VarList, VarListSizes[j], &ConfigVarListPtr, &ConfigVarListCount);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (ConfigVarListCount, KNOWN_GOOD_TAG_COUNT);
+
+    // The list must not refer to the variable list buffer
+    ZeroMem (VarList, VarListSizes[j]);
+    FreePool (VarList);
+
+    for (i = 0; i < ConfigVarListCount; i++) {
+      UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrSize (mKnown_Good_VarList_Names[i]));
+      if (i < 2) {
+        UT_ASSERT_MEM_EQUAL (&mKnown_Good_Yaml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Yaml_Guid));
+        UT_ASSERT_EQUAL (3, ConfigVarListPtr[i].Attributes);
+      } else {
+        // Xml part of blob
+        UT_ASSERT_MEM_EQUAL (&mKnown_Good_Xml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Xml_Guid));
+        UT_ASSERT_EQUAL (7, ConfigVarListPtr[i].Attributes);
+      }
+
+      UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+      UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+      UT_ASSERT_EQUAL ((UINTN)ConfigVarListPtr[i].Data % sizeof (UINT64), 0);
+    }
+
+    FreeConfigVarList (ConfigVarListPtr);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarListArena with invalid parameters and corrupted data.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListArenaBadDataTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr;
+  UINTN                  ConfigVarListCount;
+  EFI_STATUS             Status;
+
+  Status = RetrieveActiveConfigVarListArena (NULL, 0, NULL, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = RetrieveActiveConfigVarListArena (NULL, 0, &ConfigVarListPtr, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = RetrieveActiveConfigVarListArena (NULL, sizeof (mKnown_Good_Generic_Profile), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = RetrieveActiveConfigVarListArena (mKnown_Good_Generic_Profile, 0, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  // mKnown_Bad_Config_Data is not in varlist format, so it should fail
+  UT_EXPECT_ASSERT_FAILURE (RetrieveActiveConfigVarListArena (mKnown_Bad_Config_Data, sizeof (mKnown_Bad_Config_Data), &ConfigVarListPtr, &ConfigVarListCount), NULL);
+
+  // Freeing nothing is fine
+  FreeConfigVarList (NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   ConfigVariableListLib and run the ConfigVariableListLib unit test.
@@ -1220,6 +1812,23 @@ UnitTestingEntry (
   AddTestCase (ConfigVariableListLib, "VariableEntry loop back should succeed", "VariableEntryLoopBack", VariableEntryLoopBack, NULL, NULL, NULL);
   AddTestCase (ConfigVariableListLib, "VariableList loop back should succeed", "VariableListLoopBack", VariableListLoopBack, NULL, NULL, NULL);
 
+  // v2 var list
+  AddTestCase (ConfigVariableListLib, "Retrieve entire v2 config should succeed", "RetrieveActiveConfigVarListV2Test", RetrieveActiveConfigVarListV2Test, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Query single Ascii v2 config should succeed", "QuerySingleActiveConfigAsciiVarListV2Test", QuerySingleActiveConfigAsciiVarListV2Test, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad v2 data test should fail", "RetrieveActiveConfigVarListV2BadDataTest", RetrieveActiveConfigVarListV2BadDataTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "v2 var list to var entry should be unsupported", "ConvertVariableListToVariableEntryV2", ConvertVariableListToVariableEntryV2, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Retrieve entire aligned v2 config should succeed", "RetrieveActiveConfigVarListV2AlignedTest", RetrieveActiveConfigVarListV2AlignedTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad aligned v2 data test should fail", "RetrieveActiveConfigVarListV2AlignedBadDataTest", RetrieveActiveConfigVarListV2AlignedBadDataTest, NULL, NULL, NULL);
+
+  // Query by name key
+  AddTestCase (ConfigVariableListLib, "Query by key should succeed", "QuerySingleActiveConfigVarListByKeyTest", QuerySingleActiveConfigVarListByKeyTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad name key test should fail", "QuerySingleActiveConfigVarListByKeyNotFoundTest", QuerySingleActiveConfigVarListByKeyNotFoundTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Null Param test should fail", "QuerySingleActiveConfigVarListByKeyInvalidParamTest", QuerySingleActiveConfigVarListByKeyInvalidParamTest, NULL, NULL, NULL);
+
+  // Single allocation var list
+  AddTestCase (ConfigVariableListLib, "Retrieve entire config in a single allocation should succeed", "RetrieveActiveConfigVarListArenaTest", RetrieveActiveConfigVarListArenaTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad params and data should fail", "RetrieveActiveConfigVarListArenaBadDataTest", RetrieveActiveConfigVarListArenaBadDataTest, NULL, NULL, NULL);
+
   // Test GetVarListSize
   AddTestCase (ConfigVariableListLib, "Good params should succeed", "GetVarListSizeSuccess", GetVarListSizeSuccess, NULL, NULL, NULL);
   AddTestCase (ConfigVariableListLib, "Bad params should fail", "GetVarListSizeInvalidParam", GetVarListSizeInvalidParam, NULL, NULL, NULL);
@@ -22,4 +22,10 @@ CHAR8  *gProfileFlavorNames[1] = { NULL };
 
 UINT8  gProfileFlavorIds[1] = { 0 };
 
+CONST UINT8  *gProfileCacheImages[1] = { NULL };
+
+CONST UINT8  *gGenericProfileCacheImage = NULL;
+
+UINTN  gProfileCacheImageSize = 0;
+
 CHAR8  *gSchemaXmlHash = NULL;
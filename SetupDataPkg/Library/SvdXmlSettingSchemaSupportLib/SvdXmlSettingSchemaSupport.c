@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <XmlTypes.h>
 
 #include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/PrintLib.h>
 #include <Library/XmlTreeLib.h>
 #include <Library/XmlTreeQueryLib.h>
@@ -211,38 +212,31 @@ GetInputSettings (
 }
 
 /**
-Function to Create the XML nodes for a single setting output status
+Internal function to Create the XML nodes for a single setting output status
 
-@param[in] ParentSettingsListNode:  The <Settings> element node that all <ResultSettings> are under
+@param[in] ParentSettingsListNode:  The validated <Settings> element node that all <ResultSettings> are under
 @param[in] Id:        String for the Id
 @param[in] Result:    String of the status code value for the operation
 @param[in,opt] Flags: optional String of the return flags
+@param[out,opt] ResultNode: The created <SettingResult> node
 
 @retval Success if created and added to the xml successfully
 @retval Error if it could not be created or added to the xml
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-SetOutputSettingsStatus (
+AddOutputSettingsStatus (
   IN CONST XmlNode  *ParentSettingsListNode,
   IN CONST CHAR8    *Id,
   IN CONST CHAR8    *Result,
-  IN CONST CHAR8    *Flags  OPTIONAL
+  IN CONST CHAR8    *Flags       OPTIONAL,
+  OUT XmlNode       **ResultNode OPTIONAL
   )
 {
   XmlNode     *Temp    = NULL;
   XmlNode     *Setting = NULL;
   EFI_STATUS  Status;
 
-  if ((ParentSettingsListNode == NULL) || (Id == NULL) || (Result == NULL)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  if (AsciiStrnCmp (ParentSettingsListNode->Name, RESULTS_SETTINGS_LIST_ELEMENT_NAME, sizeof (RESULTS_SETTINGS_LIST_ELEMENT_NAME)) != 0) {
-    DEBUG ((DEBUG_ERROR, "%a - Parent Setting Node is not Setting Node List\n", __func__));
-    return EFI_INVALID_PARAMETER;
-  }
-
   // Make the <SettingResult>
   Status = AddNode ((XmlNode *)ParentSettingsListNode, RESULTS_SETTING_ELEMENT_NAME, NULL, &Setting);
   if (EFI_ERROR (Status)) {
@@ -273,9 +267,362 @@ SetOutputSettingsStatus (
     return EFI_DEVICE_ERROR;
   }
 
+  if (ResultNode != NULL) {
+    *ResultNode = Setting;
+  }
+
   return EFI_SUCCESS;
 }
 
+/**
+Function to Create the XML nodes for a single setting output status
+
+@param[in] ParentSettingsListNode:  The <Settings> element node that all <ResultSettings> are under
+@param[in] Id:        String for the Id
+@param[in] Result:    String of the status code value for the operation
+@param[in,opt] Flags: optional String of the return flags
+
+@retval Success if created and added to the xml successfully
+@retval Error if it could not be created or added to the xml
+**/
+EFI_STATUS
+EFIAPI
+SetOutputSettingsStatus (
+  IN CONST XmlNode  *ParentSettingsListNode,
+  IN CONST CHAR8    *Id,
+  IN CONST CHAR8    *Result,
+  IN CONST CHAR8    *Flags  OPTIONAL
+  )
+{
+  if ((ParentSettingsListNode == NULL) || (Id == NULL) || (Result == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (AsciiStrnCmp (ParentSettingsListNode->Name, RESULTS_SETTINGS_LIST_ELEMENT_NAME, sizeof (RESULTS_SETTINGS_LIST_ELEMENT_NAME)) != 0) {
+    DEBUG ((DEBUG_ERROR, "%a - Parent Setting Node is not Setting Node List\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return AddOutputSettingsStatus (ParentSettingsListNode, Id, Result, Flags, NULL);
+}
+
+///// SETTINGS PACKET INDEX
+
+/**
+Hash an Id string for the setting index (FNV-1a).
+
+@param[in] Id:  Null terminated Id string
+
+@retval The hash of the Id.
+**/
+STATIC
+UINTN
+HashSettingId (
+  IN CONST CHAR8  *Id
+  )
+{
+  UINT32  Hash = 0x811C9DC5;
+
+  while (*Id != '\0') {
+    Hash ^= (UINT8)*Id++;
+    Hash *= 0x01000193;
+  }
+
+  return (UINTN)Hash;
+}
+
+/**
+Count the children of a node.
+
+@param[in] Node:  Node whose children are counted
+
+@retval The number of children of the node.
+**/
+STATIC
+UINTN
+CountChildNodes (
+  IN CONST XmlNode  *Node
+  )
+{
+  CONST LIST_ENTRY  *Link;
+  UINTN             Count = 0;
+
+  BASE_LIST_FOR_EACH (Link, &(Node->ChildrenListHead)) {
+    Count++;
+  }
+
+  return Count;
+}
+
+/**
+Build an index over the elements and settings of a SettingsPacket with a single walk of the tree.
+
+Every <Setting> element must have an <Id> and a <Value>. If the same Id appears more than once,
+lookups by Id return the first one, while Settings still holds all of them in document order.
+
+@param[in]  PacketNode:  The SettingsPacket node, as returned by GetSettingsPacketNode
+@param[out] Index:       Newly allocated index, to be freed with FreeSettingsPacketIndex
+
+@retval EFI_SUCCESS             The index was built.
+@retval EFI_INVALID_PARAMETER   A parameter is NULL or PacketNode is not a SettingsPacket.
+@retval EFI_NOT_FOUND           The packet has no <Settings> list, or a <Setting> misses its Id or Value.
+@retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+**/
+EFI_STATUS
+EFIAPI
+BuildSettingsPacketIndex (
+  IN  CONST XmlNode              *PacketNode,
+  OUT SVD_SETTINGS_PACKET_INDEX  **Index
+  )
+{
+  SVD_SETTINGS_PACKET_INDEX  *NewIndex = NULL;
+  SVD_SETTING_INDEX_ENTRY    *Entry;
+  CONST LIST_ENTRY           *Link;
+  CONST LIST_ENTRY           *ChildLink;
+  XmlNode                    *Child;
+  UINTN                      SettingNodeCount;
+  UINTN                      Bucket;
+  EFI_STATUS                 Status;
+
+  if ((PacketNode == NULL) || (Index == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (AsciiStrnCmp (PacketNode->Name, SETTINGS_PACKET_ELEMENT_NAME, sizeof (SETTINGS_PACKET_ELEMENT_NAME)) != 0) {
+    DEBUG ((DEBUG_ERROR, "%a - PacketNode is not Settings Packet Element\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  NewIndex = AllocateZeroPool (sizeof (*NewIndex));
+  if (NewIndex == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  NewIndex->PacketNode = (XmlNode *)PacketNode;
+
+  // Index the packet elements, Version, LowestSupportedVersion, Settings, etc.
+  NewIndex->Elements = AllocatePool (MAX (CountChildNodes (PacketNode), 1) * sizeof (XmlNode *));
+  if (NewIndex->Elements == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  BASE_LIST_FOR_EACH (Link, &(PacketNode->ChildrenListHead)) {
+    Child                                        = (XmlNode *)Link; // Link is first member so just cast it.
+    NewIndex->Elements[NewIndex->ElementCount++] = Child;
+    if ((NewIndex->SettingsListNode == NULL) &&
+        (AsciiStrnCmp (Child->Name, SETTINGS_LIST_ELEMENT_NAME, sizeof (SETTINGS_LIST_ELEMENT_NAME)) == 0))
+    {
+      NewIndex->SettingsListNode = Child;
+    }
+  }
+
+  if (NewIndex->SettingsListNode == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a - Packet has no Settings List Element\n", __func__));
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+  // Index the settings, keeping the hash table at most half full
+  SettingNodeCount      = CountChildNodes (NewIndex->SettingsListNode);
+  NewIndex->Settings    = AllocateZeroPool (MAX (SettingNodeCount, 1) * sizeof (SVD_SETTING_INDEX_ENTRY));
+  NewIndex->BucketCount = 2;
+  while (NewIndex->BucketCount < SettingNodeCount * 2) {
+    NewIndex->BucketCount <<= 1;
+  }
+
+  NewIndex->Buckets = AllocateZeroPool (NewIndex->BucketCount * sizeof (UINTN));
+  if ((NewIndex->Settings == NULL) || (NewIndex->Buckets == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  BASE_LIST_FOR_EACH (Link, &(NewIndex->SettingsListNode->ChildrenListHead)) {
+    Entry              = &NewIndex->Settings[NewIndex->SettingCount];
+    Entry->SettingNode = (XmlNode *)Link;
+
+    // Get the Id and Value in one walk of the <Setting> children
+    BASE_LIST_FOR_EACH (ChildLink, &(Entry->SettingNode->ChildrenListHead)) {
+      Child = (XmlNode *)ChildLink;
+      if ((Entry->Id == NULL) && (AsciiStrnCmp (Child->Name, SETTING_ID_ELEMENT_NAME, sizeof (SETTING_ID_ELEMENT_NAME)) == 0)) {
+        Entry->Id = Child->Value;
+      } else if ((Entry->Value == NULL) && (AsciiStrnCmp (Child->Name, SETTING_VALUE_ELEMENT_NAME, sizeof (SETTING_VALUE_ELEMENT_NAME)) == 0)) {
+        Entry->Value = Child->Value;
+      }
+    }
+
+    if ((Entry->Id == NULL) || (Entry->Value == NULL)) {
+      DEBUG ((DEBUG_ERROR, "%a - Failed to find Id or Value Element of setting %u\n", __func__, NewIndex->SettingCount));
+      Status = EFI_NOT_FOUND;
+      goto Exit;
+    }
+
+    NewIndex->SettingCount++;
+
+    // Linear probe for a free bucket, a duplicated Id keeps pointing to the first setting
+    Bucket = HashSettingId (Entry->Id) & (NewIndex->BucketCount - 1);
+    while (NewIndex->Buckets[Bucket] != 0) {
+      if (AsciiStrCmp (NewIndex->Settings[NewIndex->Buckets[Bucket] - 1].Id, Entry->Id) == 0) {
+        DEBUG ((DEBUG_WARN, "%a - Duplicated setting Id %a\n", __func__, Entry->Id));
+        break;
+      }
+
+      Bucket = (Bucket + 1) & (NewIndex->BucketCount - 1);
+    }
+
+    if (NewIndex->Buckets[Bucket] == 0) {
+      NewIndex->Buckets[Bucket] = NewIndex->SettingCount;
+    }
+  }
+
+  *Index = NewIndex;
+  Status = EFI_SUCCESS;
+
+Exit:
+  if (EFI_ERROR (Status)) {
+    FreeSettingsPacketIndex (NewIndex);
+  }
+
+  return Status;
+}
+
+/**
+Function to get a direct child element of the indexed packet by name, e.g. the Version element.
+
+@param[in] Index:        Index built by BuildSettingsPacketIndex
+@param[in] ElementName:  Name of the element
+
+@retval The first element with that name, NULL if there is none or a parameter is NULL.
+**/
+XmlNode *
+EFIAPI
+GetIndexedPacketElement (
+  IN CONST SVD_SETTINGS_PACKET_INDEX  *Index,
+  IN CONST CHAR8                      *ElementName
+  )
+{
+  UINTN  Idx;
+
+  if ((Index == NULL) || (ElementName == NULL)) {
+    return NULL;
+  }
+
+  // A packet only has a handful of elements
+  for (Idx = 0; Idx < Index->ElementCount; Idx++) {
+    if (AsciiStrCmp (Index->Elements[Idx]->Name, ElementName) == 0) {
+      return Index->Elements[Idx];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+Function to find an indexed setting by Id in constant time.
+
+@param[in] Index:  Index built by BuildSettingsPacketIndex
+@param[in] Id:     Id of the setting
+
+@retval The index entry of the setting, NULL if there is none or a parameter is NULL.
+**/
+SVD_SETTING_INDEX_ENTRY *
+EFIAPI
+FindIndexedSetting (
+  IN CONST SVD_SETTINGS_PACKET_INDEX  *Index,
+  IN CONST CHAR8                      *Id
+  )
+{
+  UINTN  Bucket;
+
+  if ((Index == NULL) || (Id == NULL)) {
+    return NULL;
+  }
+
+  Bucket = HashSettingId (Id) & (Index->BucketCount - 1);
+  while (Index->Buckets[Bucket] != 0) {
+    if (AsciiStrCmp (Index->Settings[Index->Buckets[Bucket] - 1].Id, Id) == 0) {
+      return &Index->Settings[Index->Buckets[Bucket] - 1];
+    }
+
+    Bucket = (Bucket + 1) & (Index->BucketCount - 1);
+  }
+
+  return NULL;
+}
+
+/**
+Function to Create the XML nodes for the output status of an indexed setting.
+
+Same as SetOutputSettingsStatus, but the created <SettingResult> node is remembered in the
+index entry, so each setting gets exactly one result.
+
+@param[in] ParentSettingsListNode:  The <Settings> element node that all <ResultSettings> are under
+@param[in] Setting:   Index entry of the setting, from the Settings of the index or FindIndexedSetting
+@param[in] Result:    String of the status code value for the operation
+@param[in,opt] Flags: optional String of the return flags
+
+@retval EFI_SUCCESS             Created and added to the xml successfully
+@retval EFI_INVALID_PARAMETER   A parameter is NULL or ParentSettingsListNode is not a results settings list
+@retval EFI_ALREADY_STARTED     A status was already set for this setting
+@retval Error if it could not be created or added to the xml
+**/
+EFI_STATUS
+EFIAPI
+SetIndexedOutputSettingsStatus (
+  IN CONST XmlNode            *ParentSettingsListNode,
+  IN SVD_SETTING_INDEX_ENTRY  *Setting,
+  IN CONST CHAR8              *Result,
+  IN CONST CHAR8              *Flags  OPTIONAL
+  )
+{
+  if ((ParentSettingsListNode == NULL) || (Setting == NULL) || (Result == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (AsciiStrnCmp (ParentSettingsListNode->Name, RESULTS_SETTINGS_LIST_ELEMENT_NAME, sizeof (RESULTS_SETTINGS_LIST_ELEMENT_NAME)) != 0) {
+    DEBUG ((DEBUG_ERROR, "%a - Parent Setting Node is not Setting Node List\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Setting->ResultNode != NULL) {
+    DEBUG ((DEBUG_ERROR, "%a - Result of setting %a was already set\n", __func__, Setting->Id));
+    return EFI_ALREADY_STARTED;
+  }
+
+  return AddOutputSettingsStatus (ParentSettingsListNode, Setting->Id, Result, Flags, &Setting->ResultNode);
+}
+
+/**
+Free an index built by BuildSettingsPacketIndex. The indexed XML tree is not freed.
+
+@param[in] Index:  Index to free, may be NULL
+**/
+VOID
+EFIAPI
+FreeSettingsPacketIndex (
+  IN SVD_SETTINGS_PACKET_INDEX  *Index
+  )
+{
+  if (Index == NULL) {
+    return;
+  }
+
+  if (Index->Elements != NULL) {
+    FreePool (Index->Elements);
+  }
+
+  if (Index->Settings != NULL) {
+    FreePool (Index->Settings);
+  }
+
+  if (Index->Buckets != NULL) {
+    FreePool (Index->Buckets);
+  }
+
+  FreePool (Index);
+}
+
 ///// CURRENT SETTINGS
 
 XmlNode *
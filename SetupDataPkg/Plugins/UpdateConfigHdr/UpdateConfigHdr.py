@@ -17,7 +17,8 @@ class UpdateConfigHdr(IUefiBuildPlugin):
     # Attempt to run GenCfgData to generate C header files
     #
     # Consumes build environment variables: "CONF_AUTOGEN_INCLUDE_PATH", "MU_SCHEMA_DIR",
-    # "MU_SCHEMA_FILE_NAME", "CONF_PROFILE_PATHS" and "CONF_PROFILE_NAMES"
+    # "MU_SCHEMA_FILE_NAME", "CONF_PROFILE_PATHS", "CONF_PROFILE_NAMES", "CONF_PROFILE_IDS",
+    # "CONF_PROFILE_CACHE_IMAGES" and "CONF_ALIGNED_POLICY"
     def do_pre_build(self, thebuilder):
         default_generated_path = thebuilder.edk2path.GetAbsolutePathOnThisSystemFromEdk2RelativePath(
             "SetupDataPkg", "Test", "Include"
@@ -70,6 +71,13 @@ class UpdateConfigHdr(IUefiBuildPlugin):
         profile_names = thebuilder.env.GetValue("CONF_PROFILE_NAMES", "").split(";")
         profile_ids = thebuilder.env.GetValue("CONF_PROFILE_IDS", "").split(";")
 
+        # when set to TRUE, the complete config policy of each profile is generated along with its overrides
+        cache_images = thebuilder.env.GetValue("CONF_PROFILE_CACHE_IMAGES", "FALSE").upper() == "TRUE"
+
+        # when set to TRUE, the config policy is published as an aligned v2 variable list and the getters read knobs in
+        # place
+        aligned_policy = thebuilder.env.GetValue("CONF_ALIGNED_POLICY", "FALSE").upper() == "TRUE"
+
         if len(schema_files) != len(final_dirs):
             logging.error("Differing number of items in CONF_AUTOGEN_INCLUDE_PATH and MU_SCHEMA_FILE_NAME!\
                            They must be the same")
@@ -94,6 +102,11 @@ class UpdateConfigHdr(IUefiBuildPlugin):
                 if len(profile_ids) > i and profile_ids[i] != "":
                     params.append("-pid")
                     params.append(profile_ids[i])
+                if cache_images:
+                    params.append("-ci")
+
+            if aligned_policy:
+                params.append("-al")
 
             ret = RunPythonScript(cmd, " ".join(params), workingdir=final_dirs[i])
             if ret != 0:
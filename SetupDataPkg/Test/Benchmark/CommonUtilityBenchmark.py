@@ -0,0 +1,146 @@
+# @ CommonUtilityBenchmark.py
+#
+# Benchmark of the CommonUtility bit-field extraction, reported in the same JSON lines format as the host based
+# SetupDataPkg benchmarks. The baseline is the per call big integer conversion that the precomputed extractors
+# replaced.
+#
+# Copyright (c) 2025, Microsoft Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+#
+
+import argparse
+import json
+import os
+import random
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Tools'))
+
+import CommonUtility  # noqa: E402
+
+SUITE = 'CommonUtility'
+
+
+def big_int_get_bits_from_bytes(bytes, start, length):
+    if length == 0:
+        return 0
+    byte_start = (start) // 8
+    byte_end = (start + length - 1) // 8
+    bit_start = start & 7
+    mask = (1 << length) - 1
+    val = int.from_bytes(bytes[byte_start:byte_end + 1], 'little')
+    return (val >> bit_start) & mask
+
+
+def big_int_set_bits_to_bytes(bytes, start, length, bvalue):
+    if length == 0:
+        return
+    byte_start = (start) // 8
+    byte_end = (start + length - 1) // 8
+    bit_start = start & 7
+    mask = (1 << length) - 1
+    val = int.from_bytes(bytes[byte_start:byte_end + 1], 'little')
+    val &= ~(mask << bit_start)
+    val |= ((bvalue & mask) << bit_start)
+    bytes[byte_start:byte_end + 1] = bytearray(val.to_bytes(byte_end + 1 - byte_start, 'little'))
+
+
+# A page of items: mostly byte aligned integers of 1 to 8 bytes, with packed bit fields in between
+def generate_fields(item_count, seed=1):
+    rand = random.Random(seed)
+    fields = []
+    bit = 0
+    for _ in range(item_count):
+        if rand.random() < 0.25:
+            length = rand.randint(1, 7)
+        else:
+            bit = (bit + 7) // 8 * 8
+            length = rand.choice([8, 16, 32, 64])
+        fields.append((bit, length))
+        bit += length
+    return fields, bytearray(rand.randbytes((bit + 7) // 8))
+
+
+def measure(function, iterations):
+    begin = time.perf_counter_ns()
+    for _ in range(iterations):
+        function()
+    return time.perf_counter_ns() - begin
+
+
+def report(benchmark, items, iterations, total_ns, baseline_ns=None):
+    result = {
+        'suite': SUITE,
+        'benchmark': benchmark,
+        'items': items,
+        'iterations': iterations,
+        'total_ns': total_ns,
+        'ns_per_op': total_ns // iterations
+    }
+    if baseline_ns is not None:
+        result['baseline_ns_per_op'] = baseline_ns // iterations
+        result['speedup'] = round(baseline_ns / total_ns, 2)
+    print(json.dumps(result), flush=True)
+
+
+def run(item_count, iterations):
+    fields, buffer = generate_fields(item_count)
+    values = [big_int_get_bits_from_bytes(buffer, start, length) for start, length in fields]
+
+    def big_int_get():
+        return [big_int_get_bits_from_bytes(buffer, start, length) for start, length in fields]
+
+    extractors = [CommonUtility.BitField(start, length) for start, length in fields]
+
+    def field_get():
+        return [extractor.get(buffer) for extractor in extractors]
+
+    plan = CommonUtility.BitFieldPlan(fields)
+
+    def plan_get():
+        return plan.get(buffer)
+
+    if field_get() != values or plan_get() != values:
+        raise Exception("Bit field extraction does not match the baseline")
+
+    baseline_ns = measure(big_int_get, iterations)
+    report('GetBitsBigInt', item_count, iterations, baseline_ns)
+    report('GetBitsField', item_count, iterations, measure(field_get, iterations), baseline_ns)
+    report('GetBitsPlan', item_count, iterations, measure(plan_get, iterations), baseline_ns)
+
+    target = bytearray(len(buffer))
+
+    def big_int_set():
+        for (start, length), value in zip(fields, values):
+            big_int_set_bits_to_bytes(target, start, length, value)
+
+    def plan_set():
+        plan.set(target, values)
+
+    big_int_set()
+    expected = bytes(target)
+    target[:] = bytes(len(buffer))
+    plan_set()
+    if bytes(target) != expected:
+        raise Exception("Bit field update does not match the baseline")
+
+    baseline_ns = measure(big_int_set, iterations)
+    report('SetBitsBigInt', item_count, iterations, baseline_ns)
+    report('SetBitsPlan', item_count, iterations, measure(plan_set, iterations), baseline_ns)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark of the CommonUtility bit-field extraction.')
+    parser.add_argument('--items', type=int, nargs='+', default=[100, 500, 2000], help='Items per page.')
+    parser.add_argument('--iterations', type=int, default=200, help='Extractions of the whole page per benchmark.')
+    args = parser.parse_args()
+
+    for item_count in args.items:
+        run(item_count, args.iterations)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
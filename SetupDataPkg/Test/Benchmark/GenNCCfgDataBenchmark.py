@@ -0,0 +1,101 @@
+# @ GenNCCfgDataBenchmark.py
+#
+# Benchmark of loading variable lists into the schema of GenNCCfgData, and of building its pages and searching it,
+# reported in the same JSON lines format as the host based SetupDataPkg benchmarks.
+#
+# Copyright (c) 2025, Microsoft Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+#
+
+import argparse
+import json
+import os
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Tools'))
+
+from GenNCCfgData import CGenNCCfgData  # noqa: E402
+from VariableList import UEFIVariable, create_vlist_buffer  # noqa: E402
+
+SUITE = 'GenNCCfgData'
+NAMESPACE = 'FE3ED49F-B173-41ED-9076-356661D46A42'
+
+
+def generate_schema(knob_count):
+    """Generate a schema with knob_count knobs, alternating between structs and scalars."""
+    xml = ['<ConfigSchema><Enums /><Structs>',
+           '<Struct name="pair_t"><Member name="a" type="uint32_t" /><Member name="b" type="uint8_t" /></Struct>',
+           f'</Structs><Knobs namespace="{{{NAMESPACE}}}">']
+    for index in range(knob_count):
+        if index % 2:
+            xml.append(f'<Knob name="KNOB_{index}" type="uint32_t" default="0" help="Help {index % 10}" />')
+        else:
+            xml.append(f'<Knob name="KNOB_{index}" type="pair_t" default="{{0,0}}" help="Help {index % 10}" />')
+    xml.append('</Knobs></ConfigSchema>')
+    return ''.join(xml)
+
+
+def generate_vlist(knob_count):
+    """Generate a variable list with a variable for every scalar knob of generate_schema."""
+    return b''.join(create_vlist_buffer(UEFIVariable(f'KNOB_{index}', NAMESPACE, index.to_bytes(4, 'little')))
+                    for index in range(1, knob_count, 2))
+
+
+def load_variables(cdata, knob_count):
+    vlist = generate_vlist(knob_count)
+    return lambda: cdata.load_default_from_bin(vlist, True)
+
+
+def pages_and_search(cdata, knob_count):
+    def build_and_search():
+        for index in range(knob_count):
+            cdata.get_cfg_list(f'{NAMESPACE}.KNOB_{index}')
+        cdata.search_cfg_items('help 7')
+    return build_and_search
+
+
+def run(benchmark, knob_count, iterations):
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        schema_path = os.path.join(tmp_dir, 'BenchmarkSchema.xml')
+        with open(schema_path, 'w') as schema_file:
+            schema_file.write(generate_schema(knob_count))
+        cdata = CGenNCCfgData(schema_path)
+
+    results = []
+    for name, function in {'LoadVariables': load_variables, 'PagesAndSearch': pages_and_search}.items():
+        operation = function(cdata, knob_count)
+        begin = time.perf_counter_ns()
+        for _ in range(iterations):
+            operation()
+        total_ns = time.perf_counter_ns() - begin
+
+        result = {
+            'suite': SUITE,
+            'benchmark': f'{benchmark}{name}',
+            'knobs': knob_count,
+            'iterations': iterations,
+            'total_ns': total_ns,
+            'ns_per_op': total_ns // iterations
+        }
+        print(json.dumps(result), flush=True)
+        results.append(result)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark of loading, building the pages and searching GenNCCfgData.')
+    parser.add_argument('--knobs', type=int, nargs='+', default=[1000, 4000], help='Knob counts of the schemas.')
+    parser.add_argument('--iterations', type=int, default=3, help='Operations per benchmark.')
+    args = parser.parse_args()
+
+    for knob_count in args.knobs:
+        run(f'Schema{knob_count}', knob_count, args.iterations)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
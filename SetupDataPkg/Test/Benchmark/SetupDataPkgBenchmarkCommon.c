@@ -0,0 +1,355 @@
+/** @file
+  Helpers shared by the host based micro-benchmarks of SetupDataPkg.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ConfigVariableListLib.h>
+#include <Library/MockVariableStoreLib.h>
+
+#include <SetupDataPkgBenchmark.h>
+
+EFI_GUID  gBenchmarkKnobGuid = {
+  0x6c6a1b8e, 0x3f6d, 0x4c43, { 0x9a, 0x8e, 0x2b, 0x5d, 0x41, 0x6f, 0x0e, 0x7a }
+};
+
+/**
+  Parse the command line of a benchmark application.
+
+  The only accepted argument is the largest knob count to benchmark, which allows a quick run
+  of the small inputs only.
+
+  @param[in]  Argc  Number of arguments.
+  @param[in]  Argv  Arguments.
+
+  @return The largest knob count to benchmark.
+**/
+UINTN
+BenchmarkGetMaxKnobCount (
+  IN  INTN   Argc,
+  IN  CHAR8  **Argv
+  )
+{
+  UINTN  MaxKnobCount;
+
+  if (Argc < 2) {
+    return BENCHMARK_MAX_KNOB_COUNT;
+  }
+
+  MaxKnobCount = (UINTN)strtoul (Argv[1], NULL, 0);
+  if ((MaxKnobCount < BENCHMARK_MIN_KNOB_COUNT) || (MaxKnobCount > BENCHMARK_MAX_KNOB_COUNT)) {
+    fprintf (
+      stderr,
+      "Max knob count must be in [%u, %u], using %u\n",
+      BENCHMARK_MIN_KNOB_COUNT,
+      BENCHMARK_MAX_KNOB_COUNT,
+      BENCHMARK_MAX_KNOB_COUNT
+      );
+    return BENCHMARK_MAX_KNOB_COUNT;
+  }
+
+  return MaxKnobCount;
+}
+
+/**
+  Return the next knob count to benchmark, the counts grow by a factor of 10 from
+  BENCHMARK_MIN_KNOB_COUNT to BENCHMARK_MAX_KNOB_COUNT.
+
+  @param[in]  KnobCount  The knob count just benchmarked.
+
+  @return The next knob count to benchmark.
+**/
+UINTN
+BenchmarkNextKnobCount (
+  IN  UINTN  KnobCount
+  )
+{
+  return KnobCount * 10;
+}
+
+/**
+  Return the number of iterations to run a benchmark processing KnobCount knobs per iteration.
+
+  @param[in]  KnobCount  Number of knobs processed per iteration.
+
+  @return Number of iterations, at least 1.
+**/
+UINTN
+BenchmarkGetIterations (
+  IN  UINTN  KnobCount
+  )
+{
+  if ((KnobCount == 0) || (KnobCount >= BENCHMARK_KNOB_BUDGET)) {
+    return 1;
+  }
+
+  return BENCHMARK_KNOB_BUDGET / KnobCount;
+}
+
+/**
+  Read the current time.
+
+  @return Current time in nanoseconds.
+**/
+UINT64
+BenchmarkGetTimeNs (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  if (timespec_get (&Now, TIME_UTC) != TIME_UTC) {
+    return 0;
+  }
+
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Report one measurement as a JSON line on stdout.
+
+  @param[in]  Suite       Name of the benchmarked module.
+  @param[in]  Benchmark   Name of the benchmarked function.
+  @param[in]  KnobCount   Number of knobs of the input.
+  @param[in]  Iterations  Number of times the function was run.
+  @param[in]  ElapsedNs   Total time of all iterations in nanoseconds.
+**/
+VOID
+BenchmarkReport (
+  IN  CONST CHAR8  *Suite,
+  IN  CONST CHAR8  *Benchmark,
+  IN  UINTN        KnobCount,
+  IN  UINTN        Iterations,
+  IN  UINT64       ElapsedNs
+  )
+{
+  printf (
+    "{\"suite\":\"%s\",\"benchmark\":\"%s\",\"knobs\":%llu,\"iterations\":%llu,\"total_ns\":%llu,\"ns_per_op\":%llu}\n",
+    Suite,
+    Benchmark,
+    (unsigned long long)KnobCount,
+    (unsigned long long)Iterations,
+    (unsigned long long)ElapsedNs,
+    (unsigned long long)(ElapsedNs / ((Iterations == 0) ? 1 : Iterations))
+    );
+  fflush (stdout);
+}
+
+/**
+  Report that a benchmark failed as a JSON line on stdout.
+
+  @param[in]  Suite       Name of the benchmarked module.
+  @param[in]  Benchmark   Name of the benchmarked function.
+  @param[in]  KnobCount   Number of knobs of the input.
+  @param[in]  Status      Status returned by the benchmarked function.
+**/
+VOID
+BenchmarkReportError (
+  IN  CONST CHAR8  *Suite,
+  IN  CONST CHAR8  *Benchmark,
+  IN  UINTN        KnobCount,
+  IN  EFI_STATUS   Status
+  )
+{
+  printf (
+    "{\"suite\":\"%s\",\"benchmark\":\"%s\",\"knobs\":%llu,\"error\":\"0x%llx\"}\n",
+    Suite,
+    Benchmark,
+    (unsigned long long)KnobCount,
+    (unsigned long long)Status
+    );
+  fflush (stdout);
+}
+
+/**
+  Report the simulated cost of accesses to the mocked variable store as a JSON line on stdout.
+
+  @param[in]  Suite       Name of the benchmarked module.
+  @param[in]  Benchmark   Name of the benchmarked strategy.
+  @param[in]  KnobCount   Number of knobs of the input.
+  @param[in]  Stats       Statistics of the store accumulated by the benchmark.
+**/
+VOID
+BenchmarkReportVariableStore (
+  IN  CONST CHAR8                      *Suite,
+  IN  CONST CHAR8                      *Benchmark,
+  IN  UINTN                            KnobCount,
+  IN  CONST MOCK_VARIABLE_STORE_STATS  *Stats
+  )
+{
+  printf (
+    "{\"suite\":\"%s\",\"benchmark\":\"%s\",\"knobs\":%llu,\"iterations\":1,\"total_ns\":%llu,\"ns_per_op\":%llu,"
+    "\"writes\":%llu,\"skipped\":%llu,\"bytes_written\":%llu,\"reclaims\":%llu,\"blocks_erased\":%llu}\n",
+    Suite,
+    Benchmark,
+    (unsigned long long)KnobCount,
+    (unsigned long long)Stats->SimulatedNs,
+    (unsigned long long)Stats->SimulatedNs,
+    (unsigned long long)Stats->WriteCount,
+    (unsigned long long)Stats->SkippedCount,
+    (unsigned long long)Stats->BytesWritten,
+    (unsigned long long)Stats->ReclaimCount,
+    (unsigned long long)Stats->BlocksErased
+    );
+  fflush (stdout);
+}
+
+/**
+  Empty the mocked variable store and size it for KnobCount synthetic knobs.
+
+  The knobs fill two thirds of the store, rounded up to whole erase blocks, so rewriting all of them forces a reclaim
+  once they span a few blocks. The default latencies are used.
+
+  @param[in]  KnobCount   Number of knobs the store must hold.
+
+  @retval EFI_SUCCESS  The store is empty.
+  @retval Others       The store could not be initialized.
+**/
+EFI_STATUS
+BenchmarkInitializeVariableStore (
+  IN  UINTN  KnobCount
+  )
+{
+  MOCK_VARIABLE_STORE_COST_MODEL  CostModel;
+  UINTN                           StoreSize;
+
+  StoreSize = KnobCount * BENCHMARK_KNOB_RECORD_SIZE * 3 / 2;
+
+  CostModel.StoreSize      = ALIGN_VALUE (StoreSize, MOCK_VARIABLE_STORE_DEFAULT_ERASE_BLOCK_SIZE);
+  CostModel.EraseBlockSize = MOCK_VARIABLE_STORE_DEFAULT_ERASE_BLOCK_SIZE;
+  CostModel.ReadLatencyNs  = MOCK_VARIABLE_STORE_DEFAULT_READ_NS;
+  CostModel.WriteLatencyNs = MOCK_VARIABLE_STORE_DEFAULT_WRITE_NS;
+  CostModel.ByteLatencyNs  = MOCK_VARIABLE_STORE_DEFAULT_BYTE_NS;
+  CostModel.EraseLatencyNs = MOCK_VARIABLE_STORE_DEFAULT_ERASE_NS;
+
+  return MockVariableStoreInitialize (&CostModel);
+}
+
+/**
+  Fill the name of a synthetic knob.
+
+  @param[in]  Index     Index of the knob.
+  @param[out] Name      Buffer of BENCHMARK_KNOB_NAME_LEN characters receiving the name.
+**/
+VOID
+BenchmarkGetKnobName (
+  IN  UINTN   Index,
+  OUT CHAR16  *Name
+  )
+{
+  UnicodeSPrint (Name, BENCHMARK_KNOB_NAME_LEN * sizeof (CHAR16), L"BenchmarkKnob_%06u", (UINT32)Index);
+}
+
+/**
+  Create a synthetic variable list of KnobCount knobs, the layout of a generated profile.
+
+  Knob Index is named by BenchmarkGetKnobName, lives in gBenchmarkKnobGuid and holds the UINT32 Index.
+
+  @param[in]  KnobCount    Number of knobs in the variable list.
+  @param[out] VarList      Allocated variable list, the caller frees it with FreePool.
+  @param[out] VarListSize  Size in bytes of VarList.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+  @retval EFI_SUCCESS           The variable list was created.
+  @retval Others                The conversion of a knob failed.
+**/
+EFI_STATUS
+BenchmarkCreateVarList (
+  IN  UINTN  KnobCount,
+  OUT VOID   **VarList,
+  OUT UINTN  *VarListSize
+  )
+{
+  EFI_STATUS             Status;
+  CHAR16                 Name[BENCHMARK_KNOB_NAME_LEN];
+  UINT32                 Data;
+  UINT32                 EntrySize;
+  UINTN                  Size;
+  UINTN                  Offset;
+  UINTN                  Index;
+  UINT8                  *Buffer;
+  CONFIG_VAR_LIST_ENTRY  Entry;
+
+  Buffer = NULL;
+
+  // All the names have the same length, so every entry has the same size
+  BenchmarkGetKnobName (0, Name);
+  Status = GetVarListSize ((UINT32)StrSize (Name), BENCHMARK_KNOB_DATA_SIZE, &EntrySize);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Buffer = AllocatePool (EntrySize * KnobCount);
+  if (Buffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Entry.Name       = Name;
+  Entry.Guid       = gBenchmarkKnobGuid;
+  Entry.Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS;
+  Entry.Data       = &Data;
+  Entry.DataSize   = BENCHMARK_KNOB_DATA_SIZE;
+
+  Offset = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    BenchmarkGetKnobName (Index, Name);
+    Data   = (UINT32)Index;
+    Size   = EntrySize;
+    Status = ConvertVariableEntryToVariableList (&Entry, Buffer + Offset, &Size);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    Offset += Size;
+  }
+
+  *VarList     = Buffer;
+  *VarListSize = Offset;
+  Buffer       = NULL;
+
+Exit:
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+
+  return Status;
+}
+
+/**
+  Free a list of variable entries along with the Name and Data of each entry.
+
+  @param[in]  ConfigVarList       The list of entries.
+  @param[in]  ConfigVarListCount  Number of entries in ConfigVarList.
+**/
+VOID
+BenchmarkFreeConfigVarList (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                  ConfigVarListCount
+  )
+{
+  UINTN  Index;
+
+  if (ConfigVarList == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < ConfigVarListCount; Index++) {
+    FreePool (ConfigVarList[Index].Name);
+    FreePool (ConfigVarList[Index].Data);
+  }
+
+  FreePool (ConfigVarList);
+}
@@ -0,0 +1,745 @@
+/** @file
+  Host based micro-benchmarks of ConfigVariableListLib, ConfigKnobShimDxeLib and ConfigBase64Lib.
+
+  The strategies applying settings to variable storage and the knob shim reads are also run against the mocked variable
+  store, which reports their simulated flash cost.
+
+  Results are printed on stdout as one JSON object per line, see SetupDataPkgBenchmark.h.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/ConfigVariableListLib.h>
+#include <Library/ConfigKnobShimLib.h>
+#include <Library/ConfigBase64Lib.h>
+#include <Library/MockVariableStoreLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include <SetupDataPkgBenchmark.h>
+
+#define VAR_LIST_SUITE_NAME   "ConfigVariableListLib"
+#define KNOB_SHIM_SUITE_NAME  "ConfigKnobShimDxeLib"
+#define BASE64_SUITE_NAME     "ConfigBase64Lib"
+#define VAR_STORE_SUITE_NAME  "MockVariableStoreLib"
+
+//
+// Number of distinct knobs looked up by the single query benchmarks, spread evenly over the list.
+//
+#define LOOKUP_KNOB_COUNT  16
+
+//
+// One knob out of CHANGED_KNOB_STRIDE is changed when settings are applied to a populated variable store, as a
+// typical SVD changes a few settings of the current configuration.
+//
+#define CHANGED_KNOB_STRIDE  10
+
+//
+// Ways of applying settings to variable storage.
+//
+typedef enum {
+  ApplyDeleteThenWrite,   // Delete each variable then write it, as ConfApp does to allow size or attribute changes
+  ApplyOverwrite,         // Write each variable, the variable store skips identical ones
+  ApplySkipUnchanged,     // Read each variable first, delete then write only the ones that differ
+  ApplyStrategyMax
+} APPLY_STRATEGY;
+
+STATIC CONST CHAR8  *mApplyStrategyNames[ApplyStrategyMax] = {
+  "ApplyDeleteThenWrite",
+  "ApplyOverwrite",
+  "ApplySkipUnchanged"
+};
+
+//
+// Variable storage served by the mocked GetVariable, sorted by name.
+//
+STATIC CONFIG_VAR_LIST_ENTRY  *mVariableStore      = NULL;
+STATIC UINTN                  mVariableStoreCount = 0;
+
+/**
+  Mocked version of GetVariable, backed by mVariableStore.
+
+  The synthetic knob names have a fixed width index suffix, so the store is sorted by name and
+  can be binary searched, keeping the cost of the mock out of the measurement.
+
+  @param[in]       VariableName  A Null-terminated string that is the name of the vendor's
+                                 variable.
+  @param[in]       VendorGuid    A unique identifier for the vendor.
+  @param[out]      Attributes    If not NULL, a pointer to the memory location to return the
+                                 attributes bitmask for the variable.
+  @param[in, out]  DataSize      On input, the size in bytes of the return Data buffer.
+                                 On output the size of data returned in Data.
+  @param[out]      Data          The buffer to return the contents of the variable. May be NULL
+                                 with a zero DataSize in order to determine the size buffer needed.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The variable was not found.
+  @retval EFI_BUFFER_TOO_SMALL   The DataSize is too small for the result.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes     OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data           OPTIONAL
+  )
+{
+  UINTN                  Low;
+  UINTN                  High;
+  UINTN                  Middle;
+  INTN                   Compare;
+  CONFIG_VAR_LIST_ENTRY  *Entry;
+
+  Low  = 0;
+  High = mVariableStoreCount;
+  while (Low < High) {
+    Middle  = Low + (High - Low) / 2;
+    Entry   = &mVariableStore[Middle];
+    Compare = StrCmp (VariableName, Entry->Name);
+    if (Compare == 0) {
+      if (!CompareGuid (VendorGuid, &Entry->Guid)) {
+        break;
+      }
+
+      if (*DataSize < Entry->DataSize) {
+        *DataSize = Entry->DataSize;
+        return EFI_BUFFER_TOO_SMALL;
+      }
+
+      *DataSize = Entry->DataSize;
+      CopyMem (Data, Entry->Data, Entry->DataSize);
+      if (Attributes != NULL) {
+        *Attributes = Entry->Attributes;
+      }
+
+      return EFI_SUCCESS;
+    } else if (Compare < 0) {
+      High = Middle;
+    } else {
+      Low = Middle + 1;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+///
+/// Mock version of the UEFI Runtime Services Table
+///
+EFI_RUNTIME_SERVICES  MockRuntime = {
+  .GetVariable = BenchmarkGetVariable
+};
+
+/**
+  Benchmark parsing a whole variable list.
+
+  @param[in]  VarList      The variable list.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+**/
+STATIC
+VOID
+BenchmarkRetrieveActiveConfigVarList (
+  IN  VOID   *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount
+  )
+{
+  EFI_STATUS             Status;
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarList;
+  UINTN                  ConfigVarListCount;
+  UINTN                  Iterations;
+  UINTN                  Index;
+  UINT64                 Start;
+  UINT64                 Elapsed;
+
+  Iterations = BenchmarkGetIterations (KnobCount);
+  Elapsed    = 0;
+  for (Index = 0; Index < Iterations; Index++) {
+    ConfigVarList      = NULL;
+    ConfigVarListCount = 0;
+
+    Start   = BenchmarkGetTimeNs ();
+    Status  = RetrieveActiveConfigVarList (VarList, VarListSize, &ConfigVarList, &ConfigVarListCount);
+    Elapsed = Elapsed + BenchmarkGetTimeNs () - Start;
+    if (EFI_ERROR (Status) || (ConfigVarListCount != KnobCount)) {
+      BenchmarkReportError (
+        VAR_LIST_SUITE_NAME,
+        "RetrieveActiveConfigVarList",
+        KnobCount,
+        EFI_ERROR (Status) ? Status : EFI_COMPROMISED_DATA
+        );
+      BenchmarkFreeConfigVarList (ConfigVarList, ConfigVarListCount);
+      return;
+    }
+
+    BenchmarkFreeConfigVarList (ConfigVarList, ConfigVarListCount);
+  }
+
+  BenchmarkReport (VAR_LIST_SUITE_NAME, "RetrieveActiveConfigVarList", KnobCount, Iterations, Elapsed);
+}
+
+/**
+  Benchmark parsing a whole variable list into a single allocation.
+
+  @param[in]  VarList      The variable list.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+**/
+STATIC
+VOID
+BenchmarkRetrieveActiveConfigVarListArena (
+  IN  VOID   *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount
+  )
+{
+  EFI_STATUS             Status;
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarList;
+  UINTN                  ConfigVarListCount;
+  UINTN                  Iterations;
+  UINTN                  Index;
+  UINT64                 Start;
+  UINT64                 Elapsed;
+
+  Iterations = BenchmarkGetIterations (KnobCount);
+  Elapsed    = 0;
+  for (Index = 0; Index < Iterations; Index++) {
+    ConfigVarList      = NULL;
+    ConfigVarListCount = 0;
+
+    // Freeing is part of the measurement, it is the other half of the allocation cost
+    Start  = BenchmarkGetTimeNs ();
+    Status = RetrieveActiveConfigVarListArena (VarList, VarListSize, &ConfigVarList, &ConfigVarListCount);
+    FreeConfigVarList (ConfigVarList);
+    Elapsed = Elapsed + BenchmarkGetTimeNs () - Start;
+    if (EFI_ERROR (Status) || (ConfigVarListCount != KnobCount)) {
+      BenchmarkReportError (
+        VAR_LIST_SUITE_NAME,
+        "RetrieveActiveConfigVarListArena",
+        KnobCount,
+        EFI_ERROR (Status) ? Status : EFI_COMPROMISED_DATA
+        );
+      return;
+    }
+  }
+
+  BenchmarkReport (VAR_LIST_SUITE_NAME, "RetrieveActiveConfigVarListArena", KnobCount, Iterations, Elapsed);
+}
+
+/**
+  Benchmark looking up single knobs spread over a variable list, by unicode name, by ascii name and by
+  precomputed name key.
+
+  @param[in]  VarList      The variable list.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+**/
+STATIC
+VOID
+BenchmarkQuerySingleActiveConfigVarList (
+  IN  VOID   *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount
+  )
+{
+  EFI_STATUS                Status;
+  CHAR16                    UnicodeNames[LOOKUP_KNOB_COUNT][BENCHMARK_KNOB_NAME_LEN];
+  CHAR8                     AsciiNames[LOOKUP_KNOB_COUNT][BENCHMARK_KNOB_NAME_LEN];
+  CONFIG_VAR_LIST_NAME_KEY  Keys[LOOKUP_KNOB_COUNT];
+  CONFIG_VAR_LIST_ENTRY     Entry;
+  UINTN                     Iterations;
+  UINTN                     Index;
+  UINT64                    Start;
+  UINT64                    UnicodeElapsed;
+  UINT64                    AsciiElapsed;
+  UINT64                    KeyElapsed;
+
+  for (Index = 0; Index < LOOKUP_KNOB_COUNT; Index++) {
+    BenchmarkGetKnobName ((Index * KnobCount) / LOOKUP_KNOB_COUNT, UnicodeNames[Index]);
+    UnicodeStrToAsciiStrS (UnicodeNames[Index], AsciiNames[Index], BENCHMARK_KNOB_NAME_LEN);
+    InitConfigVarListNameKey (AsciiNames[Index], &Keys[Index]);
+  }
+
+  // Each lookup scans the list, so it counts as processing all of its knobs
+  Iterations     = BenchmarkGetIterations (KnobCount);
+  UnicodeElapsed = 0;
+  AsciiElapsed   = 0;
+  KeyElapsed     = 0;
+  for (Index = 0; Index < Iterations; Index++) {
+    Start          = BenchmarkGetTimeNs ();
+    Status         = QuerySingleActiveConfigUnicodeVarList (
+                       VarList,
+                       VarListSize,
+                       UnicodeNames[Index % LOOKUP_KNOB_COUNT],
+                       &Entry
+                       );
+    UnicodeElapsed = UnicodeElapsed + BenchmarkGetTimeNs () - Start;
+    if (EFI_ERROR (Status)) {
+      BenchmarkReportError (VAR_LIST_SUITE_NAME, "QuerySingleActiveConfigUnicodeVarList", KnobCount, Status);
+      return;
+    }
+
+    FreePool (Entry.Name);
+    FreePool (Entry.Data);
+
+    Start        = BenchmarkGetTimeNs ();
+    Status       = QuerySingleActiveConfigAsciiVarList (
+                     VarList,
+                     VarListSize,
+                     AsciiNames[Index % LOOKUP_KNOB_COUNT],
+                     &Entry
+                     );
+    AsciiElapsed = AsciiElapsed + BenchmarkGetTimeNs () - Start;
+    if (EFI_ERROR (Status)) {
+      BenchmarkReportError (VAR_LIST_SUITE_NAME, "QuerySingleActiveConfigAsciiVarList", KnobCount, Status);
+      return;
+    }
+
+    FreePool (Entry.Name);
+    FreePool (Entry.Data);
+
+    Start      = BenchmarkGetTimeNs ();
+    Status     = QuerySingleActiveConfigVarListByKey (VarList, VarListSize, &Keys[Index % LOOKUP_KNOB_COUNT], &Entry);
+    KeyElapsed = KeyElapsed + BenchmarkGetTimeNs () - Start;
+    if (EFI_ERROR (Status)) {
+      BenchmarkReportError (VAR_LIST_SUITE_NAME, "QuerySingleActiveConfigVarListByKey", KnobCount, Status);
+      return;
+    }
+
+    FreePool (Entry.Name);
+    FreePool (Entry.Data);
+  }
+
+  BenchmarkReport (VAR_LIST_SUITE_NAME, "QuerySingleActiveConfigUnicodeVarList", KnobCount, Iterations, UnicodeElapsed);
+  BenchmarkReport (VAR_LIST_SUITE_NAME, "QuerySingleActiveConfigAsciiVarList", KnobCount, Iterations, AsciiElapsed);
+  BenchmarkReport (VAR_LIST_SUITE_NAME, "QuerySingleActiveConfigVarListByKey", KnobCount, Iterations, KeyElapsed);
+}
+
+/**
+  Benchmark serializing all knobs of a parsed list back into a variable list.
+
+  @param[in]  ConfigVarList  The parsed knobs.
+  @param[in]  KnobCount      Number of knobs in ConfigVarList.
+  @param[in]  VarListSize    Size in bytes of the serialized knobs.
+**/
+STATIC
+VOID
+BenchmarkConvertVariableEntryToVariableList (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                  KnobCount,
+  IN  UINTN                  VarListSize
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *Buffer;
+  UINTN       Size;
+  UINTN       Offset;
+  UINTN       Iterations;
+  UINTN       Index;
+  UINTN       KnobIndex;
+  UINT64      Start;
+
+  Status = EFI_SUCCESS;
+  Buffer = AllocatePool (VarListSize);
+  if (Buffer == NULL) {
+    BenchmarkReportError (VAR_LIST_SUITE_NAME, "ConvertVariableEntryToVariableList", KnobCount, EFI_OUT_OF_RESOURCES);
+    return;
+  }
+
+  Iterations = BenchmarkGetIterations (KnobCount);
+  Start      = BenchmarkGetTimeNs ();
+  for (Index = 0; Index < Iterations && !EFI_ERROR (Status); Index++) {
+    Offset = 0;
+    for (KnobIndex = 0; KnobIndex < KnobCount; KnobIndex++) {
+      Size   = VarListSize - Offset;
+      Status = ConvertVariableEntryToVariableList (&ConfigVarList[KnobIndex], Buffer + Offset, &Size);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      Offset += Size;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (VAR_LIST_SUITE_NAME, "ConvertVariableEntryToVariableList", KnobCount, Status);
+  } else {
+    BenchmarkReport (
+      VAR_LIST_SUITE_NAME,
+      "ConvertVariableEntryToVariableList",
+      KnobCount,
+      Iterations,
+      BenchmarkGetTimeNs () - Start
+      );
+  }
+
+  FreePool (Buffer);
+}
+
+/**
+  Benchmark fetching the override of every knob of a variable storage holding all of them.
+
+  @param[in]  ConfigVarList  The parsed knobs, used as variable storage.
+  @param[in]  KnobCount      Number of knobs in ConfigVarList.
+**/
+STATIC
+VOID
+BenchmarkGetConfigKnobOverride (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                  KnobCount
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Data;
+  UINTN       Iterations;
+  UINTN       Index;
+  UINTN       KnobIndex;
+  UINT64      Start;
+
+  mVariableStore      = ConfigVarList;
+  mVariableStoreCount = KnobCount;
+
+  Status     = EFI_SUCCESS;
+  Iterations = BenchmarkGetIterations (KnobCount);
+  Start      = BenchmarkGetTimeNs ();
+  for (Index = 0; Index < Iterations && !EFI_ERROR (Status); Index++) {
+    for (KnobIndex = 0; KnobIndex < KnobCount; KnobIndex++) {
+      Status = GetConfigKnobOverride (&gBenchmarkKnobGuid, ConfigVarList[KnobIndex].Name, &Data, sizeof (Data));
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (KNOB_SHIM_SUITE_NAME, "GetConfigKnobOverride", KnobCount, Status);
+  } else {
+    BenchmarkReport (
+      KNOB_SHIM_SUITE_NAME,
+      "GetConfigKnobOverride",
+      KnobCount,
+      Iterations,
+      BenchmarkGetTimeNs () - Start
+      );
+  }
+
+  mVariableStore      = NULL;
+  mVariableStoreCount = 0;
+}
+
+/**
+  Benchmark Base64 encoding and decoding a whole variable list as a single SVD setting value, with BaseLib sizing the
+  destination with a first call as ConfApp used to, and with ConfigBase64Lib in a single pass.
+
+  @param[in]  VarList      The variable list.
+  @param[in]  VarListSize  Size in bytes of VarList.
+  @param[in]  KnobCount    Number of knobs in VarList.
+**/
+STATIC
+VOID
+BenchmarkBase64 (
+  IN  VOID   *VarList,
+  IN  UINTN  VarListSize,
+  IN  UINTN  KnobCount
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *Encoded;
+  UINT8       *Decoded;
+  UINTN       EncodedSize;
+  UINTN       DecodedSize;
+  UINTN       Size;
+  UINTN       Iterations;
+  UINTN       Index;
+  UINT64      Start;
+
+  EncodedSize = CONFIG_BASE64_ENCODED_SIZE (VarListSize);
+  DecodedSize = CONFIG_BASE64_DECODED_MAX_SIZE (EncodedSize - 1);
+  Encoded     = AllocatePool (EncodedSize);
+  Decoded     = AllocatePool (DecodedSize);
+  if ((Encoded == NULL) || (Decoded == NULL)) {
+    BenchmarkReportError (BASE64_SUITE_NAME, "ConfigBase64Encode", KnobCount, EFI_OUT_OF_RESOURCES);
+    goto Exit;
+  }
+
+  Status     = EFI_SUCCESS;
+  Iterations = BenchmarkGetIterations (KnobCount);
+  Start      = BenchmarkGetTimeNs ();
+  for (Index = 0; Index < Iterations && !EFI_ERROR (Status); Index++) {
+    Size   = 0;
+    Status = Base64Encode (VarList, VarListSize, NULL, &Size);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      Status = Base64Encode (VarList, VarListSize, Encoded, &Size);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (BASE64_SUITE_NAME, "Base64Encode", KnobCount, Status);
+  } else {
+    BenchmarkReport (BASE64_SUITE_NAME, "Base64Encode", KnobCount, Iterations, BenchmarkGetTimeNs () - Start);
+  }
+
+  Start = BenchmarkGetTimeNs ();
+  for (Index = 0; Index < Iterations && !EFI_ERROR (Status); Index++) {
+    Size   = EncodedSize;
+    Status = ConfigBase64Encode (VarList, VarListSize, Encoded, &Size);
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (BASE64_SUITE_NAME, "ConfigBase64Encode", KnobCount, Status);
+  } else {
+    BenchmarkReport (BASE64_SUITE_NAME, "ConfigBase64Encode", KnobCount, Iterations, BenchmarkGetTimeNs () - Start);
+  }
+
+  Start = BenchmarkGetTimeNs ();
+  for (Index = 0; Index < Iterations && !EFI_ERROR (Status); Index++) {
+    Size   = 0;
+    Status = Base64Decode (Encoded, EncodedSize - 1, NULL, &Size);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      Status = Base64Decode (Encoded, EncodedSize - 1, Decoded, &Size);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (BASE64_SUITE_NAME, "Base64Decode", KnobCount, Status);
+  } else {
+    BenchmarkReport (BASE64_SUITE_NAME, "Base64Decode", KnobCount, Iterations, BenchmarkGetTimeNs () - Start);
+  }
+
+  Start = BenchmarkGetTimeNs ();
+  for (Index = 0; Index < Iterations && !EFI_ERROR (Status); Index++) {
+    Size   = DecodedSize;
+    Status = ConfigBase64Decode (Encoded, EncodedSize - 1, Decoded, &Size);
+  }
+
+  if (!EFI_ERROR (Status) && ((Size != VarListSize) || (CompareMem (Decoded, VarList, VarListSize) != 0))) {
+    Status = EFI_COMPROMISED_DATA;
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (BASE64_SUITE_NAME, "ConfigBase64Decode", KnobCount, Status);
+  } else {
+    BenchmarkReport (BASE64_SUITE_NAME, "ConfigBase64Decode", KnobCount, Iterations, BenchmarkGetTimeNs () - Start);
+  }
+
+Exit:
+  if (Encoded != NULL) {
+    FreePool (Encoded);
+  }
+
+  if (Decoded != NULL) {
+    FreePool (Decoded);
+  }
+}
+
+/**
+  Apply every entry of a list of variable entries to variable storage.
+
+  @param[in]  Strategy       How the entries are applied.
+  @param[in]  ConfigVarList  The entries to apply.
+  @param[in]  KnobCount      Number of entries in ConfigVarList.
+
+  @retval EFI_SUCCESS  All the entries were applied.
+  @retval Others       An entry could not be written.
+**/
+STATIC
+EFI_STATUS
+BenchmarkApplyConfigVarList (
+  IN  APPLY_STRATEGY         Strategy,
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                  KnobCount
+  )
+{
+  EFI_STATUS             Status;
+  CONFIG_VAR_LIST_ENTRY  *Entry;
+  UINT32                 Attributes;
+  UINT64                 Data;
+  UINTN                  DataSize;
+  UINTN                  Index;
+
+  for (Index = 0; Index < KnobCount; Index++) {
+    Entry = &ConfigVarList[Index];
+    if (Strategy == ApplySkipUnchanged) {
+      DataSize = sizeof (Data);
+      Status   = gRT->GetVariable (Entry->Name, &Entry->Guid, &Attributes, &DataSize, &Data);
+      if (!EFI_ERROR (Status) && (Attributes == Entry->Attributes) && (DataSize == Entry->DataSize) &&
+          (CompareMem (&Data, Entry->Data, DataSize) == 0))
+      {
+        continue;
+      }
+    }
+
+    if (Strategy != ApplyOverwrite) {
+      gRT->SetVariable (Entry->Name, &Entry->Guid, 0, 0, NULL);
+    }
+
+    Status = gRT->SetVariable (Entry->Name, &Entry->Guid, Entry->Attributes, Entry->DataSize, Entry->Data);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Flip the lowest bit of one knob out of CHANGED_KNOB_STRIDE, calling it twice restores the list.
+
+  @param[in]  ConfigVarList  The parsed knobs.
+  @param[in]  KnobCount      Number of knobs in ConfigVarList.
+**/
+STATIC
+VOID
+BenchmarkToggleChangedKnobs (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                  KnobCount
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < KnobCount; Index += CHANGED_KNOB_STRIDE) {
+    *(UINT8 *)ConfigVarList[Index].Data ^= 1;
+  }
+}
+
+/**
+  Benchmark the simulated flash cost of applying settings to a variable store holding all the knobs, with every
+  strategy, then of fetching the override of every knob through the knob shim.
+
+  @param[in]  ConfigVarList  The parsed knobs.
+  @param[in]  KnobCount      Number of knobs in ConfigVarList.
+**/
+STATIC
+VOID
+BenchmarkVariableStore (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                  KnobCount
+  )
+{
+  EFI_STATUS                 Status;
+  MOCK_VARIABLE_STORE_STATS  Stats;
+  APPLY_STRATEGY             Strategy;
+  UINT32                     Data;
+  UINTN                      KnobIndex;
+
+  MockRuntime.GetVariable = MockVariableStoreGetVariable;
+  MockRuntime.SetVariable = MockVariableStoreSetVariable;
+
+  for (Strategy = 0; Strategy < ApplyStrategyMax; Strategy++) {
+    Status = BenchmarkInitializeVariableStore (KnobCount);
+    if (!EFI_ERROR (Status)) {
+      Status = BenchmarkApplyConfigVarList (ApplyOverwrite, ConfigVarList, KnobCount);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      BenchmarkToggleChangedKnobs (ConfigVarList, KnobCount);
+      MockVariableStoreResetStats ();
+      Status = BenchmarkApplyConfigVarList (Strategy, ConfigVarList, KnobCount);
+      MockVariableStoreGetStats (&Stats);
+      BenchmarkToggleChangedKnobs (ConfigVarList, KnobCount);
+    }
+
+    if (EFI_ERROR (Status)) {
+      BenchmarkReportError (VAR_STORE_SUITE_NAME, mApplyStrategyNames[Strategy], KnobCount, Status);
+    } else {
+      BenchmarkReportVariableStore (VAR_STORE_SUITE_NAME, mApplyStrategyNames[Strategy], KnobCount, &Stats);
+    }
+  }
+
+  // The store holds all the knobs, one out of CHANGED_KNOB_STRIDE changed, unless the last strategy failed
+  MockVariableStoreResetStats ();
+  for (KnobIndex = 0; KnobIndex < KnobCount && !EFI_ERROR (Status); KnobIndex++) {
+    Status = GetConfigKnobOverride (&gBenchmarkKnobGuid, ConfigVarList[KnobIndex].Name, &Data, sizeof (Data));
+  }
+
+  if (EFI_ERROR (Status)) {
+    BenchmarkReportError (VAR_STORE_SUITE_NAME, "GetConfigKnobOverride", KnobCount, Status);
+  } else {
+    MockVariableStoreGetStats (&Stats);
+    BenchmarkReportVariableStore (VAR_STORE_SUITE_NAME, "GetConfigKnobOverride", KnobCount, &Stats);
+  }
+
+  MockVariableStoreFree ();
+  MockRuntime.GetVariable = BenchmarkGetVariable;
+  MockRuntime.SetVariable = NULL;
+}
+
+/**
+  Run all library benchmarks against synthetic variable lists of growing size.
+
+  @param[in]  MaxKnobCount  Largest knob count to benchmark.
+
+  @retval EFI_SUCCESS  All benchmarks ran, failures of individual benchmarks are reported in the output.
+  @retval Others       A synthetic variable list could not be created.
+**/
+STATIC
+EFI_STATUS
+BenchmarkEntry (
+  IN  UINTN  MaxKnobCount
+  )
+{
+  EFI_STATUS             Status;
+  VOID                   *VarList;
+  UINTN                  VarListSize;
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarList;
+  UINTN                  ConfigVarListCount;
+  UINTN                  KnobCount;
+
+  Status = EFI_SUCCESS;
+  for (KnobCount = BENCHMARK_MIN_KNOB_COUNT;
+       KnobCount <= MaxKnobCount;
+       KnobCount = BenchmarkNextKnobCount (KnobCount))
+  {
+    VarList = NULL;
+    Status  = BenchmarkCreateVarList (KnobCount, &VarList, &VarListSize);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to create a variable list of %u knobs - %r\n", __func__, KnobCount, Status));
+      break;
+    }
+
+    BenchmarkRetrieveActiveConfigVarList (VarList, VarListSize, KnobCount);
+    BenchmarkRetrieveActiveConfigVarListArena (VarList, VarListSize, KnobCount);
+    BenchmarkQuerySingleActiveConfigVarList (VarList, VarListSize, KnobCount);
+    BenchmarkBase64 (VarList, VarListSize, KnobCount);
+
+    ConfigVarList      = NULL;
+    ConfigVarListCount = 0;
+    Status             = RetrieveActiveConfigVarList (VarList, VarListSize, &ConfigVarList, &ConfigVarListCount);
+    if (!EFI_ERROR (Status)) {
+      BenchmarkConvertVariableEntryToVariableList (ConfigVarList, ConfigVarListCount, VarListSize);
+      BenchmarkGetConfigKnobOverride (ConfigVarList, ConfigVarListCount);
+      BenchmarkVariableStore (ConfigVarList, ConfigVarListCount);
+      BenchmarkFreeConfigVarList (ConfigVarList, ConfigVarListCount);
+    }
+
+    FreePool (VarList);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to parse a variable list of %u knobs - %r\n", __func__, KnobCount, Status));
+      break;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based benchmark execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return EFI_ERROR (BenchmarkEntry (BenchmarkGetMaxKnobCount (argc, argv))) ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+# @ VariableListBenchmark.py
+#
+# Benchmark of the binary and value literal serialization of VariableList, reported in the same JSON lines format as
+# the host based SetupDataPkg benchmarks.
+#
+# Copyright (c) 2025, Microsoft Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+#
+
+import argparse
+import importlib.util
+import json
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Tools'))
+
+import VariableList  # noqa: E402
+
+SUITE = 'VariableList'
+NAMESPACE = 'FE3ED49F-B173-41ED-9076-356661D46A42'
+
+
+def generate_schema(knob_count, array_count):
+    """Generate a schema with knob_count knobs of large arrays of scalars and of structs."""
+    lines = ['<ConfigSchema>', '  <Enums>',
+             '    <Enum name="mode_t"><Value name="OFF" value="0" /><Value name="ON" value="1" /></Enum>',
+             '  </Enums>', '  <Structs>',
+             '    <Struct name="entry_t">',
+             '      <Member name="id" type="uint32_t" />',
+             '      <Member name="mode" type="mode_t" />',
+             '      <Member name="data" type="uint8_t" count="8" />',
+             '    </Struct>',
+             '    <Struct name="table_t">',
+             f'      <Member name="bytes" type="uint8_t" count="{array_count}" />',
+             f'      <Member name="words" type="uint32_t" count="{array_count // 4}" />',
+             f'      <Member name="entries" type="entry_t" count="{array_count // 32}" />',
+             '    </Struct>', '  </Structs>',
+             f'  <Knobs namespace="{{{NAMESPACE}}}">']
+    for index in range(knob_count):
+        lines.append(f'    <Knob name="Table{index}" type="table_t" />')
+        lines.append(f'    <Knob name="Value{index}" type="uint32_t" default="{index}" />')
+    lines += ['  </Knobs>', '</ConfigSchema>']
+    return '\n'.join(lines)
+
+
+def load_schema(module, schema_xml):
+    schema = module.Schema.parse(schema_xml)
+    for index, knob in enumerate(schema.knobs):
+        value = knob.default
+        if isinstance(value, dict):
+            value['bytes'] = [(index + i) & 0xff for i in range(len(value['bytes']))]
+            value['words'] = [(index * i) & 0xffffffff for i in range(len(value['words']))]
+        knob.value = value
+    return schema
+
+
+def measure(function, iterations):
+    """Return the total nanoseconds of iterations calls of function and its last result."""
+    result = None
+    begin = time.perf_counter_ns()
+    for _ in range(iterations):
+        result = function()
+    return time.perf_counter_ns() - begin, result
+
+
+def load_baseline(path):
+    """Load another revision of VariableList.py to compare against."""
+    sys.path.insert(0, os.path.dirname(os.path.abspath(path)))
+    spec = importlib.util.spec_from_file_location('VariableListBaseline', path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    sys.path.pop(0)
+    return module
+
+
+def to_binary(module, schema):
+    return lambda: module.vlist_to_binary(schema)
+
+
+def from_binary(module, schema, binary):
+    def decode():
+        values = []
+        for variable in module.read_vlist_from_buffer(binary):
+            knob = schema.get_knob(variable.guid, variable.name)
+            values.append(knob.format.binary_to_object(variable.data))
+        return values
+    return decode
+
+
+def from_strings(module, schema, strings):
+    return lambda: [knob.format.string_to_object(string) for knob, string in zip(schema.knobs, strings)]
+
+
+def run(benchmark, knob_count, array_count, iterations, baseline=None):
+    schema_xml = generate_schema(knob_count, array_count)
+    schema = load_schema(VariableList, schema_xml)
+    binary = VariableList.vlist_to_binary(schema)
+    strings = [knob.format.object_to_string(knob.value) for knob in schema.knobs]
+    functions = {'VlistToBinary': to_binary, 'BinaryToObjects': lambda module, schema: from_binary(
+        module, schema, binary), 'StringsToObjects': lambda module, schema: from_strings(module, schema, strings)}
+
+    results = []
+    for name, function in functions.items():
+        total_ns, output = measure(function(VariableList, schema), iterations)
+        result = {
+            'suite': SUITE,
+            'benchmark': f'{benchmark}{name}',
+            'knobs': len(schema.knobs),
+            'bytes': len(binary),
+            'iterations': iterations,
+            'total_ns': total_ns,
+            'ns_per_op': total_ns // iterations
+        }
+        if baseline is not None:
+            baseline_schema = load_schema(baseline, schema_xml)
+            baseline_ns, baseline_output = measure(function(baseline, baseline_schema), iterations)
+            result['baseline_ns_per_op'] = baseline_ns // iterations
+            result['speedup'] = round(baseline_ns / total_ns, 2)
+            result['identical'] = baseline_output == output
+        print(json.dumps(result), flush=True)
+        results.append(result)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark of the serialization of VariableList.')
+    parser.add_argument('--knobs', type=int, nargs='+', default=[16, 64], help='Array knob counts of the schemas.')
+    parser.add_argument('--array', type=int, default=4096, help='Elements of the byte array of each knob.')
+    parser.add_argument('--iterations', type=int, default=5, help='Serializations per benchmark.')
+    parser.add_argument('--baseline', help='Another revision of VariableList.py to compare against.')
+    args = parser.parse_args()
+
+    baseline = load_baseline(args.baseline) if args.baseline else None
+
+    results = []
+    for knob_count in args.knobs:
+        results += run(f'LargeArrays{knob_count}', knob_count, args.array, args.iterations, baseline)
+
+    return 1 if any(result.get('identical') is False for result in results) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
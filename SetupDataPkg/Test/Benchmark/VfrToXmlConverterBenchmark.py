@@ -0,0 +1,162 @@
+# @ VfrToXmlConverterBenchmark.py
+#
+# Benchmark of the VFR parsing stages of VfrToXmlConverter, reported in the same JSON lines format as the host based
+# SetupDataPkg benchmarks.
+#
+# Copyright (c) 2025, Microsoft Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+#
+
+import argparse
+import importlib.util
+import json
+import os
+import random
+import sys
+import time
+import xml.etree.ElementTree as ET
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Tools'))
+
+import VfrToXmlConverter  # noqa: E402
+
+SUITE = 'VfrToXmlConverter'
+VARSTORE_COUNT = 4
+
+
+def generate_vfr(question_count, seed=1):
+    """Generate a synthetic VFR with question_count questions, some of them under suppressif statements."""
+    rand = random.Random(seed)
+    lines = ['formset guid = {0x1, 0x2, 0x3, {0, 0, 0, 0, 0, 0, 0, 0}},',
+             '  title = STRING_TOKEN(STR_TITLE), help = STRING_TOKEN(STR_TITLE),']
+    for index in range(VARSTORE_COUNT):
+        lines.append(f'  efivarstore CFG{index}_T, attribute = 0x7, name = Cfg{index},'
+                     f' guid = {{0x1, 0x2, 0x3, {{0, 0, 0, 0, 0, 0, 0, {index}}}}};')
+    lines.append('  form formid = 1, title = STRING_TOKEN(STR_TITLE);')
+    for index in range(question_count):
+        varstore = index % VARSTORE_COUNT
+        conditional = rand.random() < 0.3
+        if conditional:
+            lines.append(f'    suppressif ideqval Cfg{(varstore + 1) % VARSTORE_COUNT}.Knob{max(index - 3, 0)} =='
+                         f' {rand.randint(0, 1)} OR NOT ideqval Cfg{varstore}.Knob{max(index - 1, 0)} == 0;')
+        header = (f'    {{}} varid = Cfg{varstore}.Knob{index},\n'
+                  f'      prompt = STRING_TOKEN(STR_PROMPT{index}),\n'
+                  f'      help = STRING_TOKEN(STR_HELP{index}),')
+        kind = rand.random()
+        if kind < 0.6:
+            lines.append(header.format('oneof'))
+            for value in range(3):
+                flags = 'DEFAULT' if value == 0 else '0'
+                lines.append(f'      option text = STRING_TOKEN(STR_OPTION{value}), value = {value},'
+                             f' flags = {flags} | RESET_REQUIRED;')
+            lines.append('    endoneof;')
+        elif kind < 0.85:
+            lines.append(header.format('numeric'))
+            lines.append(f'      minimum = 0,\n      maximum = 255,\n      step = 1,\n'
+                         f'      default = {rand.randint(0, 255)},\n    endnumeric;')
+        else:
+            lines.append(header.format('checkbox'))
+            lines.append('      flags = 0,\n    endcheckbox;')
+        if conditional:
+            lines.append('    endif;')
+        if index % 50 == 0:
+            lines.append('    // Line comment\n    /* Block\n       comment */')
+    lines.append('  endform;\nendformset;')
+    return '\n'.join(lines) + '\n'
+
+
+def generate_uni(question_count):
+    """Generate the strings referenced by generate_vfr."""
+    uni_str_dict = {'STR_TITLE': 'Title'}
+    for index in range(question_count):
+        uni_str_dict[f'STR_PROMPT{index}'] = f'Knob {index}'
+        uni_str_dict[f'STR_HELP{index}'] = f'Help of knob {index}'
+    for value in range(3):
+        uni_str_dict[f'STR_OPTION{value}'] = f'Option {value}'
+    return uni_str_dict
+
+
+def convert(converter, vfr_content, uni_str_dict):
+    """Run the VFR parsing stages of converter over vfr_content and return the resulting schema as a string."""
+    root = ET.Element('ConfigSchema')
+    ET.SubElement(root, 'Enums')
+    ET.SubElement(root, 'Structs')
+    structs = {}
+    repeated_items = []
+    vfr_content = converter.vfr_remove_comments(vfr_content)
+    converter.parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items, 0)
+    vfr_content = converter.vfr_process_statements(vfr_content, structs)
+    converter.parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items, 1)
+    return ET.tostring(root, encoding='unicode')
+
+
+def measure(converter, vfr_content, uni_str_dict, iterations):
+    """Return the total nanoseconds of iterations conversions and the schema of the last one."""
+    schema = None
+    begin = time.perf_counter_ns()
+    for _ in range(iterations):
+        schema = convert(converter, vfr_content, uni_str_dict)
+    return time.perf_counter_ns() - begin, schema
+
+
+def load_baseline(path):
+    """Load another revision of VfrToXmlConverter.py to compare against."""
+    sys.path.insert(0, os.path.dirname(os.path.abspath(path)))
+    spec = importlib.util.spec_from_file_location('VfrToXmlConverterBaseline', path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    sys.path.pop(0)
+    return module
+
+
+def run(benchmark, vfr_content, uni_str_dict, iterations, baseline=None):
+    questions = len(VfrToXmlConverter.VfrTokenizer.parse_questions(VfrToXmlConverter.vfr_remove_comments(vfr_content)))
+    total_ns, schema = measure(VfrToXmlConverter, vfr_content, uni_str_dict, iterations)
+    result = {
+        'suite': SUITE,
+        'benchmark': benchmark,
+        'questions': questions,
+        'iterations': iterations,
+        'total_ns': total_ns,
+        'ns_per_op': total_ns // iterations
+    }
+    if baseline is not None:
+        baseline_ns, baseline_schema = measure(baseline, vfr_content, uni_str_dict, iterations)
+        result['baseline_ns_per_op'] = baseline_ns // iterations
+        result['speedup'] = round(baseline_ns / total_ns, 2)
+        result['identical'] = baseline_schema == schema
+    print(json.dumps(result), flush=True)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark of the VFR parsing stages of VfrToXmlConverter.')
+    parser.add_argument('--questions', type=int, nargs='+', default=[500, 2000, 4000],
+                        help='Question counts of the synthetic VFRs.')
+    parser.add_argument('--iterations', type=int, default=3, help='Conversions per benchmark.')
+    parser.add_argument('--vfr', nargs='*', default=[],
+                        help='Preprocessed VFR files (e.g. *.vfr.dump.i) to benchmark in addition.')
+    parser.add_argument('--uni', nargs='*', default=[], help='UNI files of the VFR files given with --vfr.')
+    parser.add_argument('--baseline', help='Another revision of VfrToXmlConverter.py to compare against.')
+    args = parser.parse_args()
+
+    VfrToXmlConverter.logging.disable(VfrToXmlConverter.logging.WARNING)
+    baseline = load_baseline(args.baseline) if args.baseline else None
+
+    results = []
+    for question_count in args.questions:
+        results.append(run(f'SyntheticVfr{question_count}', generate_vfr(question_count),
+                           generate_uni(question_count), args.iterations, baseline))
+
+    uni_str_dict = VfrToXmlConverter.load_string_from_uni(args.uni) if args.uni else {}
+    for vfr_file_name in args.vfr:
+        with open(vfr_file_name, 'r') as vfr_file:
+            vfr_content = vfr_file.read()
+        results.append(run(os.path.basename(vfr_file_name), vfr_content, uni_str_dict, args.iterations, baseline))
+
+    return 1 if any(result.get('identical') is False for result in results) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -79,6 +79,100 @@ UINT8  mKnown_Good_Generic_Profile[] = {
   0x96, 0x60, 0xF6
 };
 
+/*
+  The known good generic profile above, re-encoded in the v2 variable list format
+  with interned names and namespace guids
+*/
+UINT8  mKnown_Good_Generic_Profile_V2[] = {
+  0x43, 0x56, 0x4C, 0x32, 0x02, 0x00, 0x14, 0x00, 0x02, 0x00, 0x00, 0x00, 0x3E, 0x01, 0x00, 0x00,
+  0x37, 0xB7, 0x5F, 0x9E, 0x9F, 0x55, 0x64, 0x76, 0x9E, 0x82, 0xE8, 0x48, 0xA4, 0x73, 0xF1, 0x2A,
+  0xDA, 0xD1, 0xDD, 0xD2, 0xFE, 0x3E, 0xD4, 0x9F, 0xB1, 0x73, 0x41, 0xED, 0x90, 0x76, 0x35, 0x66,
+  0x61, 0xD4, 0x6A, 0x42, 0x44, 0x00, 0x65, 0x00, 0x76, 0x00, 0x69, 0x00, 0x63, 0x00, 0x65, 0x00,
+  0x2E, 0x00, 0x43, 0x00, 0x6F, 0x00, 0x6E, 0x00, 0x66, 0x00, 0x69, 0x00, 0x67, 0x00, 0x44, 0x00,
+  0x61, 0x00, 0x74, 0x00, 0x61, 0x00, 0x2E, 0x00, 0x54, 0x00, 0x61, 0x00, 0x67, 0x00, 0x49, 0x00,
+  0x44, 0x00, 0x5F, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x32, 0x00,
+  0x38, 0x00, 0x30, 0x00, 0x00, 0x00, 0x44, 0x00, 0x65, 0x00, 0x76, 0x00, 0x69, 0x00, 0x63, 0x00,
+  0x65, 0x00, 0x2E, 0x00, 0x43, 0x00, 0x6F, 0x00, 0x6E, 0x00, 0x66, 0x00, 0x69, 0x00, 0x67, 0x00,
+  0x44, 0x00, 0x61, 0x00, 0x74, 0x00, 0x61, 0x00, 0x2E, 0x00, 0x54, 0x00, 0x61, 0x00, 0x67, 0x00,
+  0x49, 0x00, 0x44, 0x00, 0x5F, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00,
+  0x33, 0x00, 0x30, 0x00, 0x30, 0x00, 0x00, 0x00, 0x43, 0x00, 0x4F, 0x00, 0x4D, 0x00, 0x50, 0x00,
+  0x4C, 0x00, 0x45, 0x00, 0x58, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00,
+  0x31, 0x00, 0x61, 0x00, 0x00, 0x00, 0x43, 0x00, 0x4F, 0x00, 0x4D, 0x00, 0x50, 0x00, 0x4C, 0x00,
+  0x45, 0x00, 0x58, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x31, 0x00,
+  0x62, 0x00, 0x00, 0x00, 0x43, 0x00, 0x4F, 0x00, 0x4D, 0x00, 0x50, 0x00, 0x4C, 0x00, 0x45, 0x00,
+  0x58, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x32, 0x00, 0x00, 0x00,
+  0x49, 0x00, 0x4E, 0x00, 0x54, 0x00, 0x45, 0x00, 0x47, 0x00, 0x45, 0x00, 0x52, 0x00, 0x5F, 0x00,
+  0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x00, 0x00, 0x42, 0x00, 0x4F, 0x00, 0x4F, 0x00,
+  0x4C, 0x00, 0x45, 0x00, 0x41, 0x00, 0x4E, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00,
+  0x42, 0x00, 0x00, 0x00, 0x44, 0x00, 0x4F, 0x00, 0x55, 0x00, 0x42, 0x00, 0x4C, 0x00, 0x45, 0x00,
+  0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x00, 0x00, 0x46, 0x00, 0x4C, 0x00,
+  0x4F, 0x00, 0x41, 0x00, 0x54, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x08, 0x00,
+  0x00, 0x00, 0x43, 0x43, 0x76, 0x31, 0x00, 0x00, 0x00, 0x00, 0x2C, 0xDD, 0xCE, 0x1F, 0x42, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00,
+  0x00, 0x00, 0x78, 0xF6, 0x8B, 0xBB, 0x84, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00,
+  0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00, 0x3F,
+  0x44, 0x42, 0xB0, 0xA2, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x09,
+  0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x01, 0x00, 0x00, 0x00, 0x20, 0x01, 0x0B, 0xD3,
+  0xC0, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x16, 0x00, 0x00, 0x00,
+  0x02, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00, 0x06, 0x07, 0x08,
+  0x09, 0x0A, 0x01, 0x00, 0x00, 0x00, 0x0E, 0xEA, 0x57, 0x27, 0xDC, 0x00, 0x00, 0x00, 0x01, 0x00,
+  0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0xC9, 0xFB,
+  0xD2, 0x88, 0xF6, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x00,
+  0x00, 0x00, 0x01, 0x44, 0xEE, 0x73, 0x43, 0x10, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07,
+  0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x4A, 0xD8, 0x12, 0x4D, 0xFB, 0x21, 0x09, 0x40, 0xC3,
+  0x01, 0xB1, 0xD8, 0x28, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x04,
+  0x00, 0x00, 0x00, 0xF4, 0xFD, 0xB4, 0x3F, 0x7A, 0xCC, 0x7D, 0x83
+};
+
+/*
+  The known good generic profile above, re-encoded in the aligned v2 variable list format
+  where the data of every entry is 8 byte aligned from the start of the list
+*/
+UINT8  mKnown_Good_Generic_Profile_V2_Aligned[] = {
+  0x43, 0x56, 0x4C, 0x32, 0x03, 0x00, 0x14, 0x00, 0x02, 0x00, 0x00, 0x00, 0x44, 0x01, 0x00, 0x00,
+  0xBC, 0xC8, 0xB9, 0x6E, 0x9F, 0x55, 0x64, 0x76, 0x9E, 0x82, 0xE8, 0x48, 0xA4, 0x73, 0xF1, 0x2A,
+  0xDA, 0xD1, 0xDD, 0xD2, 0xFE, 0x3E, 0xD4, 0x9F, 0xB1, 0x73, 0x41, 0xED, 0x90, 0x76, 0x35, 0x66,
+  0x61, 0xD4, 0x6A, 0x42, 0x44, 0x00, 0x65, 0x00, 0x76, 0x00, 0x69, 0x00, 0x63, 0x00, 0x65, 0x00,
+  0x2E, 0x00, 0x43, 0x00, 0x6F, 0x00, 0x6E, 0x00, 0x66, 0x00, 0x69, 0x00, 0x67, 0x00, 0x44, 0x00,
+  0x61, 0x00, 0x74, 0x00, 0x61, 0x00, 0x2E, 0x00, 0x54, 0x00, 0x61, 0x00, 0x67, 0x00, 0x49, 0x00,
+  0x44, 0x00, 0x5F, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x32, 0x00,
+  0x38, 0x00, 0x30, 0x00, 0x00, 0x00, 0x44, 0x00, 0x65, 0x00, 0x76, 0x00, 0x69, 0x00, 0x63, 0x00,
+  0x65, 0x00, 0x2E, 0x00, 0x43, 0x00, 0x6F, 0x00, 0x6E, 0x00, 0x66, 0x00, 0x69, 0x00, 0x67, 0x00,
+  0x44, 0x00, 0x61, 0x00, 0x74, 0x00, 0x61, 0x00, 0x2E, 0x00, 0x54, 0x00, 0x61, 0x00, 0x67, 0x00,
+  0x49, 0x00, 0x44, 0x00, 0x5F, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00,
+  0x33, 0x00, 0x30, 0x00, 0x30, 0x00, 0x00, 0x00, 0x43, 0x00, 0x4F, 0x00, 0x4D, 0x00, 0x50, 0x00,
+  0x4C, 0x00, 0x45, 0x00, 0x58, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00,
+  0x31, 0x00, 0x61, 0x00, 0x00, 0x00, 0x43, 0x00, 0x4F, 0x00, 0x4D, 0x00, 0x50, 0x00, 0x4C, 0x00,
+  0x45, 0x00, 0x58, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x31, 0x00,
+  0x62, 0x00, 0x00, 0x00, 0x43, 0x00, 0x4F, 0x00, 0x4D, 0x00, 0x50, 0x00, 0x4C, 0x00, 0x45, 0x00,
+  0x58, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x32, 0x00, 0x00, 0x00,
+  0x49, 0x00, 0x4E, 0x00, 0x54, 0x00, 0x45, 0x00, 0x47, 0x00, 0x45, 0x00, 0x52, 0x00, 0x5F, 0x00,
+  0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x00, 0x00, 0x42, 0x00, 0x4F, 0x00, 0x4F, 0x00,
+  0x4C, 0x00, 0x45, 0x00, 0x41, 0x00, 0x4E, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00,
+  0x42, 0x00, 0x00, 0x00, 0x44, 0x00, 0x4F, 0x00, 0x55, 0x00, 0x42, 0x00, 0x4C, 0x00, 0x45, 0x00,
+  0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00, 0x00, 0x00, 0x46, 0x00, 0x4C, 0x00,
+  0x4F, 0x00, 0x41, 0x00, 0x54, 0x00, 0x5F, 0x00, 0x4B, 0x00, 0x4E, 0x00, 0x4F, 0x00, 0x42, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x03, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x43, 0x43, 0x76, 0x31, 0x00, 0x00, 0x00, 0x00,
+  0x2C, 0xDD, 0xCE, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x03, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x78, 0xF6, 0x8B, 0xBB,
+  0x84, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x44, 0x42, 0xB0,
+  0xA2, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x01, 0x0B, 0xD3,
+  0xC0, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x16, 0x00, 0x00, 0x00,
+  0x02, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00, 0x06, 0x07, 0x08,
+  0x09, 0x0A, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0xEA, 0x57, 0x27, 0x00, 0x00, 0x00, 0x00,
+  0xDC, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+  0x64, 0x00, 0x00, 0x00, 0xC9, 0xFB, 0xD2, 0x88, 0xF6, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+  0x07, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x44, 0xEE, 0x73, 0x43,
+  0x10, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x4A, 0xD8, 0x12, 0x4D, 0xFB, 0x21, 0x09, 0x40, 0xC3, 0x01, 0xB1, 0xD8, 0x00, 0x00, 0x00, 0x00,
+  0x28, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+  0xF4, 0xFD, 0xB4, 0x3F, 0x7A, 0xCC, 0x7D, 0x83
+};
+
 UINT8  mKnown_Good_VarList_Entries[KNOWN_GOOD_TAG_COUNT][KNOWN_GOOD_TAG_MAX_LEN] = {
   { 0x43, 0x43, 0x76, 0x31, 0x00, 0x00, 0x00, 0x00 },
   { 0x01, 0x00, 0x00, 0x00 },
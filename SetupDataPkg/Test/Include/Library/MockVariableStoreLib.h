@@ -0,0 +1,177 @@
+/** @file MockVariableStoreLib.h
+  In memory variable storage for host based tests and benchmarks, with a simulated flash cost model.
+
+  The store behaves like the variable driver on top of a NOR flash region: every update appends a new record and
+  invalidates the previous one in place, identical updates are not written, and when the appended record does not fit
+  anymore the store is reclaimed, erasing it block by block and writing back the live records. Nothing is slept, each
+  access adds its simulated cost to the statistics instead, so strategies can be compared deterministically.
+
+  The Get, Set and GetNextVariableName routines match the runtime services prototypes. They can be installed in the
+  mocked runtime services table of cmocka tests, or invoked by the default actions of the GoogleTest
+  MockUefiRuntimeServicesTableLib, in which case this header is included inside an extern "C" block.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MOCK_VARIABLE_STORE_LIB_H_
+#define MOCK_VARIABLE_STORE_LIB_H_
+
+//
+// Size of the header of each record, as the authenticated variable header of the variable driver.
+//
+#define MOCK_VARIABLE_STORE_RECORD_HEADER_SIZE  60
+
+//
+// Default cost model, in the order of magnitude of a SPI NOR flash variable region.
+//
+#define MOCK_VARIABLE_STORE_DEFAULT_STORE_SIZE        SIZE_256KB
+#define MOCK_VARIABLE_STORE_DEFAULT_ERASE_BLOCK_SIZE  SIZE_4KB
+#define MOCK_VARIABLE_STORE_DEFAULT_READ_NS           1000
+#define MOCK_VARIABLE_STORE_DEFAULT_WRITE_NS          100000
+#define MOCK_VARIABLE_STORE_DEFAULT_BYTE_NS           3000
+#define MOCK_VARIABLE_STORE_DEFAULT_ERASE_NS          45000000
+
+typedef struct {
+  UINTN     StoreSize;        // Bytes of records the store holds before it must be reclaimed
+  UINTN     EraseBlockSize;   // Bytes erased at once, a reclaim erases every block of the store
+  UINT64    ReadLatencyNs;    // Cost of every GetVariable, GetNextVariableName and SetVariable lookup
+  UINT64    WriteLatencyNs;   // Fixed cost of every SetVariable programming the store
+  UINT64    ByteLatencyNs;    // Cost of programming one byte, records and state bytes alike
+  UINT64    EraseLatencyNs;   // Cost of erasing one block
+} MOCK_VARIABLE_STORE_COST_MODEL;
+
+typedef struct {
+  UINT64    GetCount;         // GetVariable calls
+  UINT64    GetNextCount;     // GetNextVariableName calls
+  UINT64    SetCount;         // SetVariable calls
+  UINT64    WriteCount;       // SetVariable calls that programmed the store
+  UINT64    SkippedCount;     // SetVariable calls identical to the stored variable, not written
+  UINT64    BytesWritten;     // Bytes programmed, reclaims included
+  UINT64    ReclaimCount;     // Reclaims of the store
+  UINT64    BlocksErased;     // Blocks erased by the reclaims
+  UINT64    SimulatedNs;      // Total simulated cost of all the calls
+} MOCK_VARIABLE_STORE_STATS;
+
+/**
+  Empty the variable store, reset its statistics and select its cost model.
+
+  @param[in]  CostModel  Cost model of the store, the default model is used if NULL.
+
+  @retval EFI_SUCCESS            The store is empty.
+  @retval EFI_INVALID_PARAMETER  The store or erase block size of CostModel is zero.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreInitialize (
+  IN CONST MOCK_VARIABLE_STORE_COST_MODEL  *CostModel OPTIONAL
+  );
+
+/**
+  Free every variable of the store, it is empty afterwards.
+
+**/
+VOID
+EFIAPI
+MockVariableStoreFree (
+  VOID
+  );
+
+/**
+  Retrieve the statistics accumulated since the store was initialized or the statistics were reset.
+
+  @param[out]  Stats  The statistics.
+**/
+VOID
+EFIAPI
+MockVariableStoreGetStats (
+  OUT MOCK_VARIABLE_STORE_STATS  *Stats
+  );
+
+/**
+  Reset the statistics of the store, leaving its variables untouched.
+
+**/
+VOID
+EFIAPI
+MockVariableStoreResetStats (
+  VOID
+  );
+
+/**
+  GetVariable of the runtime services, served from the store.
+
+  @param[in]       VariableName  A Null-terminated string that is the name of the vendor's variable.
+  @param[in]       VendorGuid    A unique identifier for the vendor.
+  @param[out]      Attributes    If not NULL, receives the attributes bitmask of the variable.
+  @param[in, out]  DataSize      On input, the size in bytes of the return Data buffer.
+                                 On output the size of data returned in Data.
+  @param[out]      Data          The buffer to return the contents of the variable. May be NULL
+                                 with a zero DataSize in order to determine the size buffer needed.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The variable was not found.
+  @retval EFI_BUFFER_TOO_SMALL   The DataSize is too small for the result.
+  @retval EFI_INVALID_PARAMETER  VariableName, VendorGuid or DataSize is NULL, or Data is NULL with a non zero
+                                 DataSize.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes     OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data           OPTIONAL
+  );
+
+/**
+  GetNextVariableName of the runtime services, enumerating the store in record order.
+
+  @param[in, out]  VariableNameSize  The size of the VariableName buffer in bytes.
+  @param[in, out]  VariableName      On input, the name returned by the previous call or an empty string to start
+                                     over. On output, the name of the next variable.
+  @param[in, out]  VendorGuid        On input, the GUID returned by the previous call. On output, the GUID of the
+                                     next variable.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The next variable was not found, the enumeration is complete.
+  @retval EFI_BUFFER_TOO_SMALL   The VariableNameSize is too small for the result, it is updated with the size needed.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, VariableName is not terminated within VariableNameSize, or the
+                                 variable named on input does not exist.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreGetNextVariableName (
+  IN OUT UINTN     *VariableNameSize,
+  IN OUT CHAR16    *VariableName,
+  IN OUT EFI_GUID  *VendorGuid
+  );
+
+/**
+  SetVariable of the runtime services, updating the store and charging its simulated cost.
+
+  @param[in]  VariableName       A Null-terminated string that is the name of the vendor's variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+  @param[in]  Attributes         Attributes bitmask to set for the variable, zero deletes it.
+  @param[in]  DataSize           The size in bytes of the Data buffer, zero deletes the variable.
+  @param[in]  Data               The contents for the variable.
+
+  @retval EFI_SUCCESS            The variable was stored, deleted, or is identical to the stored one.
+  @retval EFI_NOT_FOUND          The variable to delete was not found.
+  @retval EFI_INVALID_PARAMETER  VariableName is NULL or empty, VendorGuid is NULL, Data is NULL with a non zero
+                                 DataSize, or the attributes differ from the stored variable.
+  @retval EFI_OUT_OF_RESOURCES   The variable does not fit in the store, even once reclaimed.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  );
+
+#endif // MOCK_VARIABLE_STORE_LIB_H_
@@ -0,0 +1,216 @@
+/** @file
+  Helpers shared by the host based micro-benchmarks of SetupDataPkg.
+
+  Every measurement is reported on stdout as a single JSON object per line, i.e.
+
+  {"suite":"ConfigVariableListLib","benchmark":"RetrieveActiveConfigVarList","knobs":1000,"iterations":64,
+   "total_ns":123456,"ns_per_op":1929}
+
+  so results can be collected and compared between builds by a script. Benchmarks run against the mocked variable
+  store report its simulated flash time as total_ns instead, followed by the store statistics.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef SETUPDATAPKG_BENCHMARK_H_
+#define SETUPDATAPKG_BENCHMARK_H_
+
+#include <Uefi.h>
+#include <Library/ConfigVariableListLib.h>
+#include <Library/MockVariableStoreLib.h>
+
+//
+// Knob counts every benchmark is run against, capped by the optional command line argument.
+//
+#define BENCHMARK_MIN_KNOB_COUNT  10
+#define BENCHMARK_MAX_KNOB_COUNT  100000
+
+//
+// Budget of knobs processed per measurement, the iteration count is derived from it so that
+// small inputs are repeated often enough to be measurable and large ones are not repeated at all.
+//
+#define BENCHMARK_KNOB_BUDGET  1000000
+
+//
+// Size of the data of each synthetic knob.
+//
+#define BENCHMARK_KNOB_DATA_SIZE  sizeof (UINT32)
+
+//
+// Large enough for L"BenchmarkKnob_" followed by a 6 digit index.
+//
+#define BENCHMARK_KNOB_NAME_LEN  21
+
+//
+// Bytes of the record of a synthetic knob in the mocked variable store.
+//
+#define BENCHMARK_KNOB_RECORD_SIZE \
+  (MOCK_VARIABLE_STORE_RECORD_HEADER_SIZE + BENCHMARK_KNOB_NAME_LEN * sizeof (CHAR16) + BENCHMARK_KNOB_DATA_SIZE)
+
+extern EFI_GUID  gBenchmarkKnobGuid;
+
+/**
+  Parse the command line of a benchmark application.
+
+  The only accepted argument is the largest knob count to benchmark, which allows a quick run
+  of the small inputs only.
+
+  @param[in]  Argc  Number of arguments.
+  @param[in]  Argv  Arguments.
+
+  @return The largest knob count to benchmark.
+**/
+UINTN
+BenchmarkGetMaxKnobCount (
+  IN  INTN   Argc,
+  IN  CHAR8  **Argv
+  );
+
+/**
+  Return the next knob count to benchmark, the counts grow by a factor of 10 from
+  BENCHMARK_MIN_KNOB_COUNT to BENCHMARK_MAX_KNOB_COUNT.
+
+  @param[in]  KnobCount  The knob count just benchmarked.
+
+  @return The next knob count to benchmark.
+**/
+UINTN
+BenchmarkNextKnobCount (
+  IN  UINTN  KnobCount
+  );
+
+/**
+  Return the number of iterations to run a benchmark processing KnobCount knobs per iteration.
+
+  @param[in]  KnobCount  Number of knobs processed per iteration.
+
+  @return Number of iterations, at least 1.
+**/
+UINTN
+BenchmarkGetIterations (
+  IN  UINTN  KnobCount
+  );
+
+/**
+  Read the current time.
+
+  @return Current time in nanoseconds.
+**/
+UINT64
+BenchmarkGetTimeNs (
+  VOID
+  );
+
+/**
+  Report one measurement as a JSON line on stdout.
+
+  @param[in]  Suite       Name of the benchmarked module.
+  @param[in]  Benchmark   Name of the benchmarked function.
+  @param[in]  KnobCount   Number of knobs of the input.
+  @param[in]  Iterations  Number of times the function was run.
+  @param[in]  ElapsedNs   Total time of all iterations in nanoseconds.
+**/
+VOID
+BenchmarkReport (
+  IN  CONST CHAR8  *Suite,
+  IN  CONST CHAR8  *Benchmark,
+  IN  UINTN        KnobCount,
+  IN  UINTN        Iterations,
+  IN  UINT64       ElapsedNs
+  );
+
+/**
+  Report that a benchmark failed as a JSON line on stdout.
+
+  @param[in]  Suite       Name of the benchmarked module.
+  @param[in]  Benchmark   Name of the benchmarked function.
+  @param[in]  KnobCount   Number of knobs of the input.
+  @param[in]  Status      Status returned by the benchmarked function.
+**/
+VOID
+BenchmarkReportError (
+  IN  CONST CHAR8  *Suite,
+  IN  CONST CHAR8  *Benchmark,
+  IN  UINTN        KnobCount,
+  IN  EFI_STATUS   Status
+  );
+
+/**
+  Report the simulated cost of accesses to the mocked variable store as a JSON line on stdout.
+
+  @param[in]  Suite       Name of the benchmarked module.
+  @param[in]  Benchmark   Name of the benchmarked strategy.
+  @param[in]  KnobCount   Number of knobs of the input.
+  @param[in]  Stats       Statistics of the store accumulated by the benchmark.
+**/
+VOID
+BenchmarkReportVariableStore (
+  IN  CONST CHAR8                      *Suite,
+  IN  CONST CHAR8                      *Benchmark,
+  IN  UINTN                            KnobCount,
+  IN  CONST MOCK_VARIABLE_STORE_STATS  *Stats
+  );
+
+/**
+  Empty the mocked variable store and size it for KnobCount synthetic knobs.
+
+  The knobs fill two thirds of the store, rounded up to whole erase blocks, so rewriting all of them forces a reclaim
+  once they span a few blocks. The default latencies are used.
+
+  @param[in]  KnobCount   Number of knobs the store must hold.
+
+  @retval EFI_SUCCESS  The store is empty.
+  @retval Others       The store could not be initialized.
+**/
+EFI_STATUS
+BenchmarkInitializeVariableStore (
+  IN  UINTN  KnobCount
+  );
+
+/**
+  Fill the name of a synthetic knob.
+
+  @param[in]  Index     Index of the knob.
+  @param[out] Name      Buffer of BENCHMARK_KNOB_NAME_LEN characters receiving the name.
+**/
+VOID
+BenchmarkGetKnobName (
+  IN  UINTN   Index,
+  OUT CHAR16  *Name
+  );
+
+/**
+  Create a synthetic variable list of KnobCount knobs, the layout of a generated profile.
+
+  Knob Index is named by BenchmarkGetKnobName, lives in gBenchmarkKnobGuid and holds the UINT32 Index.
+
+  @param[in]  KnobCount    Number of knobs in the variable list.
+  @param[out] VarList      Allocated variable list, the caller frees it with FreePool.
+  @param[out] VarListSize  Size in bytes of VarList.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+  @retval EFI_SUCCESS           The variable list was created.
+  @retval Others                The conversion of a knob failed.
+**/
+EFI_STATUS
+BenchmarkCreateVarList (
+  IN  UINTN  KnobCount,
+  OUT VOID   **VarList,
+  OUT UINTN  *VarListSize
+  );
+
+/**
+  Free a list of variable entries along with the Name and Data of each entry.
+
+  @param[in]  ConfigVarList       The list of entries.
+  @param[in]  ConfigVarListCount  Number of entries in ConfigVarList.
+**/
+VOID
+BenchmarkFreeConfigVarList (
+  IN  CONFIG_VAR_LIST_ENTRY  *ConfigVarList,
+  IN  UINTN                  ConfigVarListCount
+  );
+
+#endif // SETUPDATAPKG_BENCHMARK_H_
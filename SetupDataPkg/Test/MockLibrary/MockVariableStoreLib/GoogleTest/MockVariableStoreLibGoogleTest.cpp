@@ -0,0 +1,172 @@
+/** @file MockVariableStoreLibGoogleTest.cpp
+  Unit tests of the MockVariableStoreLib instance behind the GoogleTest MockUefiRuntimeServicesTableLib.
+
+  The store serves the default actions of the runtime services mock, so that ConfigKnobShimDxeLib reads its overrides
+  from it without any expectation written per call.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/GoogleTestLib.h>
+#include <GoogleTest/Library/MockUefiRuntimeServicesTableLib.h>
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/ConfigKnobShimLib.h>
+  #include <Library/MockVariableStoreLib.h>
+}
+
+#define CONFIG_KNOB_GUID  {0x52d39693, 0x4f64, 0x4ee6, {0x81, 0xde, 0x45, 0x89, 0x37, 0x72, 0x78, 0x55}}
+
+#define TEST_ATTRIBUTES  (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+using namespace testing;
+
+//
+// Default actions of the runtime services mock, forwarding to the store.
+//
+STATIC
+EFI_STATUS
+StoreGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes     OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data           OPTIONAL
+  )
+{
+  return MockVariableStoreGetVariable (VariableName, VendorGuid, Attributes, DataSize, Data);
+}
+
+STATIC
+EFI_STATUS
+StoreSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  )
+{
+  return MockVariableStoreSetVariable (VariableName, VendorGuid, Attributes, DataSize, Data);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+class MockVariableStoreRuntimeServicesTest : public Test
+{
+protected:
+  NiceMock<MockUefiRuntimeServicesTableLib> RtServicesMock;
+  MOCK_VARIABLE_STORE_STATS Stats;
+  EFI_STATUS Status;
+  EFI_GUID ConfigKnobGuid;
+  CHAR16 *ConfigKnobName;
+  UINT64 ProfileDefaultValue;
+  UINT64 VariableData;
+  UINT64 ConfigKnobData;
+
+  // Redefining the Test class's SetUp function for test fixtures.
+  void
+  SetUp (
+    ) override
+  {
+    ConfigKnobGuid      = CONFIG_KNOB_GUID;
+    ConfigKnobName      = (CHAR16 *)L"MyDeadBeefDelivery";
+    ProfileDefaultValue = 0xDEADBEEFDEADBEEF;
+    VariableData        = 0xBEEF7777BEEF7777;
+    ConfigKnobData      = ProfileDefaultValue;
+
+    ASSERT_EQ (MockVariableStoreInitialize (NULL), EFI_SUCCESS);
+
+    // Serve the runtime services from the store unless a test expects otherwise
+    ON_CALL (RtServicesMock, gRT_GetVariable).WillByDefault (Invoke (StoreGetVariable));
+    ON_CALL (RtServicesMock, gRT_SetVariable).WillByDefault (Invoke (StoreSetVariable));
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    MockVariableStoreFree ();
+  }
+};
+
+//
+// A knob stored through the runtime services is the override read by ConfigKnobShimDxeLib.
+//
+TEST_F (MockVariableStoreRuntimeServicesTest, StoredKnobIsReadBack) {
+  Status = gRT->SetVariable (ConfigKnobName, &ConfigKnobGuid, TEST_ATTRIBUTES, sizeof (VariableData), &VariableData);
+  ASSERT_EQ (Status, EFI_SUCCESS);
+
+  MockVariableStoreResetStats ();
+  Status = GetConfigKnobOverride (&ConfigKnobGuid, ConfigKnobName, (VOID *)&ConfigKnobData, sizeof (ConfigKnobData));
+
+  ASSERT_EQ (Status, EFI_SUCCESS);
+  ASSERT_EQ (ConfigKnobData, VariableData);
+
+  // The size query and the read itself
+  MockVariableStoreGetStats (&Stats);
+  ASSERT_EQ (Stats.GetCount, 2U);
+  ASSERT_EQ (Stats.SimulatedNs, 2 * MOCK_VARIABLE_STORE_DEFAULT_READ_NS);
+}
+
+//
+// A knob missing from the store keeps its profile default, after a single size query.
+//
+TEST_F (MockVariableStoreRuntimeServicesTest, MissingKnobKeepsDefault) {
+  Status = GetConfigKnobOverride (&ConfigKnobGuid, ConfigKnobName, (VOID *)&ConfigKnobData, sizeof (ConfigKnobData));
+
+  ASSERT_EQ (Status, EFI_NOT_FOUND);
+  ASSERT_EQ (ConfigKnobData, ProfileDefaultValue);
+
+  MockVariableStoreGetStats (&Stats);
+  ASSERT_EQ (Stats.GetCount, 1U);
+}
+
+//
+// A stored knob of another size than the profile keeps its profile default.
+//
+TEST_F (MockVariableStoreRuntimeServicesTest, StoredKnobSizeMismatch) {
+  UINT32  ShortData = 0x7777;
+
+  Status = gRT->SetVariable (ConfigKnobName, &ConfigKnobGuid, TEST_ATTRIBUTES, sizeof (ShortData), &ShortData);
+  ASSERT_EQ (Status, EFI_SUCCESS);
+
+  Status = GetConfigKnobOverride (&ConfigKnobGuid, ConfigKnobName, (VOID *)&ConfigKnobData, sizeof (ConfigKnobData));
+
+  ASSERT_EQ (Status, EFI_BAD_BUFFER_SIZE);
+  ASSERT_EQ (ConfigKnobData, ProfileDefaultValue);
+}
+
+//
+// Expectations still take precedence over the store, to inject failures.
+//
+TEST_F (MockVariableStoreRuntimeServicesTest, ExpectationOverridesStore) {
+  Status = gRT->SetVariable (ConfigKnobName, &ConfigKnobGuid, TEST_ATTRIBUTES, sizeof (VariableData), &VariableData);
+  ASSERT_EQ (Status, EFI_SUCCESS);
+
+  EXPECT_CALL (
+    RtServicesMock,
+    gRT_GetVariable
+    )
+    .WillOnce (
+       Return (EFI_DEVICE_ERROR)
+       );
+
+  Status = GetConfigKnobOverride (&ConfigKnobGuid, ConfigKnobName, (VOID *)&ConfigKnobData, sizeof (ConfigKnobData));
+
+  ASSERT_EQ (Status, EFI_DEVICE_ERROR);
+  ASSERT_EQ (ConfigKnobData, ProfileDefaultValue);
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
@@ -0,0 +1,640 @@
+/** @file MockVariableStoreLib.c
+  In memory variable storage for host based tests and benchmarks, with a simulated flash cost model.
+
+  Records are kept in the order they were written, as in the flash region. Invalidated records release their memory
+  right away but keep using store space until the next reclaim, which compacts the record array. Live records are
+  indexed by a hash of their name and GUID so large stores can be exercised by the benchmarks.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/MockVariableStoreLib.h>
+
+//
+// Index terminating the hash bucket chains.
+//
+#define MOCK_NO_RECORD  MAX_UINTN
+
+//
+// Initial number of records and hash buckets, both are doubled as the store grows.
+//
+#define MOCK_INITIAL_CAPACITY  64
+
+typedef struct {
+  CHAR16      *Name;        // NULL once the record is invalidated
+  EFI_GUID    Guid;
+  UINT32      Attributes;
+  UINTN       DataSize;
+  VOID        *Data;
+  UINTN       RecordSize;   // Bytes of the record in the store
+  UINTN       Next;         // Next live record of the same hash bucket
+} MOCK_VARIABLE_RECORD;
+
+STATIC CONST MOCK_VARIABLE_STORE_COST_MODEL  mDefaultCostModel = {
+  MOCK_VARIABLE_STORE_DEFAULT_STORE_SIZE,
+  MOCK_VARIABLE_STORE_DEFAULT_ERASE_BLOCK_SIZE,
+  MOCK_VARIABLE_STORE_DEFAULT_READ_NS,
+  MOCK_VARIABLE_STORE_DEFAULT_WRITE_NS,
+  MOCK_VARIABLE_STORE_DEFAULT_BYTE_NS,
+  MOCK_VARIABLE_STORE_DEFAULT_ERASE_NS
+};
+
+STATIC MOCK_VARIABLE_STORE_COST_MODEL        mCustomCostModel;
+STATIC CONST MOCK_VARIABLE_STORE_COST_MODEL  *mCostModel = &mDefaultCostModel;
+
+STATIC MOCK_VARIABLE_STORE_STATS  mStats;
+
+STATIC MOCK_VARIABLE_RECORD  *mRecords       = NULL;
+STATIC UINTN                 mRecordCount    = 0;
+STATIC UINTN                 mRecordCapacity = 0;
+STATIC UINTN                 *mBuckets       = NULL;
+STATIC UINTN                 mBucketCount    = 0;
+
+//
+// Bytes of records in the store, invalidated ones included, and bytes of the live records only.
+//
+STATIC UINTN  mUsedSize = 0;
+STATIC UINTN  mLiveSize = 0;
+
+/**
+  Hash a variable name and GUID.
+
+  @param[in]  Name  Name of the variable.
+  @param[in]  Guid  GUID of the variable.
+
+  @retval The hash, to be masked with the bucket count.
+**/
+STATIC
+UINTN
+HashVariable (
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINT32  Hash;
+
+  // FNV-1a over the name characters, seeded with the first GUID field
+  Hash = 2166136261U ^ Guid->Data1;
+  while (*Name != L'\0') {
+    Hash = (Hash ^ *Name) * 16777619U;
+    Name++;
+  }
+
+  return Hash;
+}
+
+/**
+  Rebuild the hash index of the live records.
+
+  @param[in]  BucketCount  Number of buckets of the index, a power of two.
+
+  @retval EFI_SUCCESS           The index was rebuilt.
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed, the previous index is kept.
+**/
+STATIC
+EFI_STATUS
+RebuildIndex (
+  IN UINTN  BucketCount
+  )
+{
+  UINTN  *Buckets;
+  UINTN  Bucket;
+  UINTN  Index;
+
+  Buckets = AllocatePool (BucketCount * sizeof (UINTN));
+  if (Buckets == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SetMem (Buckets, BucketCount * sizeof (UINTN), 0xFF);
+  for (Index = 0; Index < mRecordCount; Index++) {
+    if (mRecords[Index].Name != NULL) {
+      Bucket               = HashVariable (mRecords[Index].Name, &mRecords[Index].Guid) & (BucketCount - 1);
+      mRecords[Index].Next = Buckets[Bucket];
+      Buckets[Bucket]      = Index;
+    }
+  }
+
+  if (mBuckets != NULL) {
+    FreePool (mBuckets);
+  }
+
+  mBuckets     = Buckets;
+  mBucketCount = BucketCount;
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the live record of a variable.
+
+  @param[in]  Name  Name of the variable.
+  @param[in]  Guid  GUID of the variable.
+
+  @retval The index of the record, MOCK_NO_RECORD if the variable does not exist.
+**/
+STATIC
+UINTN
+FindRecord (
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINTN  Index;
+
+  if (mBucketCount == 0) {
+    return MOCK_NO_RECORD;
+  }
+
+  for (Index = mBuckets[HashVariable (Name, Guid) & (mBucketCount - 1)];
+       Index != MOCK_NO_RECORD;
+       Index = mRecords[Index].Next)
+  {
+    if ((StrCmp (Name, mRecords[Index].Name) == 0) && CompareGuid (Guid, &mRecords[Index].Guid)) {
+      return Index;
+    }
+  }
+
+  return MOCK_NO_RECORD;
+}
+
+/**
+  Invalidate a live record, it keeps using store space until the next reclaim.
+
+  @param[in]  Index  Index of the record.
+**/
+STATIC
+VOID
+InvalidateRecord (
+  IN UINTN  Index
+  )
+{
+  UINTN  *Link;
+
+  Link = &mBuckets[HashVariable (mRecords[Index].Name, &mRecords[Index].Guid) & (mBucketCount - 1)];
+  while (*Link != Index) {
+    Link = &mRecords[*Link].Next;
+  }
+
+  *Link      = mRecords[Index].Next;
+  mLiveSize -= mRecords[Index].RecordSize;
+
+  FreePool (mRecords[Index].Name);
+  if (mRecords[Index].Data != NULL) {
+    FreePool (mRecords[Index].Data);
+  }
+
+  mRecords[Index].Name = NULL;
+  mRecords[Index].Data = NULL;
+}
+
+/**
+  Append a live record at the end of the store, the caller checked that it fits.
+
+  @param[in]  Name        Name of the variable.
+  @param[in]  Guid        GUID of the variable.
+  @param[in]  Attributes  Attributes of the variable.
+  @param[in]  DataSize    Size in bytes of Data.
+  @param[in]  Data        Content of the variable.
+  @param[in]  RecordSize  Bytes of the record in the store.
+
+  @retval EFI_SUCCESS           The record was appended.
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+**/
+STATIC
+EFI_STATUS
+AppendRecord (
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *Guid,
+  IN UINT32          Attributes,
+  IN UINTN           DataSize,
+  IN CONST VOID      *Data,
+  IN UINTN           RecordSize
+  )
+{
+  EFI_STATUS            Status;
+  MOCK_VARIABLE_RECORD  *Records;
+  MOCK_VARIABLE_RECORD  *Record;
+  UINTN                 Capacity;
+  UINTN                 Bucket;
+
+  if (mRecordCount == mRecordCapacity) {
+    Capacity = MAX (MOCK_INITIAL_CAPACITY, mRecordCapacity * 2);
+    Records  = ReallocatePool (
+                 mRecordCapacity * sizeof (MOCK_VARIABLE_RECORD),
+                 Capacity * sizeof (MOCK_VARIABLE_RECORD),
+                 mRecords
+                 );
+    if (Records == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mRecords        = Records;
+    mRecordCapacity = Capacity;
+  }
+
+  // Keep at most one record per bucket on average, invalidated ones included
+  if (mRecordCount >= mBucketCount) {
+    Status = RebuildIndex (MAX (MOCK_INITIAL_CAPACITY, mBucketCount * 2));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Record       = &mRecords[mRecordCount];
+  Record->Name = AllocateCopyPool (StrSize (Name), Name);
+  Record->Data = AllocateCopyPool (DataSize, Data);
+  if ((Record->Name == NULL) || (Record->Data == NULL)) {
+    if (Record->Name != NULL) {
+      FreePool (Record->Name);
+    }
+
+    if (Record->Data != NULL) {
+      FreePool (Record->Data);
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyGuid (&Record->Guid, Guid);
+  Record->Attributes = Attributes;
+  Record->DataSize   = DataSize;
+  Record->RecordSize = RecordSize;
+
+  Bucket           = HashVariable (Name, Guid) & (mBucketCount - 1);
+  Record->Next     = mBuckets[Bucket];
+  mBuckets[Bucket] = mRecordCount;
+
+  mRecordCount++;
+  mUsedSize += RecordSize;
+  mLiveSize += RecordSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Reclaim the store: erase every block and write the live records back, dropping the invalidated ones.
+
+  @retval EFI_SUCCESS           The store was reclaimed.
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+**/
+STATIC
+EFI_STATUS
+Reclaim (
+  VOID
+  )
+{
+  UINTN  BlockCount;
+  UINTN  Index;
+  UINTN  LiveCount;
+
+  LiveCount = 0;
+  for (Index = 0; Index < mRecordCount; Index++) {
+    if (mRecords[Index].Name != NULL) {
+      mRecords[LiveCount++] = mRecords[Index];
+    }
+  }
+
+  mRecordCount = LiveCount;
+
+  BlockCount = (mCostModel->StoreSize + mCostModel->EraseBlockSize - 1) / mCostModel->EraseBlockSize;
+
+  mStats.ReclaimCount++;
+  mStats.BlocksErased += BlockCount;
+  mStats.BytesWritten += mLiveSize;
+  mStats.SimulatedNs  += BlockCount * mCostModel->EraseLatencyNs + mLiveSize * mCostModel->ByteLatencyNs;
+
+  mUsedSize = mLiveSize;
+
+  return RebuildIndex (mBucketCount);
+}
+
+/**
+  Empty the variable store, reset its statistics and select its cost model.
+
+  @param[in]  CostModel  Cost model of the store, the default model is used if NULL.
+
+  @retval EFI_SUCCESS            The store is empty.
+  @retval EFI_INVALID_PARAMETER  The store or erase block size of CostModel is zero.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreInitialize (
+  IN CONST MOCK_VARIABLE_STORE_COST_MODEL  *CostModel OPTIONAL
+  )
+{
+  if ((CostModel != NULL) && ((CostModel->StoreSize == 0) || (CostModel->EraseBlockSize == 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MockVariableStoreFree ();
+
+  mCostModel = &mDefaultCostModel;
+  if (CostModel != NULL) {
+    CopyMem (&mCustomCostModel, CostModel, sizeof (mCustomCostModel));
+    mCostModel = &mCustomCostModel;
+  }
+
+  MockVariableStoreResetStats ();
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free every variable of the store, it is empty afterwards.
+
+**/
+VOID
+EFIAPI
+MockVariableStoreFree (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mRecordCount; Index++) {
+    if (mRecords[Index].Name != NULL) {
+      FreePool (mRecords[Index].Name);
+      FreePool (mRecords[Index].Data);
+    }
+  }
+
+  if (mRecords != NULL) {
+    FreePool (mRecords);
+  }
+
+  if (mBuckets != NULL) {
+    FreePool (mBuckets);
+  }
+
+  mRecords        = NULL;
+  mRecordCount    = 0;
+  mRecordCapacity = 0;
+  mBuckets        = NULL;
+  mBucketCount    = 0;
+  mUsedSize       = 0;
+  mLiveSize       = 0;
+}
+
+/**
+  Retrieve the statistics accumulated since the store was initialized or the statistics were reset.
+
+  @param[out]  Stats  The statistics.
+**/
+VOID
+EFIAPI
+MockVariableStoreGetStats (
+  OUT MOCK_VARIABLE_STORE_STATS  *Stats
+  )
+{
+  CopyMem (Stats, &mStats, sizeof (mStats));
+}
+
+/**
+  Reset the statistics of the store, leaving its variables untouched.
+
+**/
+VOID
+EFIAPI
+MockVariableStoreResetStats (
+  VOID
+  )
+{
+  ZeroMem (&mStats, sizeof (mStats));
+}
+
+/**
+  GetVariable of the runtime services, served from the store.
+
+  @param[in]       VariableName  A Null-terminated string that is the name of the vendor's variable.
+  @param[in]       VendorGuid    A unique identifier for the vendor.
+  @param[out]      Attributes    If not NULL, receives the attributes bitmask of the variable.
+  @param[in, out]  DataSize      On input, the size in bytes of the return Data buffer.
+                                 On output the size of data returned in Data.
+  @param[out]      Data          The buffer to return the contents of the variable. May be NULL
+                                 with a zero DataSize in order to determine the size buffer needed.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The variable was not found.
+  @retval EFI_BUFFER_TOO_SMALL   The DataSize is too small for the result.
+  @retval EFI_INVALID_PARAMETER  VariableName, VendorGuid or DataSize is NULL, or Data is NULL with a non zero
+                                 DataSize.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes     OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data           OPTIONAL
+  )
+{
+  UINTN  Index;
+
+  if ((VariableName == NULL) || (VendorGuid == NULL) || (DataSize == NULL) || ((Data == NULL) && (*DataSize != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mStats.GetCount++;
+  mStats.SimulatedNs += mCostModel->ReadLatencyNs;
+
+  Index = FindRecord (VariableName, VendorGuid);
+  if (Index == MOCK_NO_RECORD) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (*DataSize < mRecords[Index].DataSize) {
+    *DataSize = mRecords[Index].DataSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DataSize = mRecords[Index].DataSize;
+  CopyMem (Data, mRecords[Index].Data, mRecords[Index].DataSize);
+  if (Attributes != NULL) {
+    *Attributes = mRecords[Index].Attributes;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  GetNextVariableName of the runtime services, enumerating the store in record order.
+
+  @param[in, out]  VariableNameSize  The size of the VariableName buffer in bytes.
+  @param[in, out]  VariableName      On input, the name returned by the previous call or an empty string to start
+                                     over. On output, the name of the next variable.
+  @param[in, out]  VendorGuid        On input, the GUID returned by the previous call. On output, the GUID of the
+                                     next variable.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The next variable was not found, the enumeration is complete.
+  @retval EFI_BUFFER_TOO_SMALL   The VariableNameSize is too small for the result, it is updated with the size needed.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, VariableName is not terminated within VariableNameSize, or the
+                                 variable named on input does not exist.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreGetNextVariableName (
+  IN OUT UINTN     *VariableNameSize,
+  IN OUT CHAR16    *VariableName,
+  IN OUT EFI_GUID  *VendorGuid
+  )
+{
+  UINTN  Index;
+  UINTN  NameSize;
+
+  if ((VariableNameSize == NULL) || (VariableName == NULL) || (VendorGuid == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (StrnLenS (VariableName, *VariableNameSize / sizeof (CHAR16)) == *VariableNameSize / sizeof (CHAR16)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mStats.GetNextCount++;
+  mStats.SimulatedNs += mCostModel->ReadLatencyNs;
+
+  Index = 0;
+  if (VariableName[0] != L'\0') {
+    Index = FindRecord (VariableName, VendorGuid);
+    if (Index == MOCK_NO_RECORD) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Index++;
+  }
+
+  while ((Index < mRecordCount) && (mRecords[Index].Name == NULL)) {
+    Index++;
+  }
+
+  if (Index == mRecordCount) {
+    return EFI_NOT_FOUND;
+  }
+
+  NameSize = StrSize (mRecords[Index].Name);
+  if (*VariableNameSize < NameSize) {
+    *VariableNameSize = NameSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *VariableNameSize = NameSize;
+  CopyMem (VariableName, mRecords[Index].Name, NameSize);
+  CopyGuid (VendorGuid, &mRecords[Index].Guid);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  SetVariable of the runtime services, updating the store and charging its simulated cost.
+
+  A new record is appended for every update, then the previous record is invalidated by programming its state byte.
+  Deleting a variable programs its state byte only. When the new record does not fit at the end of the store, the
+  previous record is dropped and the store is reclaimed before appending it.
+
+  @param[in]  VariableName       A Null-terminated string that is the name of the vendor's variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+  @param[in]  Attributes         Attributes bitmask to set for the variable, zero deletes it.
+  @param[in]  DataSize           The size in bytes of the Data buffer, zero deletes the variable.
+  @param[in]  Data               The contents for the variable.
+
+  @retval EFI_SUCCESS            The variable was stored, deleted, or is identical to the stored one.
+  @retval EFI_NOT_FOUND          The variable to delete was not found.
+  @retval EFI_INVALID_PARAMETER  VariableName is NULL or empty, VendorGuid is NULL, Data is NULL with a non zero
+                                 DataSize, or the attributes differ from the stored variable.
+  @retval EFI_OUT_OF_RESOURCES   The variable does not fit in the store, even once reclaimed.
+**/
+EFI_STATUS
+EFIAPI
+MockVariableStoreSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       RecordSize;
+  UINTN       LiveSize;
+
+  if ((VariableName == NULL) || (VariableName[0] == L'\0') || (VendorGuid == NULL) ||
+      ((Data == NULL) && (DataSize != 0)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mStats.SetCount++;
+  mStats.SimulatedNs += mCostModel->ReadLatencyNs;
+
+  Index = FindRecord (VariableName, VendorGuid);
+
+  if ((Attributes == 0) || (DataSize == 0)) {
+    if (Index == MOCK_NO_RECORD) {
+      return EFI_NOT_FOUND;
+    }
+
+    InvalidateRecord (Index);
+
+    mStats.WriteCount++;
+    mStats.BytesWritten++;
+    mStats.SimulatedNs += mCostModel->WriteLatencyNs + mCostModel->ByteLatencyNs;
+    return EFI_SUCCESS;
+  }
+
+  if (Index != MOCK_NO_RECORD) {
+    if (mRecords[Index].Attributes != Attributes) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if ((mRecords[Index].DataSize == DataSize) && (CompareMem (mRecords[Index].Data, Data, DataSize) == 0)) {
+      mStats.SkippedCount++;
+      return EFI_SUCCESS;
+    }
+  }
+
+  RecordSize = MOCK_VARIABLE_STORE_RECORD_HEADER_SIZE + StrSize (VariableName) + DataSize;
+  LiveSize   = mLiveSize + RecordSize - ((Index != MOCK_NO_RECORD) ? mRecords[Index].RecordSize : 0);
+  if (LiveSize > mCostModel->StoreSize) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mStats.WriteCount++;
+  mStats.SimulatedNs += mCostModel->WriteLatencyNs;
+
+  if (mUsedSize + RecordSize > mCostModel->StoreSize) {
+    if (Index != MOCK_NO_RECORD) {
+      InvalidateRecord (Index);
+      Index = MOCK_NO_RECORD;
+    }
+
+    Status = Reclaim ();
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = AppendRecord (VariableName, VendorGuid, Attributes, DataSize, Data, RecordSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mStats.BytesWritten += RecordSize;
+  mStats.SimulatedNs  += RecordSize * mCostModel->ByteLatencyNs;
+
+  if (Index != MOCK_NO_RECORD) {
+    InvalidateRecord (Index);
+
+    mStats.BytesWritten++;
+    mStats.SimulatedNs += mCostModel->ByteLatencyNs;
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,566 @@
+/** @file
+  Unit tests of the MockVariableStoreLib instance.
+
+  The store is exercised directly and through the mocked runtime services table, the way cmocka based tests of the
+  variable consumers install it.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/MockVariableStoreLib.h>
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "Mock Variable Store Lib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_ATTRIBUTES  (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+//
+// Bytes of the record of a test variable holding a UINT32, named with 4 characters.
+//
+#define TEST_RECORD_SIZE  (MOCK_VARIABLE_STORE_RECORD_HEADER_SIZE + sizeof (L"Knob") + sizeof (UINT32))
+
+//
+// Cost model with distinct power of ten costs, so every access shows in the simulated time.
+//
+STATIC CONST MOCK_VARIABLE_STORE_COST_MODEL  mTestCostModel = {
+  8 * TEST_RECORD_SIZE,
+  2 * TEST_RECORD_SIZE,
+  1,
+  100,
+  10000,
+  1000000
+};
+
+STATIC EFI_GUID  mTestGuid  = {
+  0x6a4a2f0e, 0x3b8c, 0x4d27, { 0x9f, 0x1a, 0x52, 0x7c, 0xe4, 0x0b, 0x81, 0x3d }
+};
+STATIC EFI_GUID  mOtherGuid = {
+  0x0e1d7b3c, 0x58a2, 0x4f61, { 0xa3, 0x4e, 0x96, 0x2d, 0x1c, 0x7f, 0x05, 0xb8 }
+};
+
+///
+/// Mock version of the UEFI Runtime Services Table, backed by the mocked variable store
+///
+EFI_RUNTIME_SERVICES  MockRuntime = {
+  .GetVariable         = MockVariableStoreGetVariable,
+  .GetNextVariableName = MockVariableStoreGetNextVariableName,
+  .SetVariable         = MockVariableStoreSetVariable
+};
+
+/**
+  Clean up the variable store after each test.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+**/
+VOID
+EFIAPI
+MockVariableStoreCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MockVariableStoreFree ();
+}
+
+/**
+  Unit test for reading back variables written to the store.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MockVariableStoreGetSetTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Value;
+  UINT32      Data;
+  UINT32      Attributes;
+  UINTN       DataSize;
+
+  UT_ASSERT_NOT_EFI_ERROR (MockVariableStoreInitialize (NULL));
+
+  Value  = 0xDEADBEEF;
+  Status = gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  DataSize = 0;
+  Status   = gRT->GetVariable (L"Knob", &mTestGuid, NULL, &DataSize, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (DataSize, sizeof (Value));
+
+  Data       = 0;
+  Attributes = 0;
+  DataSize   = sizeof (Data);
+  Status     = gRT->GetVariable (L"Knob", &mTestGuid, &Attributes, &DataSize, &Data);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (DataSize, sizeof (Value));
+  UT_ASSERT_EQUAL (Data, Value);
+  UT_ASSERT_EQUAL (Attributes, TEST_ATTRIBUTES);
+
+  // Variables are identified by both name and GUID
+  DataSize = sizeof (Data);
+  Status   = gRT->GetVariable (L"Knob", &mOtherGuid, NULL, &DataSize, &Data);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  DataSize = sizeof (Data);
+  Status   = gRT->GetVariable (L"Knob2", &mTestGuid, NULL, &DataSize, &Data);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // The attributes of an existing variable cannot be changed without deleting it
+  Status = gRT->SetVariable (L"Knob", &mTestGuid, EFI_VARIABLE_BOOTSERVICE_ACCESS, sizeof (Value), &Value);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, 0, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  DataSize = sizeof (Data);
+  Status   = gRT->GetVariable (L"Knob", &mTestGuid, NULL, &DataSize, &Data);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = gRT->SetVariable (L"Knob", &mTestGuid, 0, 0, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = gRT->SetVariable (L"Knob", &mTestGuid, EFI_VARIABLE_BOOTSERVICE_ACCESS, sizeof (Value), &Value);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for enumerating the store in record order.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MockVariableStoreGetNextVariableNameTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Value;
+  CHAR16      Name[8];
+  EFI_GUID    Guid;
+  UINTN       NameSize;
+
+  UT_ASSERT_NOT_EFI_ERROR (MockVariableStoreInitialize (NULL));
+
+  Value = 1;
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"KnobA", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"KnobB", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"KnobC", &mOtherGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+
+  // Updating a variable appends a new record, moving it to the end of the enumeration
+  Value = 2;
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"KnobA", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+
+  Name[0]  = L'\0';
+  NameSize = sizeof (L"Knob");
+  Status   = gRT->GetNextVariableName (&NameSize, Name, &Guid);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (NameSize, sizeof (L"KnobB"));
+
+  NameSize = sizeof (Name);
+  UT_ASSERT_NOT_EFI_ERROR (gRT->GetNextVariableName (&NameSize, Name, &Guid));
+  UT_ASSERT_EQUAL (NameSize, sizeof (L"KnobB"));
+  UT_ASSERT_MEM_EQUAL (Name, L"KnobB", sizeof (L"KnobB"));
+  UT_ASSERT_TRUE (CompareGuid (&Guid, &mTestGuid));
+
+  NameSize = sizeof (Name);
+  UT_ASSERT_NOT_EFI_ERROR (gRT->GetNextVariableName (&NameSize, Name, &Guid));
+  UT_ASSERT_MEM_EQUAL (Name, L"KnobC", sizeof (L"KnobC"));
+  UT_ASSERT_TRUE (CompareGuid (&Guid, &mOtherGuid));
+
+  NameSize = sizeof (Name);
+  UT_ASSERT_NOT_EFI_ERROR (gRT->GetNextVariableName (&NameSize, Name, &Guid));
+  UT_ASSERT_MEM_EQUAL (Name, L"KnobA", sizeof (L"KnobA"));
+  UT_ASSERT_TRUE (CompareGuid (&Guid, &mTestGuid));
+
+  NameSize = sizeof (Name);
+  Status   = gRT->GetNextVariableName (&NameSize, Name, &Guid);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // The previous name must exist and be terminated within the buffer
+  StrCpyS (Name, ARRAY_SIZE (Name), L"KnobD");
+  NameSize = sizeof (Name);
+  Status   = gRT->GetNextVariableName (&NameSize, Name, &Guid);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  NameSize = sizeof (L"Knob");
+  Status   = gRT->GetNextVariableName (&NameSize, Name, &Guid);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for the simulated cost of each access to the store.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MockVariableStoreCostModelTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MOCK_VARIABLE_STORE_STATS  Stats;
+  UINT32                     Value;
+  UINTN                      DataSize;
+
+  UT_ASSERT_NOT_EFI_ERROR (MockVariableStoreInitialize (&mTestCostModel));
+
+  // A new variable programs its record
+  Value = 1;
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.SetCount, 1);
+  UT_ASSERT_EQUAL (Stats.WriteCount, 1);
+  UT_ASSERT_EQUAL (Stats.BytesWritten, TEST_RECORD_SIZE);
+  UT_ASSERT_EQUAL (Stats.SimulatedNs, 1 + 100 + TEST_RECORD_SIZE * 10000);
+
+  // An identical update only costs the lookup
+  MockVariableStoreResetStats ();
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.WriteCount, 0);
+  UT_ASSERT_EQUAL (Stats.SkippedCount, 1);
+  UT_ASSERT_EQUAL (Stats.BytesWritten, 0);
+  UT_ASSERT_EQUAL (Stats.SimulatedNs, 1);
+
+  // A changed update programs the new record and the state byte of the previous one
+  MockVariableStoreResetStats ();
+  Value = 2;
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.WriteCount, 1);
+  UT_ASSERT_EQUAL (Stats.BytesWritten, TEST_RECORD_SIZE + 1);
+  UT_ASSERT_EQUAL (Stats.SimulatedNs, 1 + 100 + (TEST_RECORD_SIZE + 1) * 10000);
+
+  // Deleting then writing the same value defeats the identical update check
+  MockVariableStoreResetStats ();
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mTestGuid, 0, 0, NULL));
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.WriteCount, 2);
+  UT_ASSERT_EQUAL (Stats.BytesWritten, 1 + TEST_RECORD_SIZE);
+  UT_ASSERT_EQUAL (Stats.SimulatedNs, 2 * (1 + 100) + (1 + TEST_RECORD_SIZE) * 10000);
+
+  // Reads only cost the lookup
+  MockVariableStoreResetStats ();
+  DataSize = sizeof (Value);
+  UT_ASSERT_NOT_EFI_ERROR (gRT->GetVariable (L"Knob", &mTestGuid, NULL, &DataSize, &Value));
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.GetCount, 1);
+  UT_ASSERT_EQUAL (Stats.SimulatedNs, 1);
+  UT_ASSERT_EQUAL (Stats.ReclaimCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for reclaiming the store once it is full of invalidated records.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MockVariableStoreReclaimTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MOCK_VARIABLE_STORE_STATS  Stats;
+  EFI_STATUS                 Status;
+  UINT32                     Value;
+  UINT32                     Data;
+  UINTN                      DataSize;
+  UINT8                      LargeData[8 * TEST_RECORD_SIZE];
+
+  UT_ASSERT_NOT_EFI_ERROR (MockVariableStoreInitialize (&mTestCostModel));
+
+  // Two live variables and six invalidated records fill the store
+  Value = 0;
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mOtherGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  for (Value = 0; Value < 7; Value++) {
+    UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  }
+
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.ReclaimCount, 0);
+
+  // The next update erases the four blocks of the store and writes back the other live variable, then its record
+  MockVariableStoreResetStats ();
+  UT_ASSERT_NOT_EFI_ERROR (gRT->SetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value));
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.ReclaimCount, 1);
+  UT_ASSERT_EQUAL (Stats.BlocksErased, 4);
+  UT_ASSERT_EQUAL (Stats.BytesWritten, 2 * TEST_RECORD_SIZE);
+  UT_ASSERT_EQUAL (Stats.SimulatedNs, 1 + 100 + 4 * 1000000 + 2 * TEST_RECORD_SIZE * 10000);
+
+  DataSize = sizeof (Data);
+  UT_ASSERT_NOT_EFI_ERROR (gRT->GetVariable (L"Knob", &mTestGuid, NULL, &DataSize, &Data));
+  UT_ASSERT_EQUAL (Data, Value);
+
+  DataSize = sizeof (Data);
+  UT_ASSERT_NOT_EFI_ERROR (gRT->GetVariable (L"Knob", &mOtherGuid, NULL, &DataSize, &Data));
+  UT_ASSERT_EQUAL (Data, 0);
+
+  // A variable that cannot fit even once reclaimed is rejected without touching the store
+  MockVariableStoreResetStats ();
+  ZeroMem (LargeData, sizeof (LargeData));
+  Status = gRT->SetVariable (L"Large", &mTestGuid, TEST_ATTRIBUTES, sizeof (LargeData), LargeData);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_OUT_OF_RESOURCES);
+  MockVariableStoreGetStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.WriteCount, 0);
+  UT_ASSERT_EQUAL (Stats.ReclaimCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for the parameter validation of the store.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MockVariableStoreInvalidParamTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MOCK_VARIABLE_STORE_COST_MODEL  CostModel;
+  EFI_STATUS                      Status;
+  UINT32                          Value;
+  UINTN                           DataSize;
+  CHAR16                          Name[8];
+
+  CopyMem (&CostModel, &mTestCostModel, sizeof (CostModel));
+  CostModel.EraseBlockSize = 0;
+  UT_ASSERT_STATUS_EQUAL (MockVariableStoreInitialize (&CostModel), EFI_INVALID_PARAMETER);
+
+  CostModel.EraseBlockSize = mTestCostModel.EraseBlockSize;
+  CostModel.StoreSize      = 0;
+  UT_ASSERT_STATUS_EQUAL (MockVariableStoreInitialize (&CostModel), EFI_INVALID_PARAMETER);
+
+  UT_ASSERT_NOT_EFI_ERROR (MockVariableStoreInitialize (NULL));
+
+  Value = 0;
+  Status = MockVariableStoreSetVariable (NULL, &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  Status = MockVariableStoreSetVariable (L"", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), &Value);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  Status = MockVariableStoreSetVariable (L"Knob", NULL, TEST_ATTRIBUTES, sizeof (Value), &Value);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  Status = MockVariableStoreSetVariable (L"Knob", &mTestGuid, TEST_ATTRIBUTES, sizeof (Value), NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  DataSize = sizeof (Value);
+  Status = MockVariableStoreGetVariable (NULL, &mTestGuid, NULL, &DataSize, &Value);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  Status = MockVariableStoreGetVariable (L"Knob", NULL, NULL, &DataSize, &Value);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  Status = MockVariableStoreGetVariable (L"Knob", &mTestGuid, NULL, NULL, &Value);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  Status = MockVariableStoreGetVariable (L"Knob", &mTestGuid, NULL, &DataSize, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Name[0]  = L'\0';
+  DataSize = sizeof (Name);
+  UT_ASSERT_STATUS_EQUAL (MockVariableStoreGetNextVariableName (NULL, Name, &mTestGuid), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (MockVariableStoreGetNextVariableName (&DataSize, NULL, &mTestGuid), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (MockVariableStoreGetNextVariableName (&DataSize, Name, NULL), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  MockVariableStoreLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      MockVariableStoreLib;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the MockVariableStoreLib Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (
+             &MockVariableStoreLib,
+             Framework,
+             "MockVariableStoreLib Store Tests",
+             "MockVariableStoreLib.Store",
+             NULL,
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for MockVariableStoreLib\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (
+    MockVariableStoreLib,
+    "Variables should read back",
+    "MockVariableStoreGetSetTest",
+    MockVariableStoreGetSetTest,
+    NULL,
+    MockVariableStoreCleanup,
+    NULL
+    );
+  AddTestCase (
+    MockVariableStoreLib,
+    "Variables should enumerate in record order",
+    "MockVariableStoreGetNextVariableNameTest",
+    MockVariableStoreGetNextVariableNameTest,
+    NULL,
+    MockVariableStoreCleanup,
+    NULL
+    );
+  AddTestCase (
+    MockVariableStoreLib,
+    "Accesses should follow the cost model",
+    "MockVariableStoreCostModelTest",
+    MockVariableStoreCostModelTest,
+    NULL,
+    MockVariableStoreCleanup,
+    NULL
+    );
+  AddTestCase (
+    MockVariableStoreLib,
+    "Full store should be reclaimed",
+    "MockVariableStoreReclaimTest",
+    MockVariableStoreReclaimTest,
+    NULL,
+    MockVariableStoreCleanup,
+    NULL
+    );
+  AddTestCase (
+    MockVariableStoreLib,
+    "Null Param test should fail",
+    "MockVariableStoreInvalidParamTest",
+    MockVariableStoreInvalidParamTest,
+    NULL,
+    MockVariableStoreCleanup,
+    NULL
+    );
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -10,8 +10,13 @@
 ##
 # Import Modules
 #
+import os
+import ctypes
 import string
 import hashlib
+import bisect
+import struct
+import functools
 import xml.etree.ElementTree as ET
 
 
@@ -34,7 +39,8 @@ def _try_get_fw_schema_xml_hash():
         return None
 
 
-def validate_config_xml_hash_against_fw(xml_path, *, skip_check=False, ignore_mismatch=False, logger=None):
+def validate_config_xml_hash_against_fw(xml_path, *, skip_check=False, ignore_mismatch=False, logger=None,
+                                        xml_hash=None):
     """Validate that the given config XML matches the platform FW schema hash.
 
     Args:
@@ -42,6 +48,8 @@ def validate_config_xml_hash_against_fw(xml_path, *, skip_check=False, ignore_mi
         skip_check (bool): If True, do not perform FW comparison.
         ignore_mismatch (bool): If True, do not fail on mismatch (still logs warning).
         logger (callable | None): Optional logging function. Defaults to print.
+        xml_hash (str | None): Hash of the config XML when the caller already has it,
+            e.g. Schema.hash. Computed from xml_path otherwise.
 
     Returns:
         tuple[bool, str | None, str | None]: (ok, fw_hash, xml_hash)
@@ -54,12 +62,12 @@ def validate_config_xml_hash_against_fw(xml_path, *, skip_check=False, ignore_mi
         return (True, None, None)
 
     fw_hash = _try_get_fw_schema_xml_hash()
-    xml_hash = None
-    try:
-        xml_hash = get_xml_full_hash(xml_path)
-    except Exception as e:
-        log(f"ERROR: Failed to compute XML hash for '{xml_path}': {e}")
-        return (False, fw_hash, None)
+    if xml_hash is None:
+        try:
+            xml_hash = get_xml_full_hash(xml_path)
+        except Exception as e:
+            log(f"ERROR: Failed to compute XML hash for '{xml_path}': {e}")
+            return (False, fw_hash, None)
 
     # If FW hash can't be obtained, we can't validate; treat as non-fatal.
     if fw_hash is None:
@@ -74,6 +82,21 @@ def validate_config_xml_hash_against_fw(xml_path, *, skip_check=False, ignore_mi
     return (True, fw_hash, xml_hash)
 
 
+#
+# check the privilege level needed to access the system variables and report error
+#
+def has_privilege():
+    if os.name == 'nt':
+        if not ctypes.windll.shell32.IsUserAnAdmin():
+            print("Administrator privilege required. Please launch from an Administrator privilege level.")
+            return False
+    else:
+        if os.geteuid() != 0:
+            print("Root permission required, please run script with sudo.")
+            return False
+    return True
+
+
 def print_bytes(data, indent=0, offset=0, show_ascii=False):
     bytes_per_line = 16
     printable = ' ' + string.ascii_letters + string.digits + string.punctuation
@@ -87,29 +110,136 @@ def print_bytes(data, indent=0, offset=0, show_ascii=False):
         print(str_fmt.format(indent * ' ', offset + idx, hex_str, ' ' + asc_str if show_ascii else ''))
 
 
+# struct codes of the little endian integers that can be read in a single unpack
+_INT_CODES = {1: 'B', 2: 'H', 4: 'I', 8: 'Q'}
+
+
+# Precomputed plan to read and write a bit field of a buffer
+#
+# The byte range, shift and mask of the field are computed once. Reads and writes only touch the bytes of the field,
+# through a precompiled struct when the range is 1, 2, 4 or 8 bytes, or through a memoryview slice otherwise, instead
+# of converting the whole buffer to an integer.
+class BitField:
+    def __init__(self, start, length):
+        self.start = start
+        self.length = length
+        self.byte_start = start // 8
+        self.byte_end = (start + length + 7) // 8 if length else self.byte_start
+        self.shift = start & 7
+        self.mask = (1 << length) - 1
+        code = _INT_CODES.get(self.byte_end - self.byte_start)
+        self.struct = struct.Struct('<' + code) if code else None
+
+    def read(self, buffer, offset=0):
+        if self.struct is not None:
+            return self.struct.unpack_from(buffer, offset + self.byte_start)[0]
+        with memoryview(buffer) as view:
+            return int.from_bytes(view[offset + self.byte_start:offset + self.byte_end], 'little')
+
+    def get(self, buffer, offset=0):
+        if self.length == 0:
+            return 0
+        return (self.read(buffer, offset) >> self.shift) & self.mask
+
+    def set(self, buffer, value, offset=0):
+        if self.length == 0:
+            return
+        raw = self.read(buffer, offset)
+        raw = (raw & ~(self.mask << self.shift)) | ((value & self.mask) << self.shift)
+        if self.struct is not None:
+            self.struct.pack_into(buffer, offset + self.byte_start, raw)
+        else:
+            buffer[offset + self.byte_start:offset + self.byte_end] = raw.to_bytes(
+                self.byte_end - self.byte_start, 'little')
+
+
+@functools.lru_cache(maxsize=1024)
+def get_bit_field(start, length):
+    return BitField(start, length)
+
+
+# Precomputed plan to read and write a set of bit fields of a buffer in one go, e.g. all the items of a page
+#
+# Fields sharing bytes are merged into chunks and all the chunks are read with a single struct unpack, so a batch
+# costs one call plus a shift and mask per field.
+class BitFieldPlan:
+    def __init__(self, fields):
+        self.fields = [get_bit_field(start, length) for start, length in fields]
+
+        # Merge the byte ranges of the fields into non overlapping chunks
+        ranges = sorted(set((field.byte_start, field.byte_end) for field in self.fields if field.length))
+        chunks = []
+        for byte_start, byte_end in ranges:
+            if chunks and byte_start < chunks[-1][1]:
+                chunks[-1][1] = max(chunks[-1][1], byte_end)
+            else:
+                chunks.append([byte_start, byte_end])
+        self.size = chunks[-1][1] if chunks else 0
+
+        fmt = '<'
+        position = 0
+        self.chunks = []
+        for byte_start, byte_end in chunks:
+            if byte_start > position:
+                fmt += '%dx' % (byte_start - position)
+            code = _INT_CODES.get(byte_end - byte_start)
+            fmt += code if code else '%ds' % (byte_end - byte_start)
+            self.chunks.append((byte_start, byte_end, struct.Struct('<' + code) if code else None))
+            position = byte_end
+        self.struct = struct.Struct(fmt)
+
+        # Chunk index and shift within the chunk of each field
+        starts = [chunk[0] for chunk in self.chunks]
+        self.plan = []
+        for field in self.fields:
+            if field.length == 0:
+                self.plan.append((None, 0, 0))
+                continue
+            index = bisect.bisect_right(starts, field.byte_start) - 1
+            self.plan.append((index, field.start - starts[index] * 8, field.mask))
+
+    def _read_chunks(self, buffer, offset):
+        if len(buffer) < offset + self.size:
+            raise ValueError("Buffer of %d bytes is too small for bit fields up to byte %d"
+                             % (len(buffer) - offset, self.size))
+        raws = self.struct.unpack_from(buffer, offset)
+        return [raw if isinstance(raw, int) else int.from_bytes(raw, 'little') for raw in raws]
+
+    # Return the values of all fields, in the order of the fields
+    def get(self, buffer, offset=0):
+        raws = self._read_chunks(buffer, offset)
+        return [(raws[index] >> shift) & mask if index is not None else 0 for index, shift, mask in self.plan]
+
+    # Write the values of all fields, in the order of the fields
+    def set(self, buffer, values, offset=0):
+        raws = self._read_chunks(buffer, offset)
+        for (index, shift, mask), value in zip(self.plan, values):
+            if index is not None:
+                raws[index] = (raws[index] & ~(mask << shift)) | ((value & mask) << shift)
+        for (byte_start, byte_end, chunk_struct), raw in zip(self.chunks, raws):
+            if chunk_struct is not None:
+                chunk_struct.pack_into(buffer, offset + byte_start, raw)
+            else:
+                buffer[offset + byte_start:offset + byte_end] = raw.to_bytes(byte_end - byte_start, 'little')
+
+
 def get_bits_from_bytes(bytes, start, length):
-    if length == 0:
-        return 0
-    byte_start = (start) // 8
-    byte_end = (start + length - 1) // 8
-    bit_start = start & 7
-    mask = (1 << length) - 1
-    val = bytes_to_value(bytes[byte_start:byte_end + 1])
-    val = (val >> bit_start) & mask
-    return val
+    field = get_bit_field(start, length)
+    if len(bytes) < field.byte_end:
+        # Bits beyond the buffer read as 0
+        return (bytes_to_value(bytes[field.byte_start:field.byte_end]) >> field.shift) & field.mask
+    return field.get(bytes)
 
 
 def set_bits_to_bytes(bytes, start, length, bvalue):
-    if length == 0:
+    field = get_bit_field(start, length)
+    if length and len(bytes) < field.byte_end:
+        # The buffer grows to hold the field
+        val = bytes_to_value(bytes[field.byte_start:field.byte_end])
+        val = (val & ~(field.mask << field.shift)) | ((bvalue & field.mask) << field.shift)
+        bytes[field.byte_start:field.byte_end] = value_to_bytearray(val, field.byte_end - field.byte_start)
         return
-    byte_start = (start) // 8
-    byte_end = (start + length - 1) // 8
-    bit_start = start & 7
-    mask = (1 << length) - 1
-    val = bytes_to_value(bytes[byte_start:byte_end + 1])
-    val &= ~(mask << bit_start)
-    val |= ((bvalue & mask) << bit_start)
-    bytes[byte_start:byte_end + 1] = value_to_bytearray(val, byte_end + 1 - byte_start)
+    field.set(bytes, bvalue)
 
 
 def check_quote(text):
@@ -149,6 +279,8 @@ def bytes_to_bracket_str(bytes):
     return '{ %s }' % (', '.join('0x%02x' % i for i in bytes))
 
 
+# The strings come from the config items and are parsed again on every refresh, so the results are cached
+@functools.lru_cache(maxsize=4096)
 def array_str_to_value(val_str):
     val_str = val_str.strip()
     val_str = strip_delimiter(val_str, '{}')
@@ -160,30 +292,85 @@ def array_str_to_value(val_str):
     return value
 
 
-def get_xml_full_hash(xml_path):
-    # Parse the XML file
-    tree = ET.parse(xml_path)
-    root = tree.getroot()
+# Suffix of the optional file next to a config XML that records its hash
+XML_HASH_SIDECAR_SUFFIX = '.hash'
+
+_XMLNS_NAMESPACE = 'http://www.w3.org/2000/xmlns/'
 
-    # List to store all tags, attributes, and values
+
+# The hash embedded as gSchemaXmlHash covers the tag names and the sorted attributes of all the elements in document
+# order, with namespaced names in ElementTree's {uri}name form. Text and comments are not part of it.
+def _get_xml_nodes_hash(nodes):
     hash_content = []
+    for tag, attributes in nodes:
+        hash_content.append(tag)
+        hash_content.extend(f"{key}={value}" for key, value in sorted(attributes))
+    return hashlib.md5(''.join(hash_content).encode('utf-8')).hexdigest()
+
+
+def _get_element_tree_nodes(root):
+    for element in root.iter():
+        yield element.tag, element.attrib.items()
 
-    def traverse(element):
-        # Add tag name
-        hash_content.append(element.tag)
 
-        # Add attribute names and values
-        for key, value in sorted(element.attrib.items()):
-            hash_content.append(f"{key}={value}")
+def _get_dom_name(node):
+    if node.namespaceURI:
+        return f"{{{node.namespaceURI}}}{node.localName}"
+    return node.nodeName
+
+
+def _get_dom_nodes(document):
+    pending = [document.documentElement]
+    while pending:
+        element = pending.pop()
+        # Namespace declarations are not attributes in ElementTree
+        attributes = [(_get_dom_name(attribute), attribute.value) for attribute in element.attributes.values()
+                      if attribute.namespaceURI != _XMLNS_NAMESPACE]
+        yield _get_dom_name(element), attributes
+        pending.extend(reversed([child for child in element.childNodes if child.nodeType == child.ELEMENT_NODE]))
+
+
+# Get the hash of a config XML that was already parsed with xml.dom.minidom
+def get_dom_full_hash(document):
+    return _get_xml_nodes_hash(_get_dom_nodes(document))
+
+
+def _get_xml_hash_sidecar_stamp(xml_path):
+    stat = os.stat(xml_path)
+    return f"{stat.st_size} {stat.st_mtime_ns}"
+
+
+# Read the hash recorded next to xml_path, None if there is none or the XML changed since it was recorded
+def read_xml_hash_sidecar(xml_path):
+    try:
+        with open(xml_path + XML_HASH_SIDECAR_SUFFIX, 'r') as sidecar:
+            xml_hash, stamp = sidecar.read().strip().split(' ', 1)
+        if stamp != _get_xml_hash_sidecar_stamp(xml_path):
+            return None
+        return xml_hash
+    except (OSError, ValueError):
+        return None
+
+
+# Record the hash of xml_path next to it, best effort since the XML may live in a read only location
+def write_xml_hash_sidecar(xml_path, xml_hash):
+    try:
+        stamp = _get_xml_hash_sidecar_stamp(xml_path)
+        with open(xml_path + XML_HASH_SIDECAR_SUFFIX, 'w') as sidecar:
+            sidecar.write(f"{xml_hash} {stamp}\n")
+        return True
+    except OSError:
+        return False
 
-        # Recursively process each child element
-        for child in element:
-            traverse(child)
 
-    # Start traversing the root node
-    traverse(root)
+def get_xml_full_hash(xml_path, sidecar=False):
+    if sidecar:
+        xml_hash = read_xml_hash_sidecar(xml_path)
+        if xml_hash is not None:
+            return xml_hash
 
-    # Combine all items in hash_content list into a single string
-    combined_string = ''.join(hash_content)
+    xml_hash = _get_xml_nodes_hash(_get_element_tree_nodes(ET.parse(xml_path).getroot()))
 
-    return hashlib.md5(combined_string.encode('utf-8')).hexdigest()
+    if sidecar:
+        write_xml_hash_sidecar(xml_path, xml_hash)
+    return xml_hash
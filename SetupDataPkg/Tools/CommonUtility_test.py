@@ -9,7 +9,10 @@
 ##
 # Import Modules
 #
+import os
+import tempfile
 import unittest
+from xml.dom.minidom import parseString
 import CommonUtility
 
 
@@ -57,6 +60,92 @@ class CommonUtilityTest(unittest.TestCase):
         CommonUtility.set_bits_to_bytes(input, 25, 4, 9)
         self.assertEqual(input, b'dearbeef')
 
+    # Bits beyond a short buffer read as 0 and writing them grows the buffer
+    def test_bits_beyond_buffer(self):
+        self.assertEqual(CommonUtility.get_bits_from_bytes(b'Q', 4, 12), (ord('Q') & 0xF0) >> 4)
+        input = bytearray(b'Q')
+        CommonUtility.set_bits_to_bytes(input, 12, 8, 0xAB)
+        self.assertEqual(input, bytearray([ord('Q'), 0xB0, 0x0A]))
+
+    # Bit fields should read and write only their bits, at any offset into the buffer
+    def test_bit_field(self):
+        field = CommonUtility.BitField(12, 8)
+        self.assertEqual((field.byte_start, field.byte_end, field.shift), (1, 3, 4))
+        self.assertEqual(field.get(bytes([0x00, 0xA0, 0x0B])), 0xBA)
+        self.assertEqual(field.get(memoryview(bytes([0xFF, 0x00, 0xA0, 0x0B]))[1:]), 0xBA)
+        self.assertEqual(field.get(bytes([0xFF, 0x00, 0xA0, 0x0B]), 1), 0xBA)
+
+        input = bytearray(b'\xff\xff\xff')
+        field.set(input, 0)
+        self.assertEqual(input, bytearray([0xFF, 0x0F, 0xF0]))
+
+        # Ranges without a struct code go through a memoryview slice
+        field = CommonUtility.BitField(8, 24)
+        self.assertIsNone(field.struct)
+        input = bytearray(5)
+        field.set(input, 0x123456)
+        self.assertEqual(input, bytearray([0x00, 0x56, 0x34, 0x12, 0x00]))
+        self.assertEqual(field.get(input), 0x123456)
+
+        self.assertEqual(CommonUtility.BitField(3, 0).get(b''), 0)
+
+    # Plans should read and write all their fields like the single field functions
+    def test_bit_field_plan(self):
+        fields = [(0, 8), (8, 1), (9, 7), (12, 8), (24, 32), (56, 24), (100, 0)]
+        input = bytearray(b'deadbeefcafe')
+        plan = CommonUtility.BitFieldPlan(fields)
+        self.assertEqual(plan.size, 10)
+        self.assertEqual(plan.get(input), [CommonUtility.get_bits_from_bytes(input, s, n) for s, n in fields])
+        self.assertEqual(plan.get(b'\x00\x00' + input, 2), plan.get(input))
+
+        # Overlapping fields are written in order
+        values = [0x11, 1, 0x7F, 0x5A, 0xDEADBEEF, 0xABCDEF, 3]
+        expected = bytearray(input)
+        for (start, length), value in zip(fields, values):
+            CommonUtility.set_bits_to_bytes(expected, start, length, value)
+        plan.set(input, values)
+        self.assertEqual(input, expected)
+
+        with self.assertRaises(ValueError):
+            plan.get(b'short')
+        self.assertEqual(CommonUtility.BitFieldPlan([]).get(b''), [])
+
+    # Parsing array strings should keep working through the cache
+    def test_array_str_to_value(self):
+        self.assertEqual(CommonUtility.array_str_to_value('{ 0x01, 0x02 }'), 0x0201)
+        self.assertEqual(CommonUtility.array_str_to_value('{ 0x01, 0x02 }'), 0x0201)
+        self.assertEqual(CommonUtility.array_str_to_value('7'), 7)
+
+    # Hashing a parsed DOM should match hashing the file, including namespaced names
+    def test_dom_full_hash(self):
+        xml = ('<Root xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xsi:noNamespaceSchemaLocation="a.xsd">'
+               '<!-- comment --><B z="1" a="2">text<C/></B><D xmlns="urn:d"><E e="&amp;"/></D></Root>')
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, 'config.xml')
+            with open(path, 'w') as xml_file:
+                xml_file.write(xml)
+            self.assertEqual(CommonUtility.get_dom_full_hash(parseString(xml)), CommonUtility.get_xml_full_hash(path))
+
+    # The sidecar should only be used while the XML is unchanged
+    def test_xml_hash_sidecar(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, 'config.xml')
+            with open(path, 'w') as xml_file:
+                xml_file.write('<Root a="1"/>')
+            self.assertIsNone(CommonUtility.read_xml_hash_sidecar(path))
+
+            xml_hash = CommonUtility.get_xml_full_hash(path, sidecar=True)
+            self.assertEqual(xml_hash, CommonUtility.get_xml_full_hash(path))
+            self.assertEqual(CommonUtility.read_xml_hash_sidecar(path), xml_hash)
+
+            CommonUtility.write_xml_hash_sidecar(path, 'cached')
+            self.assertEqual(CommonUtility.get_xml_full_hash(path, sidecar=True), 'cached')
+
+            with open(path, 'w') as xml_file:
+                xml_file.write('<Root a="2" b="3"/>')
+            self.assertIsNone(CommonUtility.read_xml_hash_sidecar(path))
+            self.assertNotEqual(CommonUtility.get_xml_full_hash(path, sidecar=True), xml_hash)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -25,11 +25,10 @@ import ReadUefiVarsToConfVarList as uefi_var_read               # noqa: E402
 import BoardMiscInfo                                            # noqa: E402
 from VariableList import Schema                                 # noqa: E402
 from CommonUtility import (                                     # noqa: E402
-    bytes_to_value,
     bytes_to_bracket_str,
     value_to_bytes,
     array_str_to_value,
-    get_xml_full_hash
+    BitFieldPlan
 )
 from KnobDelta import CompareConfigs                             # noqa: E402
 
@@ -196,6 +195,14 @@ class custom_table(ttk.Treeview):
         self.size = len(bins)
         self.last_dir = ""
 
+        # Every cell of the table is a field of the binary, read all of them in one go on load and refresh
+        col_offsets = [sum(col_byte_len[:col]) for col in range(cols)]
+        self.col_offsets = col_offsets
+        self.cell_plan = BitFieldPlan(
+            ((row * byte_len + col_offsets[col]) * 8, col_byte_len[col] * 8)
+            for row in range(rows) for col in range(cols)
+        )
+
         style = ttk.Style()
         style.configure(
             "Custom.Treeview.Heading", font=("calibri", 10, "bold"), foreground="blue"
@@ -227,6 +234,7 @@ class custom_table(ttk.Treeview):
                 anchor=tkinter.CENTER,
             )
 
+        cell_values = self.read_cells(bins)
         idx = 0
         for row in range(rows):  # Rows
             text = "%04X" % (row * len(col_hdr))
@@ -234,8 +242,8 @@ class custom_table(ttk.Treeview):
             for col in range(cols):  # Columns
                 if idx >= len(bins):
                     break
-                byte_len = int(col_hdr[col].split(":")[1])
-                value = bytes_to_value(bins[idx: idx + byte_len])
+                byte_len = col_byte_len[col]
+                value = cell_values[row * cols + col]
                 hex = ("%%0%dX" % (byte_len * 2)) % value
                 vals.append(hex)
                 idx += byte_len
@@ -254,23 +262,32 @@ class custom_table(ttk.Treeview):
     def focus_out(self, event):
         self.entry.display(None)
 
+    # Return the values of all cells, a partial last row reads as if padded with zeros
+    def read_cells(self, bins):
+        padding = self.cell_plan.size - len(bins)
+        if padding > 0:
+            bins = bytes(bins) + bytes(padding)
+        return self.cell_plan.get(bins)
+
     def refresh_bin(self, bins):
         if not bins:
             return
 
         # Reload binary into widget
         bin_len = len(bins)
+        row_len = sum(self.col_byte_len)
+        cell_values = self.read_cells(bins)
+        children = self.get_children()
         for row in range(self.rows):
-            iid = self.get_children()[row]
+            iid = children[row]
             for col in range(self.cols):
-                idx = row * sum(self.col_byte_len) + sum(self.col_byte_len[:col])
+                idx = row * row_len + self.col_offsets[col]
                 byte_len = self.col_byte_len[col]
                 if idx + byte_len <= self.size:
-                    byte_len = int(self.col_hdr[col].split(":")[1])
                     if idx + byte_len > bin_len:
                         val = 0
                     else:
-                        val = bytes_to_value(bins[idx: idx + byte_len])
+                        val = cell_values[row * self.cols + col]
                     hex_val = ("%%0%dX" % (byte_len * 2)) % val
                     self.set(iid, col + 1, hex_val)
 
@@ -382,6 +399,22 @@ class cfg_data:
         self.config_type = ''
 
 
+# Rows of the config page on display. Widgets are only created for the rows that were scrolled into view, a row is
+# placed on grid row first_row + 2 * index whenever it gets created.
+class page_rows:
+    def __init__(self, items=None, first_row=0, file_id=None):
+        self.items = items if items is not None else []
+        self.first_row = first_row
+        self.file_id = file_id
+        self.rendered = 0
+        # Row index to (label, widget) of the rendered rows that have widgets
+        self.widgets = {}
+        self.pending = None
+
+    def done(self):
+        return self.rendered >= len(self.items)
+
+
 class application(tkinter.Frame):
     def __init__(self, master=None):
         root = master
@@ -402,6 +435,11 @@ class application(tkinter.Frame):
         self.page_size = 500   # Number of items per page, this should be <= 532 in current version
         self.current_page = 0  # Initial page
         self.total_pages = 0   # Default value
+        # Lazy rendering, rows are created in chunks once the view gets close to the last rendered row
+        self.page_rows = page_rows()
+        self.render_chunk_size = 40
+        self.render_threshold = 0.9
+        self.search_result = set()
 
         # Check if current directory contains a file with a .yaml extension
         # if not default self.last_dir to a Platform directory where it is
@@ -505,7 +543,7 @@ class application(tkinter.Frame):
             frame_right, orient="vertical", command=self.conf_canvas.yview
         )
         self.right_grid = ttk.Frame(self.conf_canvas)
-        self.conf_canvas.configure(yscrollcommand=self.page_scroll.set)
+        self.conf_canvas.configure(yscrollcommand=self.on_page_view_change)
         self.conf_canvas.pack(
             side="left", fill=tkinter.BOTH, expand=True, pady=pady, padx=(5, 0)
         )
@@ -659,41 +697,29 @@ class application(tkinter.Frame):
         self.current_match_index = -1
 
         def expand_tree_to_page(page_id_list):
-            leaf_list = []
-            for item in self.left.get_children():
-                for child in self.left.get_children(item):
-                    for leaf in self.left.get_children(child):
-                        leaf_list.append(leaf)
-            sorted_page_id_list = sorted(page_id_list, key=lambda x: leaf_list.index(x))
-            first_page_id = sorted_page_id_list[0]
+            first_page_id = page_id_list[0]
             self.left.selection_set(first_page_id)
             self.left.see(first_page_id)
 
-        def find_matching_knob_name(data, struct_name):
-            return next((knob.name for knob in data.schema.knobs if knob.type == struct_name), False)
-
         def highlight_left_tree_label(page_id_list):
+            page_id_set = set(page_id_list)
             self.left.tag_configure("highlight", background="yellow")
             for item in self.left.get_children():
                 for child in self.left.get_children(item):
                     for leaf in self.left.get_children(child):
-                        if leaf in page_id_list:
+                        if leaf in page_id_set:
                             self.left.item(leaf, tags="highlight")
                             self.left.see(leaf)
 
+        # Pages in the order of the left tree, which lists the config files and their knobs in load order
         def search_in_config_data(search_term):
-            search_term = search_term.lower()
-            page_id_list = set()
+            page_id_list = {}
             for cfg_data in self.cfg_data_list.values():
-                data = cfg_data.cfg_data_obj
-                for struct in data.schema.structs:
-                    for member in struct.members:
-                        name = (member.pretty_name or member.name).lower()
-                        if search_term in name:
-                            knob_name = find_matching_knob_name(data, struct.name)
-                            if knob_name:
-                                page_id = f"{data.schema.knobs[0].namespace}.{knob_name}"
-                                page_id_list.add(page_id)
+                for item in cfg_data.cfg_data_obj.search_cfg_items(search_term):
+                    page_id = ".".join(item["path"].split(".")[:2])
+                    if page_id in self.page_list:
+                        self.search_result.add(id(item))
+                        page_id_list[page_id] = True
             return list(page_id_list)
 
         search_term = self.search_var.get().lower()
@@ -703,7 +729,7 @@ class application(tkinter.Frame):
 
         self.clear_search(clear_search_bar=False)
         search_result = search_in_config_data(search_term)
-        print(f"search result: {search_result}")
+        print(f"search result: {len(search_result)} page(s)")
         if search_result:
             self.remove_highlight_in_left_tree()
             self.search_active = True
@@ -727,6 +753,7 @@ class application(tkinter.Frame):
         self.reset_widget_backgrounds()
         self.master.focus_set()
         self.search_active = False
+        self.search_result = set()
         self.current_matches = []
         self.current_match_index = -1
         self.match_label.config(text="")
@@ -736,15 +763,15 @@ class application(tkinter.Frame):
             if isinstance(widget, tkinter.Label):
                 widget.configure(background=self.cget("background"))
 
+    # Matches are rows of the page, their labels are highlighted as they get rendered
     def highlight_label(self):
-        search_term = self.search_var.get().lower()
         self.current_matches = [
-            widget for widget in self.right_grid.winfo_children()[1:]
-            if search_term in widget.cget('text').lower() and isinstance(widget, tkinter.Label)
+            index for index, item in enumerate(self.page_rows.items)
+            if id(item) in self.search_result and item["type"].upper() != "ARRAY_KNOB"
         ]
 
-        for widget in self.current_matches:
-            widget.configure(background="yellow")
+        for index in self.page_rows.widgets:
+            self.highlight_row_label(index)
 
         if self.current_matches:
             self.current_match_index = 0
@@ -752,16 +779,21 @@ class application(tkinter.Frame):
         else:
             self.match_label.config(text="")
 
+    def highlight_row_label(self, index):
+        if id(self.page_rows.items[index]) in self.search_result:
+            self.page_rows.widgets[index][0].configure(background="yellow")
+
     def highlight_current_entry(self):
         if not self.current_matches:
             return
 
-        widget_list = self.right_grid.winfo_children()[1:]
-        current_widget = self.current_matches[self.current_match_index]
-        label_index = widget_list.index(current_widget)
-        entry_widget = widget_list[label_index + 1]
+        index = self.current_matches[self.current_match_index]
+        self.render_page_rows(index + 1)
+        if index not in self.page_rows.widgets:
+            return
+        current_widget, entry_widget = self.page_rows.widgets[index]
 
-        if hasattr(entry_widget, 'selection_range'):
+        if entry_widget is not None and hasattr(entry_widget, 'selection_range'):
             entry_value = entry_widget.get()
             entry_widget.selection_range(0, len(entry_value))
             entry_widget.focus_set()
@@ -812,6 +844,41 @@ class application(tkinter.Frame):
             self.on_page_scroll(event)
             return "break"
 
+    def on_page_view_change(self, first, last):
+        self.page_scroll.set(first, last)
+        if float(last) >= self.render_threshold:
+            self.schedule_page_rows()
+
+    def schedule_page_rows(self):
+        if self.page_rows.pending is None and not self.page_rows.done():
+            self.page_rows.pending = self.after_idle(self.render_next_page_rows)
+
+    def render_next_page_rows(self):
+        self.page_rows.pending = None
+        self.render_page_rows(self.page_rows.rendered + self.render_chunk_size)
+
+    # Create the widgets of the page rows up to, but not including, row index end
+    def render_page_rows(self, end):
+        rows = self.page_rows
+        end = min(end, len(rows.items))
+        if rows.rendered >= end:
+            return
+
+        start = rows.rendered
+        rows.rendered = end
+        for index in range(start, end):
+            widgets = self.add_config_item(rows.items[index], rows.first_row + 2 * index, rows.file_id)
+            if widgets is None:
+                continue
+            rows.widgets[index] = widgets
+            for widget in widgets:
+                if widget is not None:
+                    self.update_visibility_for_widget(widget, None)
+            if self.search_active:
+                self.highlight_row_label(index)
+
+        self.update_page_scroll_bar()
+
     def on_page_scroll(self, event):
         if self.in_right.get():
             # Only scroll when it is in active area
@@ -910,6 +977,9 @@ class application(tkinter.Frame):
 
         parent.grid_forget()
         self.conf_list.clear()
+        if self.page_rows.pending is not None:
+            self.after_cancel(self.page_rows.pending)
+        self.page_rows = page_rows()
 
     def build_config_page_tree(self, cfg_page, parent, file_id):
         for page in cfg_page["child"]:
@@ -971,13 +1041,10 @@ class application(tkinter.Frame):
         self.add_config_item(disp_list[1], row, self.page_cfg_map[page_id])
         row += 2
 
-        for item in disp_list[page_start:page_end]:
-            self.add_config_item(item, row, self.page_cfg_map[page_id])
-            row += 2
-
-        # Update widgets and scrollbar
+        # The rows are rendered once they get close to the view, starting with the first chunk
+        self.page_rows = page_rows(disp_list[page_start:page_end], row, self.page_cfg_map[page_id])
         self.update_widgets_visibility_on_page()
-        self.update_page_scroll_bar()
+        self.render_page_rows(self.render_chunk_size)
 
         if self.search_active:
             self.highlight_label()
@@ -1251,8 +1318,8 @@ class application(tkinter.Frame):
         self.config_xml_path = path
         self.output_current_status(f"{path} file is loaded")
         self.default_cfg_data_obj = copy.deepcopy(self.cfg_data_list[file_id].cfg_data_obj)
-        # load xml file and get the hash value of all xml nodes
-        config_xml_hash = get_xml_full_hash(self.config_xml_path)
+        # hash value of all xml nodes, computed when the schema was loaded
+        config_xml_hash = self.cfg_data_list[file_id].cfg_data_obj.schema.hash
 
         # Compare the xml hash and the hash claimed in FW.
         if self.bios_schema_xml_hash is not None and config_xml_hash != self.bios_schema_xml_hash:
@@ -1689,6 +1756,10 @@ class application(tkinter.Frame):
             widget.grid(
                 row=row + 1, rowspan=1, column=0, padx=10, pady=5, sticky="nsew"
             )
+            return (name, widget)
+        elif itype.upper() in ['STRUCT_KNOB']:
+            return (name, None)
+        return None
 
     def update_config_data_on_page(self):
         self.walk_widgets_in_layout(
@@ -8,6 +8,7 @@
 
 import sys
 import re
+import bisect
 from collections import OrderedDict
 import base64
 import argparse
@@ -57,12 +58,7 @@ class CGenNCCfgData:
             return self.knob_shim
         else:
             # build a new list for items under a page ID
-            cfgs = [
-                i
-                for i in self.knob_shim
-                if (".".join(i["path"].split(".")[:2]) == page_id)
-            ]
-            return cfgs
+            return list(self._page_shim_index.get(page_id, []))
 
     def get_cfg_page(self):
         return self._cfg_page
@@ -128,17 +124,7 @@ class CGenNCCfgData:
         return None
 
     def get_item_by_path(self, path):
-        for each in self.knob_shim:
-            path_list = path.split(".")
-            namespace = path_list[0]
-            var_path = ".".join(path_list[1:])
-            if (
-                each["inst"].knob.namespace == namespace
-                and each["inst"].name == var_path
-                and each["inst"].leaf is True
-            ):
-                return each
-        return None
+        return self._leaf_shim_index.get(path)
 
     def add_cfg_page(self, child, parent, title=""):
         def _add_cfg_page(cfg_page, child, parent):
@@ -211,8 +197,64 @@ class CGenNCCfgData:
 
         return ret_list
 
-    def sync_shim_and_schema(self):
+    # Index the shim by knob, by page and by path of its leaves, so that lookups and syncs only touch the relevant
+    # entries
+    def build_shim_index(self):
+        self._knob_shim_index = {}
+        self._leaf_shim_index = {}
+        self._page_shim_index = {}
+        for shim in self.knob_shim:
+            data = shim["inst"]
+            self._knob_shim_index.setdefault(data.knob, []).append(shim)
+            self._page_shim_index.setdefault(".".join(shim["path"].split(".")[:2]), []).append(shim)
+            if data.leaf is True:
+                self._leaf_shim_index.setdefault(shim["path"], shim)
+        self.build_search_index()
+
+    # Join the lower case names and help texts of the shim into one string, so that a search is a handful of substring
+    # finds instead of a walk over every entry. Values change while editing and are matched when searching.
+    def build_search_index(self):
+        self._search_offsets = []
+        texts = []
+        offset = 0
         for shim in self.knob_shim:
+            text = "\n".join([shim["name"], shim["cname"], shim["help"] or ""]).lower()
+            self._search_offsets.append(offset)
+            texts.append(text)
+            offset += len(text) + 1
+        self._search_text = "\0".join(texts)
+
+    # Return the shim entries whose name, help or value contains the search term, in shim order
+    def search_cfg_items(self, search_term):
+        search_term = search_term.lower()
+        if not search_term:
+            return []
+
+        found = set()
+        pos = self._search_text.find(search_term)
+        while pos >= 0:
+            idx = bisect.bisect_right(self._search_offsets, pos) - 1
+            found.add(idx)
+            if idx + 1 >= len(self._search_offsets):
+                break
+            pos = self._search_text.find(search_term, self._search_offsets[idx + 1])
+
+        for idx, shim in enumerate(self.knob_shim):
+            if idx not in found and shim["value"] is not None and search_term in shim["value"].lower():
+                found.add(idx)
+
+        return [self.knob_shim[idx] for idx in sorted(found)]
+
+    # Sync the shim values of the given knobs, or of all knobs if none are given
+    def sync_shim_and_schema(self, knobs=None):
+        if knobs is None:
+            shims = self.knob_shim
+        else:
+            shims = []
+            for knob in dict.fromkeys(knobs):
+                shims += self._knob_shim_index.get(knob, [])
+
+        for shim in shims:
             data = shim["inst"]
             shim["value"] = data.format.object_to_string(data.value)
 
@@ -221,13 +263,12 @@ class CGenNCCfgData:
         return get_delta_vlist(self.schema)
 
     def get_var_list_for_instance(self, var_list):
-        loaded_vars = read_vlist_from_buffer(self.generate_binary_array(True))
         actual_var_list = []
         for var in var_list:
-            for loaded_var in loaded_vars:
-                if loaded_var.guid == var.guid and loaded_var.name == var.name:
-                    actual_var_list.append(var)
-                    break
+            subknob = self.schema.get_knob(var.guid, var.name)
+            # only whole knobs with a value are backed by a variable
+            if subknob is not None and subknob.name == subknob.knob.name and subknob.knob.value is not None:
+                actual_var_list.append(var)
         return actual_var_list
 
     def iterate_each_setting(self, resultfile, handler):
@@ -276,8 +317,8 @@ class CGenNCCfgData:
                 bin_data = base64.b64decode(base64_val)
                 var_list = read_vlist_from_buffer(bin_data)
                 actual_var_list = self.get_var_list_for_instance(var_list)
-                uefi_variables_to_knobs(self.schema, actual_var_list)
-                self.sync_shim_and_schema()
+                updated_knobs = uefi_variables_to_knobs(self.schema, actual_var_list)
+                self.sync_shim_and_schema(updated_knobs)
 
         self.iterate_each_setting(path, handler)
 
@@ -287,8 +328,8 @@ class CGenNCCfgData:
         # ensure that read in variables are part of schema, otherwise ignore them
         actual_var_list = self.get_var_list_for_instance(var_list)
 
-        uefi_variables_to_knobs(self.schema, actual_var_list)
-        self.sync_shim_and_schema()
+        updated_knobs = uefi_variables_to_knobs(self.schema, actual_var_list)
+        self.sync_shim_and_schema(updated_knobs)
 
     def get_var_by_index(self, index):
         vlist = self.generate_binary_array(True)
@@ -303,13 +344,7 @@ class CGenNCCfgData:
         return vlist_to_binary(self.schema)
 
     def generate_delta_binary_array(self):
-        bin = b''
-        list = get_delta_vlist(self.schema)[1]
-
-        for var in list:
-            bin += var
-
-        return bin
+        return b''.join(get_delta_vlist(self.schema)[1])
 
     def generate_binary(self, bin_file_name):
         bin_file = open(bin_file_name, "wb")
@@ -353,6 +388,7 @@ class CGenNCCfgData:
             knob.value = knob.default
 
         self.knob_shim = self.build_cfg_list()
+        self.build_shim_index()
         return 0
 
     def delete_all_variables(self, config_xml_path):
@@ -369,26 +405,33 @@ class CGenNCCfgData:
             print("Error: The number of variables and new values must match.")
             return
 
+        # Index the knobs by member name once, instead of scanning every knob for every variable
+        member_index = {}
         for knob in self.schema.knobs:
-            for i, variable_name in enumerate(variables):
-                if variable_name in knob.value.keys():
-                    print(f"Orig {variable_name} is {knob.value[variable_name]}")
-
-                    new_knob_value = knob.value
-                    new_value = new_values[i]
-                    # Check if the new value is a hexadecimal string or a decimal string
-                    if isinstance(new_value, str) and new_value.startswith("0x"):
-                        new_knob_value[variable_name] = int(new_value, 16)  # Convert hex string to int
-                    elif new_value.isdigit():
-                        new_knob_value[variable_name] = int(new_value)  # Convert decimal string to int
-                    elif isinstance(new_value, str) and new_value.startswith("[") and new_value.endswith("]"):
-                        new_knob_value[variable_name] = [int(x) for x in new_value[1:-1].split(",")]
-                    else:
-                        new_knob_value[variable_name] = str(new_value)  # Treat as a string
-
-                    # Update the variable in the schema
-                    knob.value = new_knob_value
-                    print(f"Updated {variable_name} to {knob.value[variable_name]}")
+            value = knob.value
+            if isinstance(value, dict):
+                for member_name in value.keys():
+                    member_index.setdefault(member_name, []).append(knob)
+
+        for i, variable_name in enumerate(variables):
+            for knob in member_index.get(variable_name, []):
+                print(f"Orig {variable_name} is {knob.value[variable_name]}")
+
+                new_knob_value = knob.value
+                new_value = new_values[i]
+                # Check if the new value is a hexadecimal string or a decimal string
+                if isinstance(new_value, str) and new_value.startswith("0x"):
+                    new_knob_value[variable_name] = int(new_value, 16)  # Convert hex string to int
+                elif new_value.isdigit():
+                    new_knob_value[variable_name] = int(new_value)  # Convert decimal string to int
+                elif isinstance(new_value, str) and new_value.startswith("[") and new_value.endswith("]"):
+                    new_knob_value[variable_name] = [int(x) for x in new_value[1:-1].split(",")]
+                else:
+                    new_knob_value[variable_name] = str(new_value)  # Treat as a string
+
+                # Update the variable in the schema
+                knob.value = new_knob_value
+                print(f"Updated {variable_name} to {knob.value[variable_name]}")
 
         self.generate_binary(output_file)
         uefi_var_write.set_variable_from_file(output_file)
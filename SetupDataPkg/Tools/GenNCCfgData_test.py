@@ -9,8 +9,12 @@
 import unittest
 import copy
 import os
+import tempfile
 
 from GenNCCfgData import CGenNCCfgData
+from VariableList import UEFIVariable, create_vlist_buffer
+
+SCALE_KNOB_COUNT = 4000
 
 
 class UncoreCfgUnitTests(unittest.TestCase):
@@ -313,6 +317,147 @@ class UncoreCfgUnitTests(unittest.TestCase):
         for each in cdata.knob_shim:
             self.assertEqual(each['value'], each['inst'].format.object_to_string(each['inst'].value))
 
+    # Loading variables should only re-sync the shim entries of the knobs that were loaded
+    def test_xml_load_syncs_updated_knobs(self):
+        if os.path.exists("sampleschema.xml"):
+            # Load for local testing
+            sample_path = "sampleschema.xml"
+        elif os.path.exists("SetupDataPkg/Tools/sampleschema.xml"):
+            # Load for Linux CI
+            sample_path = "SetupDataPkg/Tools/sampleschema.xml"
+        else:
+            # Load for Windows CI
+            sample_path = "SetupDataPkg\\Tools\\sampleschema.xml"
+
+        cdata = CGenNCCfgData(sample_path)
+        for each in cdata.knob_shim:
+            each['value'] = None
+
+        guid = 'FE3ED49F-B173-41ED-9076-356661D46A42'
+        variables = [
+            UEFIVariable('INTEGER_KNOB', guid, (1234).to_bytes(4, 'little')),
+            # unknown knobs and subknob paths are not backed by variables and must be ignored
+            UEFIVariable('UNKNOWN_KNOB', guid, (1).to_bytes(4, 'little')),
+            UEFIVariable('COMPLEX_KNOB2.counter', guid, (1).to_bytes(4, 'little')),
+        ]
+        self.assertEqual(len(cdata.get_var_list_for_instance(variables)), 1)
+
+        cdata.load_default_from_bin(b''.join(create_vlist_buffer(var) for var in variables), True)
+
+        ret = cdata.get_item_by_path(guid + '.INTEGER_KNOB')
+        self.assertEqual(ret['value'], '1234')
+        for each in cdata.knob_shim:
+            if each['inst'].knob.name == 'INTEGER_KNOB':
+                self.assertEqual(each['value'], each['inst'].format.object_to_string(each['inst'].value))
+            else:
+                self.assertIsNone(each['value'])
+
+    # Searching should match names, help texts and current values, in shim order
+    def test_xml_search_cfg_items(self):
+        if os.path.exists("sampleschema.xml"):
+            # Load for local testing
+            sample_path = "sampleschema.xml"
+        elif os.path.exists("SetupDataPkg/Tools/sampleschema.xml"):
+            # Load for Linux CI
+            sample_path = "SetupDataPkg/Tools/sampleschema.xml"
+        else:
+            # Load for Windows CI
+            sample_path = "SetupDataPkg\\Tools\\sampleschema.xml"
+
+        cdata = CGenNCCfgData(sample_path)
+        guid = 'FE3ED49F-B173-41ED-9076-356661D46A42'
+
+        # Names are matched case insensitively
+        ret = cdata.search_cfg_items('boolean knob')
+        self.assertEqual([each['path'] for each in ret][:1], [guid + '.BOOLEAN_KNOB'])
+        self.assertTrue(all('boolean_knob' in each['cname'].lower() for each in ret))
+
+        # Help texts
+        ret = cdata.search_cfg_items('Number value')
+        self.assertEqual(len(ret), 2)
+        self.assertTrue(all(each['cname'].endswith('.counter') for each in ret))
+
+        # Current values, which change while editing
+        self.assertEqual(cdata.search_cfg_items('4321'), [])
+        item = cdata.get_item_by_path(guid + '.INTEGER_KNOB')
+        item['value'] = '4321'
+        self.assertEqual(cdata.search_cfg_items('4321'), [item])
+
+        # Results keep the shim order
+        ret = cdata.search_cfg_items('knob')
+        orders = [each['order'] for each in ret]
+        self.assertEqual(orders, sorted(orders))
+        self.assertEqual(len(ret), len(set(orders)))
+
+        self.assertEqual(cdata.search_cfg_items(''), [])
+        self.assertEqual(cdata.search_cfg_items('no such knob'), [])
+
+    # Every page of a large schema is built from the index and the search finds every matching knob
+    def test_xml_large_schema_pages_and_search(self):
+        guid = 'FE3ED49F-B173-41ED-9076-356661D46A42'
+        xml = ['<ConfigSchema><Enums /><Structs>',
+               '<Struct name="pair_t"><Member name="a" type="uint32_t" /><Member name="b" type="uint8_t" /></Struct>',
+               '</Structs><Knobs namespace="{{{}}}">'.format(guid)]
+        for i in range(SCALE_KNOB_COUNT):
+            xml.append('<Knob name="KNOB_{}" type="pair_t" default="{{0,0}}" help="Help {}" />'.format(i, i % 10))
+        xml.append('</Knobs></ConfigSchema>')
+
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            schema_path = os.path.join(tmp_dir, "scaleschema.xml")
+            with open(schema_path, "w") as schema_file:
+                schema_file.write("".join(xml))
+            cdata = CGenNCCfgData(schema_path)
+
+        for i in range(SCALE_KNOB_COUNT):
+            page_id = '{}.KNOB_{}'.format(guid, i)
+            ret = cdata.get_cfg_list(page_id)
+            # The knob header, the struct and its two members
+            self.assertEqual(len(ret), 4)
+            for each in ret:
+                self.assertEqual(".".join(each['path'].split(".")[:2]), page_id)
+
+        ret = cdata.search_cfg_items('help 7')
+        self.assertEqual([each['path'] for each in ret],
+                         ['{}.KNOB_{}'.format(guid, i) for i in range(7, SCALE_KNOB_COUNT, 10)])
+
+    # Every variable of a large list is matched to its knob through the index, unknown variables are ignored
+    def test_xml_load_large_schema(self):
+        guid = 'FE3ED49F-B173-41ED-9076-356661D46A42'
+        xml = ['<ConfigSchema><Enums /><Structs>',
+               '<Struct name="pair_t"><Member name="a" type="uint32_t" /><Member name="b" type="uint8_t" /></Struct>',
+               '</Structs><Knobs namespace="{{{}}}">'.format(guid)]
+        for i in range(SCALE_KNOB_COUNT):
+            if i % 2:
+                xml.append('<Knob name="KNOB_{}" type="uint32_t" default="0" />'.format(i))
+            else:
+                xml.append('<Knob name="KNOB_{}" type="pair_t" default="{{0,0}}" />'.format(i))
+        xml.append('</Knobs></ConfigSchema>')
+
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            schema_path = os.path.join(tmp_dir, "scaleschema.xml")
+            with open(schema_path, "w") as schema_file:
+                schema_file.write("".join(xml))
+            cdata = CGenNCCfgData(schema_path)
+
+        variables = [UEFIVariable('KNOB_{}'.format(i), guid, i.to_bytes(4, 'little'))
+                     for i in range(1, SCALE_KNOB_COUNT, 2)]
+        unknown = [UEFIVariable('KNOB_{}'.format(SCALE_KNOB_COUNT), guid, b'\x01\x00\x00\x00'),
+                   UEFIVariable('KNOB_1', '00000000-0000-0000-0000-000000000000', b'\x01\x00\x00\x00')]
+
+        self.assertEqual(cdata.get_var_list_for_instance(variables + unknown), variables)
+
+        cdata.load_default_from_bin(b''.join(create_vlist_buffer(var) for var in variables + unknown), True)
+
+        for i in range(SCALE_KNOB_COUNT):
+            knob = cdata.schema.get_knob(guid, 'KNOB_{}'.format(i))
+            self.assertEqual(knob.name, 'KNOB_{}'.format(i))
+            if i % 2:
+                self.assertEqual(knob.value, i)
+                ret = cdata.get_item_by_path('{}.KNOB_{}'.format(guid, i))
+                self.assertEqual(ret['value'], str(i))
+            else:
+                self.assertEqual(knob.value, {'a': 0, 'b': 0})
+
 
 if __name__ == '__main__':
     unittest.main()
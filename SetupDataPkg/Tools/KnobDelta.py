@@ -46,7 +46,7 @@ class CompareConfigs:
     def generate_csv_rows(self, schema, full, subknobs=True):
         rows = []
         guid = None
-        name_list = get_delta_vlist(schema)[0]
+        name_list = set(get_delta_vlist(schema)[0])
 
         rows.append(["Guid", "Knob", "Value", "Binary", "Help"])
 
@@ -117,13 +117,14 @@ class CompareConfigs:
 
     def parsing_csv_data(self, csv_rows, with_eg_token_name=False):
         bios_setting_dict = {}
+        # Map each knob name to its type once, keeping the first type like a scan of the knobs would
+        page_names = {}
+        for type_name, value_name in self.xml_information["Knobs"].items():
+            page_names.setdefault(value_name, type_name)
+
         for csv_data in csv_rows[1:]:
             csv_knob_value = csv_data[1]
-            csv_page_name = None
-            for type_name, value_name in self.xml_information["Knobs"].items():
-                if value_name == csv_knob_value:
-                    csv_page_name = type_name
-                    break
+            csv_page_name = page_names.get(csv_knob_value)
 
             if csv_page_name is None:
                 continue
@@ -11,7 +11,6 @@ import uuid
 import argparse
 import re
 import VariableList
-from CommonUtility import get_xml_full_hash
 
 
 # Converts a type name from standard C to UEFI
@@ -193,9 +192,31 @@ def get_variable_list_size(knob):
     return size
 
 
+# Variables of the config policy of the current knob values, overridden knobs keep their value and the others use
+# their default
+def get_policy_variables(schema):
+    return [VariableList.UEFIVariable(
+        knob.name,
+        knob.namespace,
+        knob.format.object_to_binary(knob.value if knob.value is not None else knob.default))
+        for knob in schema.knobs]
+
+
+# With the aligned option, the config policy is an aligned v2 variable list instead of a v1 one. Returns the image
+# of the policy of the current knob values and the offset of the data of each knob in it
+def get_aligned_policy_layout(schema):
+    data_offsets = []
+    image = VariableList.create_vlist_v2_buffer(get_policy_variables(schema), aligned=True, data_offsets=data_offsets)
+    return image, data_offsets
+
+
 # in UEFI builds we need to know what the size of the variable list constructed
 # from this data will be. Return value in bytes
-def get_conf_policy_size(schema):
+def get_conf_policy_size(schema, aligned=False):
+    if aligned:
+        # The layout does not depend on the knob values, only on their sizes
+        return len(get_aligned_policy_layout(schema)[0])
+
     size = 0
     for knob in schema.knobs:
         size += get_variable_list_size(knob)
@@ -203,12 +224,119 @@ def get_conf_policy_size(schema):
     return size
 
 
+# Build the config policy of the current knob values, overridden knobs keep their value and the others use their
+# default, in the variable list layout InitConfigPolicyCache retrieves
+def get_profile_cache_image(schema, aligned=False):
+    if aligned:
+        return get_aligned_policy_layout(schema)[0]
+
+    image = b''.join(VariableList.create_vlist_buffer(variable) for variable in get_policy_variables(schema))
+
+    if len(image) != get_conf_policy_size(schema):
+        raise Exception("Profile cache image size 0x{:x} does not match the policy size 0x{:x}".format(
+            len(image), get_conf_policy_size(schema)))
+    return image
+
+
+# write a profile cache image as a constant byte array. Aligned images are written as an array of little endian
+# UINT64 instead, so the data of their knobs stays aligned wherever the image is placed
+def write_profile_cache_image(out, name, image, efi_type, aligned=False):
+    if aligned:
+        out.write("STATIC CONST UINT64 {}[PROFILE_CACHE_IMAGE_SIZE / sizeof (UINT64)] = {{".format(name)
+                  + get_line_ending(efi_type))
+        for index in range(0, len(image), 32):
+            out.write(get_spacing_string(efi_type) + " ".join(
+                "0x{:016x}ULL,".format(int.from_bytes(image[offset:offset + 8], 'little'))
+                for offset in range(index, min(index + 32, len(image)), 8)) + get_line_ending(efi_type))
+        out.write("};" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+        return
+
+    out.write("STATIC CONST UINT8 {}[PROFILE_CACHE_IMAGE_SIZE] = {{".format(name) + get_line_ending(efi_type))
+    for index in range(0, len(image), 16):
+        out.write(get_spacing_string(efi_type) + " ".join(
+            "0x{:02x},".format(byte) for byte in image[index:index + 16]) + get_line_ending(efi_type))
+    out.write("};" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+
+
 # write getter implementations. In stdlibc projects this is part of the data header
 # for UEFI, this is separate from the data header
-def write_uefi_getter_implementations(efi_type, out, schema):
+# Per knob statistics of the UEFI getters, only compiled in when the module defines CONFIG_KNOB_STATISTICS
+def write_uefi_knob_statistics(efi_type, out, schema):
+    out.write("// Define CONFIG_KNOB_STATISTICS to collect per knob statistics of this module"
+              + get_line_ending(efi_type))
+    out.write("#ifdef CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+    out.write("#include <Library/DebugLib.h>" + get_line_ending(efi_type))
+    out.write("#include <Protocol/ConfigKnobStatistics.h>" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write("KNOB_STATISTICS gKnobStatistics[KNOB_MAX];" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write("STATIC CONST CHAR8 *mKnobStatisticsNames[KNOB_MAX] = {" + get_line_ending(efi_type))
+    for knob in schema.knobs:
+        out.write(get_spacing_string(efi_type) + "\"{}\",".format(knob.name) + get_line_ending(efi_type))
+    out.write("};" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write("// DXE modules may install this instance with gConfigKnobStatisticsProtocolGuid"
+              + get_line_ending(efi_type))
+    out.write("CONFIG_KNOB_STATISTICS_PROTOCOL gConfigKnobStatistics = {" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "CONFIG_KNOB_STATISTICS_PROTOCOL_REVISION," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "KNOB_MAX," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "mKnobStatisticsNames," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "gKnobStatistics" + get_line_ending(efi_type))
+    out.write("};" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write("#define CACHED_POLICY_STATS_READ(Knob, Hit)  "
+              + "(gKnobStatistics[(Knob)].ReadCount++, gKnobStatistics[(Knob)].CacheHitCount += (Hit) ? 1 : 0)"
+              + get_line_ending(efi_type))
+    out.write("#define CACHED_POLICY_STATS_FAILURE(Knob)    (gKnobStatistics[(Knob)].ValidationFailureCount++)"
+              + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+
+    # ConfigDumpKnobStatistics
+    out.write("// Print the statistics of every knob read by this module to the debug output"
+              + get_line_ending(efi_type))
+    out.write("VOID" + get_line_ending(efi_type))
+    out.write("ConfigDumpKnobStatistics (" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "VOID" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + ")" + get_line_ending(efi_type))
+    out.write("{" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "UINTN Index;" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "for (Index = 0; Index < KNOB_MAX; Index++) {" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=2))
+    out.write("if ((gKnobStatistics[Index].ReadCount == 0) && (gKnobStatistics[Index].ValidationFailureCount == 0)) {")
+    out.write(get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3) + "continue;" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=2) + "}" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=2) + "DEBUG ((" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3) + "DEBUG_INFO," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3))
+    out.write("\"%a %a: %d reads, %d cache hits, %d validation failures\\n\"," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3) + "__func__," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3) + "mKnobStatisticsNames[Index]," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3) + "gKnobStatistics[Index].ReadCount," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3) + "gKnobStatistics[Index].CacheHitCount," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3))
+    out.write("gKnobStatistics[Index].ValidationFailureCount" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3) + "));" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+    out.write("}" + get_line_ending(efi_type))
+    out.write("#else" + get_line_ending(efi_type))
+    out.write("#define CACHED_POLICY_STATS_READ(Knob, Hit)  ((VOID)(Hit))" + get_line_ending(efi_type))
+    out.write("#define CACHED_POLICY_STATS_FAILURE(Knob)" + get_line_ending(efi_type))
+    out.write("#endif // CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+
+
+def write_uefi_getter_implementations(efi_type, out, schema, aligned=False):
     out.write("// Schema-defined knobs" + get_line_ending(efi_type))
     offset = 0
-    for knob in schema.knobs:
+    if aligned:
+        data_offsets = get_aligned_policy_layout(schema)[1]
+
+    for (index, knob) in enumerate(schema.knobs):
         out.write("// {} knob".format(knob.name) + get_line_ending(efi_type))
         if knob.help != "":
             out.write("// {}".format(knob.help) + get_line_ending(efi_type))
@@ -237,8 +365,13 @@ def write_uefi_getter_implementations(efi_type, out, schema):
         offset += get_variable_list_size(knob)
         offset -= 4 + knob.format.size_in_bytes()
         out.write("CONST UINTN Offset = CACHED_POLICY_HEADER_SIZE + {};".format(
+            data_offsets[index] if aligned else
             offset
         ) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("UINT64 PerfBegin = CACHED_POLICY_PERF_BEGIN ();" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("BOOLEAN CacheHit = TRUE;" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
 
         # for the next offset, move past data and CRC32
@@ -256,10 +389,14 @@ def write_uefi_getter_implementations(efi_type, out, schema):
         out.write("if (((CACHED_POLICY_HEADER *)Cache)->Signature != CACHED_POLICY_SIGNATURE) {")
         out.write(get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type, num=2))
+        out.write("CacheHit = FALSE;" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=2))
         out.write("Status = InitConfigPolicyCache (Cache, CacheSize);" + get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type, num=2))
         out.write("if (EFI_ERROR (Status)) {" + get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type, num=3))
+        out.write("CACHED_POLICY_STATS_FAILURE (KNOB_{});".format(knob.name) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=3))
         out.write("ASSERT (FALSE);" + get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type, num=3))
         out.write("return Status;" + get_line_ending(efi_type))
@@ -274,6 +411,8 @@ def write_uefi_getter_implementations(efi_type, out, schema):
             get_type_string(knob.format.c_type, efi_type)
         ) + get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type, num=2))
+        out.write("CACHED_POLICY_STATS_FAILURE (KNOB_{});".format(knob.name) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=2))
         out.write("ASSERT (FALSE);" + get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type, num=2))
         out.write("return EFI_COMPROMISED_DATA;" + get_line_ending(efi_type))
@@ -282,9 +421,19 @@ def write_uefi_getter_implementations(efi_type, out, schema):
         out.write(get_line_ending(efi_type))
 
         out.write(get_spacing_string(efi_type))
-        out.write("CopyMem(Knob, Cache + Offset, sizeof ({}));".format(
-            get_type_string(knob.format.c_type, efi_type)
-        ) + get_line_ending(efi_type))
+        if aligned:
+            # The data of the knob is aligned in the aligned policy, read it in place
+            out.write("*Knob = *(CONST {} *)(Cache + Offset);".format(
+                get_type_string(knob.format.c_type, efi_type)
+            ) + get_line_ending(efi_type))
+        else:
+            out.write("CopyMem(Knob, Cache + Offset, sizeof ({}));".format(
+                get_type_string(knob.format.c_type, efi_type)
+            ) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("CACHED_POLICY_STATS_READ (KNOB_{}, CacheHit);".format(knob.name) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("CACHED_POLICY_PERF_END (CacheHit, PerfBegin);" + get_line_ending(efi_type))
 
         out.write(get_spacing_string(efi_type))
         out.write("return EFI_SUCCESS;" + get_line_ending(efi_type))
@@ -304,7 +453,7 @@ def write_uefi_getter_implementations(efi_type, out, schema):
         out.write(get_spacing_string(efi_type) + ")" + get_line_ending(efi_type))
         out.write("{" + get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type))
-        out.write("return {}{}FromCache (Knob, CachedPolicy, sizeof (CachedPolicy));".format(
+        out.write("return {}{}FromCache (Knob, CACHED_POLICY_BUFFER (), CACHED_POLICY_BUFFER_SIZE);".format(
             naming_convention_filter("config_get_", False, efi_type),
             knob.name
         ) + get_line_ending(efi_type))
@@ -635,7 +784,7 @@ def generate_cached_implementation(schema, header_path, efi_type=False, no_chang
         out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
         out.write(
             'CHAR8 *gSchemaXmlHash = (CHAR8*)"'
-            + get_xml_full_hash(schema.path)
+            + schema.hash
             + '";'
             + get_line_ending(efi_type)
         )
@@ -996,19 +1145,45 @@ def generate_cached_implementation(schema, header_path, efi_type=False, no_chang
 
 
 # UEFI utilizes a third header file to hold the getter implementation
-def generate_getter_implementation(schema, header_path, efi_type):
+def generate_getter_implementation(schema, header_path, efi_type, aligned=False):
     with open(header_path, 'w', newline='') as out:
         out.write(get_spdx_header(header_path, efi_type))
         out.write(get_include_once_style(header_path, uefi=efi_type, header=True))
         out.write("#include <Library/PcdLib.h>" + get_line_ending(efi_type))
         out.write("#include <Library/BaseMemoryLib.h>" + get_line_ending(efi_type))
+        if aligned:
+            out.write("#include <Library/ConfigVariableListLib.h>" + get_line_ending(efi_type))
         out.write("// The config public header must be included prior to this file" + get_line_ending(efi_type))
         out.write("// Generated Header" + get_line_ending(efi_type))
         out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
         out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
 
-        policy_size = hex(get_conf_policy_size(schema))
+        # Knob reads are only accounted when the module opts in, otherwise the accounting compiles to nothing
+        out.write("// Define CONFIG_KNOB_PERF and link ConfigKnobPerfLib to account knob reads"
+                  + get_line_ending(efi_type))
+        out.write("#ifdef CONFIG_KNOB_PERF" + get_line_ending(efi_type))
+        out.write("#include <Library/ConfigKnobPerfLib.h>" + get_line_ending(efi_type))
+        out.write("#define CACHED_POLICY_PERF_BEGIN()          ConfigKnobPerfBegin ()" + get_line_ending(efi_type))
+        out.write("#define CACHED_POLICY_PERF_END(Hit, Begin)  "
+                  + "ConfigKnobPerfEnd ((Hit) ? ConfigKnobSourceCache : ConfigKnobSourcePolicy, (Begin))"
+                  + get_line_ending(efi_type))
+        out.write("#else" + get_line_ending(efi_type))
+        out.write("#define CACHED_POLICY_PERF_BEGIN()          0" + get_line_ending(efi_type))
+        out.write("#define CACHED_POLICY_PERF_END(Hit, Begin)  ((VOID)(Hit), (VOID)(Begin))"
+                  + get_line_ending(efi_type))
+        out.write("#endif" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        # The cached policy is a STATIC copy of each module, unless the module opts in to the one of the boot phase
+        out.write("// Define CONFIG_SHARED_POLICY_CACHE and link ConfigPolicyCacheLib to share one cached policy "
+                  + "between all modules" + get_line_ending(efi_type))
+        out.write("#ifdef CONFIG_SHARED_POLICY_CACHE" + get_line_ending(efi_type))
+        out.write("#include <Library/ConfigPolicyCacheLib.h>" + get_line_ending(efi_type))
+        out.write("#endif" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        policy_size = hex(get_conf_policy_size(schema, aligned))
         out.write("#define CACHED_POLICY_SIGNATURE    SIGNATURE_32 ('C', 'P', 'O', 'L')" + get_line_ending(efi_type))
         out.write("#define CACHED_POLICY_HEADER_SIZE  sizeof (CACHED_POLICY_HEADER)" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
@@ -1023,13 +1198,29 @@ def generate_getter_implementation(schema, header_path, efi_type):
         out.write(get_line_ending(efi_type))
         out.write("typedef struct {" + get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type) + "UINT32 Signature;" + get_line_ending(efi_type))
+        if aligned:
+            # Keeps the aligned policy following the header aligned
+            out.write(get_spacing_string(efi_type) + "UINT32 Reserved;" + get_line_ending(efi_type))
         out.write("} CACHED_POLICY_HEADER;" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
         out.write("#pragma pack ()" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
 
-        out.write("STATIC UINT8 CachedPolicy[CACHED_POLICY_SIZE + CACHED_POLICY_HEADER_SIZE];")
-        out.write(get_line_ending(efi_type))
+        out.write("#define CACHED_POLICY_BUFFER_SIZE  (CACHED_POLICY_SIZE + CACHED_POLICY_HEADER_SIZE)"
+                  + get_line_ending(efi_type))
+        out.write("#ifdef CONFIG_SHARED_POLICY_CACHE" + get_line_ending(efi_type))
+        out.write("#define CACHED_POLICY_BUFFER()  ConfigPolicyCacheGetShared (CACHED_POLICY_BUFFER_SIZE)"
+                  + get_line_ending(efi_type))
+        out.write("#else" + get_line_ending(efi_type))
+        if aligned:
+            out.write("STATIC UINT64 CachedPolicy["
+                      + "(CACHED_POLICY_BUFFER_SIZE + sizeof (UINT64) - 1) / sizeof (UINT64)];"
+                      + get_line_ending(efi_type))
+            out.write("#define CACHED_POLICY_BUFFER()  ((UINT8 *)CachedPolicy)" + get_line_ending(efi_type))
+        else:
+            out.write("STATIC UINT8 CachedPolicy[CACHED_POLICY_BUFFER_SIZE];" + get_line_ending(efi_type))
+            out.write("#define CACHED_POLICY_BUFFER()  CachedPolicy" + get_line_ending(efi_type))
+        out.write("#endif" + get_line_ending(efi_type))
         out.write(get_assert_style(
             efi_type,
             "(CACHED_POLICY_SIZE + CACHED_POLICY_HEADER_SIZE <= MAX_UINT16",
@@ -1052,6 +1243,15 @@ def generate_getter_implementation(schema, header_path, efi_type):
         out.write("UINT16 ConfPolSize = CacheSize;" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
 
+        if aligned:
+            # Knobs are read in place, which needs the cache itself to be aligned
+            out.write(get_spacing_string(efi_type))
+            out.write("if (((UINTN)Cache % sizeof (UINT64)) != 0) {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, num=2) + "ASSERT (FALSE);" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, num=2) + "return EFI_UNSUPPORTED;" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+
         out.write(get_spacing_string(efi_type))
         out.write("Status = GetPolicy (")
         out.write("(const EFI_GUID *)PcdGetPtr (PcdConfigurationPolicyGuid), NULL,")
@@ -1065,6 +1265,19 @@ def generate_getter_implementation(schema, header_path, efi_type):
         out.write(get_spacing_string(efi_type))
         out.write("}" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
+
+        if aligned:
+            # The offsets of the getters are only valid for a policy published in the aligned layout
+            out.write(get_spacing_string(efi_type))
+            out.write("if ((((CONFIG_VAR_LIST_V2_HDR *)(Cache + CACHED_POLICY_HEADER_SIZE))->Signature != "
+                      + "CONFIG_VAR_LIST_V2_SIGNATURE) ||" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, num=3))
+            out.write("(((CONFIG_VAR_LIST_V2_HDR *)(Cache + CACHED_POLICY_HEADER_SIZE))->Version != "
+                      + "CONFIG_VAR_LIST_V2_ALIGNED_VERSION)) {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, num=2) + "ASSERT (FALSE);" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, num=2) + "return EFI_COMPROMISED_DATA;" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
         out.write(get_spacing_string(efi_type))
         out.write("((CACHED_POLICY_HEADER*)Cache)->Signature = CACHED_POLICY_SIGNATURE;" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
@@ -1073,12 +1286,14 @@ def generate_getter_implementation(schema, header_path, efi_type):
         out.write("}" + get_line_ending(efi_type))
         out.write(get_line_ending(efi_type))
 
-        write_uefi_getter_implementations(efi_type, out, schema)
+        write_uefi_knob_statistics(efi_type, out, schema)
+        write_uefi_getter_implementations(efi_type, out, schema, aligned)
 
         out.write(get_include_once_style(header_path, uefi=efi_type, header=False))
 
 
-def generate_profiles(schema, profile_header_path, profile_paths, efi_type, profile_names=None, profile_ids=None):
+def generate_profiles(schema, profile_header_path, profile_paths, efi_type, profile_names=None, profile_ids=None,
+                      cache_images=False, aligned=False):
     with open(profile_header_path, 'w', newline='') as out:
         out.write(get_spdx_header(profile_header_path, efi_type))
         out.write(get_include_once_style(profile_header_path, uefi=efi_type, header=True))
@@ -1096,6 +1311,7 @@ def generate_profiles(schema, profile_header_path, profile_paths, efi_type, prof
         format_options.efi_format = efi_type
 
         profiles = []
+        cache_images_list = []
         for profile_path in profile_paths:
             base_name = os.path.splitext(os.path.basename(profile_path))[0]
             out.write("// Profile {}".format(base_name) + get_line_ending(efi_type))
@@ -1178,6 +1394,9 @@ def generate_profiles(schema, profile_header_path, profile_paths, efi_type, prof
             out.write("" + get_line_ending(efi_type))
 
             profiles.append((base_name, override_count))
+
+            if efi_type and cache_images:
+                cache_images_list.append((base_name, get_profile_cache_image(schema, aligned)))
         out.write("" + get_line_ending(efi_type))
         out.write("#define PROFILE_COUNT {}".format(len(profiles)) + get_line_ending(efi_type))
         if not efi_type:
@@ -1250,6 +1469,46 @@ def generate_profiles(schema, profile_header_path, profile_paths, efi_type, prof
             )
             out.write(get_line_ending(efi_type))
 
+        if efi_type and cache_images:
+            # The generic profile is the defaults of all the knobs
+            for knob in schema.knobs:
+                knob.value = None
+            generic_image = get_profile_cache_image(schema, aligned)
+
+            out.write(get_line_ending(efi_type))
+            out.write("// Complete config policy of each profile, in the variable list layout InitConfigPolicyCache"
+                      + get_line_ending(efi_type))
+            out.write("// expects. The active profile can be published as the config policy as is, instead of"
+                      + get_line_ending(efi_type))
+            out.write("// applying its overrides on top of the defaults." + get_line_ending(efi_type))
+            out.write("#define PROFILE_CACHE_IMAGE_SIZE {}".format(hex(len(generic_image)))
+                      + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+            write_profile_cache_image(out, "mGenericProfileCacheImage", generic_image, efi_type, aligned)
+            for (profile, image) in cache_images_list:
+                write_profile_cache_image(out, "m{}{}CacheImage".format(
+                    naming_convention_filter("profile_", False, efi_type),
+                    profile
+                ), image, efi_type, aligned)
+
+            # Aligned images are UINT64 arrays
+            image_cast = "(CONST UINT8 *)" if aligned else ""
+            out.write("CONST UINT8 *gProfileCacheImages[PROFILE_COUNT + 1] = {" + get_line_ending(efi_type))
+            for (profile, _) in cache_images_list:
+                out.write(get_spacing_string(efi_type) + "{}m{}{}CacheImage,".format(
+                    image_cast,
+                    naming_convention_filter("profile_", False, efi_type),
+                    profile
+                ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "NULL" + get_line_ending(efi_type))
+            out.write("};" + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+            out.write("CONST UINT8 *gGenericProfileCacheImage = {}mGenericProfileCacheImage;".format(image_cast))
+            out.write(get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+            out.write("UINTN gProfileCacheImageSize = PROFILE_CACHE_IMAGE_SIZE;" + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+
         out.write(get_include_once_style(profile_header_path, uefi=efi_type, header=False))
 
 
@@ -1260,7 +1519,7 @@ def generate_sources(schema, public_header, service_header, data_header, efi_typ
     # The parameters used below can be received as 'None' if a 'types_only' generation is used
     if efi_type is True:
         if service_header:
-            generate_getter_implementation(schema, service_header, efi_type)
+            generate_getter_implementation(schema, service_header, efi_type, options.aligned)
         if data_header:
             generate_cached_implementation(schema, data_header, efi_type)
     elif service_header:
@@ -1288,6 +1547,11 @@ def usage():
     print("                   profiles specified in profile.csv")
     print("-pid ids         : n-number of 1-byte hexadecimal (prepend with 0x) profile id that uniquely identify the")
     print("                   profiles specified in profile.csv")
+    print("-ci              : Option flag to also generate the complete config policy of each profile in")
+    print("                   'profile_header.h', UEFI builds only.")
+    print("-al              : Option flag to expect the config policy in the aligned v2 variable list layout, so")
+    print("                   the getters read knobs in place. Cache images are generated in that layout too.")
+    print("                   UEFI builds only.")
     print("-t               : Option flag to enable 'types only' outputting, forcing the generation of")
     print("                   'public_header.h' with Enum/Struct type declarations only.")
     print("                   'service_header.h' generation is skipped if this option is used.")
@@ -1306,6 +1570,14 @@ def arg_parse():
         '-pid', '--profileids', dest='profile_ids', type=str, default=None,
         help='''Specify the comma separated profile ids (1-byte hexadecimal number prepend with 0x) '''
              '''by passing -pid <Id1,Id2> or --profileids <Id1,Id2,Id3>.''')
+    parser.add_argument(
+        '-ci', '--cacheimages', action='store_true', dest='cache_images',
+        help='''Set this option to also generate the complete config policy of each profile in the profile header,'''
+             ''' for platforms that publish the policy of the active profile as is.''')
+    parser.add_argument(
+        '-al', '--aligned', action='store_true', dest='aligned',
+        help='''Set this option when the config policy is published as an aligned v2 variable list, to read the '''
+             '''knobs in place instead of copying them out of the cached policy.''')
     parser.add_argument(
         '-t', '--typesonly', action='store_true', dest='types_only',
         help='''Set this option when you wish to generate only type definitions from the schema.'''
@@ -1410,7 +1682,8 @@ def main():
                 formatted_profile_ids = None
 
             generate_profiles(schema, profile_header_path, profile_paths, efi_type,
-                              profile_names=known_args.profile_names, profile_ids=formatted_profile_ids)
+                              profile_names=known_args.profile_names, profile_ids=formatted_profile_ids,
+                              cache_images=known_args.cache_images, aligned=known_args.aligned)
         return 0
 
 
@@ -0,0 +1,190 @@
+# @ NativeVariableList.py
+#
+# ctypes binding of ConfigVariableListLib, built as a host shared library by the host based unit test build
+# (SetupDataPkg/Library/ConfigVariableListLib/HostLib). VariableList.py uses it when it is found, so the tools parse
+# variable lists with the same code as the firmware.
+#
+# The library is looked up in the path set by the CONFIG_VARIABLE_LIST_HOST_LIB environment variable, or in the host
+# test build output of the workspace. Setting CONFIG_VARIABLE_LIST_HOST_LIB to an empty string disables it.
+#
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+import ctypes
+import glob
+import os
+import struct
+import sys
+
+HOST_LIB_ENV = "CONFIG_VARIABLE_LIST_HOST_LIB"
+HOST_LIB_NAME = "ConfigVariableListHostLib"
+# Must match CONFIG_VAR_LIST_HOST_LIB_REVISION
+HOST_LIB_REVISION = 1
+
+EFI_NOT_FOUND = 14
+EFI_BUFFER_TOO_SMALL = 5
+EFI_ERROR_BIT = 1 << (ctypes.sizeof(ctypes.c_size_t) * 8 - 1)
+
+
+class NativeVariableListError(Exception):
+    def __init__(self, function, status):
+        super().__init__("{} failed with status 0x{:x}".format(function, status))
+        self.status = status
+
+
+class EfiGuid(ctypes.Structure):
+    _fields_ = [("Data1", ctypes.c_uint32), ("Data2", ctypes.c_uint16), ("Data3", ctypes.c_uint16),
+                ("Data4", ctypes.c_uint8 * 8)]
+
+
+# CONFIG_VAR_LIST_ENTRY
+class ConfigVarListEntry(ctypes.Structure):
+    _fields_ = [("Name", ctypes.c_void_p), ("Guid", EfiGuid), ("Attributes", ctypes.c_uint32),
+                ("Data", ctypes.c_void_p), ("DataSize", ctypes.c_uint32)]
+
+
+# CONFIG_VAR_LIST_ENTRY in the native layout, to unpack a whole array of them at once
+ENTRY_LAYOUT = struct.Struct("@P16sIPI")
+ENTRY_SIZE = ctypes.sizeof(ConfigVarListEntry)
+
+_library = None
+_library_loaded = False
+
+
+def _library_paths():
+    path = os.environ.get(HOST_LIB_ENV)
+    if path is not None:
+        return [path] if path != "" else []
+
+    # <Workspace>/Build/SetupDataPkg/HostTest/NOOPT_<Toolchain>/<Arch>/ConfigVariableListHostLib[.ext]
+    workspace = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+    arch = "X64" if sys.maxsize > 2**32 else "IA32"
+    pattern = os.path.join(workspace, "Build", "SetupDataPkg", "HostTest", "*", arch, HOST_LIB_NAME + "*")
+    return [path for path in sorted(glob.glob(pattern))
+            if os.path.isfile(path) and os.path.splitext(path)[1].lower() in ("", ".so", ".dll", ".exe", ".dylib")]
+
+
+def _load():
+    for path in _library_paths():
+        try:
+            library = ctypes.CDLL(path)
+            library.ConfigVarListHostRevision.restype = ctypes.c_uint32
+            if library.ConfigVarListHostRevision() != HOST_LIB_REVISION:
+                continue
+        except (OSError, AttributeError):
+            continue
+
+        library.ConfigVarListHostParse.restype = ctypes.c_size_t
+        library.ConfigVarListHostParse.argtypes = [
+            ctypes.c_char_p, ctypes.c_size_t, ctypes.POINTER(ctypes.POINTER(ConfigVarListEntry)),
+            ctypes.POINTER(ctypes.c_size_t)]
+        library.ConfigVarListHostFree.restype = None
+        library.ConfigVarListHostFree.argtypes = [ctypes.POINTER(ConfigVarListEntry)]
+        library.ConfigVarListHostGetNameSizes.restype = None
+        library.ConfigVarListHostGetNameSizes.argtypes = [
+            ctypes.POINTER(ConfigVarListEntry), ctypes.c_size_t, ctypes.POINTER(ctypes.c_uint32)]
+        library.ConfigVarListHostQuery.restype = ctypes.c_size_t
+        library.ConfigVarListHostQuery.argtypes = [
+            ctypes.c_char_p, ctypes.c_size_t, ctypes.c_char_p, ctypes.POINTER(ConfigVarListEntry)]
+        library.ConfigVarListHostFreeEntry.restype = None
+        library.ConfigVarListHostFreeEntry.argtypes = [ctypes.POINTER(ConfigVarListEntry)]
+        library.ConfigVarListHostSerialize.restype = ctypes.c_size_t
+        library.ConfigVarListHostSerialize.argtypes = [
+            ctypes.POINTER(ConfigVarListEntry), ctypes.c_size_t, ctypes.c_char_p, ctypes.POINTER(ctypes.c_size_t)]
+        library.ConfigVarListHostCrc32.restype = ctypes.c_uint32
+        library.ConfigVarListHostCrc32.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
+        return library
+
+    return None
+
+
+# Return the host library, None if it is not available
+def get_library():
+    global _library, _library_loaded
+    if not _library_loaded:
+        _library = _load()
+        _library_loaded = True
+    return _library
+
+
+def is_available():
+    return get_library() is not None
+
+
+# Parse a v1 or v2 variable list. Returns a list of (name, guid bytes_le, attributes, data) tuples, raises
+# NativeVariableListError if ConfigVariableListLib rejects the list
+def parse(buffer):
+    library = get_library()
+    buffer = bytes(buffer)
+    entries = ctypes.POINTER(ConfigVarListEntry)()
+    count = ctypes.c_size_t(0)
+    status = library.ConfigVarListHostParse(buffer, len(buffer), ctypes.byref(entries), ctypes.byref(count))
+    if status & EFI_ERROR_BIT:
+        raise NativeVariableListError("ConfigVarListHostParse", status & ~EFI_ERROR_BIT)
+
+    try:
+        name_sizes = (ctypes.c_uint32 * count.value)()
+        library.ConfigVarListHostGetNameSizes(entries, count.value, name_sizes)
+        array = ctypes.string_at(entries, count.value * ENTRY_SIZE)
+        variables = []
+        for index in range(count.value):
+            name, guid, attributes, data, data_size = ENTRY_LAYOUT.unpack_from(array, index * ENTRY_SIZE)
+            variables.append((
+                ctypes.string_at(name, name_sizes[index] - 2).decode("utf-16le"),
+                guid,
+                attributes,
+                ctypes.string_at(data, data_size)))
+        return variables
+    finally:
+        library.ConfigVarListHostFree(entries)
+
+
+# Find a variable of a v1 or v2 variable list by name. Returns a (name, guid bytes_le, attributes, data) tuple, None
+# if there is no such variable
+def query(buffer, name):
+    library = get_library()
+    buffer = bytes(buffer)
+    entry = ConfigVarListEntry()
+    status = library.ConfigVarListHostQuery(buffer, len(buffer), name.encode("ascii"), ctypes.byref(entry))
+    if status == EFI_NOT_FOUND | EFI_ERROR_BIT:
+        return None
+    if status & EFI_ERROR_BIT:
+        raise NativeVariableListError("ConfigVarListHostQuery", status & ~EFI_ERROR_BIT)
+
+    try:
+        return (name, bytes(entry.Guid), entry.Attributes, ctypes.string_at(entry.Data, entry.DataSize))
+    finally:
+        library.ConfigVarListHostFreeEntry(ctypes.byref(entry))
+
+
+# Serialize (name, guid bytes_le, attributes, data) tuples to a v1 variable list
+def serialize(variables):
+    library = get_library()
+    entries = (ConfigVarListEntry * len(variables))()
+    # Keep the encoded names and data alive until the list is serialized
+    buffers = []
+    for (entry, (name, guid, attributes, data)) in zip(entries, variables):
+        buffers.append(ctypes.create_string_buffer((name + "\0").encode("utf-16le")))
+        buffers.append(ctypes.create_string_buffer(bytes(data), max(len(data), 1)))
+        entry.Name = ctypes.cast(buffers[-2], ctypes.c_void_p)
+        ctypes.memmove(ctypes.byref(entry.Guid), guid, 16)
+        entry.Attributes = attributes
+        entry.Data = ctypes.cast(buffers[-1], ctypes.c_void_p)
+        entry.DataSize = len(data)
+
+    size = ctypes.c_size_t(0)
+    status = library.ConfigVarListHostSerialize(entries, len(variables), None, ctypes.byref(size))
+    if status == EFI_BUFFER_TOO_SMALL | EFI_ERROR_BIT:
+        output = ctypes.create_string_buffer(size.value)
+        status = library.ConfigVarListHostSerialize(entries, len(variables), output, ctypes.byref(size))
+    else:
+        output = b''
+    if status & EFI_ERROR_BIT:
+        raise NativeVariableListError("ConfigVarListHostSerialize", status & ~EFI_ERROR_BIT)
+
+    return output.raw[:size.value] if size.value else b''
+
+
+def crc32(data):
+    data = bytes(data)
+    return get_library().ConfigVarListHostCrc32(data, len(data))
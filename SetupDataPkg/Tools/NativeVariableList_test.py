@@ -0,0 +1,75 @@
+# @ NativeVariableList_test.py
+#
+# Cross checks the host build of ConfigVariableListLib against the Python variable list implementation. Skipped when
+# the host library was not built.
+#
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+import unittest
+import zlib
+
+import NativeVariableList
+from VariableList import UEFIVariable, create_vlist_buffer, create_vlist_v2_buffer
+from VariableList import read_vlist_from_buffer, read_vlist_from_buffer_python
+
+
+def as_tuples(variables):
+    return [(v.name, v.guid.bytes_le, v.attributes, v.data) for v in variables]
+
+
+@unittest.skipUnless(NativeVariableList.is_available(), "ConfigVariableListHostLib not built")
+class NativeVariableListUnitTests(unittest.TestCase):
+    variables = [
+        UEFIVariable("COMPLEX_KNOB1a", "FE3ED49F-B173-41ED-9076-356661D46A42", bytes(range(11))),
+        UEFIVariable("INTEGER_KNOB", "FE3ED49F-B173-41ED-9076-356661D46A42", b'\x78\x56\x34\x12'),
+        UEFIVariable("BOOLEAN_KNOB", "7664559F-829E-48E8-A473-F12ADAD1DDD2", b'\x01', 3),
+        UEFIVariable("EMPTY_KNOB", "7664559F-829E-48E8-A473-F12ADAD1DDD2", b''),
+    ]
+
+    def v1_list(self):
+        return b''.join(create_vlist_buffer(variable) for variable in self.variables)
+
+    def test_parse_matches_python(self):
+        for vlist in (self.v1_list(), create_vlist_v2_buffer(self.variables),
+                      create_vlist_v2_buffer(self.variables, aligned=True)):
+            self.assertEqual(NativeVariableList.parse(vlist), as_tuples(self.variables))
+            self.assertEqual(as_tuples(read_vlist_from_buffer(vlist)),
+                             as_tuples(read_vlist_from_buffer_python(vlist)))
+
+    def test_parse_empty(self):
+        self.assertEqual(NativeVariableList.parse(b''), [])
+        self.assertEqual(NativeVariableList.parse(create_vlist_v2_buffer([])), [])
+
+    def test_parse_corrupted(self):
+        for vlist in (self.v1_list(), create_vlist_v2_buffer(self.variables)):
+            corrupted = bytearray(vlist)
+            corrupted[-1] ^= 0xFF
+            with self.assertRaises(NativeVariableList.NativeVariableListError):
+                NativeVariableList.parse(corrupted)
+            # The Python error is reported through read_vlist_from_buffer
+            with self.assertRaisesRegex(Exception, "CRC mismatch"):
+                read_vlist_from_buffer(corrupted)
+
+    def test_query(self):
+        for vlist in (self.v1_list(), create_vlist_v2_buffer(self.variables, aligned=True)):
+            for variable in self.variables:
+                self.assertEqual(NativeVariableList.query(vlist, variable.name), as_tuples([variable])[0])
+            self.assertIsNone(NativeVariableList.query(vlist, "MISSING_KNOB"))
+
+    def test_serialize_matches_python(self):
+        self.assertEqual(NativeVariableList.serialize(as_tuples(self.variables)), self.v1_list())
+        self.assertEqual(NativeVariableList.serialize([]), b'')
+
+    def test_serialize_name_too_long(self):
+        with self.assertRaises(NativeVariableList.NativeVariableListError):
+            NativeVariableList.serialize([("A" * 1024, bytes(16), 7, b'\x00')])
+
+    def test_crc32(self):
+        for data in (b'', b'\x00', bytes(range(256)) * 3):
+            self.assertEqual(NativeVariableList.crc32(data), zlib.crc32(data))
+
+
+if __name__ == '__main__':
+    unittest.main()
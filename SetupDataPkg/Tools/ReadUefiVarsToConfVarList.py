@@ -9,12 +9,14 @@ import os
 import sys
 import logging
 import argparse
-import struct
-import uuid
-import ctypes
-from edk2toollib.os.uefivariablesupport import UefiVariable
-from VariableList import Schema, UEFIVariable, create_vlist_buffer
-from CommonUtility import validate_config_xml_hash_against_fw
+from VariableList import Schema, create_vlist_buffer
+from CommonUtility import validate_config_xml_hash_against_fw, has_privilege
+from UefiVariableStore import (
+    BulkVariableEngine,
+    FileUefiVariableBackend,
+    EfivarfsUefiVariableBackend,
+    EFIVARFS_PATH
+)
 
 
 def option_parser():
@@ -51,6 +53,26 @@ def option_parser():
         help="""Specify the output file path and name, in vl format""",
     )
 
+    parser.add_argument(
+        "-s",
+        "--store",
+        dest="store_file",
+        required=False,
+        type=str,
+        help="""Optional: read from a variable list file backed variable store instead of the system, for testing""",
+    )
+
+    parser.add_argument(
+        "--efivarfs",
+        dest="efivarfs_root",
+        required=False,
+        type=str,
+        nargs="?",
+        const=EFIVARFS_PATH,
+        help="""Optional: read from the variables through efivarfs on Linux. Given a directory other than
+        /sys/firmware/efi/efivars, runs dry against a directory tree that mimics it""",
+    )
+
     arguments = parser.parse_args()
 
     if arguments.configuration_file is not None and not os.path.isfile(arguments.configuration_file):
@@ -61,54 +83,26 @@ def option_parser():
 
 
 #
-# With given UEFI variable name and namespace (GUID), query the variable from
-# UEFI variable storage and convert the output to variable list formatted byte
-# array
+# Read all the variables, or the variables of the config knobs when a configuration file is given, in one batch
+# through the bulk variable engine and save them to a variable list file. Pass an engine to use another variable
+# store or to collect the statistics of the read.
 #
-def read_variable_into_variable_list(uefi_var, name, namespace):
-    (rc, var) = uefi_var.GetUefiVar(name, namespace)
-    if rc != 0:
-        if rc != UefiVariable.ERROR_ENVVAR_NOT_FOUND:
-            # only log the errors other than EFI_NOT_FOUND, because not found is normal in this case...
-            logging.error(f"Error returned from GetUefiVar: {rc} on Name: {name}, Guid: {namespace}")
-        return b''
-
-    variable = UEFIVariable(name, namespace, var)
-    b_array = create_vlist_buffer(variable)
-    return b_array
-
-
-def read_all_uefi_vars(output_file, configuration_file=None):
-    UefiVar = UefiVariable()
+def read_all_uefi_vars(output_file, configuration_file=None, engine=None, schema=None):
+    if engine is None:
+        engine = BulkVariableEngine()
 
     # Get ready to write vl file
     with open(output_file, "wb") as file:
-        ret = b''
-        if configuration_file is None:
+        if configuration_file is None and schema is None:
             # Read all the variables
-            (rc, efi_var_names) = UefiVar.GetUefiAllVarNames()
-            if rc != 0:
-                logging.error(f"Error returned from GetUefiAllVarNames: {rc}")
-
-            offset = 0
-            UUID_BYTES_SIZE = 16
-            int_format = "<I"
-            int_size = struct.calcsize(int_format)
-            while offset < len(efi_var_names):
-                (next_offset,) = struct.unpack_from(int_format, efi_var_names[offset:])
-                if next_offset == 0:
-                    # This is the end... But we still need to go through the last loop
-                    next_offset = len(efi_var_names) - offset
-                namespace = uuid.UUID(bytes_le=efi_var_names[offset + int_size: offset + int_size + UUID_BYTES_SIZE])
-                name = efi_var_names[offset + int_size + UUID_BYTES_SIZE: offset + next_offset].decode('utf16')
-                ret += read_variable_into_variable_list(UefiVar, name, namespace)
-                offset += next_offset
+            keys = engine.backend.names()
         else:
             # Read the variables for each config knobs
-            schema = Schema.load(configuration_file)
-            for knob in schema.knobs:
-                ret += read_variable_into_variable_list(UefiVar, knob.name, knob.namespace)
+            if schema is None:
+                schema = Schema.load(configuration_file)
+            keys = [(knob.name, knob.namespace) for knob in schema.knobs]
 
+        ret = b''.join(create_vlist_buffer(variable) for variable in engine.read(keys).values())
         if len(ret) != 0:
             file.write(ret)
             return 0
@@ -122,16 +116,37 @@ def read_all_uefi_vars(output_file, configuration_file=None):
 #
 def main():
     arguments = option_parser()
+
+    if arguments.store_file is not None:
+        engine = BulkVariableEngine(FileUefiVariableBackend(arguments.store_file))
+    elif arguments.efivarfs_root is not None and \
+            os.path.realpath(arguments.efivarfs_root) != os.path.realpath(EFIVARFS_PATH):
+        engine = BulkVariableEngine(EfivarfsUefiVariableBackend(arguments.efivarfs_root, dry_run=True))
+    elif arguments.efivarfs_root is not None:
+        if not has_privilege():
+            return 1
+        engine = BulkVariableEngine(EfivarfsUefiVariableBackend())
+    else:
+        if not has_privilege():
+            return 1
+        engine = BulkVariableEngine()
+
+    schema = None
     if arguments.configuration_file is not None:
+        # The schema is parsed once, for both the hash check and the knob list
+        schema = Schema.load(arguments.configuration_file)
         ok, _, _ = validate_config_xml_hash_against_fw(
             arguments.configuration_file,
             skip_check=arguments.skip_fw_xml_hash_check,
             ignore_mismatch=arguments.ignore_fw_xml_hash_mismatch,
+            xml_hash=schema.hash,
         )
         if not ok:
             return 1
 
-    return read_all_uefi_vars(arguments.output_file, arguments.configuration_file)
+    rc = read_all_uefi_vars(arguments.output_file, arguments.configuration_file, engine, schema)
+    print(engine.stats)
+    return rc
 
 
 if __name__ == "__main__":
@@ -142,16 +157,6 @@ if __name__ == "__main__":
     console = logging.StreamHandler()
     console.setLevel(logging.CRITICAL)
 
-    # check the privilege level and report error
-    if os.name == 'nt':
-        if not ctypes.windll.shell32.IsUserAnAdmin():
-            print("Administrator privilege required. Please launch from an Administrator privilege level.")
-            sys.exit(1)
-    else:
-        if os.geteuid() != 0:
-            print("Root permission required, please run script with sudo.")
-            sys.exit(1)
-
     # call main worker function
     retcode = main()
 
@@ -0,0 +1,405 @@
+# @file
+#
+# Bulk access to UEFI variables through a pluggable variable store backend
+#
+# A variable list is parsed once, diffed against the values currently in the
+# store, only the changed variables are written and they are read back in a
+# single batch to verify them. The system backend goes through the OS
+# firmware variable services, the file backend keeps the variables in a
+# variable list file so the host tools can be exercised without firmware.
+# On Linux, the efivarfs backend accesses the variables as files directly.
+#
+# Copyright (c), Microsoft Corporation
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+
+import os
+import logging
+import struct
+import time
+import uuid
+from collections import OrderedDict
+from concurrent.futures import ThreadPoolExecutor
+
+from VariableList import UEFIVariable, create_vlist_buffer, read_vlist_from_buffer
+
+DEFAULT_ATTRIBUTES = 7
+
+EFIVARFS_PATH = "/sys/firmware/efi/efivars"
+# Length of the "-xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" suffix of efivarfs file names
+EFIVARFS_GUID_SUFFIX_LENGTH = 37
+# ioctl requests and flag of the Linux inode flags, efivarfs marks most variable files immutable
+FS_IOC_GETFLAGS = 0x80086601
+FS_IOC_SETFLAGS = 0x40086602
+FS_IMMUTABLE_FL = 0x00000010
+
+
+def variable_key(name, guid):
+    if not isinstance(guid, uuid.UUID):
+        guid = uuid.UUID(str(guid))
+    return (name, guid)
+
+
+# Base class of the variable store backends
+#
+# get_many and set_many fall back to one call per variable, backends with a
+# cheaper way to access several variables override them.
+class UefiVariableBackend:
+    # Return (data, attributes) of a variable, attributes may be None when the
+    # backend cannot report them. Return None when the variable does not exist.
+    def get(self, name, guid):
+        raise NotImplementedError
+
+    # Write a variable, or delete it when data is None. Return True on success.
+    def set(self, name, guid, data, attributes):
+        raise NotImplementedError
+
+    # Return the (name, guid) keys of all variables in the store
+    def names(self):
+        raise NotImplementedError
+
+    def get_many(self, keys):
+        return OrderedDict((key, self.get(*key)) for key in keys)
+
+    # Return the variables that could not be written, stop at the first
+    # failure when abort_when_failure is set
+    def set_many(self, variables, abort_when_failure=False):
+        failed = []
+        for variable in variables:
+            if not self.set(variable.name, variable.guid, variable.data, variable.attributes):
+                failed.append(variable)
+                if abort_when_failure:
+                    break
+        return failed
+
+    # Persist pending writes
+    def flush(self):
+        pass
+
+
+# Variable store of the running system, backed by the edk2toollib UefiVariable support
+class SystemUefiVariableBackend(UefiVariableBackend):
+    def __init__(self):
+        from edk2toollib.os.uefivariablesupport import UefiVariable
+        self.uefi_var = UefiVariable()
+        self.not_found = getattr(UefiVariable, "ERROR_ENVVAR_NOT_FOUND", None)
+
+    def get(self, name, guid):
+        (rc, data) = self.uefi_var.GetUefiVar(name, guid)
+        if rc != 0:
+            if rc != self.not_found:
+                # only log the errors other than EFI_NOT_FOUND, because not found is normal in this case...
+                logging.error(f"Error returned from GetUefiVar: {rc} on Name: {name}, Guid: {guid}")
+            return None
+        return (data, None)
+
+    def set(self, name, guid, data, attributes):
+        rc = self.uefi_var.SetUefiVar(name, guid, data, attributes)
+        if rc == 0:
+            logging.error(f"Error returned from SetUefiVar: {rc} on Name: {name}, Guid: {guid}")
+            return False
+        return True
+
+    def names(self):
+        (rc, efi_var_names) = self.uefi_var.GetUefiAllVarNames()
+        if rc != 0:
+            logging.error(f"Error returned from GetUefiAllVarNames: {rc}")
+            return []
+
+        keys = []
+        offset = 0
+        UUID_BYTES_SIZE = 16
+        int_format = "<I"
+        int_size = struct.calcsize(int_format)
+        while offset < len(efi_var_names):
+            (next_offset,) = struct.unpack_from(int_format, efi_var_names, offset)
+            if next_offset == 0:
+                # This is the end... But we still need to go through the last loop
+                next_offset = len(efi_var_names) - offset
+            namespace = uuid.UUID(bytes_le=efi_var_names[offset + int_size: offset + int_size + UUID_BYTES_SIZE])
+            name = efi_var_names[offset + int_size + UUID_BYTES_SIZE: offset + next_offset].decode('utf16')
+            keys.append((name.rstrip("\0"), namespace))
+            offset += next_offset
+        return keys
+
+
+# Variable store kept in a variable list file, for testing the tools on hosts
+# without firmware variable services. Writes are persisted by flush.
+class FileUefiVariableBackend(UefiVariableBackend):
+    def __init__(self, path):
+        self.path = path
+        self.variables = OrderedDict()
+        self.dirty = False
+        if os.path.isfile(path):
+            with open(path, "rb") as file:
+                for variable in read_vlist_from_buffer(file.read()):
+                    self.variables[variable_key(variable.name, variable.guid)] = variable
+
+    def get(self, name, guid):
+        variable = self.variables.get(variable_key(name, guid))
+        if variable is None:
+            return None
+        return (variable.data, variable.attributes)
+
+    def set(self, name, guid, data, attributes):
+        key = variable_key(name, guid)
+        if data is None:
+            if self.variables.pop(key, None) is None:
+                return False
+        else:
+            if attributes is None:
+                attributes = DEFAULT_ATTRIBUTES
+            self.variables[key] = UEFIVariable(key[0], key[1], bytes(data), attributes)
+        self.dirty = True
+        return True
+
+    def names(self):
+        return list(self.variables.keys())
+
+    def flush(self):
+        if not self.dirty:
+            return
+        temp_path = self.path + ".tmp"
+        with open(temp_path, "wb") as file:
+            file.write(b''.join(create_vlist_buffer(variable) for variable in self.variables.values()))
+        os.replace(temp_path, self.path)
+        self.dirty = False
+
+
+# Variable store accessed through the files of a Linux efivarfs mount
+#
+# Each variable is a file named <Name>-<guid> that holds the 32 bit attributes
+# followed by the data. The directory is enumerated once and the reads of a
+# batch run in parallel, one task per namespace guid, so no call is spent on
+# variables that do not exist. In dry run mode, root is a plain directory tree
+# that mimics efivarfs, and the immutable flag handling is skipped.
+class EfivarfsUefiVariableBackend(UefiVariableBackend):
+    def __init__(self, root=EFIVARFS_PATH, dry_run=False, workers=8):
+        self.root = root
+        self.dry_run = dry_run
+        self.workers = workers
+        self._index = None
+
+    @staticmethod
+    def file_name(name, guid):
+        return f"{name}-{str(guid).lower()}"
+
+    # Map the (name, guid) keys of all variables to their file names, with a single directory enumeration
+    def index(self):
+        if self._index is None:
+            self._index = OrderedDict()
+            with os.scandir(self.root) as entries:
+                for entry in entries:
+                    file_name = entry.name
+                    if len(file_name) <= EFIVARFS_GUID_SUFFIX_LENGTH or \
+                            file_name[-EFIVARFS_GUID_SUFFIX_LENGTH] != "-":
+                        continue
+                    try:
+                        guid = uuid.UUID(file_name[-EFIVARFS_GUID_SUFFIX_LENGTH + 1:])
+                    except ValueError:
+                        continue
+                    self._index[(file_name[:-EFIVARFS_GUID_SUFFIX_LENGTH], guid)] = file_name
+        return self._index
+
+    def _read(self, file_name):
+        try:
+            with open(os.path.join(self.root, file_name), "rb") as file:
+                content = file.read()
+        except OSError as e:
+            logging.error(f"Failed to read {file_name}: {e}")
+            return None
+        if len(content) < 4:
+            logging.error(f"Variable file {file_name} is too small")
+            return None
+        return (content[4:], struct.unpack_from("<I", content)[0])
+
+    def _read_group(self, keys):
+        index = self.index()
+        return [(key, self._read(index[key])) for key in keys]
+
+    def get(self, name, guid):
+        key = variable_key(name, guid)
+        file_name = self.index().get(key)
+        if file_name is None:
+            return None
+        return self._read(file_name)
+
+    def get_many(self, keys):
+        keys = [variable_key(*key) for key in keys]
+        index = self.index()
+        values = OrderedDict((key, None) for key in keys)
+
+        groups = OrderedDict()
+        for key in keys:
+            if key in index:
+                groups.setdefault(key[1], []).append(key)
+
+        if len(groups) <= 1 or self.workers <= 1:
+            results = [self._read_group(group) for group in groups.values()]
+        else:
+            with ThreadPoolExecutor(max_workers=min(self.workers, len(groups))) as executor:
+                results = list(executor.map(self._read_group, groups.values()))
+
+        for result in results:
+            for key, value in result:
+                values[key] = value
+        return values
+
+    def _set_immutable(self, path, immutable):
+        if self.dry_run:
+            return
+        import fcntl
+        fd = os.open(path, os.O_RDONLY)
+        try:
+            flags = bytearray(8)
+            fcntl.ioctl(fd, FS_IOC_GETFLAGS, flags)
+            value = struct.unpack_from("<I", flags)[0]
+            new_value = value | FS_IMMUTABLE_FL if immutable else value & ~FS_IMMUTABLE_FL
+            if new_value != value:
+                struct.pack_into("<I", flags, 0, new_value)
+                fcntl.ioctl(fd, FS_IOC_SETFLAGS, flags)
+        finally:
+            os.close(fd)
+
+    def set(self, name, guid, data, attributes):
+        key = variable_key(name, guid)
+        index = self.index()
+        file_name = index.get(key, self.file_name(*key))
+        path = os.path.join(self.root, file_name)
+        try:
+            if key in index:
+                self._set_immutable(path, False)
+            if data is None:
+                if key not in index:
+                    return False
+                os.remove(path)
+                del index[key]
+            else:
+                if attributes is None:
+                    attributes = DEFAULT_ATTRIBUTES
+                # efivarfs requires the attributes and data in a single write and replaces the whole variable,
+                # a plain directory tree needs the file truncated instead
+                flags = os.O_WRONLY | os.O_CREAT | (os.O_TRUNC if self.dry_run else 0)
+                fd = os.open(path, flags, 0o644)
+                try:
+                    os.write(fd, struct.pack("<I", attributes) + bytes(data))
+                finally:
+                    os.close(fd)
+                index[key] = file_name
+        except OSError as e:
+            logging.error(f"Failed to write {file_name}: {e}")
+            return False
+        return True
+
+    def names(self):
+        return list(self.index().keys())
+
+
+# Counters of a bulk operation
+class BulkVariableStats:
+    def __init__(self):
+        self.total = 0
+        self.written = 0
+        self.skipped_unchanged = 0
+        self.failed = 0
+        self.mismatched = 0
+        self.read = 0
+        self.bytes = 0
+        self.seconds = 0.0
+
+    def variables_per_second(self):
+        return (self.total + self.read) / self.seconds if self.seconds > 0 else 0.0
+
+    def bytes_per_second(self):
+        return self.bytes / self.seconds if self.seconds > 0 else 0.0
+
+    def __str__(self):
+        return (f"{self.total} variable(s): {self.written} written, {self.skipped_unchanged} skipped unchanged, "
+                f"{self.failed} failed, {self.mismatched} mismatched on read back, {self.read} read, "
+                f"{self.bytes} bytes in {self.seconds:.3f}s "
+                f"({self.variables_per_second():.0f} variables/s, {self.bytes_per_second() / 1024:.1f} KiB/s)")
+
+
+class BulkVariableEngine:
+    def __init__(self, backend=None):
+        self.backend = backend if backend is not None else SystemUefiVariableBackend()
+        self.stats = BulkVariableStats()
+
+    # Parse a whole variable list buffer (v1 or v2) into UEFIVariables
+    @staticmethod
+    def parse(buffer):
+        return read_vlist_from_buffer(buffer)
+
+    # Split variables into the ones that differ from the store and the ones
+    # that are unchanged. Attributes are only compared when the backend
+    # reports them.
+    def diff(self, variables):
+        current = self.backend.get_many([variable_key(variable.name, variable.guid) for variable in variables])
+        changed = []
+        unchanged = []
+        for variable in variables:
+            value = current.get(variable_key(variable.name, variable.guid))
+            if value is not None and value[0] == variable.data and value[1] in (None, variable.attributes):
+                unchanged.append(variable)
+            else:
+                changed.append(variable)
+        return changed, unchanged
+
+    # Write the variables that differ from the store and verify them with a
+    # batched read back. Return True when all of them were written.
+    def write(self, variables, abort_when_failure=False, verify=True):
+        start = time.perf_counter()
+        stats = self.stats
+        stats.total += len(variables)
+
+        changed, unchanged = self.diff(variables)
+        stats.skipped_unchanged += len(unchanged)
+
+        failed = self.backend.set_many(changed, abort_when_failure)
+        self.backend.flush()
+        failed_keys = set(variable_key(variable.name, variable.guid) for variable in failed)
+        written = [variable for variable in changed if variable_key(variable.name, variable.guid) not in failed_keys]
+        if abort_when_failure and failed:
+            # Nothing after the failing variable was attempted
+            written = changed[:changed.index(failed[0])]
+        stats.failed += len(failed)
+        stats.written += len(written)
+        stats.bytes += sum(len(variable.data) for variable in written)
+
+        mismatched = 0
+        if verify and written:
+            current = self.backend.get_many([variable_key(variable.name, variable.guid) for variable in written])
+            for variable in written:
+                value = current.get(variable_key(variable.name, variable.guid))
+                if value is None or value[0] != variable.data:
+                    logging.error(f"Read back of {variable.name} {variable.guid} does not match the written data")
+                    mismatched += 1
+        stats.mismatched += mismatched
+
+        stats.seconds += time.perf_counter() - start
+        logging.debug(f"Bulk variable write: {stats}")
+        return not failed and mismatched == 0
+
+    # Read the variables of keys in one batch, return the existing ones as an
+    # ordered {key: UEFIVariable}
+    def read(self, keys):
+        start = time.perf_counter()
+        keys = [variable_key(*key) for key in keys]
+        current = self.backend.get_many(keys)
+        variables = OrderedDict()
+        for key in keys:
+            value = current.get(key)
+            if value is None:
+                continue
+            attributes = value[1] if value[1] is not None else DEFAULT_ATTRIBUTES
+            variables[key] = UEFIVariable(key[0], key[1], value[0], attributes)
+        self.stats.read += len(variables)
+        self.stats.bytes += sum(len(variable.data) for variable in variables.values())
+        self.stats.seconds += time.perf_counter() - start
+        logging.debug(f"Bulk variable read: {self.stats}")
+        return variables
+
+    def delete(self, name, guid):
+        key = variable_key(name, guid)
+        rc = self.backend.set(key[0], key[1], None, None)
+        self.backend.flush()
+        return rc
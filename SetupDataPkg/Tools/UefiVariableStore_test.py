@@ -0,0 +1,296 @@
+# @ UefiVariableStore_test.py
+#
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import struct
+import tempfile
+import unittest
+import uuid
+
+from VariableList import UEFIVariable, create_vlist_buffer, create_vlist_v2_buffer, read_vlist
+from UefiVariableStore import BulkVariableEngine, FileUefiVariableBackend, EfivarfsUefiVariableBackend
+import WriteConfVarListToUefiVars as uefi_var_write
+import ReadUefiVarsToConfVarList as uefi_var_read
+
+GUID = uuid.UUID('FE3ED49F-B173-41ED-9076-356661D46A42')
+GUID2 = uuid.UUID('8CF777E5-0D01-479D-9255-19B1F07328D4')
+
+
+# Fails the writes of the given variable names
+class FailingBackend(FileUefiVariableBackend):
+    def __init__(self, path, failing):
+        super().__init__(path)
+        self.failing = failing
+        self.set_calls = []
+
+    def set(self, name, guid, data, attributes):
+        self.set_calls.append(name)
+        if name in self.failing:
+            return False
+        return super().set(name, guid, data, attributes)
+
+
+# Stores different data than written for the given variable names
+class CorruptingBackend(FileUefiVariableBackend):
+    def __init__(self, path, corrupting):
+        super().__init__(path)
+        self.corrupting = corrupting
+
+    def set(self, name, guid, data, attributes):
+        if name in self.corrupting and data is not None:
+            data = bytes(byte ^ 0xff for byte in data)
+        return super().set(name, guid, data, attributes)
+
+
+class UefiVariableStoreTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp_dir = tempfile.TemporaryDirectory()
+        self.store_path = os.path.join(self.tmp_dir.name, 'store.vl')
+
+    def tearDown(self):
+        self.tmp_dir.cleanup()
+
+    def write_vlist(self, variables, version=1):
+        path = os.path.join(self.tmp_dir.name, 'settings.vl')
+        with open(path, 'wb') as vl_file:
+            if version == 1:
+                vl_file.write(b''.join(create_vlist_buffer(variable) for variable in variables))
+            else:
+                vl_file.write(create_vlist_v2_buffer(variables))
+        return path
+
+    def test_file_backend_persists_on_flush(self):
+        backend = FileUefiVariableBackend(self.store_path)
+        self.assertTrue(backend.set('A', str(GUID), b'\x01', 7))
+        self.assertEqual(backend.get('A', GUID), (b'\x01', 7))
+        self.assertFalse(os.path.exists(self.store_path))
+        backend.flush()
+
+        backend = FileUefiVariableBackend(self.store_path)
+        self.assertEqual(backend.names(), [('A', GUID)])
+        self.assertTrue(backend.set('A', GUID, None, None))
+        self.assertFalse(backend.set('A', GUID, None, None))
+        self.assertIsNone(backend.get('A', GUID))
+
+    def test_write_skips_unchanged(self):
+        variables = [UEFIVariable('KNOB_%d' % i, GUID, bytes([i])) for i in range(10)]
+        engine = BulkVariableEngine(FileUefiVariableBackend(self.store_path))
+        self.assertTrue(engine.write(variables))
+        self.assertEqual(engine.stats.written, 10)
+        self.assertEqual(engine.stats.skipped_unchanged, 0)
+
+        # Only the changed variable is written again
+        variables[3] = UEFIVariable('KNOB_3', GUID, b'\xff')
+        backend = FailingBackend(self.store_path, [])
+        engine = BulkVariableEngine(backend)
+        self.assertTrue(engine.write(variables))
+        self.assertEqual(backend.set_calls, ['KNOB_3'])
+        self.assertEqual(engine.stats.written, 1)
+        self.assertEqual(engine.stats.skipped_unchanged, 9)
+        self.assertEqual(engine.stats.mismatched, 0)
+        self.assertEqual(FileUefiVariableBackend(self.store_path).get('KNOB_3', GUID), (b'\xff', 7))
+
+        # Different attributes are a change as well
+        variables[4] = UEFIVariable('KNOB_4', GUID, bytes([4]), 3)
+        changed, unchanged = engine.diff(variables)
+        self.assertEqual([variable.name for variable in changed], ['KNOB_4'])
+        self.assertEqual(len(unchanged), 9)
+
+    def test_write_failures(self):
+        variables = [UEFIVariable('KNOB_%d' % i, GUID, bytes([i])) for i in range(4)]
+
+        backend = FailingBackend(self.store_path, ['KNOB_1'])
+        engine = BulkVariableEngine(backend)
+        self.assertFalse(engine.write(variables))
+        self.assertEqual(backend.set_calls, ['KNOB_0', 'KNOB_1', 'KNOB_2', 'KNOB_3'])
+        self.assertEqual(engine.stats.failed, 1)
+        self.assertEqual(engine.stats.written, 3)
+
+        os.remove(self.store_path)
+        backend = FailingBackend(self.store_path, ['KNOB_1'])
+        engine = BulkVariableEngine(backend)
+        self.assertFalse(engine.write(variables, abort_when_failure=True))
+        self.assertEqual(backend.set_calls, ['KNOB_0', 'KNOB_1'])
+        self.assertEqual(engine.stats.failed, 1)
+        self.assertEqual(engine.stats.written, 1)
+
+    def test_write_mismatches_are_per_call(self):
+        engine = BulkVariableEngine(CorruptingBackend(self.store_path, ['KNOB_1']))
+        self.assertFalse(engine.write([UEFIVariable('KNOB_%d' % i, GUID, bytes([i])) for i in range(2)]))
+        self.assertEqual(engine.stats.mismatched, 1)
+
+        # A later write only fails on its own mismatches, the statistics keep the total
+        self.assertTrue(engine.write([UEFIVariable('KNOB_2', GUID, b'\x02')]))
+        self.assertFalse(engine.write([UEFIVariable('KNOB_1', GUID, b'\x03')]))
+        self.assertEqual(engine.stats.mismatched, 2)
+        self.assertEqual(engine.stats.written, 4)
+
+    def test_read(self):
+        backend = FileUefiVariableBackend(self.store_path)
+        backend.set('A', GUID, b'\x01\x02', 3)
+        engine = BulkVariableEngine(backend)
+        variables = engine.read([('A', str(GUID)), ('B', GUID)])
+        self.assertEqual(list(variables.keys()), [('A', GUID)])
+        self.assertEqual(variables[('A', GUID)].data, b'\x01\x02')
+        self.assertEqual(variables[('A', GUID)].attributes, 3)
+        self.assertEqual(engine.stats.read, 1)
+        self.assertEqual(engine.stats.bytes, 2)
+
+    def test_set_variable_from_file(self):
+        variables = [UEFIVariable('KNOB_%d' % i, GUID, bytes([i, i])) for i in range(5)]
+        for version in [1, 2]:
+            engine = BulkVariableEngine(FileUefiVariableBackend(self.store_path))
+            self.assertEqual(uefi_var_write.set_variable_from_file(self.write_vlist(variables, version),
+                                                                   engine=engine), 1)
+            self.assertEqual(engine.stats.total, 5)
+
+        # The second pass found every variable unchanged
+        self.assertEqual(engine.stats.written, 0)
+        self.assertEqual(engine.stats.skipped_unchanged, 5)
+
+        stored = read_vlist(self.store_path)
+        self.assertEqual([(variable.name, variable.data) for variable in stored],
+                         [(variable.name, variable.data) for variable in variables])
+
+        engine = BulkVariableEngine(FailingBackend(self.store_path, ['KNOB_6']))
+        variables.append(UEFIVariable('KNOB_6', GUID, b'\x06'))
+        path = self.write_vlist(variables)
+        self.assertEqual(uefi_var_write.set_variable_from_file(path, engine=engine), 1)
+        self.assertEqual(uefi_var_write.set_variable_from_file(path, abort_when_failure=True, engine=engine), 0)
+
+        # A corrupted list is not written at all
+        with open(path, 'r+b') as vl_file:
+            vl_file.seek(-1, os.SEEK_END)
+            vl_file.write(b'\x00')
+        engine = BulkVariableEngine(FailingBackend(self.store_path, []))
+        self.assertEqual(uefi_var_write.set_variable_from_file(path, engine=engine), 0)
+        self.assertEqual(engine.backend.set_calls, [])
+
+    def test_delete_var_by_guid_name(self):
+        backend = FileUefiVariableBackend(self.store_path)
+        backend.set('A', GUID, b'\x01', 7)
+        engine = BulkVariableEngine(backend)
+        self.assertEqual(uefi_var_write.delete_var_by_guid_name('A', str(GUID), engine), 1)
+        self.assertEqual(uefi_var_write.delete_var_by_guid_name('A', str(GUID), engine), 0)
+        self.assertEqual(FileUefiVariableBackend(self.store_path).names(), [])
+
+    def test_read_all_uefi_vars(self):
+        backend = FileUefiVariableBackend(self.store_path)
+        backend.set('A', GUID, b'\x01', 7)
+        backend.set('B', GUID, b'\x02', 7)
+        backend.flush()
+
+        output_path = os.path.join(self.tmp_dir.name, 'output.vl')
+        engine = BulkVariableEngine(FileUefiVariableBackend(self.store_path))
+        self.assertEqual(uefi_var_read.read_all_uefi_vars(output_path, engine=engine), 0)
+        self.assertEqual([(variable.name, variable.data) for variable in read_vlist(output_path)],
+                         [('A', b'\x01'), ('B', b'\x02')])
+
+        engine = BulkVariableEngine(FileUefiVariableBackend(os.path.join(self.tmp_dir.name, 'empty.vl')))
+        self.assertEqual(uefi_var_read.read_all_uefi_vars(output_path, engine=engine), -1)
+
+
+class EfivarfsBackendTest(unittest.TestCase):
+    def setUp(self):
+        self.tmp_dir = tempfile.TemporaryDirectory()
+        self.root = self.tmp_dir.name
+
+    def tearDown(self):
+        self.tmp_dir.cleanup()
+
+    def add_file(self, file_name, attributes, data):
+        with open(os.path.join(self.root, file_name), 'wb') as var_file:
+            var_file.write(struct.pack('<I', attributes) + data)
+
+    def test_names_and_reads(self):
+        self.add_file('KNOB_A-%s' % GUID, 7, b'\x01\x02')
+        self.add_file('Knob-With-Dashes-%s' % GUID2, 3, b'\x03')
+        self.add_file('not-a-variable', 7, b'')
+        self.add_file('Short-%s' % GUID, 0, b'')
+        os.truncate(os.path.join(self.root, 'Short-%s' % GUID), 2)
+
+        backend = EfivarfsUefiVariableBackend(self.root, dry_run=True)
+        self.assertEqual(sorted(backend.names()),
+                         sorted([('KNOB_A', GUID), ('Knob-With-Dashes', GUID2), ('Short', GUID)]))
+        self.assertEqual(backend.get('KNOB_A', str(GUID).upper()), (b'\x01\x02', 7))
+        self.assertIsNone(backend.get('KNOB_B', GUID))
+
+        values = backend.get_many([('Knob-With-Dashes', GUID2), ('KNOB_B', GUID), ('KNOB_A', GUID), ('Short', GUID)])
+        self.assertEqual(list(values.items()), [
+            (('Knob-With-Dashes', GUID2), (b'\x03', 3)),
+            (('KNOB_B', GUID), None),
+            (('KNOB_A', GUID), (b'\x01\x02', 7)),
+            (('Short', GUID), None)])
+
+    def test_parallel_reads_across_namespaces(self):
+        guids = [uuid.UUID(int=i) for i in range(16)]
+        keys = []
+        for guid in guids:
+            for i in range(20):
+                self.add_file('KNOB_%d-%s' % (i, guid), 7, bytes([i]) * 4)
+                keys.append(('KNOB_%d' % i, guid))
+
+        engine = BulkVariableEngine(EfivarfsUefiVariableBackend(self.root, dry_run=True, workers=4))
+        variables = engine.read(keys)
+        self.assertEqual(list(variables.keys()), keys)
+        self.assertTrue(all(variables[key].data == bytes([int(key[0][5:])]) * 4 for key in keys))
+        self.assertEqual(engine.stats.read, len(keys))
+
+    def test_write_and_delete(self):
+        self.add_file('KNOB_0-%s' % GUID, 7, b'\x00\x00\x00\x00')
+        self.add_file('KNOB_1-%s' % GUID, 7, b'\x01')
+
+        variables = [UEFIVariable('KNOB_0', GUID, b'\x05'), UEFIVariable('KNOB_1', GUID, b'\x01'),
+                     UEFIVariable('KNOB_2', GUID2, b'\x02\x02')]
+        engine = BulkVariableEngine(EfivarfsUefiVariableBackend(self.root, dry_run=True))
+        self.assertTrue(engine.write(variables))
+        self.assertEqual(engine.stats.written, 2)
+        self.assertEqual(engine.stats.skipped_unchanged, 1)
+        self.assertEqual(engine.stats.mismatched, 0)
+
+        # Rewritten variables are truncated to their new size
+        with open(os.path.join(self.root, 'KNOB_0-%s' % GUID), 'rb') as var_file:
+            self.assertEqual(var_file.read(), struct.pack('<I', 7) + b'\x05')
+        self.assertEqual(EfivarfsUefiVariableBackend(self.root).get('KNOB_2', GUID2), (b'\x02\x02', 7))
+
+        self.assertTrue(engine.delete('KNOB_2', GUID2))
+        self.assertFalse(engine.delete('KNOB_2', GUID2))
+        self.assertFalse(os.path.exists(os.path.join(self.root, 'KNOB_2-%s' % GUID2)))
+
+    def test_write_failure_is_logged(self):
+        # A directory in place of the variable file fails the write
+        os.mkdir(os.path.join(self.root, 'KNOB_0-%s' % GUID))
+
+        backend = EfivarfsUefiVariableBackend(self.root, dry_run=True)
+        with self.assertLogs(level='ERROR') as logs:
+            self.assertFalse(backend.set('KNOB_0', GUID, b'\x01', 7))
+        self.assertTrue(any('Failed to write KNOB_0-%s' % GUID in line for line in logs.output))
+
+    def test_tools_against_directory_tree(self):
+        variables = [UEFIVariable('KNOB_%d' % i, GUID if i % 2 else GUID2, bytes([i])) for i in range(6)]
+        settings_path = os.path.join(self.root, '..', os.path.basename(self.root) + '_settings.vl')
+        output_path = os.path.join(self.root, '..', os.path.basename(self.root) + '_output.vl')
+        try:
+            with open(settings_path, 'wb') as vl_file:
+                vl_file.write(b''.join(create_vlist_buffer(variable) for variable in variables))
+            engine = BulkVariableEngine(EfivarfsUefiVariableBackend(self.root, dry_run=True))
+            self.assertEqual(uefi_var_write.set_variable_from_file(settings_path, engine=engine), 1)
+            self.assertEqual(len(os.listdir(self.root)), 6)
+
+            engine = BulkVariableEngine(EfivarfsUefiVariableBackend(self.root, dry_run=True))
+            self.assertEqual(uefi_var_read.read_all_uefi_vars(output_path, engine=engine), 0)
+            self.assertEqual(
+                sorted((variable.name, variable.guid, variable.data) for variable in read_vlist(output_path)),
+                sorted((variable.name, variable.guid, variable.data) for variable in variables))
+        finally:
+            for path in (settings_path, output_path):
+                if os.path.exists(path):
+                    os.remove(path)
+
+
+if __name__ == '__main__':
+    unittest.main()
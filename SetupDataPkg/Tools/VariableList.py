@@ -12,8 +12,12 @@ import uuid
 import zlib
 import copy
 import os
+import functools
+from itertools import islice
 from xml.dom.minidom import parse, parseString
 from enum import Enum
+from CommonUtility import get_dom_full_hash, read_xml_hash_sidecar, write_xml_hash_sidecar
+import NativeVariableList
 
 
 class ParseError(Exception):
@@ -51,45 +55,105 @@ class StringEvaluationContext(Enum):
     MAX = 3
 
 
+# A brace group of a parsed value literal, with its source text, its offset in the parsed string and its comma
+# separated items. Scalar items are their stripped text, group items are LiteralNode
+class LiteralNode:
+    __slots__ = ('text', 'offset', 'items')
+
+    def __init__(self, text, offset, items):
+        self.text = text
+        self.offset = offset
+        self.items = items
+
+
+LITERAL_DELIMITERS = re.compile(r'[{},]')
+
+
+def _unexpected_after_group(string_object, position):
+    position += len(string_object[position:]) - len(string_object[position:].lstrip())
+    return ParseError("Unexpected character after '}}', found '{}' at offset {} of '{}'".format(
+        string_object[position], position, string_object))
+
+
+# Parses a value literal in a single scan over its delimiters, without recursion. Returns the stripped text of a
+# scalar literal, or the LiteralNode of a brace group
+# "{1,2, 3,{A, B}} " -> group of "1", "2", "3" and the group of "A" and "B"
+def parse_literal(string_object):
+    stripped = string_object.lstrip()
+    if not stripped.startswith('{'):
+        return stripped.rstrip()
+
+    # Items of the groups still open, innermost last, with the offset of their '{'
+    groups = []
+    # Start of the current item, the end of the group item just closed and the depth of braces within a scalar
+    item_start = len(string_object) - len(stripped)
+    group_end = None
+    scalar_depth = 0
+    match = LITERAL_DELIMITERS.search(string_object, item_start)
+    while match:
+        position = match.start()
+        c = string_object[position]
+        node = None
+        if scalar_depth > 0:
+            if c == '{':
+                scalar_depth += 1
+            elif c == '}':
+                scalar_depth -= 1
+            c = None
+        elif group_end is not None:
+            # Only whitespace may follow a group within its item
+            if c == '{' or (group_end != position and not string_object[group_end:position].isspace()):
+                raise _unexpected_after_group(string_object, group_end)
+            group_end = None
+        elif c != '{':
+            groups[-1][0].append(string_object[item_start:position].strip())
+        elif item_start != position and not string_object[item_start:position].isspace():
+            # Braces after the start of a scalar are part of its text
+            scalar_depth = 1
+        else:
+            close = string_object.find('}', position + 1)
+            if close != -1 and string_object.find('{', position + 1, close) == -1:
+                # A group of scalars only is split at once
+                items = [item.strip() for item in string_object[position + 1:close].split(',')]
+                node = LiteralNode(string_object[position:close + 1], position, items)
+                position = close
+            else:
+                groups.append(([], position))
+                item_start = position + 1
+
+        if c == ',':
+            item_start = position + 1
+        elif c == '}':
+            items, start = groups.pop()
+            node = LiteralNode(string_object[start:position + 1], start, items)
+
+        if node is not None:
+            if not groups:
+                if string_object[position + 1:].strip():
+                    raise _unexpected_after_group(string_object, position + 1)
+                return node
+            groups[-1][0].append(node)
+            group_end = position + 1
+        match = LITERAL_DELIMITERS.search(string_object, position + 1)
+
+    raise ParseError("expected '}}' at offset {} of '{}'".format(len(string_object), string_object))
+
+
+# Error of a literal that should have been a brace group
+def expected_group_error(text):
+    return ParseError("expected '{{', found '{}'".format(text[0]))
+
+
 # Decodes a comma separated list within curly braces in to a list
 # "{1,2, 3,{A, B}} " -> ["1", "2", "3", "{A, B}"]
 def split_braces(string_object):
-    segments = []
-    depth = 0
-    chars = []
-    complete = False
-    for c in string_object.strip():
-        if complete and c == ' ':
-            continue
-        elif complete:
-            raise ParseError(
-                "Unexpected character after '}}', found '{}'".format(c))
-        if c == '{':
-            if depth > 0:
-                chars.append(c)
-            depth += 1
-        elif c == ',':
-            if depth > 1:
-                chars.append(c)
-            else:
-                segments.append("".join(chars).strip())
-                chars = []
-        elif c == '}':
-            depth -= 1
-            if depth > 0:
-                chars.append(c)
-            elif depth == 0:
-                segments.append("".join(chars).strip())
-                chars = []
-                complete = True
-        elif depth > 0:
-            chars.append(c)
-        else:
-            raise ParseError("expected '{{', found '{}'".format(c))
-    if not complete:
-        ParseError("expected '}'")
+    node = parse_literal(string_object)
+    if isinstance(node, str):
+        if node == "":
+            return []
+        raise expected_group_error(node)
 
-    return segments
+    return [item if isinstance(item, str) else item.text for item in node.items]
 
 
 # Checks to see if a token is a valid C identifier
@@ -113,10 +177,21 @@ class StringFormatOptions:
     efi_format = False
 
 
+# Precompiled little endian layout of a binary format, shared by all the formats with the same layout.
+# Formats only keep their struct codes, as struct.Struct objects can not be deep copied along with a schema
+@functools.lru_cache(maxsize=None)
+def get_binary_layout(codes):
+    return struct.Struct('<' + codes)
+
+
 # A DataFormat defines how a variable element is serialized
 # * to/from strings (as in the XML attributes) as well as
 # * to/from binary (as in the variable list)
 # * to C data types
+#
+# The binary layout of every format is described by struct codes. Composite formats flatten their object
+# representation to the scalars of that layout, so a whole array or struct is packed or unpacked by a single
+# precompiled struct.Struct instead of element by element.
 class DataFormat:
     def __init__(self, c_type):
         self.c_type = c_type
@@ -124,6 +199,42 @@ class DataFormat:
         self.max = None
         pass
 
+    # Build the object representation of a parsed literal, scalars only need its text
+    def literal_to_object(self, node, eval_context=StringEvaluationContext.DEFAULT):
+        return self.string_to_object(node if isinstance(node, str) else node.text, eval_context)
+
+    # Struct codes of the binary layout, without byte order
+    def struct_codes(self):
+        return self.pack_format.lstrip('<')
+
+    def binary_layout(self):
+        return get_binary_layout(self.struct_codes())
+
+    # Append the scalars of the binary layout of object_representation to values
+    def flatten(self, object_representation, values):
+        values.append(object_representation)
+
+    # Build an object representation from the iterator of scalars of the binary layout
+    def unflatten(self, values):
+        return next(values)
+
+    def object_to_binary(self, object_representation):
+        values = []
+        self.flatten(object_representation, values)
+        return self.binary_layout().pack(*values)
+
+    # Serialize object_representation into buffer at offset
+    def pack_into(self, buffer, offset, object_representation):
+        values = []
+        self.flatten(object_representation, values)
+        self.binary_layout().pack_into(buffer, offset, *values)
+
+    def binary_to_object(self, binary_representation):
+        return self.unflatten(iter(self.binary_layout().unpack_from(binary_representation)))
+
+    def size_in_bytes(self):
+        return self.binary_layout().size
+
 
 # Represents all data types that have an object representation as a
 # Python int
@@ -260,6 +371,9 @@ class BoolFormat(DataFormat):
             else:
                 return 'false'
 
+    def struct_codes(self):
+        return '?'
+
     def object_to_binary(self, object_representation):
         return struct.pack("<?", object_representation)
 
@@ -383,6 +497,9 @@ class EnumFormat(DataFormat):
                     return value.pretty_name
         return str(object_representation)
 
+    def struct_codes(self):
+        return 'I'
+
     def object_to_binary(self, object_representation):
         return struct.pack("<I", object_representation)
 
@@ -429,7 +546,12 @@ class ArrayFormat(DataFormat):
         pass
 
     def string_to_object(self, string_representation, eval_context=StringEvaluationContext.DEFAULT):
-        if string_representation == "":
+        return self.literal_to_object(parse_literal(string_representation), eval_context)
+
+    def literal_to_object(self, node, eval_context=StringEvaluationContext.DEFAULT):
+        if isinstance(node, str):
+            if node != "":
+                raise expected_group_error(node)
             if eval_context == StringEvaluationContext.DEFAULT:
                 return self.default
             elif eval_context == StringEvaluationContext.MIN:
@@ -437,31 +559,24 @@ class ArrayFormat(DataFormat):
             elif eval_context == StringEvaluationContext.MAX:
                 return self.max
 
-        object_array = []
-
         # If an array is specified with "{1,2,3}" and the number of elements
         #   matches the expected number for the array, decode the array
         # If an array is specified with only a single element "{4}" treat
         #   that as an array in which all elements are set to that value
-        segments = split_braces(string_representation)
-        if len(segments) == 1:
-            repeated_element = self.format.string_to_object(segments[0], eval_context)
-            for element in range(self.count):
-                object_array.append(repeated_element)
-        elif len(segments) == self.count:
-            for element in segments:
-                object_array.append(self.format.string_to_object(element, eval_context))
+        if len(node.items) == 1:
+            return [self.format.literal_to_object(node.items[0], eval_context)] * self.count
+        elif len(node.items) == self.count:
+            return [self.format.literal_to_object(item, eval_context) for item in node.items]
         else:
             raise ParseError(
                 "Member '{}' of struct '{}' should have {} elements, "
-                "but {} were found"
+                "but {} were found at offset {}"
                 .format(
                     self.member_name,
                     self.struct_name,
                     self.count,
-                    len(segments)))
-
-        return object_array
+                    len(node.items),
+                    node.offset))
 
     def object_to_string(
             self,
@@ -474,23 +589,32 @@ class ArrayFormat(DataFormat):
 
         return "{{{}}}".format(",".join(element_strings))
 
-    def object_to_binary(self, object_representation):
-        binary = b''
-        for element in object_representation:
-            binary += self.format.object_to_binary(element)
-        return binary
+    def struct_codes(self):
+        element_codes = self.format.struct_codes()
+        if len(element_codes) == 1:
+            return "{}{}".format(self.count, element_codes)
+        return element_codes * self.count
 
-    def binary_to_object(self, binary_representation):
-        values = []
-        element_size = self.format.size_in_bytes()
-        for i in range(self.count):
-            element_binary = binary_representation[
-                (i * element_size):((i + 1) * element_size)]
-            values.append(self.format.binary_to_object(element_binary))
-        return values
+    def flatten(self, object_representation, values):
+        if len(object_representation) != self.count:
+            raise ParseError(
+                "Member '{}' of struct '{}' should have {} elements, "
+                "but {} were found"
+                .format(
+                    self.member_name,
+                    self.struct_name,
+                    self.count,
+                    len(object_representation)))
+        if isinstance(self.format, StructFormat):
+            for element in object_representation:
+                self.format.flatten(element, values)
+        else:
+            values.extend(object_representation)
 
-    def size_in_bytes(self):
-        return self.format.size_in_bytes() * self.count
+    def unflatten(self, values):
+        if isinstance(self.format, StructFormat):
+            return [self.format.unflatten(values) for i in range(self.count)]
+        return list(islice(values, self.count))
 
     def check_bounds(self, value, min, max):
         for i in range(self.count):
@@ -546,6 +670,9 @@ class StructMember:
     def string_to_object(self, string_representation, eval_context=StringEvaluationContext.DEFAULT):
         return self.format.string_to_object(string_representation, eval_context)
 
+    def literal_to_object(self, node, eval_context=StringEvaluationContext.DEFAULT):
+        return self.format.literal_to_object(node, eval_context)
+
     def object_to_string(
             self,
             object_representation,
@@ -654,12 +781,16 @@ class StructFormat(DataFormat):
         return subknobs
 
     def string_to_object(self, string_representation, eval_context=StringEvaluationContext.DEFAULT):
+        return self.literal_to_object(parse_literal(string_representation), eval_context)
+
+    def literal_to_object(self, node, eval_context=StringEvaluationContext.DEFAULT):
         obj = OrderedDict()
 
-        segments = split_braces(string_representation)
+        if isinstance(node, str) and node != "":
+            raise expected_group_error(node)
 
         # Get the defaults from the member values
-        if len(segments) == 0 or (len(segments) == 1 and segments[0] == ""):
+        if isinstance(node, str) or node.items == [""]:
             for member in self.members:
                 if eval_context == StringEvaluationContext.DEFAULT:
                     obj[member.name] = member.default
@@ -669,21 +800,21 @@ class StructFormat(DataFormat):
                     obj[member.name] = member.max
             return obj
 
-        if len(self.members) > len(segments):
+        if len(self.members) > len(node.items):
             raise ParseError(
                 "Value '{}' does not have enough members for struct '{}'"
                 .format(
-                    string_representation,
+                    node.text,
                     self.name))
-        if len(self.members) < len(segments):
+        if len(self.members) < len(node.items):
             raise ParseError(
                 "Value '{}' does has too many members for struct '{}'"
                 .format(
-                    string_representation,
+                    node.text,
                     self.name))
 
-        for (member, value) in zip(self.members, segments):
-            obj[member.name] = member.string_to_object(value, eval_context)
+        for (member, item) in zip(self.members, node.items):
+            obj[member.name] = member.literal_to_object(item, eval_context)
         return obj
 
     def object_to_string(
@@ -703,32 +834,22 @@ class StructFormat(DataFormat):
 
         return "{{{}}}".format(",".join(member_strings))
 
-    def object_to_binary(self, object_representation):
-        binary_representation = b''
+    def struct_codes(self):
+        # Members do not change once the struct is parsed, keep the codes of large structs
+        if getattr(self, '_struct_codes', None) is None:
+            self._struct_codes = ''.join(member.format.struct_codes() for member in self.members)
+        return self._struct_codes
+
+    def flatten(self, object_representation, values):
         for member in self.members:
-            value = object_representation[member.name]
-            member_binary = member.object_to_binary(value)
-            binary_representation += member_binary
-            assert len(member_binary) == member.size_in_bytes()
-        return binary_representation
+            member.format.flatten(object_representation[member.name], values)
 
-    def binary_to_object(self, binary_representation):
-        position = 0
+    def unflatten(self, values):
         obj = OrderedDict()
         for member in self.members:
-            member_binary = binary_representation[
-                position:(position + member.size_in_bytes())]
-            member_value = member.binary_to_object(member_binary)
-            obj[member.name] = member_value
-            position += member.size_in_bytes()
+            obj[member.name] = member.format.unflatten(values)
         return obj
 
-    def size_in_bytes(self):
-        total_size = 0
-        for member in self.members:
-            total_size += member.size_in_bytes()
-        return total_size
-
     def check_bounds(self, value, min, max):
         for member in self.members:
             member_value = value[member.name]
@@ -945,13 +1066,20 @@ class SubKnob:
         return self.knob._get_child_value(self.name, self.knob.max)
 
 
+# XSD of the config schemas, loaded on first use
+_config_xsd = None
+
+
 class Schema:
-    def __init__(self, dom, origin_path=""):
+    def __init__(self, dom, origin_path="", xml_hash=None):
         self.enums = []
         self.structs = []
         self.knobs = []
         self.path = origin_path
 
+        # Hash of the schema content as embedded in firmware as gSchemaXmlHash, computed from the same parse
+        self.hash = xml_hash if xml_hash is not None else get_dom_full_hash(dom)
+
         for section in dom.getElementsByTagName('Enums'):
             for enum in section.getElementsByTagName('Enum'):
                 self.enums.append(EnumFormat(enum))
@@ -969,10 +1097,19 @@ class Schema:
         for knob in self.knobs:
             self.subknobs += knob.subknobs
 
+        # Index the subknobs by (namespace, name) so lookups do not scan the whole schema,
+        # the first subknob wins to match the order of a linear scan
+        self._subknob_index = {}
+        for subknob in self.subknobs:
+            self._subknob_index.setdefault((str(subknob.knob.namespace).upper(), subknob.name), subknob)
+
         pass
 
     # Load a schema given a path to a schema xml file
-    def load(path):
+    # When sidecar is set, the hash is taken from the sidecar file next to the schema if it is up to date, and
+    # recorded there otherwise
+    def load(path, sidecar=False):
+        global _config_xsd
 
         # Per instructions from PyInstaller:
         # https://pyinstaller.org/en/stable/runtime-information.html#run-time-information
@@ -983,12 +1120,18 @@ class Schema:
             # The application is not frozen, perform schema check
             import xmlschema
             # Get the XML schema from the current path
-            xsd = xmlschema.XMLSchema(os.path.join(os.path.dirname(os.path.abspath(__file__)), "configschema.xsd"))
+            if _config_xsd is None:
+                _config_xsd = xmlschema.XMLSchema(
+                    os.path.join(os.path.dirname(os.path.abspath(__file__)), "configschema.xsd"))
 
             # raises exception if validation fails
-            xsd.validate(path)
+            _config_xsd.validate(path)
 
-        return Schema(parse(path), path)
+        xml_hash = read_xml_hash_sidecar(path) if sidecar else None
+        schema = Schema(parse(path), path, xml_hash)
+        if sidecar and xml_hash is None:
+            write_xml_hash_sidecar(path, schema.hash)
+        return schema
 
     # Parse a schema given a string representation of the xml content
     def parse(string):
@@ -996,12 +1139,8 @@ class Schema:
 
     # Get a knob by name
     def get_knob(self, guid, knob_name):
-        for knob in self.subknobs:
-            # namespace guid lives at the Knob level, not the subknob level
-            if str(knob.knob.namespace).upper() == str(guid).upper() and knob.name == knob_name:
-                return knob
-
-        return None
+        # namespace guid lives at the Knob level, not the subknob level
+        return self._subknob_index.get((str(guid).upper(), knob_name))
 
     # Get a format by name
     def get_format(self, type_name):
@@ -1067,6 +1206,193 @@ def create_vlist_buffer(variable):
     return payload + struct.pack("<I", crc)
 
 
+VLIST_ENTRY_HEADER = struct.Struct("<ii")
+VLIST_ENTRY_FIELD = struct.Struct("<I")
+# Bytes of an entry besides its name and data: NameSize, DataSize, Guid, Attributes and CRC32
+VLIST_ENTRY_OVERHEAD = VLIST_ENTRY_HEADER.size + 16 + VLIST_ENTRY_FIELD.size * 2
+
+
+# Writes a vlist entry into buffer at offset, in the same layout as create_vlist_buffer. pack_data writes the
+# data_size bytes of data at the offset it is given. Returns the offset following the entry
+def pack_vlist_entry_into(buffer, offset, encoded_name, guid, attributes, data_size, pack_data):
+    VLIST_ENTRY_HEADER.pack_into(buffer, offset, len(encoded_name), data_size)
+    position = offset + VLIST_ENTRY_HEADER.size
+    buffer[position:position + len(encoded_name)] = encoded_name
+    position += len(encoded_name)
+    buffer[position:position + 16] = guid.bytes_le
+    position += 16
+    VLIST_ENTRY_FIELD.pack_into(buffer, position, attributes)
+    position += VLIST_ENTRY_FIELD.size
+    pack_data(buffer, position)
+    position += data_size
+    with memoryview(buffer) as view:
+        crc = zlib.crc32(view[offset:position])
+    VLIST_ENTRY_FIELD.pack_into(buffer, position, crc)
+    return position + VLIST_ENTRY_FIELD.size
+
+
+# Variable list v2 encoding
+#
+# A v2 blob starts with a single header, followed by a table of the unique
+# namespace Guids and an interned table of the unique null terminated
+# UTF-16LE names. Each entry then refers to its name by byte offset into the
+# string table and to its Guid by index into the Guid table, instead of
+# repeating both for every knob:
+#   Header:
+#     Signature(4 bytes, 'CVL2'; never a legal v1 NameSize),
+#     Version(int16, 2),
+#     HeaderSize(int16, size of this header in bytes),
+#     GuidCount(int32, number of entries in the Guid table),
+#     StringTableSize(int32, size of the string table in bytes),
+#     CRC32(int32 checksum of the Guid table and string table)
+#   Guid[GuidCount](16 Byte namespace Guids)
+#   Strings[StringTableSize](null terminated UTF-16LE encoded names)
+#   Entries:
+#     NameOffset(int32, byte offset of the name in the string table),
+#     GuidIndex(int16, index of the namespace Guid in the Guid table),
+#     Reserved(int16, 0),
+#     Attributes(int32 UEFI attributes),
+#     DataSize(int32, size of Data in bytes),
+#     Data(bytes),
+#     CRC32(int32 checksum of all bytes from NameOffset through Data)
+#
+# The aligned flavor of v2 (Version 3) keeps the same structures, but pads
+# them so the Data of every entry is 8 byte aligned in the blob, and can be
+# read in place by firmware:
+#   - the string table is padded with zeros, counted in StringTableSize, so
+#     the first entry starts 8 byte aligned
+#   - the CRC32 of an entry is 4 byte aligned, and the entry is padded with
+#     zeros to a multiple of 8 bytes after it. The padding is not covered by
+#     the CRC32
+VLIST_V2_SIGNATURE = b'CVL2'
+VLIST_V2_VERSION = 2
+VLIST_V2_ALIGNED_VERSION = 3
+VLIST_V2_DATA_ALIGNMENT = 8
+VLIST_V2_HEADER = struct.Struct("<4sHHIII")
+VLIST_V2_ENTRY = struct.Struct("<IHHII")
+
+
+def align_up(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+
+# Offsets of the CRC32 and of the next entry, relative to the start of a v2 entry with data_size bytes of data
+def get_vlist_v2_entry_layout(data_size, aligned):
+    crc_offset = VLIST_V2_ENTRY.size + data_size
+    if not aligned:
+        return crc_offset, crc_offset + 4
+
+    crc_offset = align_up(crc_offset, 4)
+    return crc_offset, align_up(crc_offset + 4, VLIST_V2_DATA_ALIGNMENT)
+
+
+# Create a v2 variable list blob, in the aligned flavor if aligned is set. If data_offsets is a list, the offset in
+# the blob of the data of each variable is appended to it
+def create_vlist_v2_buffer(variables, aligned=False, data_offsets=None):
+    guid_table = OrderedDict()
+    string_table = OrderedDict()
+    string_size = 0
+    entries = []
+
+    for variable in variables:
+        guid_index = guid_table.setdefault(variable.guid.bytes_le, len(guid_table))
+        if guid_index > 0xFFFF:
+            raise Exception("Too many namespace guids for a v2 variable list")
+
+        if variable.name not in string_table:
+            string_table[variable.name] = string_size
+            string_size += (len(variable.name) + 1) * 2
+
+        payload = VLIST_V2_ENTRY.pack(
+            string_table[variable.name],
+            guid_index,
+            0,
+            variable.attributes,
+            len(variable.data)) + variable.data
+        crc_offset, entry_size = get_vlist_v2_entry_layout(len(variable.data), aligned)
+        entry = payload.ljust(crc_offset, b'\0') + struct.pack("<I", zlib.crc32(payload))
+        entries.append(entry.ljust(entry_size, b'\0'))
+
+    tables = b''.join(guid_table.keys()) + \
+        b''.join((name + "\0").encode("utf-16le") for name in string_table)
+    if aligned:
+        # Pad the string table so the entries, and the data following their headers, are aligned
+        tables = tables.ljust(align_up(VLIST_V2_HEADER.size + len(tables), VLIST_V2_DATA_ALIGNMENT)
+                              - VLIST_V2_HEADER.size, b'\0')
+        string_size = len(tables) - len(guid_table) * 16
+
+    header = VLIST_V2_HEADER.pack(
+        VLIST_V2_SIGNATURE,
+        VLIST_V2_ALIGNED_VERSION if aligned else VLIST_V2_VERSION,
+        VLIST_V2_HEADER.size,
+        len(guid_table),
+        string_size,
+        zlib.crc32(tables))
+
+    if data_offsets is not None:
+        offset = len(header) + len(tables)
+        for entry in entries:
+            data_offsets.append(offset + VLIST_V2_ENTRY.size)
+            offset += len(entry)
+
+    return header + tables + b''.join(entries)
+
+
+def read_vlist_v2_from_buffer(array):
+    if len(array) < VLIST_V2_HEADER.size:
+        raise Exception("Variable list v2 header truncated")
+
+    signature, version, header_size, guid_count, string_size, crc = VLIST_V2_HEADER.unpack_from(array)
+    if signature != VLIST_V2_SIGNATURE or version not in (VLIST_V2_VERSION, VLIST_V2_ALIGNED_VERSION) or \
+            header_size != VLIST_V2_HEADER.size:
+        raise Exception("Unsupported variable list header")
+
+    aligned = version == VLIST_V2_ALIGNED_VERSION
+
+    guid_offset = header_size
+    string_offset = guid_offset + guid_count * 16
+    entry_offset = string_offset + string_size
+    if entry_offset > len(array):
+        raise Exception("Variable list v2 tables truncated")
+
+    if aligned and entry_offset % VLIST_V2_DATA_ALIGNMENT:
+        raise Exception("Variable list v2 entries are not aligned")
+
+    if crc != zlib.crc32(array[guid_offset:entry_offset]):
+        raise Exception("CRC mismatch")
+
+    guids = [uuid.UUID(bytes_le=bytes(array[guid_offset + i * 16:guid_offset + (i + 1) * 16]))
+             for i in range(guid_count)]
+    strings = array[string_offset:entry_offset]
+
+    variables = []
+    while entry_offset < len(array):
+        name_offset, guid_index, _, attributes, data_size = VLIST_V2_ENTRY.unpack_from(array, entry_offset)
+        data_offset = entry_offset + VLIST_V2_ENTRY.size
+        crc_offset, entry_size = get_vlist_v2_entry_layout(data_size, aligned)
+        crc_offset += entry_offset
+        if entry_offset + entry_size > len(array):
+            raise Exception("Variable list v2 entry truncated")
+
+        crc = struct.unpack_from("<I", array, crc_offset)[0]
+        if crc != zlib.crc32(array[entry_offset:data_offset + data_size]):
+            raise Exception("CRC mismatch")
+
+        if guid_index >= guid_count or name_offset >= string_size or name_offset % 2:
+            raise Exception("Variable list v2 entry references out of range table data")
+
+        name_end = name_offset
+        while name_end < string_size and strings[name_end:name_end + 2] != b'\0\0':
+            name_end += 2
+        name = bytes(strings[name_offset:name_end]).decode(encoding="UTF-16LE")
+
+        data = bytes(array[data_offset:data_offset + data_size])
+        variables.append(UEFIVariable(name, guids[guid_index], data, attributes))
+        entry_offset += entry_size
+
+    return variables
+
+
 def get_delta_vlist(schema):
     name_list = []
     var_list = []
@@ -1083,16 +1409,37 @@ def get_delta_vlist(schema):
 
 
 # Create a byte array for all the knobs in this schema
-def vlist_to_binary(schema):
-    ret = b''
+def vlist_to_binary(schema, version=1):
+    if version in (VLIST_V2_VERSION, VLIST_V2_ALIGNED_VERSION):
+        variables = []
+        for knob in schema.knobs:
+            if knob.value is not None:
+                value_bytes = knob.format.object_to_binary(knob.value)
+                variables.append(UEFIVariable(knob.name, knob.namespace, value_bytes))
+        return create_vlist_v2_buffer(variables, aligned=version == VLIST_V2_ALIGNED_VERSION)
+
+    # Size the whole list first and serialize every knob in place. The values are read without the defensive copy
+    # of Knob.value since they are only serialized
+    entries = []
+    guids = {}
+    size = 0
     for knob in schema.knobs:
-        if knob.value is not None:
-            value_bytes = knob.format.object_to_binary(knob.value)
+        if knob._value is not None:
+            encoded_name = (knob.name + "\0").encode("utf-16le")
+            if knob.namespace not in guids:
+                guids[knob.namespace] = uuid.UUID(knob.namespace)
+            data_size = knob.format.size_in_bytes()
+            entries.append((knob, encoded_name, guids[knob.namespace], data_size))
+            size += VLIST_ENTRY_OVERHEAD + len(encoded_name) + data_size
 
-            variable = UEFIVariable(knob.name, knob.namespace, value_bytes)
-            ret += create_vlist_buffer(variable)
+    buffer = bytearray(size)
+    offset = 0
+    for (knob, encoded_name, guid, data_size) in entries:
+        offset = pack_vlist_entry_into(
+            buffer, offset, encoded_name, guid, 7, data_size,
+            lambda buffer, position, knob=knob: knob.format.pack_into(buffer, position, knob._value))
 
-    return ret
+    return bytes(buffer)
 
 
 # Read a set of UEFIVariables from a variable list file
@@ -1102,61 +1449,78 @@ def read_vlist(file):
     return variables
 
 
-# Read a set of UEFIVariables from a variable list buffer
+# Read a set of UEFIVariables from a variable list buffer, with ConfigVariableListLib when its host library is
+# available so the list is validated by the same code as in firmware
 def read_vlist_from_buffer(array):
+    if NativeVariableList.is_available():
+        return read_vlist_from_buffer_native(array)
+
+    return read_vlist_from_buffer_python(array)
+
+
+# Read a set of UEFIVariables from a variable list buffer with the host build of ConfigVariableListLib
+def read_vlist_from_buffer_native(array):
+    try:
+        entries = NativeVariableList.parse(array)
+    except NativeVariableList.NativeVariableListError as error:
+        # Report why the list is rejected the same way as without the host library
+        read_vlist_from_buffer_python(array)
+        raise Exception("Variable list rejected by ConfigVariableListLib, status 0x{:x}".format(error.status))
+
+    guids = {}
+    variables = []
+    for (name, guid, attributes, data) in entries:
+        if guid not in guids:
+            guids[guid] = uuid.UUID(bytes_le=guid)
+        variables.append(UEFIVariable(name, guids[guid], data, attributes))
+
+    return variables
+
+
+# Read a set of UEFIVariables from a variable list buffer in Python
+def read_vlist_from_buffer_python(array):
+    if array[:4] == VLIST_V2_SIGNATURE:
+        return read_vlist_v2_from_buffer(array)
+
     variables = []
-    temp_arr = array
-    while len(temp_arr):
-        # Try reading the first part
-        name_size_bytes = temp_arr[:4]
-        temp_arr = temp_arr[4:]
-
-        # Decode the name size and read the data size
-        name_size = struct.unpack("<i", name_size_bytes)[0]
-        data_size = struct.unpack("<i", temp_arr[:4])[0]
-        temp_arr = temp_arr[4:]
-
-        # These portions are fixed size
-        guid_size = 16
-        attr_size = 4
-
-        # This is the number of bytes *after* the two size integers
-        # *until before* the CRC
-        remaining_bytes = name_size + guid_size + attr_size + data_size
-
-        # Payload will now contain all of the bytes including the size
-        # bytes, but not the CRC
-        payload = struct.pack("<ii", name_size, data_size) + \
-            temp_arr[:remaining_bytes]
-        temp_arr = temp_arr[remaining_bytes:]
-
-        # Read the CRC separately
-        crc = struct.unpack("<I", temp_arr[:4])[0]
-        temp_arr = temp_arr[4:]
-
-        # Validate the CRC
-        if crc != zlib.crc32(payload):
+    offset = 0
+    while offset < len(array):
+        # Decode the name size and data size, then locate the fixed size
+        # portions that follow the name
+        name_size, data_size = VLIST_ENTRY_HEADER.unpack_from(array, offset)
+        name_offset = offset + VLIST_ENTRY_HEADER.size
+        guid_offset = name_offset + name_size
+        attributes_offset = guid_offset + 16
+        data_offset = attributes_offset + VLIST_ENTRY_FIELD.size
+        crc_offset = data_offset + data_size
+
+        # The CRC covers all of the bytes from the size integers through the data
+        crc = VLIST_ENTRY_FIELD.unpack_from(array, crc_offset)[0]
+        if crc != zlib.crc32(array[offset:crc_offset]):
             raise Exception("CRC mismatch")
 
         # Decode the elements of the payload
-        name = payload[8:(name_size + 8)].decode(encoding="UTF-16LE").strip("\0")
-        guid_bytes = payload[(name_size + 8):(name_size + 8 + 16)]
-        guid = uuid.UUID(bytes_le=guid_bytes)
-        attributes_bytes = payload[(name_size + 8 + 16):(name_size + 8 + 16 + 4)]
-        attributes = struct.unpack("<I", attributes_bytes)[0]
-        data = payload[(name_size + 8 + 16 + 4):]
+        name = bytes(array[name_offset:guid_offset]).decode(encoding="UTF-16LE").strip("\0")
+        guid = uuid.UUID(bytes_le=bytes(array[guid_offset:attributes_offset]))
+        attributes = VLIST_ENTRY_FIELD.unpack_from(array, attributes_offset)[0]
+        data = bytes(array[data_offset:crc_offset])
 
         variables.append(UEFIVariable(name, guid, data, attributes))
+        offset = crc_offset + VLIST_ENTRY_FIELD.size
 
     # If there are no more entries left, returns
     return variables
 
 
+# Returns the knobs updated from variables, in order
 def uefi_variables_to_knobs(schema, variables):
+    updated_knobs = []
     for variable in variables:
         knob = schema.get_knob(variable.guid, variable.name)
         if knob is not None:
             knob.value = knob.format.binary_to_object(variable.data)
+            updated_knobs.append(knob.knob)
+    return updated_knobs
 
 
 def read_csv(schema, csv_path):
@@ -1302,9 +1666,21 @@ def write_csv_detailed(schema, csv_path):
                         subknob.help])
 
 
-def write_vlist(schema, vlist_path):
+def write_vlist(schema, vlist_path, version=1):
     with open(vlist_path, 'wb') as vlist_file:
-        buf = vlist_to_binary(schema)
+        buf = vlist_to_binary(schema, version)
+        vlist_file.write(buf)
+
+
+# Re-encode a variable list file, in either format, into the requested format
+def translate_vlist(in_path, out_path, version):
+    variables = read_vlist(in_path)
+    if version in (VLIST_V2_VERSION, VLIST_V2_ALIGNED_VERSION):
+        buf = create_vlist_v2_buffer(variables, aligned=version == VLIST_V2_ALIGNED_VERSION)
+    else:
+        buf = b''.join(create_vlist_buffer(variable) for variable in variables)
+
+    with open(out_path, 'wb') as vlist_file:
         vlist_file.write(buf)
 
 
@@ -1313,11 +1689,15 @@ def usage():
     print("  write_vl <schema.xml> [<values.csv>] <blob.vl>")
     print("  write_csv <schema.xml> [<blob.vl>] <values.csv>")
     print("  write_csv_detailed <schema.xml> <values.csv>")
+    print("  translate_vl <in.vl> <out.vl> <v1|v2|v2a>")
     print("")
     print("schema.xml : An XML with the definition of a set of known")
     print("             UEFI variables ('knobs') and types to interpret them")
     print("blob.vl : file is a binary list of UEFI variables in the")
-    print("          format used by the EFI 'dmpstore' command")
+    print("          format used by the EFI 'dmpstore' command, or the")
+    print("          compact v2 format with interned names and guids")
+    print("v2a : the v2 format, padded so the data of every entry is")
+    print("      naturally aligned and can be read in place")
     print("values.csv : file is a text list of knobs")
 
 
@@ -1411,6 +1791,17 @@ def main():
             sys.exit(1)
             return
 
+    if sys.argv[1].lower() == "translate_vl":
+        versions = {"v1": 1, "v2": VLIST_V2_VERSION, "v2a": VLIST_V2_ALIGNED_VERSION}
+        if len(sys.argv) == 5 and sys.argv[4].lower() in versions:
+            # Re-encode the vlist in the requested format
+            translate_vlist(sys.argv[2], sys.argv[3], versions[sys.argv[4].lower()])
+        else:
+            usage()
+            sys.stderr.write('Invalid arguments.\n')
+            sys.exit(1)
+            return
+
 
 if __name__ == '__main__':
     sys.exit(main())
@@ -6,13 +6,17 @@
 #
 
 import os
+import struct
 import tempfile
 import unittest
 import pytest
 from xml.dom.minidom import parseString
 
 from VariableList import Schema, ParseError, InvalidNameError, InvalidRangeError
-from VariableList import read_csv
+from VariableList import read_csv, parse_literal, split_braces
+from VariableList import UEFIVariable, create_vlist_buffer, create_vlist_v2_buffer
+from VariableList import read_vlist_from_buffer, translate_vlist, vlist_to_binary
+from CommonUtility import get_xml_full_hash, read_xml_hash_sidecar
 
 
 class SchemaParseUnitTests(unittest.TestCase):
@@ -499,6 +503,102 @@ class SchemaParseUnitTests(unittest.TestCase):
         with pytest.raises(InvalidRangeError):
             Schema(dom)
 
+    def test_schema_hash(self):
+        tmp = tempfile.TemporaryDirectory()
+        path = os.path.join(tmp.name, 'schema.xml')
+        with open(path, 'w') as schema_file:
+            schema_file.write(self.schemaTemplate)
+
+        # The hash computed while parsing matches the one of the file
+        xml_hash = get_xml_full_hash(path)
+        self.assertEqual(Schema.parse(self.schemaTemplate).hash, xml_hash)
+        self.assertEqual(Schema.load(path).hash, xml_hash)
+        self.assertFalse(os.path.exists(path + '.hash'))
+
+        # And is recorded in the sidecar when requested
+        self.assertEqual(Schema.load(path, sidecar=True).hash, xml_hash)
+        self.assertEqual(read_xml_hash_sidecar(path), xml_hash)
+        self.assertEqual(Schema.load(path, sidecar=True).hash, xml_hash)
+        tmp.cleanup()
+
+    def test_binary_layout(self):
+        schema = Schema.parse(self.schemaTemplate)
+        guid = 'FE3ED49F-B173-41ED-9076-356661D46A42'
+
+        # Arrays of scalars are a single repeated code, arrays of structs repeat the struct layout
+        self.assertEqual(schema.get_format('s_array_t').struct_codes(), '5B')
+        self.assertEqual(schema.get_format('s_array_structs_t').struct_codes(), 'II' * 5)
+        self.assertEqual(schema.get_format('sample_t').struct_codes(), 'I' + '5BI' * 2)
+
+        knob = schema.get_knob(guid, 'COMPLEX_KNOB2')
+        binary = knob.format.object_to_binary(knob.default)
+        self.assertEqual(binary, bytes([2, 0, 0, 0, 1, 2, 3, 4, 5, 0, 0, 0, 0, 6, 7, 8, 9, 10, 1, 0, 0, 0]))
+        self.assertEqual(knob.format.size_in_bytes(), len(binary))
+        self.assertEqual(knob.format.binary_to_object(binary), knob.default)
+
+        buffer = bytearray(len(binary) + 2)
+        knob.format.pack_into(buffer, 2, knob.default)
+        self.assertEqual(bytes(buffer[2:]), binary)
+
+        # Arrays must have all of their elements
+        value = knob.default
+        value['children'][1]['data'] = [1, 2]
+        with pytest.raises(ParseError):
+            knob.format.object_to_binary(value)
+
+    def test_parse_literal(self):
+        node = parse_literal(' {1,2, 3,{A, {}}, x{4,5} } ')
+        self.assertEqual(node.offset, 1)
+        self.assertEqual(node.items[:3], ['1', '2', '3'])
+        self.assertEqual(node.items[4], 'x{4,5}')
+        self.assertEqual(node.items[3].text, '{A, {}}')
+        self.assertEqual(node.items[3].offset, 9)
+        self.assertEqual(node.items[3].items[0], 'A')
+        self.assertEqual(node.items[3].items[1].items, [''])
+        self.assertEqual(parse_literal(' 1 '), '1')
+        self.assertEqual(split_braces('{1,2, 3,{A, B}} '), ['1', '2', '3', '{A, B}'])
+        self.assertEqual(split_braces(' '), [])
+
+        # Syntax errors report where they were found
+        for literal, error in [('{1,2', "expected '}' at offset 4"),
+                               ('{1,{2}', "expected '}' at offset 6"),
+                               ('{1,2} x', "found 'x' at offset 6"),
+                               ('{{1} x,2}', "found 'x' at offset 5"),
+                               ('abc', "expected '{', found 'a'")]:
+            with self.assertRaisesRegex(ParseError, error):
+                split_braces(literal)
+
+    def test_nested_literal(self):
+        schema = Schema.parse(self.schemaTemplate)
+        knob = schema.get_knob('FE3ED49F-B173-41ED-9076-356661D46A42', 'COMPLEX_KNOB2')
+
+        self.assertEqual(knob.format.string_to_object(knob.format.object_to_string(knob.default)), knob.default)
+        value = knob.format.string_to_object('{ 3, {{{7}, SECOND}, {}} }')
+        self.assertEqual(value['counter'], 3)
+        self.assertEqual(value['children'][0]['data'], [7] * 5)
+        self.assertEqual(value['children'][1], knob.format.members[1].format.format.default)
+
+        with self.assertRaisesRegex(ParseError, 'should have 5 elements, but 2 were found at offset 7'):
+            knob.format.string_to_object('{ 3, {{{7, 8}, SECOND}, {}} }')
+        with self.assertRaisesRegex(ParseError, "expected '}' at offset 25"):
+            knob.format.string_to_object('{ 3, {{{7}, SECOND}, {}} ')
+
+    def test_vlist_to_binary(self):
+        schema = Schema.parse(self.schemaTemplate)
+        for knob in schema.knobs:
+            knob.value = knob.default
+
+        # The list is serialized in place with the same layout as the individual entries
+        binary = vlist_to_binary(schema)
+        self.assertEqual(binary, b''.join(
+            create_vlist_buffer(UEFIVariable(knob.name, knob.namespace, knob.format.object_to_binary(knob.value)))
+            for knob in schema.knobs))
+
+        variables = read_vlist_from_buffer(bytearray(binary))
+        self.assertEqual([variable.name for variable in variables], [knob.name for knob in schema.knobs])
+        for (variable, knob) in zip(variables, schema.knobs):
+            self.assertEqual(knob.format.binary_to_object(variable.data), knob.value)
+
     def test_sample_config(self):
         schema = Schema.parse(self.schemaTemplate)
 
@@ -686,5 +786,133 @@ class CsvProcessingUnitTests(unittest.TestCase):
             read_csv(schema, csv_path)
 
 
+class VariableListV2UnitTests(unittest.TestCase):
+    """Tests for the v2 variable list encoding."""
+
+    guid_a = "FE3ED49F-B173-41ED-9076-356661D46A42"
+    guid_b = "7664559F-829E-48E8-A473-F12ADAD1DDD2"
+
+    def _variables(self):
+        return [
+            UEFIVariable("COMPLEX_KNOB1a", self.guid_a, bytes([1, 2, 3, 4, 5, 0, 0, 0, 0])),
+            UEFIVariable("INTEGER_KNOB", self.guid_a, bytes([0x64, 0, 0, 0])),
+            UEFIVariable("INTEGER_KNOB", self.guid_b, bytes([0x65, 0, 0, 0]), 3),
+            UEFIVariable("BOOLEAN_KNOB", self.guid_a, bytes([1])),
+        ]
+
+    def _assert_same(self, expected, actual):
+        self.assertEqual(len(expected), len(actual))
+        for a, b in zip(expected, actual):
+            self.assertEqual(a.name, b.name)
+            self.assertEqual(a.guid, b.guid)
+            self.assertEqual(a.attributes, b.attributes)
+            self.assertEqual(a.data, b.data)
+
+    def test_v2_round_trip(self):
+        """Test that v2 buffers decode back to the same variables."""
+        variables = self._variables()
+        self._assert_same(variables, read_vlist_from_buffer(create_vlist_v2_buffer(variables)))
+
+    def test_v2_smaller_than_v1(self):
+        """Test that interning names and guids shrinks the blob."""
+        variables = self._variables()
+        v1 = b''.join(create_vlist_buffer(v) for v in variables)
+        v2 = create_vlist_v2_buffer(variables)
+        self.assertLess(len(v2), len(v1))
+
+    def test_v2_empty(self):
+        """Test that a v2 buffer with no entries is valid."""
+        self.assertEqual(read_vlist_from_buffer(create_vlist_v2_buffer([])), [])
+
+    def test_v2_corrupted_table(self):
+        """Test that corruption of the interned tables is detected."""
+        buf = bytearray(create_vlist_v2_buffer(self._variables()))
+        # First byte of the guid table
+        buf[20] ^= 0xFF
+        with pytest.raises(Exception, match="CRC mismatch"):
+            read_vlist_from_buffer(bytes(buf))
+
+    def test_v2_corrupted_entry(self):
+        """Test that corruption of an entry is detected."""
+        buf = bytearray(create_vlist_v2_buffer(self._variables()))
+        buf[-5] ^= 0xFF
+        with pytest.raises(Exception, match="CRC mismatch"):
+            read_vlist_from_buffer(bytes(buf))
+
+    def test_translate_v1_v2_v1(self):
+        """Test that translating v1 to v2 and back is lossless."""
+        variables = self._variables()
+        v1 = b''.join(create_vlist_buffer(v) for v in variables)
+        tmp = tempfile.TemporaryDirectory()
+        self.addCleanup(tmp.cleanup)
+        paths = [os.path.join(tmp.name, f) for f in ("in.vl", "v2.vl", "out.vl")]
+        with open(paths[0], 'wb') as f:
+            f.write(v1)
+
+        translate_vlist(paths[0], paths[1], 2)
+        translate_vlist(paths[1], paths[2], 1)
+
+        with open(paths[1], 'rb') as f:
+            self.assertEqual(f.read(4), b'CVL2')
+        with open(paths[2], 'rb') as f:
+            self.assertEqual(f.read(), v1)
+
+    def test_v2_aligned_round_trip(self):
+        """Test that aligned v2 buffers decode back to the same variables."""
+        variables = self._variables()
+        buf = create_vlist_v2_buffer(variables, aligned=True)
+        self.assertEqual(struct.unpack_from("<H", buf, 4)[0], 3)
+        self._assert_same(variables, read_vlist_from_buffer(buf))
+
+    def test_v2_aligned_data_offsets(self):
+        """Test that the data of every entry of an aligned v2 buffer is 8 byte aligned."""
+        variables = self._variables()
+        offsets = []
+        buf = create_vlist_v2_buffer(variables, aligned=True, data_offsets=offsets)
+        self.assertEqual(len(offsets), len(variables))
+        self.assertEqual(len(buf) % 8, 0)
+        for offset, variable in zip(offsets, variables):
+            self.assertEqual(offset % 8, 0)
+            self.assertEqual(buf[offset:offset + len(variable.data)], variable.data)
+
+        # The packed layout reports the offsets of its data too
+        offsets = []
+        buf = create_vlist_v2_buffer(variables, data_offsets=offsets)
+        for offset, variable in zip(offsets, variables):
+            self.assertEqual(buf[offset:offset + len(variable.data)], variable.data)
+
+    def test_v2_aligned_corrupted_entry(self):
+        """Test that corruption of an aligned entry is detected, but not of its padding."""
+        variables = self._variables()
+        offsets = []
+        buf = bytearray(create_vlist_v2_buffer(variables, aligned=True, data_offsets=offsets))
+        buf[offsets[0]] ^= 0xFF
+        with pytest.raises(Exception, match="CRC mismatch"):
+            read_vlist_from_buffer(bytes(buf))
+
+        # BOOLEAN_KNOB has a single byte of data, followed by 3 bytes of padding before its CRC32
+        buf[offsets[0]] ^= 0xFF
+        buf[offsets[3] + 1] ^= 0xFF
+        self._assert_same(variables, read_vlist_from_buffer(bytes(buf)))
+
+    def test_translate_v2_aligned(self):
+        """Test that translating v1 to aligned v2 and back is lossless."""
+        variables = self._variables()
+        v1 = b''.join(create_vlist_buffer(v) for v in variables)
+        tmp = tempfile.TemporaryDirectory()
+        self.addCleanup(tmp.cleanup)
+        paths = [os.path.join(tmp.name, f) for f in ("in.vl", "v2a.vl", "out.vl")]
+        with open(paths[0], 'wb') as f:
+            f.write(v1)
+
+        translate_vlist(paths[0], paths[1], 3)
+        translate_vlist(paths[1], paths[2], 1)
+
+        with open(paths[1], 'rb') as f:
+            self.assertEqual(f.read(6), b'CVL2\x03\x00')
+        with open(paths[2], 'rb') as f:
+            self.assertEqual(f.read(), v1)
+
+
 if __name__ == '__main__':
     unittest.main()
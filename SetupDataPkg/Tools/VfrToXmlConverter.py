@@ -14,6 +14,9 @@ import re
 import subprocess
 import time
 import uuid
+import hashlib
+import json
+import concurrent.futures
 import chardet
 import importlib.util
 import logging
@@ -27,6 +30,7 @@ from edk2toollib.uefi.edk2.path_utilities import Edk2Path
 from edk2toolext.environment import plugin_manager, shell_environment
 from edk2toolext.environment.multiple_workspace import MultipleWorkspace
 from edk2toolext.environment.plugintypes.uefi_helper_plugin import HelperFunctions
+import VfrTokenizer
 
 # Mute warning messages from Edk2Path logger
 Edk2Path_logger = logging.getLogger("Edk2Path")
@@ -69,6 +73,12 @@ class vfr_xml_config:
         # Default path setup for cl
         self.VsDevCmd_path = r'C:\BuildTools\Common7\Tools\VsDevCmd.bat'
 
+        # (Optional) Number of processes preprocessing vfr files concurrently, 1 to preprocess in this process
+        self.jobs = os.cpu_count() or 1
+
+        # (Optional) Directory caching preprocessed vfr files across runs, empty to disable the cache
+        self.cache_dir = ''
+
         # Misc
         self.input_ref_xml = ''
         self.input_cfg_xml_list = []
@@ -328,45 +338,7 @@ def normalize_name(name):
 # dump_file_name (Optional): If a dump file name is given, write the trimmed vfr content to the file
 # Return: Trimmed vfr content
 def vfr_remove_comments(vfr_content, dump_file_name=None):
-    # Remove line comments
-    vfr_content = re.sub(r'//.*', '', vfr_content)
-
-    # Remove /* */ blocks
-    # Define the pattern to match all /* */ block comments, even if there are multiple per line
-    block_comment_pattern = re.compile(r'/\*.*?\*/', re.DOTALL)
-    # Split lines to process one by one
-    lines = vfr_content.splitlines()
-    new_vfr_content = []
-    stack = []
-
-    for line in lines:
-        # Remove block comments within the line first
-        line = re.sub(block_comment_pattern, '', line)
-
-        # Handle unmatched /* and */ using a stack
-        while '/*' in line or '*/' in line:
-            start_idx = line.find('/*')
-            end_idx = line.find('*/')
-
-            # If only /* found and no */, push to stack and cut line after /*
-            if start_idx != -1 and (end_idx == -1 or start_idx < end_idx):
-                stack.append('/*')
-                line = line[:start_idx]
-            # If only */ found and there's a matching /* in stack, pop from stack and cut line before */
-            elif end_idx != -1 and (start_idx == -1 or end_idx < start_idx):
-                if stack:
-                    stack.pop()
-                line = line[end_idx + 2:]
-            else:
-                # No match to process further
-                break
-
-        # If stack is empty, keep the line; otherwise, skip it as it's inside a block comment
-        if not stack:
-            new_vfr_content.append(line)
-
-    # Reconstruct the processed vfr content
-    vfr_content = '\n'.join(new_vfr_content)
+    vfr_content = VfrTokenizer.remove_comments(vfr_content)
 
     # Write to a dump file if provided
     if dump_file_name:
@@ -548,7 +520,7 @@ def inf_get_info(inf_file_path, platform_builder):
 # vfr_content: Content of the VFR file to be processed
 # vfr_dir: Directory of the source vfr file
 # Return: VFR content with all includes processed
-def vfr_process_includes(vfr_content, vfr_dir):
+def vfr_process_includes(vfr_content, vfr_dir, dependency_list=None):
     # Regular expression pattern to match #include statements (vfr or hfr files only)
     include_pattern = re.compile(r'#include\s*[<"](.+?\.(vfr|hfr))[">]', re.IGNORECASE)
 
@@ -588,10 +560,12 @@ def vfr_process_includes(vfr_content, vfr_dir):
 
                     with open(include_file_path, 'r') as file:
                         include_content = file.read()
+                    if dependency_list is not None:
+                        dependency_list.append(include_file_path)
 
                     # Recursively process includes in the included file, using its directory as the new vfr_dir
                     include_dir = os.path.dirname(include_file_path)
-                    include_content = vfr_process_includes(include_content, include_dir)
+                    include_content = vfr_process_includes(include_content, include_dir, dependency_list)
                     break  # Stop once we find and load the include file
                 except Exception as e:
                     logger.warning(f'  [vfr] Error reading included file: {include_file_path}')
@@ -912,30 +886,18 @@ def run_preprocess(
 # vfr_content: Content read and processed from a vfr file
 # uni_str_dict: Dictionary containing {<string token>: <string content>} mappings from uni files
 # Return: A dictionary containing varstore information: {name: varstore}
-def vfr_collect_varstore(vfr_content, uni_str_dict):
+def vfr_collect_varstore(vfr_content, uni_str_dict, keywords=None):
     varstore_dict = {}
 
-    # Regular expression for varstore/efivarstore/namevaluevarstore blocks
-    varstore_pattern = re.compile(r'(?<!\w)varstore\s+(\w+).*?name\s*=\s*(\w+).*?;', re.DOTALL | re.IGNORECASE)
-    efivarstore_pattern = re.compile(r'(?<!\w)efivarstore\s+(\w+).*?name\s*=\s*(\w+).*?;', re.DOTALL | re.IGNORECASE)
-    namevalue_pattern = re.compile(r'(?<!\w)namevaluevarstore\s+(\w+)(.*?);', re.DOTALL | re.IGNORECASE)
+    varstore_list, namevalue_list = VfrTokenizer.collect_varstores(vfr_content, keywords)
 
-    # Process varstore blocks
-    varstore_matches = varstore_pattern.findall(vfr_content)
-    for varstore, name in varstore_matches:
-        varstore_dict[name] = varstore
-
-    # Process efivarstore blocks
-    efivarstore_matches = efivarstore_pattern.findall(vfr_content)
-    for varstore, name in efivarstore_matches:
+    # Process varstore and efivarstore blocks
+    for name, varstore in varstore_list:
         varstore_dict[name] = varstore
 
     # Process namevaluevarstore blocks
-    namevalue_matches = namevalue_pattern.findall(vfr_content)
-    for varstore, token_content in namevalue_matches:
+    for varstore, name_values in namevalue_list:
         # Collect all STRING_TOKENs and their values from uni_str_dict
-        string_token_pattern = re.compile(r'STRING_TOKEN\s*\(\s*([^)]+)\s*\)')
-        name_values = string_token_pattern.findall(token_content)
         for idx, token in enumerate(name_values):
             if token in uni_str_dict:
                 varstore_dict[f'{varstore}[{idx}]'] = uni_str_dict[token]
@@ -950,57 +912,45 @@ def vfr_collect_varstore(vfr_content, uni_str_dict):
     return varstore_dict
 
 
-# Function to judge the condition string based on current structs values
-# condition: The condition string to be judged
+# Build a function returning the current value of a varstore member from structs, for evaluating conditions
+# Members of a struct are indexed on first use, structs is not expected to change while the function is used
 # structs: The current structs dictionary with values
-# Return: Boolean result of the condition
-def vfr_condition_judge(condition, structs):
-    # Remove line breaks and extra spaces to normalize the condition string
-    condition = ' '.join(condition.split())
-
-    # Pattern to match condition parts like "NOT ideqval CBS_CONFIG.CbsDbgCpuSnpMemCover == 2"
-    condition_pattern = re.compile(r'(NOT\s+)?ideqval\s+(\w+)\.(\w+)\s*==\s*(\w+)', re.IGNORECASE)
+# Return: Function taking (varstore name, member name), returning the default value of the member or None
+def vfr_condition_value_getter(structs):
+    member_defaults = {}  # {struct_name: {member_name: default value}}
 
-    # Replace logical operators for Python evaluation
-    condition = condition.replace('AND', 'and').replace('OR', 'or')
-
-    # Function to evaluate each condition part
-    def evaluate_condition(match):
-        neg, struct_name, member_name, value = match.groups()
+    def get_value(struct_name, member_name):
         struct_name = struct_name + '_STRUCT'  # struct_name in XML got patched with _STRUCT
+        defaults = member_defaults.get(struct_name)
+        if defaults is None:
+            defaults = {}
+            struct = structs.get(struct_name)
+            if struct is not None:
+                for member in struct.findall('Member'):
+                    defaults.setdefault(member.get('name'), member.get('default'))
+            member_defaults[struct_name] = defaults
+        return defaults.get(member_name)
 
-        # Get the current value from structs
-        struct = structs.get(struct_name)
-        current_value = None
-        if struct is not None:
-            member = struct.find(f"./Member[@name='{member_name}']")
-            if member is not None:
-                current_value = member.get('default')
-
-        # If current_value is None or an empty string, treat as False
-        if not current_value:
-            return False
-
-        # Compare the current value to the target value
-        is_equal = str(current_value) == value
-
-        # Reverse the result if 'NOT' is present
-        if neg and neg.strip().upper() == 'NOT':
-            is_equal = not is_equal
+    return get_value
 
-        return is_equal
 
-    # Evaluate all conditions and substitute their results in the condition string
-    result_str = condition_pattern.sub(lambda match: str(evaluate_condition(match)), condition)
+# Function to judge the condition string based on current structs values
+# condition: The condition string to be judged
+# structs: The current structs dictionary with values
+# get_value (Optional): Function from vfr_condition_value_getter(structs), to share its index between conditions
+# Return: Boolean result of the condition, False if the condition is not supported
+def vfr_condition_judge(condition, structs, get_value=None):
+    if get_value is None:
+        get_value = vfr_condition_value_getter(structs)
     logger.debug('condition: %s' % condition)
-    logger.debug('result_str: %s' % result_str)
 
-    # Evaluate the combined condition string
+    # Parse the condition, e.g. "NOT ideqval CBS_CONFIG.CbsDbgCpuSnpMemCover == 2 OR ideqval ...", and evaluate it
     try:
-        result = eval(result_str)
-    except Exception as e:
+        result = VfrTokenizer.evaluate_condition(VfrTokenizer.parse_condition(condition), get_value)
+    except VfrTokenizer.ConditionError as e:
         logger.debug(f'Error evaluating condition: {condition}. Error: {e}')
         result = False
+    logger.debug('result: %s\n' % result)
 
     return result
 
@@ -1011,56 +961,12 @@ def vfr_condition_judge(condition, structs):
 # dump_file_name (Optional): If a dump file name is given, write the processed vfr content to the file
 # Return: Processed vfr content
 def vfr_process_statements(vfr_content, structs, dump_file_name=None):
-    # Find all condition blocks
-    statements = re.findall(
-        r'((?<!\w)suppressif\b|(?<!\w)grayoutif\b|(?<!\w)disableif\b)\s+([\s\S]*?);',
-        vfr_content,
-        re.IGNORECASE
-    )
-
-    for statement in statements:
-        condition_type = statement[0].lower()  # Convert to lowercase for consistency
-        condition = statement[1].strip()  # Remove extra spaces and newline for condition processing
-
-        # Evaluate the condition
-        logger.debug(f'Found {condition_type} condition: {condition}')
-        result = vfr_condition_judge(condition, structs)
-        logger.debug(f'result: {result}\n')
-
-        if result:
-            # Locate the statement in vfr_content
-            statement_match = re.search(
-                rf'{re.escape(statement[0])}\s+{re.escape(statement[1])};',
-                vfr_content,
-                re.IGNORECASE
-            )
+    get_value = vfr_condition_value_getter(structs)
 
-            # Replace the suppressif/grayoutif/disableif block with /*
-            vfr_content_pre = vfr_content[:statement_match.start()] + '/*'
-            vfr_content_post = vfr_content[statement_match.end():]
-
-            # Search forward to pair the corresponding endif, and replace with */
-            sgd_matches = re.finditer(
-                r'((?<!\w)suppressif\b)|((?<!\w)grayoutif\b)|((?<!\w)disableif\b)|((?<!\w)endif;)',
-                vfr_content_post,
-                re.IGNORECASE
-            )
-            stack = []  # Initialize a stack to keep track of opened conditions
-            for match in sgd_matches:
-                logger.debug(match)
-                logger.debug(f'  match.group(): {match.group()}')
-                logger.debug(f'  stack before: {stack}')
-                token = match.group().lower()
-                if token in ['suppressif', 'grayoutif', 'disableif']:
-                    stack.append(token)
-                elif token == 'endif;':
-                    if stack:
-                        stack.pop()
-                    else:
-                        vfr_content_post = vfr_content_post[:match.start()] + '*/' + vfr_content_post[match.end():]
-                        break
-
-            vfr_content = vfr_content_pre + vfr_content_post
+    # Remove the statements whose condition holds, up to their matching endif
+    spans = VfrTokenizer.find_conditional_spans(
+        vfr_content, lambda condition: vfr_condition_judge(condition, structs, get_value))
+    vfr_content = VfrTokenizer.remove_spans(vfr_content, spans)
 
     vfr_content = vfr_remove_comments(vfr_content, dump_file_name)
     return vfr_content
@@ -1185,7 +1091,9 @@ def get_defines_list_and_add_arg(vfrpp_resp, tool_config):
     defines_list = []  # Do nothing for now
     add_arg = ''  # Do nothing for now
     base_name, ext = os.path.splitext(os.path.basename(vfrpp_resp))
-    modified_resp = os.path.join(tool_config.srcdir, base_name + '_mod.txt')
+    # resp files of different modules share the same base name, while their vfr files may be preprocessed concurrently
+    resp_digest = hashlib.sha256(os.path.abspath(vfrpp_resp).encode('utf-8', 'surrogateescape')).hexdigest()[:8]
+    modified_resp = os.path.join(tool_config.srcdir, f'{base_name}_{resp_digest}_mod.txt')
 
     logger.info('\nApplying resp file: %s -> %s' % (vfrpp_resp, modified_resp))
     tool_config.add_to_clean_up_list(modified_resp)
@@ -1204,7 +1112,12 @@ def get_defines_list_and_add_arg(vfrpp_resp, tool_config):
     modified_content = re.sub(fi_pattern, '', content)
     modified_content = re.sub(inc_pattern, '', modified_content)
 
-    # Write the modified content to the output file
+    # Write the modified content to the output file, unless a previous module already did while its vfr files may
+    # still be read by the preprocessor
+    if os.path.isfile(modified_resp):
+        with open(modified_resp, 'r') as file:
+            if file.read() == modified_content:
+                return defines_list, add_arg, modified_resp
     with open(modified_resp, 'w') as file:
         file.write(modified_content)
 
@@ -1505,8 +1418,8 @@ def print_dict(dict_to_print, dict_name='dict', indent=0, log_method=print):
         log_method(msg)
 
 
-# Debug function to print a tuple of blocks
-# blocks: A list of tuples ('oneof|numeric|checkbox', 'block_content')
+# Debug function to print a list of blocks
+# blocks: A list of VfrTokenizer.VfrQuestion
 # newlines: Number of newlines between each block
 # log_method: Logging method
 def print_blocks(blocks, newlines=1, log_method=print):
@@ -1544,13 +1457,23 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
     if tool_config is None:
         tool_config = vfr_xml_config()
 
+    # Find the keywords once, the varstores and the blocks are parsed from the same keywords
+    keywords = VfrTokenizer.lex(vfr_content)
+
     # Prepare a dictionary for varstore
-    varstore_dict = vfr_collect_varstore(vfr_content, uni_str_dict)
+    varstore_dict = vfr_collect_varstore(vfr_content, uni_str_dict, keywords)
 
     # Get the enum and structs elements
     enums_element = root.find('Enums')
     structs_element = root.find('Structs')
 
+    # Index members and enums by name, first one wins like Element.find
+    member_index = {}  # {struct_name: {member_name: Member element}}
+    enum_index = {}
+    for enum in enums_element.findall('Enum'):
+        enum_index.setdefault(enum.get('name'), enum)
+    repeated_item_set = set(repeated_items)
+
     logger.info('\n  Start parsing...')
     # Initialize variables and data structures
     current_member = None
@@ -1560,25 +1483,15 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
     default_set = False
     special_str = '-1FAULT-1'
 
-    # Regular expression for oneof/numeric/checkbox blocks
-    all_blocks = re.findall(
-        r'((?<!\w)oneof)\s+(.*?)endoneof;|((?<!\w)numeric)\s+(.*?)endnumeric;|((?<!\w)checkbox)\s+(.*?)endcheckbox;',
-        vfr_content,
-        re.DOTALL | re.IGNORECASE
-    )
-    print_blocks(all_blocks, log_method=logger.debug)  # Debug print
+    # oneof/numeric/checkbox blocks
+    all_blocks = VfrTokenizer.parse_questions(vfr_content, keywords)
+    if logger.isEnabledFor(logging.DEBUG):
+        print_blocks(all_blocks, log_method=logger.debug)  # Debug print
 
     # Iterate over each block
     for block in all_blocks:
-        if block[0] == 'oneof':
-            block_type = block[0]     # oneof
-            block_content = block[1]  # varid = ...,
-        elif block[2] == 'numeric':
-            block_type = block[2]     # numeric
-            block_content = block[3]  # varid = ...,
-        elif block[4] == 'checkbox':
-            block_type = block[4]     # checkbox
-            block_content = block[5]  # varid = ...,
+        block_type = block.type
+        existing_member = None
 
         # Start parsing 'oneof' block
         if block_type == 'oneof':
@@ -1614,10 +1527,9 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
             })
 
         if current_member is not None:
-            # Get varid in the block_content
-            matches = re.findall(r'(?<!\w)varid\s*=\s*([^,]+)', block_content, re.DOTALL | re.IGNORECASE)
-            if matches:
-                varid = matches[0]  # If there are more than one varid, just take the first one
+            # Get varid of the block
+            varid = block.values.get('varid')
+            if varid is not None:
                 varid_split = varid.split('.')
                 struct_name = varid_split[0]
                 if len(varid_split) > 1:
@@ -1640,25 +1552,25 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
                     current_struct = structs[struct_name]
 
                 # Update or create the member
-                existing_member = current_struct.find(f"./Member[@name='{member_name}']")
+                if struct_name not in member_index:
+                    member_index[struct_name] = {}
+                    for member in current_struct.findall('Member'):
+                        member_index[struct_name].setdefault(member.get('name'), member)
+                existing_member = member_index[struct_name].get(member_name)
                 if existing_member is not None:
                     current_member = existing_member
                     if parse_mode == 0:
                         # New parse mode: Add to repeated_items list if not already present
-                        if (struct_name, member_name) not in repeated_items:
+                        if (struct_name, member_name) not in repeated_item_set:
                             repeated_items.append((struct_name, member_name))
+                            repeated_item_set.add((struct_name, member_name))
                             logger.info(f'  [vfr] Info: Duplicate Member found in Struct: {struct_name}.{member_name}')
                 else:
                     current_member.set('name', member_name)
 
-            # Get prompt in the block_content
-            matches = re.findall(
-                r'(?<!\w)prompt\s*=\s*STRING_TOKEN\s*\(\s*([^)]+?)\s*\)',
-                block_content,
-                re.DOTALL | re.IGNORECASE
-            )
-            if matches:
-                prompt_token = matches[0]  # If there are more than one prompt, just take the first one
+            # Get prompt of the block
+            prompt_token = block.strings.get('prompt')
+            if prompt_token is not None:
                 current_prettyname = uni_str_dict.get(prompt_token, '')
                 if current_prettyname is None:
                     logger.warning(
@@ -1667,14 +1579,9 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
                         f'Token={prompt_token}, '
                     )
 
-            # Get help in the block_content
-            matches = re.findall(
-                r'(?<!\w)help\s*=\s*STRING_TOKEN\s*\(\s*([^)]+?)\s*\)',
-                block_content,
-                re.DOTALL | re.IGNORECASE
-            )
-            if matches:
-                help_token = matches[0]  # If there are more than one help, just take the first one
+            # Get help of the block
+            help_token = block.strings.get('help')
+            if help_token is not None:
                 current_help = uni_str_dict.get(help_token, '')
                 if current_help is None:
                     logger.warning(
@@ -1685,63 +1592,37 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
             # Parse numeric-specific attributes
             if block_type == 'numeric':
                 # minimum
-                matches = re.findall(r'(?<!\w)minimum\s*=\s*([^,]+)', block_content, re.DOTALL | re.IGNORECASE)
-                if matches:
-                    minimum_value = matches[0].strip()
-                    # If there are more than one minimum, just take the first one
-                    current_member.set('min', minimum_value)
+                if 'minimum' in block.values:
+                    current_member.set('min', block.values['minimum'].strip())
 
                 # maximum
-                matches = re.findall(r'(?<!\w)maximum\s*=\s*([^,]+)', block_content, re.DOTALL | re.IGNORECASE)
-                if matches:
-                    maximum_value = matches[0].strip()
-                    current_member.set('max', maximum_value)
+                if 'maximum' in block.values:
+                    current_member.set('max', block.values['maximum'].strip())
 
             # Parse default value
-            matches = re.findall(r'(?<!\w)default\s*=\s*([^,]+)', block_content, re.DOTALL | re.IGNORECASE)
-            if matches:
-                default_value = matches[0].strip()
-                current_member.set('default', default_value)
+            if 'default' in block.values:
+                current_member.set('default', block.values['default'].strip())
                 default_set = True
 
             if block_type == 'oneof':  # Parse oneof options with default flag handling
                 # Create a new Enum element for each oneof
                 enum_help = xml_get_enum_help(struct_name, member_name)
                 enum_name = enum_help.upper()
-                existing_enum = enums_element.find(f'./Enum[@name="{enum_name}"]')
+                existing_enum = enum_index.get(enum_name)
                 if existing_enum is not None:
                     current_enum = existing_enum
                 else:
                     current_enum = ET.Element('Enum', attrib={'name': enum_name, 'help': enum_help})
 
                 # Parse each option
-                matches = re.findall(r'(?<!\w)option\s+(.*?);', block_content, re.DOTALL | re.IGNORECASE)
-                for option in matches:
+                for option in block.options:
                     # option text = STRING_TOKEN(text_token), value = {value}, flags = {flags};
-                    text_matches = re.findall(
-                        r'(?<!\w)text\s*=\s*STRING_TOKEN\s*\(\s*([^)]+?)\s*\)',
-                        option,
-                        re.DOTALL | re.IGNORECASE
-                    )
-                    text_token = ''
-                    if text_matches:
-                        text_token = text_matches[0].strip()
-
-                    value_matches = re.findall(r'(?<!\w)value\s*=\s*([^,]+)', option, re.DOTALL | re.IGNORECASE)
-                    option_value = ''
-                    if value_matches:
-                        option_value = value_matches[0].strip()
-
-                    flags_matches = re.findall(r'(?<!\w)flags\s*=\s*([\w\s|]+)', option, re.DOTALL | re.IGNORECASE)
-                    flags = []
-                    for match in flags_matches:
-                        for flag in match.split('|'):
-                            flag = flag.strip()
-                            if flag:
-                                flags.append(flag)
+                    text_token = option.text if option.text is not None else ''
+                    option_value = option.value if option.value is not None else ''
+                    flags = option.flags
 
                     # Append Value to the Enum
-                    if text_matches and value_matches:
+                    if option.text is not None and option.value is not None:
                         enum_value_name = uni_str_dict.get(text_token, '')
                         existing_value = current_enum.find(f'./Value[@name="{enum_value_name}"]')
                         if existing_value is None:
@@ -1749,7 +1630,7 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
 
                     # Check if 'DEFAULT' flag is specifically set and not just any mention of 'DEFAULT'
                     if 'DEFAULT' in flags and not default_set:
-                        if (struct_name, member_name) in repeated_items:
+                        if (struct_name, member_name) in repeated_item_set:
                             if (parse_mode == 0) and (option_value != current_member.get('default')):
                                 # For repeated_items, only assign the value when the default value is all the same,
                                 # otherwise takes ''
@@ -1765,8 +1646,9 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
                             default_set = True
 
                 # Claim and append the new Enum element
-                if (len(current_enum) > 0) and (current_enum not in enums_element):
+                if (len(current_enum) > 0) and (existing_enum is None):
                     enums_element.append(current_enum)
+                    enum_index[enum_name] = current_enum
 
             # Debug patch for numeric items, use this only for generating test data
             # Sometimes we have default="", but 0 is not in the range of (min, max),
@@ -1787,8 +1669,9 @@ def parse_vfr_content(vfr_content, uni_str_dict, root, structs, repeated_items,
                 current_member.set('default', '')
 
             # Claim and append new member to the struct, and then clean up for the next parsing
-            if current_member not in current_struct:
+            if existing_member is None:
                 current_struct.append(current_member)
+                member_index[struct_name].setdefault(current_member.get('name'), current_member)
             current_member = None
             current_prettyname = ''
             current_help = ''
@@ -2472,6 +2355,187 @@ def xml_alphabetical_sorted(xml_root):
                 xml_root.insert(index, knobs_root)
 
 
+# Dependency graph of the vfr files and uni files converted in a previous run, persisted in the cache directory
+# Each node records the files its result was derived from with their content hashes, together with the inputs it was
+# derived with, so the result is reused for as long as none of them changed
+class vfr_dependency_graph:
+    def __init__(self, cache_dir):
+        self.file_path = os.path.join(cache_dir, 'dependencies.json')
+        self.file_hash_dict = {}  # {File path: Content hash}, computed once per run
+        self.nodes = {'vfr': {}, 'uni': {}}
+        self.hit_count = 0
+        self.miss_count = 0
+        if os.path.isfile(self.file_path):
+            try:
+                with open(self.file_path, 'r') as f:
+                    graph = json.load(f)
+                if graph.get('version') == this_version:
+                    self.nodes = graph['nodes']
+            except (OSError, ValueError, KeyError) as e:
+                logger.warning(f'  [cache] Ignoring dependency graph {self.file_path}: {e}')
+
+    # Return: Content hash of the file, None if it does not exist
+    def hash_file(self, file_path):
+        if file_path not in self.file_hash_dict:
+            file_hash = None
+            if os.path.isfile(file_path):
+                with open(file_path, 'rb') as f:
+                    file_hash = hashlib.sha256(f.read()).hexdigest()
+            self.file_hash_dict[file_path] = file_hash
+        return self.file_hash_dict[file_path]
+
+    # Return: Hash of the inputs a node is derived with, in addition to its files
+    @staticmethod
+    def hash_inputs(*inputs):
+        return hashlib.sha256(json.dumps(inputs, sort_keys=True).encode('utf-8', 'surrogateescape')).hexdigest()
+
+    # Return: Result of the node, None if the node is unknown or any of its inputs or files changed
+    def get(self, kind, key, inputs_hash):
+        node = self.nodes[kind].get(key)
+        if (node is None or node['inputs'] != inputs_hash
+                or any(self.hash_file(file_path) != file_hash for file_path, file_hash in node['files'].items())):
+            self.miss_count += 1
+            return None
+        self.hit_count += 1
+        return node['result']
+
+    def set(self, kind, key, inputs_hash, file_list, result):
+        self.nodes[kind][key] = {
+            'inputs': inputs_hash,
+            'files': {file_path: self.hash_file(file_path) for file_path in file_list},
+            'result': result,
+        }
+
+    def save(self):
+        # Write and rename, so a concurrent run never reads a partial graph
+        temp_file_path = f'{self.file_path}.{os.getpid()}.tmp'
+        with open(temp_file_path, 'w') as f:
+            json.dump({'version': this_version, 'nodes': self.nodes}, f)
+        os.replace(temp_file_path, self.file_path)
+        logger.info(f'  [cache] {self.hit_count} of {self.hit_count + self.miss_count} dependency nodes up to date')
+
+
+# Resolve the comments, included vfr and hfr files, header files and PCDs of a vfr file, see parse_inf_to_xml
+# vfr_file_name: vfr file to be resolved
+# search_path_list: A list of include paths from the inf file
+# FixedPcd_dict: PCD value dictionary {PCD Name: PCD Value}
+# Return:
+#   vfr_content: Resolved vfr content, also dumped to the returned dump file
+#   header_file_list: A list of header files
+#   include_path_list: A list of include paths which are actually used by vfr_content
+#   dump_vfr_file_name: Dump file holding the resolved vfr content
+#   dependency_list: A list of files the resolved vfr content is derived from
+def vfr_resolve_sources(vfr_file_name, search_path_list, FixedPcd_dict, tool_config):
+    dependency_list = [vfr_file_name]
+
+    with open(vfr_file_name, 'r') as file:
+        vfr_content = file.read()
+
+    # Get the directory of the VFR file
+    vfr_dir = os.path.dirname(vfr_file_name)
+    if not vfr_dir:
+        vfr_dir = tool_config.srcdir
+
+    # Remove comments
+    dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_01_no_comments.vfr'
+    tool_config.add_to_clean_up_list(dump_vfr_file_name)
+    vfr_content = vfr_remove_comments(vfr_content, dump_file_name=dump_vfr_file_name)
+
+    # Process the including vfr and hfr files
+    dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_02_includes.vfr'
+    tool_config.add_to_clean_up_list(dump_vfr_file_name)
+    vfr_content = vfr_process_includes(vfr_content, vfr_dir, dependency_list)
+    vfr_content = vfr_remove_comments(vfr_content, dump_file_name=dump_vfr_file_name)
+
+    # Get a list of header files to be processed
+    dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_03_headers.vfr'
+    tool_config.add_to_clean_up_list(dump_vfr_file_name)
+    header_file_list, include_path_list, vfr_content = get_header_file_list(
+        vfr_content,
+        vfr_dir,
+        search_path_list,
+        dump_file_name=dump_vfr_file_name
+    )
+    dependency_list.extend(header_file_list)
+
+    # Process PCDs
+    if len(FixedPcd_dict) > 0:
+        dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_04_pcds.vfr'
+        tool_config.add_to_clean_up_list(dump_vfr_file_name)
+        vfr_content = vfr_process_pcds(
+            vfr_content, FixedPcd_dict, dump_file_name=dump_vfr_file_name
+        )
+
+    return vfr_content, header_file_list, include_path_list, dump_vfr_file_name, dependency_list
+
+
+# Compute the key of a preprocessed vfr file in the preprocess cache
+# The preprocessed content only depends on the vfr content, the header files it includes, the PCD values and the
+# preprocessor arguments, so all of them are hashed
+# Return: Hex digest of the key
+def vfr_preprocess_cache_key(vfr_content, header_file_list, search_path_list, defines_list, add_arg, resp_file,
+                             FixedPcd_dict, tool_config):
+    hasher = hashlib.sha256()
+
+    def update(tag, value):
+        hasher.update(f'{tag}={value}\n'.encode('utf-8', 'surrogateescape'))
+
+    update('version', this_version)
+    update('preprocessor', tool_config.preprocessor)
+    update('vfr', vfr_content)
+    for header_file_name in sorted(header_file_list):
+        with open(header_file_name, 'rb') as f:
+            update('header', f'{header_file_name}:{hashlib.sha256(f.read()).hexdigest()}')
+    for search_path in search_path_list:
+        update('search_path', search_path)
+    for define in defines_list:
+        update('define', define)
+    update('add_arg', add_arg)
+    if resp_file and os.path.isfile(resp_file):
+        with open(resp_file, 'rb') as f:
+            update('resp', hashlib.sha256(f.read()).hexdigest())
+    for pcd_name in sorted(FixedPcd_dict):
+        update('pcd', f'{pcd_name}:{FixedPcd_dict[pcd_name]}')
+
+    return hasher.hexdigest()
+
+
+# Preprocess a vfr file whose includes and header files are already resolved, see parse_inf_to_xml
+# This may run in a worker process, so it only takes picklable arguments and returns the processed content
+# vfr_file_name: Original vfr file name, used to name the dump files
+# input_vfr_file_name: Dump file holding the vfr content with includes and header files resolved
+# cache_file_name (Optional): If given, also store the processed vfr content in the preprocess cache
+# Return: Processed vfr content, also dumped to the _processed_06_trimmed.vfr file
+def vfr_preprocess_job(vfr_file_name, input_vfr_file_name, search_path_list, defines_list, add_arg, resp_file,
+                       FixedPcd_dict, cache_file_name, tool_config):
+    # Worker processes start with the default logger level
+    tool_config.set_verbosity(tool_config.verbosity)
+
+    # Process header files for includes and defines
+    dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_05_macros.vfr'
+    vfr_content = run_preprocess(
+        input_vfr_file_name, search_path_list, defines_list,
+        add_arg, resp_file,
+        vfr_mode=1, dump_file_name=dump_vfr_file_name, tool_config=tool_config
+    )
+
+    # Process PCDs again since preprocess may bring additional macros with FixedPcdGet wording,
+    # and then remove redundant newlines
+    dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_06_trimmed.vfr'
+    if len(FixedPcd_dict) > 0:
+        vfr_content = vfr_process_pcds(vfr_content, FixedPcd_dict, dump_file_name=None)
+    vfr_content = vfr_remove_redundant_newlines(vfr_content, dump_file_name=dump_vfr_file_name)
+
+    if cache_file_name:
+        # Write and rename, so a concurrent run never reads a partial cache entry
+        temp_cache_file_name = f'{cache_file_name}.{os.getpid()}.tmp'
+        with open(temp_cache_file_name, 'w') as f:
+            f.write(vfr_content)
+        os.replace(temp_cache_file_name, cache_file_name)
+
+    return vfr_content
+
+
 # Parse a list of vfr files according to the given input inf files, and generate a xml file with the option structures
 # tool_config:
 #   input_inf_dict: Dictionary that stores the input inf files:
@@ -2534,6 +2598,17 @@ def parse_inf_to_xml(tool_config):
                 tool_config.path_ready = True
                 break
 
+    # Preprocess vfr files concurrently, results are collected in input order
+    preprocess_jobs = []  # [(Processed vfr file, Corresponding uni_str_dict, Future of the processed vfr content)]
+    pending_vfr_dict = {}  # {vfr file: Future of its latest preprocessing}
+    executor = None
+    if tool_config.jobs > 1:
+        executor = concurrent.futures.ProcessPoolExecutor(max_workers=tool_config.jobs)
+    dependency_graph = None
+    if tool_config.cache_dir:
+        os.makedirs(tool_config.cache_dir, exist_ok=True)
+        dependency_graph = vfr_dependency_graph(tool_config.cache_dir)
+
     # Parse INF file
     for inf_file_name, vfrpp_resp in tool_config.input_inf_dict.items():
         vfr_file_list = []
@@ -2566,100 +2641,118 @@ def parse_inf_to_xml(tool_config):
                 defines_list, add_arg, modified_resp = get_defines_list_and_add_arg(vfrpp_resp, tool_config)
 
             # Prepare a dictionary for string token
-            uni_str_dict = load_string_from_uni(uni_file_list, language='en-US')
+            uni_str_dict = None
+            if dependency_graph is not None:
+                uni_key = '|'.join(uni_file_list)
+                uni_inputs_hash = dependency_graph.hash_inputs('en-US')
+                uni_str_dict = dependency_graph.get('uni', uni_key, uni_inputs_hash)
+            if uni_str_dict is None:
+                uni_str_dict = load_string_from_uni(uni_file_list, language='en-US')
+                if dependency_graph is not None:
+                    dependency_graph.set('uni', uni_key, uni_inputs_hash, uni_file_list, uni_str_dict)
 
             # Iterate over each vfr file found in inf
             for vfr_file_name in vfr_file_list:
                 if os.path.isfile(vfr_file_name):
-                    with open(vfr_file_name, 'r') as file:
-                        include_path_list = []
-                        header_file_list = []
-                        # Get the directory of the VFR file
-                        vfr_dir = os.path.dirname(vfr_file_name)
-                        if not vfr_dir:
-                            vfr_dir = tool_config.srcdir
-
-                        # Parse VFR file
-                        logger.info('\nParsing file: %s' % vfr_file_name)
-                        vfr_content = file.read()
-                        vfr_found = True
-
-                        # Remove comments
-                        dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_01_no_comments.vfr'
-                        tool_config.add_to_clean_up_list(dump_vfr_file_name)
-                        vfr_content = vfr_remove_comments(vfr_content, dump_file_name=dump_vfr_file_name)
-
-                        # Process the including vfr and hfr files
-                        dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_02_includes.vfr'
-                        tool_config.add_to_clean_up_list(dump_vfr_file_name)
-                        vfr_content = vfr_process_includes(vfr_content, vfr_dir)
-                        vfr_content = vfr_remove_comments(vfr_content, dump_file_name=dump_vfr_file_name)
-
-                        # Get a list of header files to be processed
-                        dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_03_headers.vfr'
+                    # The same vfr file shares its dump files, let its previous preprocessing finish first
+                    if vfr_file_name in pending_vfr_dict:
+                        pending_vfr_dict[vfr_file_name].result()
+
+                    # Parse VFR file
+                    logger.info('\nParsing file: %s' % vfr_file_name)
+                    vfr_found = True
+
+                    # Resolve includes, header files and PCDs, unless none of the files they came from changed
+                    resolved = None
+                    if dependency_graph is not None:
+                        vfr_inputs_hash = dependency_graph.hash_inputs(search_path_list, FixedPcd_dict)
+                        resolved = dependency_graph.get('vfr', vfr_file_name, vfr_inputs_hash)
+                    if resolved is not None:
+                        vfr_content, header_file_list, include_path_list, dump_vfr_file_name = resolved
                         tool_config.add_to_clean_up_list(dump_vfr_file_name)
-                        header_file_list, include_path_list, vfr_content = get_header_file_list(
-                            vfr_content,
-                            vfr_dir,
-                            search_path_list,
-                            dump_file_name=dump_vfr_file_name
-                        )
-
-                        # Add header files to the master list
-                        for header_file_name in header_file_list:
-                            if header_file_name not in header_master_list:
-                                header_master_list.append(header_file_name)
-
-                        # Append all possible search paths
-                        for include_path in include_path_list:
-                            if include_path not in search_path_list:
-                                search_path_list.append(include_path)
-
-                        # Process PCDs
-                        if len(FixedPcd_dict) > 0:
-                            dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_04_pcds.vfr'
-                            tool_config.add_to_clean_up_list(dump_vfr_file_name)
-                            vfr_content = vfr_process_pcds(
-                                vfr_content, FixedPcd_dict, dump_file_name=dump_vfr_file_name
+                        with open(dump_vfr_file_name, 'w') as f:
+                            f.write(vfr_content)
+                    else:
+                        (vfr_content, header_file_list, include_path_list, dump_vfr_file_name,
+                         dependency_list) = vfr_resolve_sources(
+                            vfr_file_name, search_path_list, FixedPcd_dict, tool_config)
+                        if dependency_graph is not None:
+                            dependency_graph.set(
+                                'vfr', vfr_file_name, vfr_inputs_hash, dependency_list,
+                                [vfr_content, header_file_list, include_path_list, dump_vfr_file_name]
                             )
 
-                        # Process header files for includes and defines
-                        input_vfr_file_name = dump_vfr_file_name
-                        dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_05_macros.vfr'
-                        tool_config.add_to_clean_up_list(dump_vfr_file_name)
-                        vfr_content = run_preprocess(
-                            input_vfr_file_name, search_path_list, defines_list,
-                            add_arg, modified_resp,
-                            vfr_mode=1, dump_file_name=dump_vfr_file_name, tool_config=tool_config
-                        )
-
-                        # Process PCDs again since preprocess may bring additional macros with FixedPcdGet wording,
-                        # and then remove redundant newlines
-                        dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_06_trimmed.vfr'
-                        tool_config.add_to_clean_up_list(dump_vfr_file_name)
-                        if len(FixedPcd_dict) > 0:
-                            vfr_content = vfr_process_pcds(vfr_content, FixedPcd_dict, dump_file_name=None)
-                        vfr_content = vfr_remove_redundant_newlines(vfr_content, dump_file_name=dump_vfr_file_name)
-                        processed_vfr_dict[dump_vfr_file_name] = uni_str_dict
-
-                        # Parse VFR content
-                        parse_vfr_content(
-                            vfr_content, uni_str_dict, root, structs, repeated_items, parse_mode=0,
-                            tool_config=tool_config
-                        )
-
+                    # Add header files to the master list
+                    for header_file_name in header_file_list:
+                        if header_file_name not in header_master_list:
+                            header_master_list.append(header_file_name)
+
+                    # Append all possible search paths
+                    for include_path in include_path_list:
+                        if include_path not in search_path_list:
+                            search_path_list.append(include_path)
+
+                    # Preprocess macros and PCDs, which is the slow part, concurrently with the next vfr files
+                    input_vfr_file_name = dump_vfr_file_name
+                    tool_config.add_to_clean_up_list(
+                        os.path.splitext(vfr_file_name)[0] + '_processed_05_macros.vfr')
+                    dump_vfr_file_name = os.path.splitext(vfr_file_name)[0] + '_processed_06_trimmed.vfr'
+                    tool_config.add_to_clean_up_list(dump_vfr_file_name)
+                    preprocess_args = (
+                        vfr_file_name, input_vfr_file_name, list(search_path_list), list(defines_list),
+                        add_arg, modified_resp, dict(FixedPcd_dict)
+                    )
+                    cache_file_name = None
+                    if tool_config.cache_dir:
+                        cache_key = vfr_preprocess_cache_key(
+                            vfr_content, header_file_list, *preprocess_args[2:], tool_config)
+                        cache_file_name = os.path.join(tool_config.cache_dir, cache_key + '.vfr')
+
+                    future = concurrent.futures.Future()
+                    if cache_file_name and os.path.isfile(cache_file_name):
+                        logger.info('  [cache] %s' % cache_file_name)
+                        with open(cache_file_name, 'r') as f:
+                            vfr_content = f.read()
+                        with open(dump_vfr_file_name, 'w') as f:
+                            f.write(vfr_content)
+                        future.set_result(vfr_content)
+                    elif executor is not None:
+                        future = executor.submit(
+                            vfr_preprocess_job, *preprocess_args, cache_file_name, tool_config)
+                    else:
+                        future.set_result(vfr_preprocess_job(*preprocess_args, cache_file_name, tool_config))
+                    pending_vfr_dict[vfr_file_name] = future
+                    preprocess_jobs.append((dump_vfr_file_name, uni_str_dict, future))
                 else:
                     logger.warning('VFR File not found: %s' % vfr_file_name)
         else:
             logger.error('INF File not found: %s' % inf_file_name)
+            if executor is not None:
+                executor.shutdown(cancel_futures=True)
             os.chdir(tempdir)
             return None, 1
 
     if not vfr_found:
         logger.error('No VFR file found')
+        if executor is not None:
+            executor.shutdown(cancel_futures=True)
         os.chdir(tempdir)
         return None, 1
 
+    # Parse VFR contents in input order, so the merged structs do not depend on which preprocessing finished first
+    for dump_vfr_file_name, uni_str_dict, future in preprocess_jobs:
+        vfr_content = future.result()
+        processed_vfr_dict[dump_vfr_file_name] = uni_str_dict
+        logger.info('\nParsing preprocessed file: %s' % dump_vfr_file_name)
+        parse_vfr_content(
+            vfr_content, uni_str_dict, root, structs, repeated_items, parse_mode=0,
+            tool_config=tool_config
+        )
+    if executor is not None:
+        executor.shutdown()
+    if dependency_graph is not None:
+        dependency_graph.save()
+
     # Process Data Type
     logger.info('\nparse_data_type:')
     processed_vfr_list = processed_vfr_dict.keys()
@@ -3266,6 +3359,14 @@ def ProcessArgs():
         help='Merge Config XML files. This argument only works when --command_line and --cfg_xml are specified',
         action="store_true"
     )
+    argParser.add_argument(
+        '-j', '--jobs', type=int,
+        help='Number of processes preprocessing VFR files concurrently, 1 to disable. Defaults to the CPU count'
+    )
+    argParser.add_argument(
+        '-cache', '--cache_dir',
+        help='Directory caching preprocessed VFR files, so unchanged VFR files are not preprocessed again'
+    )
     argParser.add_argument(
         '-uuid', '--input_uuid', nargs=1,
         metavar=('input_uuid'),
@@ -3339,6 +3440,14 @@ if __name__ == '__main__':
     if args.alphabetical_sorted:
         tool_config.alphabetical_sorted = True
 
+    # Concurrent preprocessing
+    if args.jobs is not None:
+        tool_config.jobs = max(args.jobs, 1)
+
+    # Preprocess cache
+    if args.cache_dir:
+        tool_config.cache_dir = os.path.abspath(args.cache_dir)
+
     # Replace Config XML UUID
     if args.input_uuid:
         if not args.input_uuid[0]:
@@ -0,0 +1,156 @@
+# @ VfrToXmlConverter_test.py
+#
+# Copyright (c) 2025, Microsoft Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+#
+
+import os
+import re
+import tempfile
+import unittest
+from unittest import mock
+
+import VfrToXmlConverter
+
+VFR_CONTENT = '''#include "Config.h"
+formset guid = {0x1, 0x2, 0x3, {0, 0, 0, 0, 0, 0, 0, 0}},
+  title = STRING_TOKEN(STR_TITLE), help = STRING_TOKEN(STR_TITLE),
+  efivarstore CONFIG_T, attribute = 0x7, name = Cfg, guid = {0x1, 0x2, 0x3, {0, 0, 0, 0, 0, 0, 0, 1}};
+  form formid = 1, title = STRING_TOKEN(STR_TITLE);
+    numeric varid = Cfg.Knob,
+      prompt = STRING_TOKEN(STR_PROMPT),
+      help = STRING_TOKEN(STR_HELP),
+      minimum = 0,
+      maximum = 255,
+      step = 1,
+      default = KNOB_DEFAULT,
+    endnumeric;
+  endform;
+endformset;
+'''
+
+CONFIG_HEADER = '''#include "Nested.h"
+typedef struct {
+  KNOB_TYPE  Knob;
+} CONFIG_T;
+'''
+
+NESTED_HEADER = '''#define KNOB_TYPE  {}
+#define KNOB_DEFAULT  {}
+'''
+
+
+# Minimal preprocessor standing in for cl or gcc: inlines the quoted includes and expands the object like macros
+def fake_preprocess(input_file_name, include_path_list, defines_list=[], add_arg='', resp_file=None, vfr_mode=0,
+                    dump_file_name=None, tool_config=None):
+    macros = {}
+
+    def inline(file_name):
+        lines = []
+        with open(file_name, 'r') as f:
+            for line in f.read().splitlines():
+                include = re.match(r'\s*#include\s*"(.+)"', line)
+                define = re.match(r'\s*#define\s+(\w+)\s+(.*)', line)
+                if include:
+                    for path in [os.path.dirname(file_name)] + include_path_list:
+                        if os.path.isfile(os.path.join(path, include.group(1))):
+                            lines += inline(os.path.join(path, include.group(1)))
+                            break
+                elif define:
+                    macros[define.group(1)] = define.group(2).strip()
+                else:
+                    lines.append(line)
+        return lines
+
+    vfr_content = '\n'.join(inline(input_file_name))
+    return re.sub(r'\w+', lambda match: macros.get(match.group(0), match.group(0)), vfr_content)
+
+
+class VfrConversionCacheTests(unittest.TestCase):
+    def setUp(self):
+        self.tmp_dir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.tmp_dir.cleanup)
+        self.module_dir = os.path.join(self.tmp_dir.name, 'Module')
+        os.makedirs(os.path.join(self.module_dir, 'Include'))
+        self.inf_file = os.path.join(self.module_dir, 'Module.inf')
+        self.vfr_file = os.path.join(self.module_dir, 'Form.vfr')
+        self.nested_header = os.path.join(self.module_dir, 'Include', 'Nested.h')
+        self.write(self.inf_file, '')
+        self.write(self.vfr_file, VFR_CONTENT)
+        self.write(os.path.join(self.module_dir, 'Include', 'Config.h'), CONFIG_HEADER)
+        self.write(self.nested_header, NESTED_HEADER.format('UINT8', 3))
+
+        self.tool_config = VfrToXmlConverter.vfr_xml_config()
+        self.tool_config.set_verbosity(0)
+        self.tool_config.srcdir = self.tmp_dir.name
+        self.tool_config.path_ready = True
+        self.tool_config.jobs = 1
+        self.tool_config.cache_dir = os.path.join(self.tmp_dir.name, 'Cache')
+        self.tool_config.input_inf_dict = {self.inf_file: ''}
+        self.tool_config.input_platform_build_py = ''
+        self.tool_config.input_uuid = '00000000-0000-0000-0000-000000000001'
+        self.tool_config.output_file_path = os.path.join(self.tmp_dir.name, 'output.xml')
+
+        inf_info = ([self.vfr_file], [], [], [self.module_dir, os.path.join(self.module_dir, 'Include')], 'Module', {})
+        patches = [
+            mock.patch.object(VfrToXmlConverter, 'inf_get_info', return_value=inf_info),
+            mock.patch.object(VfrToXmlConverter, 'run_preprocess', side_effect=fake_preprocess),
+            mock.patch.object(VfrToXmlConverter, 'vfr_resolve_sources', wraps=VfrToXmlConverter.vfr_resolve_sources),
+        ]
+        self.inf_get_info, self.run_preprocess, self.vfr_resolve_sources = [patch.start() for patch in patches]
+        for patch in patches:
+            self.addCleanup(patch.stop)
+
+    @staticmethod
+    def write(file_name, content):
+        with open(file_name, 'w') as f:
+            f.write(content)
+
+    # Convert the module, return the knob member and the number of times the vfr was resolved and preprocessed
+    def convert(self):
+        self.vfr_resolve_sources.reset_mock()
+        self.run_preprocess.reset_mock()
+        root, ret = VfrToXmlConverter.parse_inf_to_xml(self.tool_config)
+        self.assertEqual(ret, 0)
+        member = root.find('Structs/Struct/Member')
+        return (member.get('type'), member.get('default')), self.vfr_resolve_sources.call_count, \
+            self.run_preprocess.call_count
+
+    def test_edited_vfr_is_preprocessed_again(self):
+        self.assertEqual(self.convert(), (('uint8_t', '3'), 1, 1))
+        with open(self.tool_config.output_file_path, 'r') as f:
+            output = f.read()
+
+        # Nothing changed, the preprocessed vfr comes from the cache and the output is identical
+        self.assertEqual(self.convert(), (('uint8_t', '3'), 0, 0))
+        with open(self.tool_config.output_file_path, 'r') as f:
+            self.assertEqual(f.read(), output)
+
+        # The edited vfr misses the cache and the output follows it
+        self.write(self.vfr_file, VFR_CONTENT.replace('KNOB_DEFAULT', '7'))
+        self.assertEqual(self.convert(), (('uint8_t', '7'), 1, 1))
+        self.assertEqual(self.convert(), (('uint8_t', '7'), 0, 0))
+
+        # The cache is keyed by content, restoring the vfr reuses its first preprocessing
+        self.write(self.vfr_file, VFR_CONTENT)
+        self.assertEqual(self.convert(), (('uint8_t', '3'), 1, 0))
+
+    def test_edited_nested_header_reconverts_dependent_vfr(self):
+        self.assertEqual(self.convert(), (('uint8_t', '3'), 1, 1))
+
+        # Nothing changed, the dependency graph and the cache reuse the previous run
+        self.assertEqual(self.convert(), (('uint8_t', '3'), 0, 0))
+
+        # The header included by the header of the vfr changed, the vfr is resolved and preprocessed again
+        self.write(self.nested_header, NESTED_HEADER.format('UINT16', 5))
+        self.assertEqual(self.convert(), (('uint16_t', '5'), 1, 1))
+        self.assertEqual(self.convert(), (('uint16_t', '5'), 0, 0))
+
+        # A removed nested header is a change as well
+        os.remove(self.nested_header)
+        self.assertEqual(self.convert()[1:], (1, 1))
+
+
+if __name__ == '__main__':
+    unittest.main()
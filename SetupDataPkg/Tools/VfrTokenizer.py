@@ -0,0 +1,369 @@
+# @ VfrTokenizer.py
+#
+# Copyright (c) 2025, Microsoft Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+import re
+from collections import namedtuple
+
+QUESTION_END = {'oneof': 'endoneof', 'numeric': 'endnumeric', 'checkbox': 'endcheckbox'}
+QUESTION_VALUES = ('varid', 'minimum', 'maximum', 'default')
+QUESTION_STRINGS = ('prompt', 'help')
+CONDITION_KEYWORDS = ('suppressif', 'grayoutif', 'disableif')
+VARSTORE_KEYWORDS = ('varstore', 'efivarstore', 'namevaluevarstore')
+KEYWORDS = (tuple(QUESTION_END) + tuple(QUESTION_END.values()) + QUESTION_VALUES + QUESTION_STRINGS
+            + ('option', 'endif') + CONDITION_KEYWORDS + VARSTORE_KEYWORDS)
+
+# Strings and comments are matched only to skip the keywords inside them
+SKIP_PATTERN = r'"(?:\\.|[^"\\\n])*"|//[^\n]*|/\*.*?(?:\*/|\Z)'
+
+# A single compiled pattern finds the keywords of the vfr content in one pass, the text in between is left to the
+# parsers below. The lookahead rejects most positions before trying the keywords one by one.
+KEYWORD_PATTERN = re.compile(
+    '(?=[%s"/])(?:(?P<skip>%s)|\\b(?P<keyword>%s)\\b)' % (
+        ''.join(sorted(set(keyword[0] for keyword in KEYWORDS))),
+        SKIP_PATTERN,
+        '|'.join(sorted(KEYWORDS, key=len, reverse=True))
+    ),
+    re.DOTALL | re.IGNORECASE
+)
+
+# Tokenizer of short texts like conditions, words cover identifiers and numbers
+TOKEN_PATTERN = re.compile(
+    r'(?P<space>\s+)|(?P<skip>%s)|(?P<word>\w+)|(?P<op>==|.)' % SKIP_PATTERN,
+    re.DOTALL
+)
+
+COMMENT_PATTERN = re.compile(SKIP_PATTERN, re.DOTALL)
+ASSIGN_PATTERN = re.compile(r'\s*=')
+SEMICOLON_PATTERN = re.compile(r'\s*;')
+STRING_ASSIGN_PATTERN = re.compile(r'\s*=\s*STRING_TOKEN\s*\(([^)]*)\)', re.IGNORECASE)
+OPTION_TEXT_PATTERN = re.compile(r'(?<!\w)text\s*=\s*STRING_TOKEN\s*\(\s*([^)]+?)\s*\)', re.DOTALL | re.IGNORECASE)
+OPTION_VALUE_PATTERN = re.compile(r'(?<!\w)value\s*=\s*([^,]+)', re.DOTALL | re.IGNORECASE)
+OPTION_FLAGS_PATTERN = re.compile(r'(?<!\w)flags\s*=\s*([\w\s|]+)', re.DOTALL | re.IGNORECASE)
+VARSTORE_NAME_PATTERN = re.compile(r'\s+(\w+)[^;]*?name\s*=\s*(\w+)', re.DOTALL | re.IGNORECASE)
+NAMEVALUE_PATTERN = re.compile(r'\s+(\w+)([^;]*);', re.DOTALL)
+STRING_TOKEN_PATTERN = re.compile(r'STRING_TOKEN\s*\(\s*([^)]+)\s*\)')
+
+# kind: 'keyword', 'skip', 'word' or 'op'; value: Lower case for keywords; start, end: Span of the token
+VfrToken = namedtuple('VfrToken', ['kind', 'value', 'start', 'end'])
+
+# type: 'oneof', 'numeric' or 'checkbox'
+# values: {varid|minimum|maximum|default: Raw value}, only the first occurrence of each is kept
+# strings: {prompt|help: String token}, only the first occurrence of each is kept
+# options: A list of VfrOption
+VfrQuestion = namedtuple('VfrQuestion', ['type', 'values', 'strings', 'options'])
+
+# text: String token, value: Value, both None if absent; flags: A list of flags
+VfrOption = namedtuple('VfrOption', ['text', 'value', 'flags'])
+
+# Nodes of a parsed condition
+IdEqVal = namedtuple('IdEqVal', ['negated', 'varstore', 'member', 'value'])
+Unknown = namedtuple('Unknown', ['name'])  # Operand which is not supported, e.g. TRUE, only fails if evaluated
+And = namedtuple('And', ['operands'])
+Or = namedtuple('Or', ['operands'])
+
+
+class ConditionError(Exception):
+    def __init__(self, message):
+        super().__init__(message)
+
+
+# Find the keywords of the vfr content, the keywords inside strings and comments are skipped
+# Return: A list of VfrToken of kind 'keyword'
+def lex(vfr_content):
+    return [
+        VfrToken('keyword', match.group().lower(), match.start(), match.end())
+        for match in KEYWORD_PATTERN.finditer(vfr_content) if match.lastgroup == 'keyword'
+    ]
+
+
+# Split a short text into tokens, whitespace and comments are dropped, strings are kept as 'skip' tokens
+# Return: A list of VfrToken
+def tokenize(text):
+    return [
+        VfrToken(match.lastgroup, match.group(), match.start(), match.end())
+        for match in TOKEN_PATTERN.finditer(text)
+        if match.lastgroup != 'space' and not (match.lastgroup == 'skip' and match.group()[0] == '/')
+    ]
+
+
+# Remove // and /* */ comments from the vfr content in a single pass
+# A block comment spanning lines keeps the text before and after it on separate lines
+# Return: vfr content without comments, with its lines joined by '\n'
+def remove_comments(vfr_content):
+    def replace(match):
+        text = match.group()
+        if text[0] == '"':
+            return text
+        if text[1] == '*' and '\n' in text:
+            return '\n'
+        return ''
+
+    return '\n'.join(COMMENT_PATTERN.sub(replace, vfr_content).splitlines())
+
+
+# Match "= value" at position, where value spans up to the next ',' or stop
+# Return: Value with the leading whitespace removed, None if not matched
+#   A value made of whitespace only keeps its last character, so it still counts as assigned
+def _match_value(vfr_content, position, stop):
+    match = ASSIGN_PATTERN.match(vfr_content, position, stop)
+    if match is None:
+        return None
+    value_end = vfr_content.find(',', match.end(), stop)
+    if value_end == -1:
+        value_end = stop
+    raw = vfr_content[match.end():value_end]
+    if not raw:
+        return None
+    value = raw.lstrip()
+    return value if value else raw[-1:]
+
+
+# Match "= STRING_TOKEN(token)" at position
+# Return: String token, None if not matched
+def _match_string(vfr_content, position, stop):
+    match = STRING_ASSIGN_PATTERN.match(vfr_content, position, stop)
+    if match is None:
+        return None
+    return match.group(1).strip() or None
+
+
+# Parse the text of an option statement, between the option keyword and its ;
+def _parse_option(option):
+    text = OPTION_TEXT_PATTERN.search(option)
+    value = OPTION_VALUE_PATTERN.search(option)
+    flags = []
+    for match in OPTION_FLAGS_PATTERN.findall(option):
+        flags.extend(flag.strip() for flag in match.split('|') if flag.strip())
+    return VfrOption(
+        text.group(1).strip() if text else None,
+        value.group(1).strip() if value else None,
+        flags
+    )
+
+
+# Parse the body of a question between keywords[start] and keywords[stop], excluding both
+def _parse_question(vfr_content, keywords, question_type, start, stop):
+    values = {}
+    strings = {}
+    options = []
+    body_end = keywords[stop].start
+    next_option = 0  # Options do not nest, the next one starts after the ; of the previous one
+    for index in range(start, stop):
+        keyword = keywords[index]
+        if keyword.value in QUESTION_VALUES:
+            if keyword.value not in values:
+                value = _match_value(vfr_content, keyword.end, body_end)
+                if value is not None:
+                    values[keyword.value] = value
+        elif keyword.value in QUESTION_STRINGS:
+            if keyword.value not in strings:
+                string_token = _match_string(vfr_content, keyword.end, body_end)
+                if string_token is not None:
+                    strings[keyword.value] = string_token
+        elif keyword.value == 'option' and keyword.start >= next_option and vfr_content[keyword.end].isspace():
+            option_end = vfr_content.find(';', keyword.end, body_end)
+            if option_end != -1:
+                options.append(_parse_option(vfr_content[keyword.end:option_end]))
+                next_option = option_end + 1
+    return VfrQuestion(question_type, values, strings, options)
+
+
+# Parse the oneof, numeric and checkbox questions of the vfr content
+# keywords (Optional): Result of lex(vfr_content), if already available
+# Return: A list of VfrQuestion in the order they appear
+def parse_questions(vfr_content, keywords=None):
+    if keywords is None:
+        keywords = lex(vfr_content)
+
+    questions = []
+    count = len(keywords)
+    index = 0
+    while index < count:
+        keyword = keywords[index]
+        if keyword.value in QUESTION_END and vfr_content[keyword.end:keyword.end + 1].isspace():
+            end_keyword = QUESTION_END[keyword.value]
+            for end in range(index + 1, count):
+                if (keywords[end].value == end_keyword
+                        and SEMICOLON_PATTERN.match(vfr_content, keywords[end].end) is not None):
+                    questions.append(_parse_question(vfr_content, keywords, keyword.value, index + 1, end))
+                    index = end
+                    break
+        index += 1
+    return questions
+
+
+# Collect the varstore, efivarstore and namevaluevarstore statements of the vfr content
+# keywords (Optional): Result of lex(vfr_content), if already available
+# Return:
+#   varstore_list: A list of (varstore name, type name) from varstore and efivarstore statements, in that order
+#   namevalue_list: A list of (type name, [String tokens of the names]) from namevaluevarstore statements
+def collect_varstores(vfr_content, keywords=None):
+    if keywords is None:
+        keywords = lex(vfr_content)
+
+    varstores = {'varstore': [], 'efivarstore': []}
+    namevalue_list = []
+    for keyword in keywords:
+        if keyword.value in varstores:
+            match = VARSTORE_NAME_PATTERN.match(vfr_content, keyword.end)
+            if match:
+                varstores[keyword.value].append((match.group(2), match.group(1)))
+        elif keyword.value == 'namevaluevarstore':
+            match = NAMEVALUE_PATTERN.match(vfr_content, keyword.end)
+            if match:
+                namevalue_list.append((match.group(1), STRING_TOKEN_PATTERN.findall(match.group(2))))
+    return varstores['varstore'] + varstores['efivarstore'], namevalue_list
+
+
+# Recursive descent parser of a condition, supporting ideqval comparisons, NOT ideqval, AND, OR and parentheses
+# Any other single word is parsed as an Unknown operand
+class _ConditionParser:
+    def __init__(self, tokens):
+        self.tokens = tokens
+        self.index = 0
+
+    def peek(self):
+        if self.index < len(self.tokens):
+            return self.tokens[self.index].value
+        return None
+
+    def take(self, expected=None):
+        value = self.peek()
+        if value is None or (expected is not None and value.upper() != expected):
+            raise ConditionError(f'Expected {expected or "a token"}, got {value}')
+        self.index += 1
+        return self.tokens[self.index - 1]
+
+    def parse(self):
+        node = self.parse_or()
+        if self.peek() is not None:
+            raise ConditionError(f'Unexpected {self.peek()}')
+        return node
+
+    def parse_or(self):
+        operands = [self.parse_and()]
+        while self.peek() is not None and self.peek().upper() == 'OR':
+            self.take()
+            operands.append(self.parse_and())
+        return operands[0] if len(operands) == 1 else Or(operands)
+
+    def parse_and(self):
+        operands = [self.parse_unary()]
+        while self.peek() is not None and self.peek().upper() == 'AND':
+            self.take()
+            operands.append(self.parse_unary())
+        return operands[0] if len(operands) == 1 else And(operands)
+
+    def parse_unary(self):
+        if self.peek() == '(':
+            self.take()
+            node = self.parse_or()
+            self.take(')')
+            return node
+        if (self.index < len(self.tokens) and self.tokens[self.index].kind == 'word'
+                and self.peek().upper() not in ('NOT', 'IDEQVAL')):
+            return Unknown(self.take().value)
+        negated = False
+        if self.peek() is not None and self.peek().upper() == 'NOT':
+            self.take()
+            negated = True
+        self.take('IDEQVAL')
+        varstore = self.take()
+        self.take('.')
+        member = self.take()
+        self.take('==')
+        value = self.take()
+        if varstore.kind != 'word' or member.kind != 'word' or value.kind != 'word':
+            raise ConditionError('ideqval expects varstore.member == value')
+        return IdEqVal(negated, varstore.value, member.value, value.value)
+
+
+# Parse a condition of a suppressif, grayoutif or disableif statement
+# condition: Condition string, or its tokens
+# Return: Root node of the condition, raise ConditionError if the condition cannot be parsed
+def parse_condition(condition):
+    if isinstance(condition, str):
+        condition = tokenize(condition)
+    return _ConditionParser(condition).parse()
+
+
+# Evaluate a parsed condition, AND and OR evaluate their operands from left to right only until the result is known
+# get_value: Function returning the current value of (varstore, member), an empty value if unknown
+# Return: Boolean result of the condition, an ideqval of an unknown value is False even when negated
+#   Raise ConditionError if an Unknown operand is evaluated
+def evaluate_condition(node, get_value):
+    if isinstance(node, IdEqVal):
+        current_value = get_value(node.varstore, node.member)
+        if not current_value:
+            return False
+        return (str(current_value) == node.value) != node.negated
+    if isinstance(node, Unknown):
+        raise ConditionError(f'Unsupported operand {node.name}')
+    if isinstance(node, And):
+        return all(evaluate_condition(operand, get_value) for operand in node.operands)
+    return any(evaluate_condition(operand, get_value) for operand in node.operands)
+
+
+# Find the spans of the suppressif, grayoutif and disableif statements whose condition holds
+# Each span covers the statement up to its matching endif;, or the end of the content if there is none
+# judge: Function taking the condition string, returning the boolean result of the condition
+# keywords (Optional): Result of lex(vfr_content), if already available
+# Return: A sorted list of non-overlapping (start, end) spans
+def find_conditional_spans(vfr_content, judge, keywords=None):
+    if keywords is None:
+        keywords = lex(vfr_content)
+
+    spans = []
+    count = len(keywords)
+    index = 0
+    while index < count:
+        keyword = keywords[index]
+        index += 1
+        if keyword.value not in CONDITION_KEYWORDS or not vfr_content[keyword.end:keyword.end + 1].isspace():
+            continue
+
+        condition_end = vfr_content.find(';', keyword.end)
+        if condition_end == -1:
+            break
+        while index < count and keywords[index].start < condition_end:
+            index += 1
+        if not judge(vfr_content[keyword.end:condition_end].strip()):
+            continue
+
+        # Pair the matching endif;, skipping nested conditional statements
+        span_end = len(vfr_content)
+        depth = 0
+        for end in range(index, count):
+            if keywords[end].value in CONDITION_KEYWORDS:
+                depth += 1
+            elif keywords[end].value == 'endif':
+                match = SEMICOLON_PATTERN.match(vfr_content, keywords[end].end)
+                if match is None:
+                    continue
+                if depth == 0:
+                    span_end = match.end()
+                    break
+                depth -= 1
+        if spans and keyword.start < spans[-1][1]:
+            spans[-1] = (spans[-1][0], max(spans[-1][1], span_end))
+        else:
+            spans.append((keyword.start, span_end))
+    return spans
+
+
+# Remove the given spans from the vfr content
+# A span covering several lines keeps the text before and after it on separate lines
+# Return: vfr content without the spans, with its lines joined by '\n'
+def remove_spans(vfr_content, spans):
+    pieces = []
+    position = 0
+    for start, end in spans:
+        pieces.append(vfr_content[position:start])
+        if '\n' in vfr_content[start:end]:
+            pieces.append('\n')
+        position = end
+    pieces.append(vfr_content[position:])
+    return '\n'.join(''.join(pieces).splitlines())
@@ -0,0 +1,172 @@
+# @ VfrTokenizer_test.py
+#
+# Copyright (c) 2025, Microsoft Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+#
+
+import unittest
+
+from VfrTokenizer import lex, tokenize, remove_comments, parse_questions, collect_varstores
+from VfrTokenizer import parse_condition, evaluate_condition, find_conditional_spans, remove_spans
+from VfrTokenizer import IdEqVal, And, Or, ConditionError
+
+
+class RemoveCommentsTests(unittest.TestCase):
+    def test_line_and_block_comments(self):
+        vfr = 'a = 1; // line\nb /* inline */ = 2;\nc /* block\n spanning\n lines */ = 3;\n'
+        self.assertEqual(remove_comments(vfr), 'a = 1; \nb  = 2;\nc \n = 3;')
+
+    def test_comment_markers_in_strings(self):
+        vfr = '#include "Dir//File.h" // comment\nx = "/* not a comment */";'
+        self.assertEqual(remove_comments(vfr), '#include "Dir//File.h" \nx = "/* not a comment */";')
+
+    def test_unterminated_block_comment(self):
+        self.assertEqual(remove_comments('a;\nb; /* open\nc;\n'), 'a;\nb; ')
+
+
+class LexTests(unittest.TestCase):
+    def test_keywords_only(self):
+        keywords = lex('oneof varid = Cfg.Mode, // option\n "default" endoneof;')
+        self.assertEqual([keyword.value for keyword in keywords], ['oneof', 'varid', 'endoneof'])
+        self.assertEqual(keywords[0].start, 0)
+        self.assertEqual(keywords[0].end, 5)
+
+    def test_keywords_ignore_case(self):
+        self.assertEqual([keyword.value for keyword in lex('OneOf SUPPRESSIF x')], ['oneof', 'suppressif'])
+
+    def test_tokenize(self):
+        tokens = tokenize('ideqval A.B == 0x1 /* c */')
+        self.assertEqual([(token.kind, token.value) for token in tokens], [
+            ('word', 'ideqval'), ('word', 'A'), ('op', '.'), ('word', 'B'), ('op', '=='), ('word', '0x1')
+        ])
+
+
+class ParseQuestionsTests(unittest.TestCase):
+    vfr = """
+    efivarstore CFG_T, attribute = 0x7, name = Cfg, guid = {0x1};
+    oneof varid = Cfg.Mode,
+      prompt = STRING_TOKEN(STR_MODE_PROMPT),
+      help = STRING_TOKEN(STR_MODE_HELP),
+      option text = STRING_TOKEN(STR_OFF), value = 0, flags = 0;
+      option text = STRING_TOKEN(STR_ON), value = 1, flags = DEFAULT | RESET_REQUIRED;
+    endoneof;
+    numeric varid = Cfg.Count,
+      prompt = STRING_TOKEN(STR_COUNT),
+      help = STRING_TOKEN(STR_COUNT),
+      minimum = 1,
+      maximum = 16,
+      default = 4, default = 5,
+    endnumeric;
+    checkbox varid = Cfg.Enable,
+      prompt = STRING_TOKEN(STR_ENABLE),
+      help = STRING_TOKEN( STR_ENABLE_HELP ),
+      flags = CHECKBOX_DEFAULT,
+    endcheckbox;
+"""
+
+    def test_questions(self):
+        questions = parse_questions(self.vfr)
+        self.assertEqual([question.type for question in questions], ['oneof', 'numeric', 'checkbox'])
+
+        oneof = questions[0]
+        self.assertEqual(oneof.values, {'varid': 'Cfg.Mode'})
+        self.assertEqual(oneof.strings, {'prompt': 'STR_MODE_PROMPT', 'help': 'STR_MODE_HELP'})
+        self.assertEqual(len(oneof.options), 2)
+        self.assertEqual(oneof.options[1].text, 'STR_ON')
+        self.assertEqual(oneof.options[1].value, '1')
+        self.assertEqual(oneof.options[1].flags, ['DEFAULT', 'RESET_REQUIRED'])
+
+        # Only the first occurrence of a value counts
+        numeric = questions[1]
+        self.assertEqual(numeric.values['minimum'].strip(), '1')
+        self.assertEqual(numeric.values['maximum'].strip(), '16')
+        self.assertEqual(numeric.values['default'].strip(), '4')
+
+        checkbox = questions[2]
+        self.assertEqual(checkbox.strings['help'], 'STR_ENABLE_HELP')
+        self.assertEqual(checkbox.options, [])
+
+    def test_unterminated_question(self):
+        self.assertEqual(parse_questions('oneof varid = Cfg.Mode,\n endoneof\n'), [])
+
+    def test_varstores(self):
+        vfr = self.vfr + """
+    varstore VS_T, varid = 0x10, name = Vs, guid = {0x2};
+    namevaluevarstore NV_T, name = STRING_TOKEN(STR_NV0), name = STRING_TOKEN(STR_NV1), guid = {0x3};
+"""
+        varstore_list, namevalue_list = collect_varstores(vfr)
+        self.assertEqual(varstore_list, [('Vs', 'VS_T'), ('Cfg', 'CFG_T')])
+        self.assertEqual(namevalue_list, [('NV_T', ['STR_NV0', 'STR_NV1'])])
+
+
+class ConditionTests(unittest.TestCase):
+    values = {('Cfg', 'A'): '1', ('Cfg', 'B'): '0', ('Cfg', 'Empty'): ''}
+
+    def judge(self, condition):
+        return evaluate_condition(parse_condition(condition), lambda varstore, member: self.values.get(
+            (varstore, member)))
+
+    def test_parse(self):
+        self.assertEqual(
+            parse_condition('NOT ideqval Cfg.A == 1 OR ideqval Cfg.B == 0 AND ideqval Cfg.A == 2'),
+            Or([IdEqVal(True, 'Cfg', 'A', '1'),
+                And([IdEqVal(False, 'Cfg', 'B', '0'), IdEqVal(False, 'Cfg', 'A', '2')])])
+        )
+
+    def test_evaluate(self):
+        self.assertTrue(self.judge('ideqval Cfg.A == 1'))
+        self.assertFalse(self.judge('NOT ideqval Cfg.A == 1'))
+        self.assertTrue(self.judge('ideqval Cfg.A == 2 OR ideqval Cfg.B == 0'))
+        self.assertFalse(self.judge('(ideqval Cfg.A == 2 OR ideqval Cfg.B == 0) AND ideqval Cfg.A == 0'))
+        self.assertTrue(self.judge('ideqval Cfg.A == 1 AND\n  (ideqval Cfg.A == 2 OR ideqval Cfg.B == 0)'))
+
+    def test_unknown_values_are_false(self):
+        self.assertFalse(self.judge('ideqval Cfg.Empty == 0'))
+        self.assertFalse(self.judge('NOT ideqval Cfg.Empty == 0'))
+        self.assertFalse(self.judge('NOT ideqval Cfg.Missing == 0'))
+
+    def test_unsupported_operands(self):
+        # Unsupported operands only fail when they are evaluated
+        self.assertTrue(self.judge('ideqval Cfg.A == 1 OR TRUE'))
+        with self.assertRaises(ConditionError):
+            self.judge('ideqval Cfg.A == 0 OR TRUE')
+        for condition in ['ideqvallist Cfg.A == 1 2', 'NOT (ideqval Cfg.A == 1)', 'ideqval Cfg.A == ', '']:
+            with self.assertRaises(ConditionError):
+                parse_condition(condition)
+
+
+class ConditionalSpanTests(unittest.TestCase):
+    vfr = """a;
+suppressif ideqval Cfg.A == 1;
+  b;
+  grayoutif ideqval Cfg.B == 1;
+    c;
+  endif;
+  d;
+endif;
+e;
+disableif ideqval Cfg.B == 1;
+  f;
+endif;
+g;"""
+
+    def test_nested_spans(self):
+        spans = find_conditional_spans(self.vfr, lambda condition: condition in ('ideqval Cfg.A == 1',))
+        self.assertEqual(remove_spans(self.vfr, spans), 'a;\n\n\ne;\ndisableif ideqval Cfg.B == 1;\n  f;\nendif;\ng;')
+
+    def test_inner_span(self):
+        spans = find_conditional_spans(self.vfr, lambda condition: condition == 'ideqval Cfg.B == 1')
+        self.assertEqual(len(spans), 2)
+        self.assertEqual(remove_spans(self.vfr, spans), 'a;\nsuppressif ideqval Cfg.A == 1;\n  b;\n  \n\n  d;\n'
+                                                        'endif;\ne;\n\n\ng;')
+
+    def test_unmatched_endif(self):
+        vfr = 'a;\nsuppressif ideqval Cfg.A == 1;\nb;\n'
+        spans = find_conditional_spans(vfr, lambda condition: True)
+        self.assertEqual(spans, [(3, len(vfr))])
+        self.assertEqual(remove_spans(vfr, spans), 'a;\n')
+
+
+if __name__ == '__main__':
+    unittest.main()
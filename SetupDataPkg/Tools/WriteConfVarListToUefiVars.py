@@ -9,12 +9,16 @@ import os
 import sys
 import logging
 import argparse
-import struct
 import uuid
-import ctypes
 from edk2toollib.os.uefivariablesupport import UefiVariable
 
-from CommonUtility import validate_config_xml_hash_against_fw
+from CommonUtility import validate_config_xml_hash_against_fw, has_privilege
+from UefiVariableStore import (
+    BulkVariableEngine,
+    FileUefiVariableBackend,
+    EfivarfsUefiVariableBackend,
+    EFIVARFS_PATH
+)
 
 gEfiGlobalVariableGuid = "8BE4DF61-93CA-11D2-AA0D-00E098032B8C"
 
@@ -53,6 +57,26 @@ def option_parser():
         help="Do not fail when XML hash mismatches FW (still prints a warning)",
     )
 
+    parser.add_argument(
+        "-s",
+        "--store",
+        dest="store_file",
+        required=False,
+        type=str,
+        help="""Optional: write to a variable list file backed variable store instead of the system, for testing""",
+    )
+
+    parser.add_argument(
+        "--efivarfs",
+        dest="efivarfs_root",
+        required=False,
+        type=str,
+        nargs="?",
+        const=EFIVARFS_PATH,
+        help="""Optional: write to the variables through efivarfs on Linux. Given a directory other than
+        /sys/firmware/efi/efivars, runs dry against a directory tree that mimics it""",
+    )
+
     arguments = parser.parse_args()
 
     if not os.path.isfile(arguments.setting_file):
@@ -66,82 +90,14 @@ def option_parser():
     return arguments
 
 
-#
-# Create an unpack statement formatted to address the variable length
-# parameters in the var store (Data and Unicode Name)
-def create_unpack_statement(NameStringSize, DataBufferSize):
-    #
-    # Dmpstore Format taken from AppendSingleVariableToFile() in
-    # ShellPkg\Library\UefiShellDebug1CommandsLib\DmpStore.c
-    # NameSize
-    # DataSize
-    # Name[NameSize]
-    # EFI_GUID
-    # Attributes
-    # Data[DataSize]
-    # CRC32
-
-    unpack_statement = "<II"
-    unpack_statement = unpack_statement + f"{NameStringSize}s"
-    unpack_statement = unpack_statement + "16s"
-    unpack_statement = unpack_statement + "I"
-    unpack_statement = unpack_statement + f"{DataBufferSize}s"
-    unpack_statement = unpack_statement + "I"
-
-    logging.debug(f"Created unpack statement {unpack_statement}")
-    return unpack_statement
-
-
-#
-# Using the passed byte array, extract the variable data and
-# write it into nvram
-#
-# Return a tuple that holds return code and the size of the variable.
-# A return code 0 indicates failure and other non-zero value represents success.
-#
-def extract_single_var_from_file_and_write_nvram(var):
-    # check that the passed byte array has at least enough space for the NameSize and DataSize
-    if len(var) > 8:
-        (NameSize, DataSize) = struct.unpack("<II", var[0:8])
-
-        unpack_statement = create_unpack_statement(NameSize, DataSize)
-
-        # check that the input byte array has at least enough space for unpack statement
-        if struct.calcsize(unpack_statement) > len(var):
-            logging.critical("Input File Parsing error: input buffer is smaller than unpack size")
-            return len(var)
-
-        result = struct.unpack(unpack_statement, var[0: struct.calcsize(unpack_statement)])
-
-        VarName = result[2].decode('utf16')
-        Guid = uuid.UUID(bytes_le=result[3])
-        Attributes = result[4]
-        Data = result[5]
-
-        logging.debug(f"Found Variable: {VarName} {Guid} {Attributes}")
-
-        UefiVar = UefiVariable()
-        rc = UefiVar.SetUefiVar(
-            VarName,
-            Guid,
-            Data,
-            Attributes,
-        )
-        if rc == 0:
-            logging.debug(f"Error returned from SetUefiVar: {rc}")
-
-        return [rc, struct.calcsize(unpack_statement)]
-    else:
-        logging.critical("var buffer was too small to be a valid dmpstore")
-
-    return [0, len(var)]
-
-
 #
 # Set variable from file
 #
-# Reads variable list from given file and writes each variable to NVRAM.
-# The file is expected to be in the dmpstore format.
+# Reads variable list from given file and writes the variables whose value differs from NVRAM.
+# The file is expected to be in the dmpstore (variable list) format, it is parsed once and the
+# variables are written through the bulk variable engine, which skips the unchanged ones and
+# reads the written ones back in one batch. Pass an engine to use another variable store or
+# to collect the statistics of the write.
 #
 # The return 0 indicates failure and other non-zero value represents success.
 # If abort_when_failure is set to True, the function will stop processing further variables and return 0
@@ -149,22 +105,33 @@ def extract_single_var_from_file_and_write_nvram(var):
 # Otherwise, it will continue processing all variables in the file regardless of individual failures
 # and return 1 at the end if it successfully processes the entire file.
 #
-def set_variable_from_file(setting_file, abort_when_failure=False) -> int:
+def set_variable_from_file(setting_file, abort_when_failure=False, engine=None) -> int:
+    if engine is None:
+        engine = BulkVariableEngine()
+
     # read the entire file
     with open(setting_file, "rb") as file:
         var = file.read()
 
-        # go through the entire file parsing each dmpstore variable
-        start = 0
-        while len(var[start:]) != 0:
-            rc, var_size = extract_single_var_from_file_and_write_nvram(var[start:])
-            if abort_when_failure and rc == 0:
-                return 0
-            start = start + var_size
+    try:
+        variables = engine.parse(var)
+    except Exception as e:
+        logging.critical(f"Input File Parsing error: {e}")
+        return 0
+
+    if not engine.write(variables, abort_when_failure) and abort_when_failure:
+        return 0
     return 1
 
 
-def delete_var_by_guid_name(var_name, guid):
+def delete_var_by_guid_name(var_name, guid, engine=None):
+    if engine is not None:
+        logging.debug(f"Clear Variable: {var_name} {guid}")
+        if not engine.delete(var_name, guid):
+            logging.debug(f"Error returned from deleting variable {var_name} {guid}")
+            return 0
+        return 1
+
     # convert var_name to utf16
     VarName = var_name.encode('utf16').decode('utf16')
     Guid = uuid.UUID(guid)
@@ -193,6 +160,20 @@ def delete_var_by_guid_name(var_name, guid):
 def main():
     arguments = option_parser()
 
+    if arguments.store_file is not None:
+        engine = BulkVariableEngine(FileUefiVariableBackend(arguments.store_file))
+    elif arguments.efivarfs_root is not None and \
+            os.path.realpath(arguments.efivarfs_root) != os.path.realpath(EFIVARFS_PATH):
+        engine = BulkVariableEngine(EfivarfsUefiVariableBackend(arguments.efivarfs_root, dry_run=True))
+    elif arguments.efivarfs_root is not None:
+        if not has_privilege():
+            return 1
+        engine = BulkVariableEngine(EfivarfsUefiVariableBackend())
+    else:
+        if not has_privilege():
+            return 1
+        engine = BulkVariableEngine()
+
     if arguments.configuration_file is not None:
         ok, _, _ = validate_config_xml_hash_against_fw(
             arguments.configuration_file,
@@ -201,7 +182,8 @@ def main():
         )
         if not ok:
             return 1
-    set_variable_from_file(arguments.setting_file)
+    set_variable_from_file(arguments.setting_file, engine=engine)
+    print(engine.stats)
     return 0
 
 
@@ -213,16 +195,6 @@ if __name__ == "__main__":
     console = logging.StreamHandler()
     console.setLevel(logging.CRITICAL)
 
-    # check the privilege level and report error
-    if os.name == 'nt':
-        if not ctypes.windll.shell32.IsUserAnAdmin():
-            print("Administrator privilege required. Please launch from an Administrator privilege level.")
-            sys.exit(1)
-    else:
-        if os.geteuid() != 0:
-            print("Root permission required, please run script with sudo.")
-            sys.exit(1)
-
     # call main worker function
     retcode = main()
 